@@ -24,21 +24,46 @@
 
 #include "memblock_cache.h"
 #include "srsran/adt/circular_buffer.h"
+#include <algorithm>
 #include <thread>
+#include <vector>
 
 namespace srsran {
 
+/// Snapshot of the usage statistics of a concurrent_fixed_memory_pool.
+struct fixed_memory_pool_metrics_t {
+  /// Total number of blocks managed by the pool.
+  size_t nof_blocks = 0;
+  /// Number of blocks currently stored in the central cache.
+  size_t nof_central_blocks = 0;
+  /// Number of threads that currently hold a local cache.
+  size_t nof_workers = 0;
+  /// Highest number of blocks stored in a single thread local cache.
+  size_t max_local_cache_size = 0;
+  /// Total number of allocations.
+  uint64_t nof_allocs = 0;
+  /// Number of allocations that missed the thread local cache and had to fetch a batch from the central cache.
+  uint64_t nof_central_refills = 0;
+  /// Number of times a thread local cache returned blocks to the central cache.
+  uint64_t nof_central_returns = 0;
+  /// Number of allocations that failed due to pool depletion.
+  uint64_t nof_failed_allocs = 0;
+};
+
 /**
  * Concurrent fixed size memory pool made of blocks of equal size
  * Each worker keeps a separate thread-local memory block cache that it uses for fast allocation/deallocation.
- * When this cache gets depleted, the worker tries to obtain blocks from a central memory block cache.
+ * When this cache gets depleted, the worker obtains a batch of blocks from a central, lock-free memory block cache.
  * When accessing a thread local cache, no locks are required.
  * Since there is no stealing of blocks between workers, it is possible that a worker can't allocate while another
  * worker still has blocks in its own cache. To minimize the impact of this event, an upper bound is place on a worker
- * thread cache size. Once a worker reaches that upper bound, it sends half of its stored blocks to the central cache.
+ * thread cache size. Once a worker reaches that upper bound, it sends half of its stored blocks to the central cache,
+ * in batches. This also covers the case where blocks are allocated in one thread and deallocated in another.
+ * All blocks are allocated in a single contiguous arena, which is required by the central lock-free batch stack.
+ * Each worker keeps allocation counters that can be retrieved via get_metrics().
  * Note: Taking into account the usage of thread_local, this class is made a singleton
- * Note2: No considerations were made regarding false sharing between threads. It is assumed that the blocks are big
- *        enough to fill a cache line.
+ * Note2: The blocks are assumed to be big enough to fill a cache line. Worker contexts are cache line aligned to avoid
+ *        false sharing of the counters.
  * @tparam NofObjects number of objects in the pool
  * @tparam ObjSize object size
  */
@@ -55,19 +80,24 @@ class concurrent_fixed_memory_pool
   const static size_t batch_steal_size = 16;
 
   // ctor only accessible from singleton get_instance()
-  explicit concurrent_fixed_memory_pool(size_t nof_objects_)
+  explicit concurrent_fixed_memory_pool(size_t nof_objects_) :
+    nof_blocks(nof_objects_),
+    arena(new obj_storage_t[nof_objects_]),
+    central_mem_cache(arena.get(), sizeof(obj_storage_t), nof_objects_)
   {
     srsran_assert(nof_objects_ > batch_steal_size, "A positive pool size must be provided");
+    srsran_assert(arena != nullptr, "Failed to instantiate fixed memory pool");
 
-    std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.resize(nof_objects_);
-    for (std::unique_ptr<obj_storage_t>& b : allocated_blocks) {
-      b.reset(new obj_storage_t());
-      srsran_assert(b.get() != nullptr, "Failed to instantiate fixed memory pool");
-      central_mem_cache.push(static_cast<void*>(b.get()));
+    // fill the central cache in batches, ordered by address
+    free_memblock_list blocks;
+    for (size_t i = nof_blocks; i > 0; --i) {
+      blocks.push(static_cast<void*>(&arena[i - 1]));
     }
-    local_growth_thres = allocated_blocks.size() / 16;
-    local_growth_thres = local_growth_thres < batch_steal_size ? batch_steal_size : local_growth_thres;
+    while (not blocks.empty()) {
+      central_mem_cache.push(blocks, batch_steal_size);
+    }
+    local_growth_thres = nof_blocks / 16;
+    local_growth_thres = local_growth_thres < 2 * batch_steal_size ? 2 * batch_steal_size : local_growth_thres;
   }
 
 public:
@@ -78,19 +108,13 @@ public:
   concurrent_fixed_memory_pool& operator=(const concurrent_fixed_memory_pool&) = delete;
   concurrent_fixed_memory_pool& operator=(concurrent_fixed_memory_pool&&) = delete;
 
-  ~concurrent_fixed_memory_pool()
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.clear();
-  }
-
   static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress>* get_instance(size_t size = 4096)
   {
     static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress> pool(size);
     return &pool;
   }
 
-  size_t size() { return allocated_blocks.size(); }
+  size_t size() { return nof_blocks; }
 
   void* allocate_node(size_t sz)
   {
@@ -99,45 +123,44 @@ public:
 
     void* node = worker_ctxt->cache.try_pop();
     if (node == nullptr) {
-      // fill the thread local cache enough for this and next allocations
-      std::array<void*, batch_steal_size> popped_blocks;
-      size_t                              n = central_mem_cache.try_pop(popped_blocks);
-      for (size_t i = 0; i < n; ++i) {
-        new (popped_blocks[i]) obj_storage_t();
-        worker_ctxt->cache.push(static_cast<void*>(popped_blocks[i]));
-      }
+      // fill the thread local cache with a batch of blocks for this and next allocations
+      increment(worker_ctxt->nof_central_refills);
+      central_mem_cache.try_pop(worker_ctxt->cache);
       node = worker_ctxt->cache.try_pop();
     }
+    increment(worker_ctxt->nof_allocs);
 
-#ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
     if (node == nullptr) {
+      increment(worker_ctxt->nof_failed_allocs);
+#ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
       print_error("Error allocating buffer in pool of ObjSize=%zd", ObjSize);
-    }
 #endif
+    }
     return node;
   }
 
   void deallocate_node(void* p)
   {
     srsran_assert(p != nullptr, "Deallocated nodes must have valid address");
-    worker_ctxt*   worker_ctxt = get_worker_cache();
-    obj_storage_t* block_ptr   = static_cast<obj_storage_t*>(p);
+    worker_ctxt* worker_ctxt = get_worker_cache();
 
     if (DebugSanitizeAddress) {
-      std::lock_guard<std::mutex> lock(mutex);
-      srsran_assert(std::any_of(allocated_blocks.begin(),
-                                allocated_blocks.end(),
-                                [block_ptr](const std::unique_ptr<obj_storage_t>& b) { return b.get() == block_ptr; }),
-                    "Error deallocating block with address 0x%lx",
-                    (long unsigned)block_ptr);
+      srsran_assert(central_mem_cache.owns(p), "Error deallocating block with address 0x%lx", (long unsigned)p);
     }
 
     // push to local memory block cache
-    worker_ctxt->cache.push(static_cast<void*>(p));
+    worker_ctxt->cache.push(p);
+    size_t cache_size = worker_ctxt->cache.size();
+    if (cache_size > worker_ctxt->max_cache_size.load(std::memory_order_relaxed)) {
+      worker_ctxt->max_cache_size.store(cache_size, std::memory_order_relaxed);
+    }
 
-    if (worker_ctxt->cache.size() >= local_growth_thres) {
+    if (cache_size >= local_growth_thres) {
       // if local cache reached max capacity, send half of the blocks to central cache
-      central_mem_cache.steal_blocks(worker_ctxt->cache, worker_ctxt->cache.size() / 2);
+      increment(worker_ctxt->nof_central_returns);
+      while (worker_ctxt->cache.size() > local_growth_thres / 2) {
+        central_mem_cache.push(worker_ctxt->cache, batch_steal_size);
+      }
     }
   }
 
@@ -151,33 +174,73 @@ public:
     }
   }
 
-  void print_all_buffers()
+  /// Aggregates the counters of all the threads that used the pool, including threads that have already exited.
+  fixed_memory_pool_metrics_t get_metrics()
   {
-    auto*  worker     = get_worker_cache();
-    size_t tot_blocks = 0;
-    {
-      std::lock_guard<std::mutex> lock(mutex);
-      tot_blocks = allocated_blocks.size();
+    std::lock_guard<std::mutex> lock(mutex);
+    fixed_memory_pool_metrics_t ret = retired_metrics;
+    ret.nof_blocks                  = nof_blocks;
+    ret.nof_central_blocks          = central_mem_cache.size();
+    ret.nof_workers                 = workers.size();
+    for (const worker_ctxt* w : workers) {
+      w->accumulate(ret);
     }
+    return ret;
+  }
+
+  void print_all_buffers()
+  {
+    auto* worker = get_worker_cache();
     printf("There are %zd/%zd buffers in shared block container. This thread contains %zd in its local cache\n",
            central_mem_cache.size(),
-           tot_blocks,
+           nof_blocks,
            worker->cache.size());
   }
 
 private:
-  struct worker_ctxt {
-    std::thread::id    id;
-    free_memblock_list cache;
+  struct alignas(64) worker_ctxt {
+    std::thread::id       id;
+    free_memblock_list    cache;
+    std::atomic<size_t>   max_cache_size{0};
+    std::atomic<uint64_t> nof_allocs{0};
+    std::atomic<uint64_t> nof_central_refills{0};
+    std::atomic<uint64_t> nof_central_returns{0};
+    std::atomic<uint64_t> nof_failed_allocs{0};
 
-    worker_ctxt() : id(std::this_thread::get_id()) {}
+    worker_ctxt() : id(std::this_thread::get_id())
+    {
+      pool_type*                  pool = pool_type::get_instance();
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      pool->workers.push_back(this);
+    }
     ~worker_ctxt()
     {
-      concurrent_free_memblock_list& central_cache = pool_type::get_instance()->central_mem_cache;
-      central_cache.steal_blocks(cache, cache.size());
+      pool_type* pool = pool_type::get_instance();
+      while (not cache.empty()) {
+        pool->central_mem_cache.push(cache, batch_steal_size);
+      }
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      accumulate(pool->retired_metrics);
+      pool->workers.erase(std::find(pool->workers.begin(), pool->workers.end(), this));
+    }
+
+    void accumulate(fixed_memory_pool_metrics_t& m) const
+    {
+      m.max_local_cache_size = std::max(m.max_local_cache_size, max_cache_size.load(std::memory_order_relaxed));
+      m.nof_allocs += nof_allocs.load(std::memory_order_relaxed);
+      m.nof_central_refills += nof_central_refills.load(std::memory_order_relaxed);
+      m.nof_central_returns += nof_central_returns.load(std::memory_order_relaxed);
+      m.nof_failed_allocs += nof_failed_allocs.load(std::memory_order_relaxed);
     }
   };
 
+  /// Counters are only written by their owner thread, so a relaxed load+store is enough and avoids a locked RMW.
+  template <typename T>
+  static void increment(std::atomic<T>& counter)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
   worker_ctxt* get_worker_cache()
   {
     thread_local worker_ctxt worker_cache;
@@ -195,12 +258,17 @@ private:
     }
   }
 
-  size_t                local_growth_thres = 0;
-  srslog::basic_logger* logger             = nullptr;
+  const size_t                     nof_blocks;
+  std::unique_ptr<obj_storage_t[]> arena;
+  size_t                           local_growth_thres = 0;
+  srslog::basic_logger*            logger             = nullptr;
+
+  concurrent_memblock_batch_stack central_mem_cache;
 
-  concurrent_free_memblock_list                central_mem_cache;
-  std::mutex                                   mutex;
-  std::vector<std::unique_ptr<obj_storage_t> > allocated_blocks;
+  // protects the registry of worker contexts
+  std::mutex                  mutex;
+  std::vector<worker_ctxt*>   workers;
+  fixed_memory_pool_metrics_t retired_metrics;
 };
 
 } // namespace srsran
@@ -23,6 +23,8 @@
 #define SRSRAN_MEMBLOCK_CACHE_H
 
 #include "pool_utils.h"
+#include <atomic>
+#include <limits>
 #include <mutex>
 
 namespace srsran {
@@ -71,6 +73,34 @@ public:
     head  = nullptr;
     count = 0;
   }
+
+  /// Detaches up to \c n blocks from the front of the list. Returns the number of detached blocks, and the first and
+  /// last nodes of the detached chain via \c first and \c last.
+  size_t detach_front(size_t n, node*& first, node*& last) noexcept
+  {
+    first = last = nullptr;
+    if (n == 0 or empty()) {
+      return 0;
+    }
+    size_t nof_detached = 1;
+    first = last = head;
+    for (; nof_detached < n and last->next != nullptr; ++nof_detached) {
+      last = last->next;
+    }
+    head       = last->next;
+    last->next = nullptr;
+    count -= nof_detached;
+    return nof_detached;
+  }
+
+  /// Prepends a chain of \c n nodes, starting in \c first and ending in \c last, to the list.
+  void attach_front(node* first, node* last, size_t n) noexcept
+  {
+    srsran_assert(first != nullptr and last != nullptr, "Invalid memory block chain");
+    last->next = head;
+    head       = first;
+    count += n;
+  }
 };
 
 } // namespace detail
@@ -269,6 +299,114 @@ private:
   mutable std::mutex mutex;
 };
 
+/**
+ * Lock-free stack of batches of free memory blocks ("magazines"). Each push/pop moves a whole batch with a single CAS,
+ * so the cost of accessing the shared stack is amortized over several blocks.
+ * All blocks must belong to a contiguous arena of equally sized blocks. This allows the stack head to be encoded as
+ * a 32-bit block index plus a 32-bit generation tag, which protects the CAS against the ABA problem.
+ * The batch bookkeeping is stored in the first block of each batch, right after its intrusive list node.
+ * Note: A thread popping a batch may read the header of a block that another thread has concurrently popped. The
+ *       value read is discarded in that case, as the generation tag makes the CAS fail.
+ */
+class concurrent_memblock_batch_stack
+{
+  using node = detail::intrusive_memblock_list::node;
+
+  struct batch_header {
+    std::atomic<uint32_t> next{null_index};
+    uint32_t              count = 0;
+    node*                 last  = nullptr;
+  };
+
+  constexpr static uint32_t null_index    = std::numeric_limits<uint32_t>::max();
+  constexpr static size_t   header_offset = align_next(sizeof(node), alignof(batch_header));
+
+public:
+  concurrent_memblock_batch_stack(void* arena_, size_t block_size_, size_t nof_blocks_) :
+    arena(static_cast<uint8_t*>(arena_)), block_size(block_size_), nof_blocks(nof_blocks_)
+  {
+    srsran_assert(block_size >= header_offset + sizeof(batch_header), "Memory block is too small to store a batch");
+    srsran_assert(nof_blocks < null_index, "Number of memory blocks exceeds the maximum supported");
+  }
+  concurrent_memblock_batch_stack(const concurrent_memblock_batch_stack&) = delete;
+  concurrent_memblock_batch_stack& operator=(const concurrent_memblock_batch_stack&) = delete;
+
+  /// Moves up to \c n blocks from the front of \c src to the stack, as a single batch.
+  void push(free_memblock_list& src, size_t n) noexcept
+  {
+    node*  first        = nullptr;
+    node*  last         = nullptr;
+    size_t nof_detached = src.detach_front(n, first, last);
+    if (nof_detached == 0) {
+      return;
+    }
+    srsran_assert(owns(first), "Memory block does not belong to the arena");
+    batch_header* hdr = new (get_header(first)) batch_header();
+    hdr->count        = nof_detached;
+    hdr->last         = last;
+
+    uint32_t idx      = index_of(first);
+    uint64_t old_head = head.load(std::memory_order_relaxed);
+    do {
+      hdr->next.store(get_index(old_head), std::memory_order_relaxed);
+    } while (not head.compare_exchange_weak(
+        old_head, make_head(idx, get_tag(old_head) + 1), std::memory_order_release, std::memory_order_relaxed));
+    nof_free.fetch_add(nof_detached, std::memory_order_relaxed);
+  }
+
+  /// Pops a batch of blocks from the stack and prepends it to \c dst. Returns the number of blocks moved.
+  size_t try_pop(free_memblock_list& dst) noexcept
+  {
+    uint64_t      old_head = head.load(std::memory_order_acquire);
+    batch_header* hdr      = nullptr;
+    uint32_t      idx      = null_index;
+    uint64_t      new_head = 0;
+    do {
+      idx = get_index(old_head);
+      if (idx == null_index) {
+        return 0;
+      }
+      hdr      = get_header(block_at(idx));
+      new_head = make_head(hdr->next.load(std::memory_order_relaxed), get_tag(old_head) + 1);
+    } while (not head.compare_exchange_weak(old_head, new_head, std::memory_order_acquire, std::memory_order_acquire));
+
+    size_t n    = hdr->count;
+    node*  last = hdr->last;
+    hdr->~batch_header();
+    nof_free.fetch_sub(n, std::memory_order_relaxed);
+    dst.attach_front(static_cast<node*>(block_at(idx)), last, n);
+    return n;
+  }
+
+  /// Number of blocks currently stored in the stack. The value may be outdated in the presence of concurrent access.
+  size_t size() const noexcept { return nof_free.load(std::memory_order_relaxed); }
+  bool   empty() const noexcept { return get_index(head.load(std::memory_order_relaxed)) == null_index; }
+
+  bool owns(void* block) const noexcept
+  {
+    auto* ptr = static_cast<uint8_t*>(block);
+    return ptr >= arena and ptr < arena + block_size * nof_blocks and (ptr - arena) % block_size == 0;
+  }
+
+private:
+  static uint64_t make_head(uint32_t idx, uint32_t tag) { return (static_cast<uint64_t>(tag) << 32U) | idx; }
+  static uint32_t get_index(uint64_t h) { return static_cast<uint32_t>(h & 0xffffffffU); }
+  static uint32_t get_tag(uint64_t h) { return static_cast<uint32_t>(h >> 32U); }
+
+  uint32_t index_of(void* block) const { return (static_cast<uint8_t*>(block) - arena) / block_size; }
+  void*    block_at(uint32_t idx) const { return static_cast<void*>(arena + idx * block_size); }
+  static batch_header* get_header(void* block)
+  {
+    return reinterpret_cast<batch_header*>(static_cast<uint8_t*>(block) + header_offset);
+  }
+
+  uint8_t* const        arena;
+  const size_t          block_size;
+  const size_t          nof_blocks;
+  std::atomic<uint64_t> head{make_head(null_index, 0)};
+  std::atomic<size_t>   nof_free{0};
+};
+
 /**
  * Manages the allocation, caching and deallocation of memory blocks.
  * On alloc, a memory block is stolen from cache. If cache is empty, malloc/new is called.
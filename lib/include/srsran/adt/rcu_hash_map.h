@@ -0,0 +1,281 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RCU_HASH_MAP_H
+#define SRSRAN_RCU_HASH_MAP_H
+
+#include "srsran/support/srsran_assert.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace srsran {
+
+/**
+ * Epoch-based reclamation domain for data structures with one writer and a fixed set of lock-free readers.
+ * Readers call online() before accessing shared objects and offline() once they no longer hold references to them,
+ * typically around the processing of a batch of events. The writer unpublishes objects and hands them to retire();
+ * they are deleted once every reader has gone offline or come back online since.
+ */
+class rcu_domain
+{
+public:
+  explicit rcu_domain(uint32_t nof_readers) : readers(new reader_state[nof_readers]), nof_readers(nof_readers) {}
+  rcu_domain(const rcu_domain&) = delete;
+  rcu_domain& operator=(const rcu_domain&) = delete;
+  ~rcu_domain()
+  {
+    for (retired_obj& obj : retired) {
+      obj.deleter(obj.ptr);
+    }
+  }
+
+  uint32_t size() const { return nof_readers; }
+
+  /// Reader side. Objects reachable from published pointers remain valid until offline() is called
+  void online(uint32_t reader_id) { readers[reader_id].epoch.store(global_epoch.load()); }
+  void offline(uint32_t reader_id) { readers[reader_id].epoch.store(offline_epoch); }
+
+  /// Writer side. Deletes obj once no reader can hold a reference to it
+  template <typename T>
+  void retire(T* obj)
+  {
+    retired.push_back({global_epoch.fetch_add(1) + 1, obj, [](void* p) { delete static_cast<T*>(p); }});
+    reclaim();
+  }
+
+  /// Writer side. Deletes the retired objects that are no longer visible to any reader
+  void reclaim()
+  {
+    uint64_t min_epoch = offline_epoch;
+    for (uint32_t i = 0; i < nof_readers; ++i) {
+      min_epoch = std::min(min_epoch, readers[i].epoch.load());
+    }
+    size_t nof_kept = 0;
+    for (retired_obj& obj : retired) {
+      if (obj.epoch <= min_epoch) {
+        obj.deleter(obj.ptr);
+      } else {
+        retired[nof_kept++] = obj;
+      }
+    }
+    retired.resize(nof_kept);
+  }
+
+  size_t nof_pending_reclaims() const { return retired.size(); }
+
+private:
+  static constexpr uint64_t offline_epoch = std::numeric_limits<uint64_t>::max();
+
+  // Padded to avoid false sharing between readers
+  struct reader_state {
+    std::atomic<uint64_t> epoch{offline_epoch};
+    char                  padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+  struct retired_obj {
+    uint64_t epoch;
+    void*    ptr;
+    void (*deleter)(void*);
+  };
+
+  std::atomic<uint64_t>           global_epoch{1};
+  std::unique_ptr<reader_state[]> readers;
+  uint32_t                        nof_readers;
+  std::vector<retired_obj>        retired;
+};
+
+/**
+ * Open-addressing hash map with linear probing, supporting lock-free lookups concurrent with a single writer.
+ * Each slot points to an immutable key/value node. The writer replaces or erases entries by swapping the slot pointer
+ * and grows the table by publishing a new slot array. Replaced nodes and arrays are reclaimed through an rcu_domain.
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V, typename Hash = std::hash<K> >
+class rcu_hash_map
+{
+  struct node {
+    K key;
+    V value;
+  };
+  struct table {
+    explicit table(uint32_t capacity) : mask(capacity - 1), slots(new std::atomic<node*>[capacity])
+    {
+      for (uint32_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+    uint32_t                              mask;
+    std::unique_ptr<std::atomic<node*>[]> slots;
+  };
+
+public:
+  using key_type    = K;
+  using mapped_type = V;
+
+  explicit rcu_hash_map(rcu_domain& rcu_, uint32_t initial_capacity = 64) :
+    rcu(rcu_), min_capacity(round_pow2(initial_capacity)), tbl(new table(min_capacity))
+  {}
+  rcu_hash_map(const rcu_hash_map&) = delete;
+  rcu_hash_map& operator=(const rcu_hash_map&) = delete;
+  ~rcu_hash_map()
+  {
+    table* t = tbl.load();
+    for (uint32_t i = 0; i <= t->mask; ++i) {
+      node* n = t->slots[i].load();
+      if (n != nullptr and n != tombstone()) {
+        delete n;
+      }
+    }
+    delete t;
+  }
+
+  /// Reader side. The returned value remains valid until the reader goes offline in the rcu_domain
+  const V* find(const K& key) const
+  {
+    const table* t   = tbl.load();
+    uint32_t     idx = slot_of(key, *t);
+    for (;; idx = (idx + 1) & t->mask) {
+      node* n = t->slots[idx].load();
+      if (n == nullptr) {
+        return nullptr;
+      }
+      if (n != tombstone() and n->key == key) {
+        return &n->value;
+      }
+    }
+  }
+
+  /// Writer side. Inserts key or replaces its value
+  void insert_or_assign(const K& key, const V& value)
+  {
+    if (nof_used + 1 > (tbl.load()->mask + 1) / 2) {
+      rehash();
+    }
+    table*   t        = tbl.load();
+    node*    new_node = new node{key, value};
+    uint32_t free_idx = t->mask + 1;
+    uint32_t idx      = slot_of(key, *t);
+    for (;; idx = (idx + 1) & t->mask) {
+      node* n = t->slots[idx].load();
+      if (n == nullptr) {
+        break;
+      }
+      if (n == tombstone()) {
+        free_idx = std::min(free_idx, idx);
+      } else if (n->key == key) {
+        t->slots[idx].store(new_node);
+        rcu.retire(n);
+        return;
+      }
+    }
+    if (free_idx > t->mask) {
+      // Claim the empty slot that terminates the probe sequence
+      free_idx = idx;
+      nof_used++;
+    }
+    t->slots[free_idx].store(new_node);
+    nof_entries++;
+  }
+
+  /// Writer side. Returns false if the key was not present
+  bool erase(const K& key)
+  {
+    table*   t   = tbl.load();
+    uint32_t idx = slot_of(key, *t);
+    for (;; idx = (idx + 1) & t->mask) {
+      node* n = t->slots[idx].load();
+      if (n == nullptr) {
+        return false;
+      }
+      if (n != tombstone() and n->key == key) {
+        // Tombstones keep the probe sequences of other keys intact. They are dropped on the next rehash
+        t->slots[idx].store(tombstone());
+        rcu.retire(n);
+        nof_entries--;
+        return true;
+      }
+    }
+  }
+
+  size_t size() const { return nof_entries; }
+  bool   empty() const { return nof_entries == 0; }
+  size_t capacity() const { return tbl.load()->mask + 1; }
+
+private:
+  /// Marks erased slots. Its address is only compared against, never dereferenced
+  static node* tombstone()
+  {
+    static typename std::aligned_storage<sizeof(node), alignof(node)>::type tomb;
+    return reinterpret_cast<node*>(&tomb);
+  }
+  /// Fibonacci hashing spreads keys whose std::hash is the identity, such as IPv4 addresses, over the whole table
+  uint32_t slot_of(const K& key, const table& t) const
+  {
+    return ((uint64_t)hasher(key) * 0x9e3779b97f4a7c15ULL >> 32) & t.mask;
+  }
+  static uint32_t round_pow2(uint32_t n)
+  {
+    uint32_t cap = 8;
+    while (cap < n) {
+      cap *= 2;
+    }
+    return cap;
+  }
+
+  /// Publishes a new slot array sized for the live entries, dropping all tombstones. Nodes are shared between arrays
+  void rehash()
+  {
+    table*   old_t = tbl.load();
+    uint32_t cap   = std::max(min_capacity, round_pow2(4 * (nof_entries + 1)));
+    auto*    new_t = new table(cap);
+    for (uint32_t i = 0; i <= old_t->mask; ++i) {
+      node* n = old_t->slots[i].load(std::memory_order_relaxed);
+      if (n == nullptr or n == tombstone()) {
+        continue;
+      }
+      uint32_t idx = slot_of(n->key, *new_t);
+      while (new_t->slots[idx].load(std::memory_order_relaxed) != nullptr) {
+        idx = (idx + 1) & new_t->mask;
+      }
+      new_t->slots[idx].store(n, std::memory_order_relaxed);
+    }
+    tbl.store(new_t);
+    rcu.retire(old_t);
+    nof_used = nof_entries;
+  }
+
+  rcu_domain&         rcu;
+  Hash                hasher;
+  uint32_t            min_capacity;
+  std::atomic<table*> tbl;
+  size_t              nof_entries = 0;
+  size_t              nof_used    = 0; ///< live entries plus tombstones
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RCU_HASH_MAP_H
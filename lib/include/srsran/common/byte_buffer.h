@@ -24,6 +24,7 @@
 
 #include "common.h"
 #include "srsran/adt/span.h"
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 
@@ -104,6 +105,9 @@ public:
     buffer_latency_calc tp;
   } md;
 
+  /// Number of shared_byte_buffer_t handles owning this buffer. It is not copied with the buffer contents
+  std::atomic<uint32_t> shared_count{0};
+
   byte_buffer_t() : msg(&buffer[SRSRAN_BUFFER_HEADER_OFFSET])
   {
 #ifdef SRSRAN_BUFFER_POOL_LOG_ENABLED
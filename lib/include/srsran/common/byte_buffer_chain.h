@@ -0,0 +1,142 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_BYTE_BUFFER_CHAIN_H
+#define SRSRAN_BYTE_BUFFER_CHAIN_H
+
+#include "srsran/common/byte_buffer.h"
+
+namespace srsran {
+
+/// Size classes of the memory blocks used to store byte_buffer_chain segments. Jumbo blocks are the ones of the global
+/// byte_buffer_pool, and are only used when a chain is linearized back into a byte_buffer_t.
+enum class byte_buffer_size_class { small, medium, jumbo };
+
+/// Memory block size of each byte_buffer_chain segment size class.
+constexpr size_t byte_buffer_small_block_size  = 512;
+constexpr size_t byte_buffer_medium_block_size = 2048;
+
+/// Headroom reserved in the first segment of a byte_buffer_chain, to prepend protocol headers without copies.
+constexpr uint32_t byte_buffer_chain_headroom = 32;
+
+namespace detail {
+
+/// Segment of a byte_buffer_chain. The payload is stored in the same memory block, right after the segment header.
+struct byte_buffer_segment {
+  byte_buffer_segment*   next     = nullptr;
+  byte_buffer_size_class cls      = byte_buffer_size_class::small;
+  uint32_t               capacity = 0;
+  uint32_t               offset   = 0;
+  uint32_t               length   = 0;
+
+  uint8_t*       data() { return reinterpret_cast<uint8_t*>(this + 1) + offset; }
+  const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(this + 1) + offset; }
+  uint32_t       get_headroom() const { return offset; }
+  uint32_t       get_tailroom() const { return capacity - offset - length; }
+};
+
+} // namespace detail
+
+/******************************************************************************
+ * Byte buffer chain
+ *
+ * Variable-size byte buffer made of a chain of segments, which are allocated from
+ * size-classed pools. Small payloads (e.g. TCP ACKs) fit in a single small block,
+ * while large payloads are stored in a chain of medium blocks, so that the memory
+ * used per buffer is proportional to its length, rather than to the maximum TB size.
+ * Only the first segment has headroom, which is reserved to prepend headers.
+ * The chain has unique ownership of its segments, similarly to unique_byte_buffer_t.
+ *****************************************************************************/
+class byte_buffer_chain
+{
+  using segment = detail::byte_buffer_segment;
+
+public:
+  byte_buffer_t::buffer_metadata_t md;
+
+  byte_buffer_chain() = default;
+  byte_buffer_chain(const byte_buffer_chain&) = delete;
+  byte_buffer_chain(byte_buffer_chain&& other) noexcept;
+  byte_buffer_chain& operator=(const byte_buffer_chain&) = delete;
+  byte_buffer_chain& operator=(byte_buffer_chain&& other) noexcept;
+  ~byte_buffer_chain() { clear(); }
+
+  /// Checks whether the chain holds any segment, even if it is empty.
+  bool     has_value() const { return head != nullptr; }
+  bool     empty() const { return nof_bytes == 0; }
+  uint32_t length() const { return nof_bytes; }
+  size_t   nof_segments() const;
+  uint32_t get_headroom() const { return head != nullptr ? head->get_headroom() : 0; }
+
+  /// Allocates the first segment, with the given headroom. Returns false if the segment pools are depleted.
+  bool reserve_headroom(uint32_t headroom = byte_buffer_chain_headroom);
+
+  /// Appends bytes to the tail of the chain, allocating new segments as needed.
+  /// Returns false if the segment pools are depleted, in which case the chain is left unmodified.
+  bool append(const uint8_t* bytes, uint32_t len);
+  bool append(const_byte_span bytes) { return append(bytes.data(), bytes.size()); }
+
+  /// Prepends bytes using the headroom of the first segment. Returns false if there is not enough headroom.
+  bool prepend(const uint8_t* bytes, uint32_t len);
+
+  /// Removes bytes from the head of the chain, releasing the segments that become empty.
+  void trim_head(uint32_t len);
+
+  /// Releases all the segments of the chain.
+  void clear();
+
+  /// Copies the contents of the chain to a contiguous memory region. Returns the number of bytes copied.
+  uint32_t copy_to(uint8_t* dst, uint32_t max_len) const;
+
+  /// Calls f(const_byte_span) for each non-empty segment of the chain.
+  template <typename F>
+  void for_each_segment(F&& f) const
+  {
+    for (const segment* seg = head; seg != nullptr; seg = seg->next) {
+      if (seg->length > 0) {
+        f(const_byte_span{seg->data(), seg->length});
+      }
+    }
+  }
+
+  std::chrono::microseconds                      get_latency_us() const { return md.tp.get_latency_us(); }
+  std::chrono::high_resolution_clock::time_point get_timestamp() const { return md.tp.get_timestamp(); }
+  void                                           set_timestamp() { md.tp.set_timestamp(); }
+
+private:
+  static segment* allocate_segment(uint32_t min_len);
+  static void     deallocate_segment(segment* seg);
+
+  segment* head      = nullptr;
+  segment* tail      = nullptr;
+  uint32_t nof_bytes = 0;
+};
+
+/// Creates a byte_buffer_chain with a copy of the payload and metadata of a byte buffer.
+/// On pool depletion, the returned chain has no value.
+byte_buffer_chain make_byte_buffer_chain(const byte_buffer_t& buf) noexcept;
+
+/// Linearizes the contents and metadata of a byte_buffer_chain into a newly allocated byte buffer.
+unique_byte_buffer_t make_byte_buffer(const byte_buffer_chain& chain) noexcept;
+
+} // namespace srsran
+
+#endif // SRSRAN_BYTE_BUFFER_CHAIN_H
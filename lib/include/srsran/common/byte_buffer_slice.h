@@ -0,0 +1,185 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_BYTE_BUFFER_SLICE_H
+#define SRSRAN_BYTE_BUFFER_SLICE_H
+
+#include "srsran/common/byte_buffer.h"
+#include "srsran/support/srsran_assert.h"
+#include <vector>
+
+namespace srsran {
+
+/******************************************************************************
+ * Shared byte buffer
+ *
+ * Byte buffer with shared ownership, whose payload can be referenced by several
+ * byte_buffer_slice objects. The buffer is taken from a pool-backed
+ * unique_byte_buffer_t and the reference count is kept in the buffer itself,
+ * so sharing it does not allocate. The buffer returns to the pool when the
+ * last handle is released.
+ *****************************************************************************/
+class shared_byte_buffer_t
+{
+public:
+  shared_byte_buffer_t() = default;
+  shared_byte_buffer_t(std::nullptr_t) {}
+  shared_byte_buffer_t(unique_byte_buffer_t buf_) : buf(buf_.release())
+  {
+    if (buf != nullptr) {
+      buf->shared_count.store(1, std::memory_order_relaxed);
+    }
+  }
+  shared_byte_buffer_t(const shared_byte_buffer_t& other) : buf(other.buf)
+  {
+    if (buf != nullptr) {
+      buf->shared_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  shared_byte_buffer_t(shared_byte_buffer_t&& other) noexcept : buf(other.buf) { other.buf = nullptr; }
+  shared_byte_buffer_t& operator=(const shared_byte_buffer_t& other)
+  {
+    shared_byte_buffer_t tmp(other);
+    std::swap(buf, tmp.buf);
+    return *this;
+  }
+  shared_byte_buffer_t& operator=(shared_byte_buffer_t&& other) noexcept
+  {
+    std::swap(buf, other.buf);
+    return *this;
+  }
+  ~shared_byte_buffer_t() { reset(); }
+
+  void reset()
+  {
+    if (buf != nullptr and buf->shared_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // operator delete of byte_buffer_t returns the buffer to the pool
+      delete buf;
+    }
+    buf = nullptr;
+  }
+
+  byte_buffer_t* get() const { return buf; }
+  byte_buffer_t* operator->() const { return buf; }
+  byte_buffer_t& operator*() const { return *buf; }
+  explicit       operator bool() const { return buf != nullptr; }
+  uint32_t       use_count() const { return buf != nullptr ? buf->shared_count.load(std::memory_order_relaxed) : 0; }
+
+  bool operator==(std::nullptr_t) const { return buf == nullptr; }
+  bool operator!=(std::nullptr_t) const { return buf != nullptr; }
+
+private:
+  byte_buffer_t* buf = nullptr;
+};
+
+/******************************************************************************
+ * Byte buffer slice
+ *
+ * Read-only view over a contiguous range of bytes of a byte buffer. The slice
+ * shares the ownership of the buffer, so the bytes remain valid as long as the
+ * slice exists, even if the msg/N_bytes of the original buffer are modified.
+ *****************************************************************************/
+class byte_buffer_slice
+{
+public:
+  byte_buffer_slice() = default;
+  byte_buffer_slice(shared_byte_buffer_t buf_, const uint8_t* ptr_, uint32_t len_) :
+    buf(std::move(buf_)), ptr(ptr_), len(len_)
+  {
+    srsran_assert(buf != nullptr and ptr >= buf->buffer and ptr + len <= buf->buffer + sizeof(buf->buffer),
+                  "Slice exceeds the byte buffer bounds");
+  }
+  /// Creates a slice with the current payload of the byte buffer.
+  explicit byte_buffer_slice(shared_byte_buffer_t buf_) : byte_buffer_slice(buf_, buf_->msg, buf_->N_bytes) {}
+
+  const uint8_t*  data() const { return ptr; }
+  uint32_t        size() const { return len; }
+  bool            empty() const { return len == 0; }
+  const uint8_t*  begin() const { return ptr; }
+  const uint8_t*  end() const { return ptr + len; }
+  const_byte_span view() const { return const_byte_span{ptr, len}; }
+
+  /// Creates a slice over a sub-range of this slice, which shares the ownership of the same byte buffer.
+  byte_buffer_slice make_slice(uint32_t offset, uint32_t length) const
+  {
+    srsran_assert(offset + length <= len, "Sub-slice exceeds the slice bounds");
+    return byte_buffer_slice{buf, ptr + offset, length};
+  }
+
+private:
+  shared_byte_buffer_t buf;
+  const uint8_t*       ptr = nullptr;
+  uint32_t             len = 0;
+};
+
+/// Ordered sequence of byte buffer slices, which represents a payload scattered across several byte buffers.
+class byte_buffer_slice_chain
+{
+public:
+  using const_iterator = std::vector<byte_buffer_slice>::const_iterator;
+
+  void push_back(byte_buffer_slice slice)
+  {
+    nof_bytes += slice.size();
+    slices.push_back(std::move(slice));
+  }
+  void clear()
+  {
+    slices.clear();
+    nof_bytes = 0;
+  }
+
+  uint32_t       length() const { return nof_bytes; }
+  bool           empty() const { return slices.empty(); }
+  size_t         nof_slices() const { return slices.size(); }
+  const_iterator begin() const { return slices.begin(); }
+  const_iterator end() const { return slices.end(); }
+
+  /// Copies "len" bytes of the payload, starting at "offset", into a contiguous buffer. Returns the number of bytes
+  /// copied.
+  uint32_t copy_to(uint8_t* dst, uint32_t offset, uint32_t len) const
+  {
+    uint32_t n = 0;
+    for (const byte_buffer_slice& s : slices) {
+      if (n == len) {
+        break;
+      }
+      if (offset >= s.size()) {
+        offset -= s.size();
+        continue;
+      }
+      uint32_t to_copy = std::min(s.size() - offset, len - n);
+      memcpy(dst + n, s.data() + offset, to_copy);
+      n += to_copy;
+      offset = 0;
+    }
+    return n;
+  }
+  uint32_t copy_to(uint8_t* dst) const { return copy_to(dst, 0, nof_bytes); }
+
+private:
+  std::vector<byte_buffer_slice> slices;
+  uint32_t                       nof_bytes = 0;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_BYTE_BUFFER_SLICE_H
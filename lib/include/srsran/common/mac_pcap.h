@@ -24,6 +24,7 @@
 
 #include "srsran/common/common.h"
 #include "srsran/common/mac_pcap_base.h"
+#include "srsran/common/pcap_writer.h"
 #include "srsran/srsran.h"
 
 namespace srsran {
@@ -33,14 +34,19 @@ public:
   mac_pcap();
   ~mac_pcap();
   uint32_t open(std::string filename, uint32_t ue_id = 0);
+  uint32_t open(std::string filename, uint32_t ue_id, const pcap_writer::args_t& writer_args);
   uint32_t close();
 
+  uint64_t nof_dropped() const { return writer.nof_dropped(); }
+
+  /// Writes the captured history of a pcap in triggered mode, e.g. upon a radio link failure.
+  void trigger() { writer.trigger(); }
+
 private:
-  void write_pdu(srsran::mac_pcap_base::pcap_pdu_t& pdu);
+  void queue_pdu(srsran::mac_pcap_base::pcap_pdu_t& pdu, const uint8_t* payload, uint32_t payload_len) override;
 
-  FILE*       pcap_file = nullptr;
-  uint32_t    dlt       = 0; // The DLT used for the PCAP file
-  std::string filename;
+  pcap_writer writer;
+  uint32_t    dlt = 0; // The DLT used for the PCAP file
 };
 } // namespace srsran
 
@@ -26,6 +26,7 @@
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/common.h"
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_filter.h"
 #include "srsran/common/threads.h"
 #include "srsran/srslog/srslog.h"
 #include <mutex>
@@ -49,6 +50,9 @@ public:
 
   void set_ue_id(uint16_t ue_id);
 
+  /// Filters the PDUs by RNTI before they are copied. Must be called before the pcap is opened.
+  void set_filter(const pcap_filter& filter_) { filter = filter_; }
+
   // EUTRA
   void
   write_ul_crnti(uint8_t* pdu, uint32_t pdu_len_bytes, uint16_t crnti, uint32_t reTX, uint32_t tti, uint8_t cc_idx);
@@ -105,7 +109,10 @@ protected:
     unique_byte_buffer_t  pdu;
   } pcap_pdu_t;
 
-  virtual void write_pdu(pcap_pdu_t& pdu) = 0;
+  /// Hands a packed PDU over to the writer. Called from the PHY/stack threads, so it must not block. By default the
+  /// payload is copied into a byte buffer and queued for the thread of this class, which calls write_pdu().
+  virtual void queue_pdu(pcap_pdu_t& pdu, const uint8_t* payload, uint32_t payload_len);
+  virtual void write_pdu(pcap_pdu_t& pdu) {}
   void         run_thread() final;
 
   std::mutex                              mutex;
@@ -114,6 +121,7 @@ protected:
   static_blocking_queue<pcap_pdu_t, 1024> queue;
   uint16_t                                ue_id                = 0;
   int                                     emergency_handler_id = -1;
+  pcap_filter                             filter;
 
 private:
   void pack_and_queue(uint8_t* payload,
@@ -22,24 +22,29 @@
 /******************************************************************************
  *  File:         multiqueue.h
  *  Description:  General-purpose non-blocking multiqueue. It behaves as a list
- *                of bounded/unbounded queues.
+ *                of bounded queues. Each queue is a lock-free bounded MPSC ring,
+ *                so producers and consumer only contend on the ring cells.
  *****************************************************************************/
 
 #ifndef SRSRAN_MULTIQUEUE_H
 #define SRSRAN_MULTIQUEUE_H
 
 #include "srsran/adt/circular_buffer.h"
+#include "srsran/adt/detail/type_storage.h"
 #include "srsran/adt/move_callback.h"
+#include "srsran/support/srsran_assert.h"
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <vector>
+#include <thread>
 
 namespace srsran {
 
 #define MULTIQUEUE_DEFAULT_CAPACITY (8192) // Default per-queue capacity
+#define MULTIQUEUE_MAX_NOF_QUEUES (64)     // Maximum number of queues that can be created in a multiqueue
 
 /**
  * N-to-1 Message-Passing Broker that manages the creation, destruction of input ports, and popping of messages that
@@ -48,6 +53,8 @@ namespace srsran {
  * The class will pop from the several created ports in a round-robin fashion.
  * The popping() interface is not safe-thread. That means, that it is expected that only one thread will
  * be popping tasks.
+ * Pushing and popping are lock-free, as long as the queue is not full and the consumer is not sleeping. A sleeping
+ * consumer is woken up via a condition variable, which is futex-based in Linux.
  * @tparam myobj message type
  */
 template <typename myobj>
@@ -55,40 +62,70 @@ class multiqueue_handler
 {
   class input_port_impl
   {
+    /// Ring cell. The sequence number tells whether the cell is free (seq == pos) or has been written (seq == pos + 1)
+    /// for the ring position "pos" that maps to it.
+    struct cell_t {
+      std::atomic<size_t>         seq;
+      detail::type_storage<myobj> storage;
+    };
+
+    /// Flag set in the enqueue position to signal that the queue has been deactivated.
+    static const size_t closed_flag = size_t{1} << (sizeof(size_t) * 8 - 1);
+
+    enum class push_result { success, full, closed };
+
   public:
-    input_port_impl(uint32_t cap, multiqueue_handler<myobj>* parent_) : buffer(cap), parent(parent_) {}
+    input_port_impl(uint32_t cap, multiqueue_handler<myobj>* parent_) :
+      parent(parent_), cap_(cap), cells(new cell_t[cap])
+    {
+      srsran_assert(cap > 0, "Invalid queue capacity");
+      for (size_t i = 0; i < cap_; ++i) {
+        cells[i].seq.store(i, std::memory_order_relaxed);
+      }
+    }
     input_port_impl(const input_port_impl&) = delete;
     input_port_impl(input_port_impl&&)      = delete;
     input_port_impl& operator=(const input_port_impl&) = delete;
     input_port_impl& operator=(input_port_impl&&) = delete;
     ~input_port_impl() { deactivate_blocking(); }
 
-    size_t capacity() const { return buffer.max_size(); }
+    size_t capacity() const { return cap_; }
     size_t size() const
     {
-      std::lock_guard<std::mutex> lock(q_mutex);
-      return buffer.size();
-    }
-    bool active() const
-    {
-      std::lock_guard<std::mutex> lock(q_mutex);
-      return active_;
+      size_t deq_pos = dequeue_pos.load(std::memory_order_acquire);
+      size_t enq_pos = enqueue_pos.load(std::memory_order_acquire) & ~closed_flag;
+      return enq_pos > deq_pos ? std::min(enq_pos - deq_pos, cap_) : 0;
     }
+    bool active() const { return (enqueue_pos.load(std::memory_order_acquire) & closed_flag) == 0; }
     void set_active(bool val)
     {
-      std::unique_lock<std::mutex> lock(q_mutex);
-      if (val == active_) {
-        // no-op
+      if (val) {
+        enqueue_pos.fetch_and(~closed_flag, std::memory_order_acq_rel);
         return;
       }
-      active_ = val;
 
-      if (not active_) {
-        buffer.clear();
-        lock.unlock();
-        // unlock blocked pushing threads
-        cv_full.notify_all();
+      // Close the queue. Pushers that did not reserve a cell before this point will fail.
+      size_t last_pos = enqueue_pos.fetch_or(closed_flag, std::memory_order_acq_rel) & ~closed_flag;
+
+      // unlock blocked pushing threads
+      {
+        std::lock_guard<std::mutex> lock(q_mutex);
+      }
+      cv_full.notify_all();
+
+      // Discard the pending messages, including the ones still being written by the pushers that reserved a cell.
+      lock_consumer();
+      size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+      for (; pos < last_pos; ++pos) {
+        cell_t& c = cells[pos % cap_];
+        while (c.seq.load(std::memory_order_acquire) != pos + 1) {
+          std::this_thread::yield();
+        }
+        c.storage.destroy();
+        c.seq.store(pos + cap_, std::memory_order_release);
       }
+      dequeue_pos.store(pos, std::memory_order_release);
+      consumer_busy.store(false, std::memory_order_release);
     }
 
     void deactivate_blocking()
@@ -97,7 +134,7 @@ class multiqueue_handler
 
       // wait for all the pushers to unlock
       std::unique_lock<std::mutex> lock(q_mutex);
-      while (nof_waiting > 0) {
+      while (nof_waiting.load(std::memory_order_relaxed) > 0) {
         cv_exit.wait(lock);
       }
     }
@@ -105,80 +142,145 @@ class multiqueue_handler
     template <typename T>
     void push(T&& o) noexcept
     {
-      push_(&o, true);
+      push_blocking_(std::forward<T>(o));
     }
 
-    bool try_push(const myobj& o) { return push_(&o, false); }
+    bool try_push(const myobj& o) { return push_(o) == push_result::success; }
 
     srsran::error_type<myobj> try_push(myobj&& o)
     {
-      if (push_(&o, false)) {
+      if (push_(std::move(o)) == push_result::success) {
         return {};
       }
       return {std::move(o)};
     }
 
-    bool try_pop(myobj& obj)
+    /// Pops up to max_values messages from the queue. Should only be called from the consumer thread.
+    uint32_t try_pop(myobj* values, uint32_t max_values)
     {
-      std::unique_lock<std::mutex> lock(q_mutex);
-      return pop_(lock, obj);
+      // Fast check without RMW operations, as most of the ports are expected to be empty.
+      size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+      if (cells[pos % cap_].seq.load(std::memory_order_acquire) != pos + 1) {
+        return 0;
+      }
+      if (consumer_busy.exchange(true, std::memory_order_acquire)) {
+        // The queue is being deactivated by another thread.
+        return 0;
+      }
+      pos        = dequeue_pos.load(std::memory_order_relaxed);
+      uint32_t n = 0;
+      for (; n < max_values; ++n, ++pos) {
+        cell_t& c = cells[pos % cap_];
+        if (c.seq.load(std::memory_order_acquire) != pos + 1) {
+          break;
+        }
+        values[n] = std::move(c.storage.get());
+        c.storage.destroy();
+        c.seq.store(pos + cap_, std::memory_order_release);
+      }
+      dequeue_pos.store(pos, std::memory_order_release);
+      consumer_busy.store(false, std::memory_order_release);
+
+      if (n > 0) {
+        // Pairs with the fence of the blocked pushers, to avoid missed wake-ups.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (nof_waiting.load(std::memory_order_relaxed) > 0) {
+          {
+            std::lock_guard<std::mutex> lock(q_mutex);
+          }
+          cv_full.notify_all();
+        }
+      }
+      return n;
     }
 
-    bool try_pop(myobj& obj, bool& try_lock_success)
+  private:
+    void lock_consumer()
     {
-      std::unique_lock<std::mutex> lock(q_mutex, std::try_to_lock);
-      try_lock_success = lock.owns_lock();
-      return try_lock_success ? pop_(lock, obj) : false;
+      while (consumer_busy.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
     }
 
-  private:
+    /// Tries to reserve a cell in the ring, and writes the message into it. The message is only moved on success.
     template <typename T>
-    bool push_(T* o, bool blocking) noexcept
+    push_result try_push_(T&& o)
     {
-      std::unique_lock<std::mutex> lock(q_mutex);
-      if (not blocking) {
-        // non-blocking case
-        if (not active_ or buffer.full()) {
-          return false;
+      size_t  pos = enqueue_pos.load(std::memory_order_relaxed);
+      cell_t* c;
+      while (true) {
+        if ((pos & closed_flag) != 0) {
+          return push_result::closed;
         }
-      } else {
-        // blocking case
-        while (active_ and buffer.full()) {
-          nof_waiting++;
-          cv_full.wait(lock);
-          nof_waiting--;
-        }
-        if (not active_) {
-          lock.unlock();
-          cv_exit.notify_one();
-          return false;
+        c          = &cells[pos % cap_];
+        size_t seq = c->seq.load(std::memory_order_acquire);
+        auto   dif = static_cast<std::ptrdiff_t>(seq - pos);
+        if (dif == 0) {
+          if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (dif < 0) {
+          return push_result::full;
+        } else {
+          pos = enqueue_pos.load(std::memory_order_relaxed);
         }
       }
-      buffer.push(std::forward<T>(*o));
-      return true;
+      c->storage.emplace(std::forward<T>(o));
+      c->seq.store(pos + 1, std::memory_order_release);
+      return push_result::success;
+    }
+
+    template <typename T>
+    push_result push_(T&& o)
+    {
+      push_result ret = try_push_(std::forward<T>(o));
+      if (ret == push_result::success) {
+        parent->notify_consumer_();
+      }
+      return ret;
     }
 
-    bool pop_(std::unique_lock<std::mutex>& lock, myobj& obj)
+    template <typename T>
+    bool push_blocking_(T&& o)
     {
-      if (buffer.empty()) {
-        return false;
+      push_result ret = push_(std::forward<T>(o));
+      if (ret != push_result::full) {
+        return ret == push_result::success;
+      }
+
+      // slow path: wait for the consumer to free cells in the queue
+      std::unique_lock<std::mutex> lock(q_mutex);
+      nof_waiting.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while ((ret = try_push_(std::forward<T>(o))) == push_result::full) {
+        cv_full.wait(lock);
       }
-      obj = std::move(buffer.top());
-      buffer.pop();
-      if (nof_waiting > 0) {
-        lock.unlock();
-        cv_full.notify_one();
+      nof_waiting.fetch_sub(1, std::memory_order_relaxed);
+      lock.unlock();
+      if (ret == push_result::closed) {
+        cv_exit.notify_one();
+        return false;
       }
+      parent->notify_consumer_();
       return true;
     }
 
     multiqueue_handler<myobj>* parent = nullptr;
-
-    mutable std::mutex                 q_mutex;
-    srsran::dyn_circular_buffer<myobj> buffer;
-    std::condition_variable            cv_full, cv_exit;
-    bool                               active_     = true;
-    int                                nof_waiting = 0;
+    const size_t               cap_;
+    std::unique_ptr<cell_t[]>  cells;
+
+    // Producer and consumer positions are kept in separate cache lines to avoid false sharing.
+    char                pad0[64];
+    std::atomic<size_t> enqueue_pos{0};
+    char                pad1[64];
+    std::atomic<size_t> dequeue_pos{0};
+    std::atomic<bool>   consumer_busy{false};
+    char                pad2[64];
+
+    // Only used when pushers block on a full queue or on deactivation.
+    mutable std::mutex      q_mutex;
+    std::condition_variable cv_full, cv_exit;
+    std::atomic<int>        nof_waiting{0};
   };
 
 public:
@@ -229,17 +331,19 @@ public:
   void stop()
   {
     std::unique_lock<std::mutex> lock(mutex);
-    running = false;
-    for (auto& q : queues) {
+    running.store(false, std::memory_order_relaxed);
+    uint32_t nof_ports = nof_ports_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < nof_ports; ++i) {
       // signal deactivation to pushing threads in a non-blocking way
-      q.set_active(false);
+      ports[i]->set_active(false);
     }
+    cv_pop.notify_all();
     while (consumer_state) {
       cv_exit.wait(lock);
     }
-    for (auto& q : queues) {
+    for (uint32_t i = 0; i < nof_ports; ++i) {
       // ensure the queues are finished being deactivated
-      q.deactivate_blocking();
+      ports[i]->deactivate_blocking();
     }
   }
 
@@ -252,22 +356,24 @@ public:
   {
     uint32_t                    qidx = 0;
     std::lock_guard<std::mutex> lock(mutex);
-    if (not running) {
+    if (not running.load(std::memory_order_relaxed)) {
       return queue_handle();
     }
-    while (qidx < queues.size() and (queues[qidx].active() or (queues[qidx].capacity() != capacity_))) {
+    uint32_t nof_ports = nof_ports_.load(std::memory_order_relaxed);
+    while (qidx < nof_ports and (ports[qidx]->active() or (ports[qidx]->capacity() != capacity_))) {
       ++qidx;
     }
 
     // check if there is a free queue of the required size
-    if (qidx == queues.size()) {
-      // create new queue
-      queues.emplace_back(capacity_, this);
-      qidx = queues.size() - 1; // update qidx to the last element
+    if (qidx == nof_ports) {
+      // create new queue. The consumer only sees it once the number of ports is updated.
+      srsran_assert(nof_ports < MULTIQUEUE_MAX_NOF_QUEUES, "Maximum number of queues reached");
+      ports[qidx].reset(new input_port_impl(capacity_, this));
+      nof_ports_.store(nof_ports + 1, std::memory_order_release);
     } else {
-      queues[qidx].set_active(true);
+      ports[qidx]->set_active(true);
     }
-    return queue_handle(&queues[qidx]);
+    return queue_handle(ports[qidx].get());
   }
 
   /**
@@ -279,67 +385,97 @@ public:
   uint32_t nof_queues() const
   {
     std::lock_guard<std::mutex> lock(mutex);
-    uint32_t                    count = 0;
-    for (uint32_t i = 0; i < queues.size(); ++i) {
-      count += queues[i].active() ? 1 : 0;
+    uint32_t                    count     = 0;
+    uint32_t                    nof_ports = nof_ports_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < nof_ports; ++i) {
+      count += ports[i]->active() ? 1 : 0;
     }
     return count;
   }
 
-  bool wait_pop(myobj* value)
+  bool wait_pop(myobj* value) { return wait_pop_batch(value, 1) > 0; }
+
+  /**
+   * Blocks until at least one message is available, and pops up to max_values messages from the same queue.
+   * @return The number of messages popped. Zero if the multiqueue was stopped.
+   */
+  uint32_t wait_pop_batch(myobj* values, uint32_t max_values)
   {
-    std::unique_lock<std::mutex> lock(mutex);
-    consumer_state = true;
-    while (running) {
-      if (round_robin_pop_(value)) {
-        consumer_state = false;
-        return true;
+    while (running.load(std::memory_order_relaxed)) {
+      uint32_t n = round_robin_pop_(values, max_values);
+      if (n > 0) {
+        return n;
+      }
+
+      // slow path: announce that the consumer is going to sleep and check the queues again, to avoid missed wake-ups
+      std::unique_lock<std::mutex> lock(mutex);
+      if (not running.load(std::memory_order_relaxed)) {
+        break;
       }
+      consumer_state = true;
+      consumer_sleeping.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      n = round_robin_pop_(values, max_values);
+      if (n == 0) {
+        cv_pop.wait(lock);
+      }
+      consumer_sleeping.store(false, std::memory_order_relaxed);
+      consumer_state = false;
       lock.unlock();
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-      lock.lock();
+      cv_exit.notify_one();
+      if (n > 0) {
+        return n;
+      }
     }
-    consumer_state = false;
-    lock.unlock();
-    cv_exit.notify_one();
-    return false;
+    return 0;
   }
 
-  bool try_pop(myobj* value)
+  bool try_pop(myobj* value) { return try_pop_batch(value, 1) > 0; }
+
+  /// Pops up to max_values messages from the same queue, without blocking.
+  uint32_t try_pop_batch(myobj* values, uint32_t max_values)
   {
-    std::unique_lock<std::mutex> lock(mutex);
-    return running and round_robin_pop_(value);
+    return running.load(std::memory_order_relaxed) ? round_robin_pop_(values, max_values) : 0;
   }
 
 private:
-  bool round_robin_pop_(myobj* value)
+  uint32_t round_robin_pop_(myobj* values, uint32_t max_values)
   {
     // Round-robin for all queues
-    auto     q_it  = queues.begin() + spin_idx;
-    uint32_t count = 0;
-    for (; count < queues.size(); ++count, ++q_it) {
-      if (q_it == queues.end()) {
-        q_it = queues.begin(); // wrap-around
-      }
-      bool try_lock_success = true;
-      if (q_it->try_pop(*value, try_lock_success)) {
-        spin_idx = (spin_idx + count + 1) % queues.size();
-        return true;
+    uint32_t nof_ports = nof_ports_.load(std::memory_order_acquire);
+    for (uint32_t count = 0; count < nof_ports; ++count) {
+      uint32_t qidx = spin_idx + count;
+      qidx          = qidx < nof_ports ? qidx : qidx - nof_ports; // wrap-around
+      uint32_t n    = ports[qidx]->try_pop(values, max_values);
+      if (n > 0) {
+        spin_idx = qidx + 1 < nof_ports ? qidx + 1 : 0;
+        return n;
       }
-      if (not try_lock_success) {
-        // restart RR search, as there was a collision with a producer
-        count = 0;
+    }
+    return 0;
+  }
+
+  /// Called by the pushers after a message is written. Only locks if the consumer is sleeping.
+  void notify_consumer_()
+  {
+    // Pairs with the fence of the consumer, before it checks the queues one last time and goes to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer_sleeping.load(std::memory_order_relaxed)) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
       }
+      cv_pop.notify_one();
     }
-    return false;
   }
 
-  mutable std::mutex          mutex;
-  std::condition_variable     cv_exit;
-  uint32_t                    spin_idx = 0;
-  bool                        running = true, consumer_state = false;
-  std::deque<input_port_impl> queues;
-  uint32_t                    default_capacity = 0;
+  mutable std::mutex      mutex;
+  std::condition_variable cv_exit, cv_pop;
+  uint32_t                spin_idx = 0;
+  std::atomic<bool>       running{true}, consumer_sleeping{false};
+  bool                    consumer_state = false;
+  std::unique_ptr<input_port_impl> ports[MULTIQUEUE_MAX_NOF_QUEUES];
+  std::atomic<uint32_t>            nof_ports_{0};
+  uint32_t                         default_capacity = 0;
 };
 
 template <typename T>
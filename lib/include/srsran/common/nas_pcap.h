@@ -24,6 +24,7 @@
 
 #include "srsran/common/common.h"
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 #include <string>
 
 namespace srsran {
@@ -40,8 +41,7 @@ public:
 
 private:
   bool        enable_write = false;
-  std::string filename;
-  FILE*       pcap_file            = nullptr;
+  pcap_writer writer;
   uint32_t    ue_id                = 0;
   int         emergency_handler_id = -1;
   void        pack_and_write(uint8_t* pdu, uint32_t pdu_len_bytes);
@@ -35,6 +35,7 @@
 #include <netinet/udp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <vector>
 
 namespace srsran {
 
@@ -102,6 +103,61 @@ namespace net_utils {
 
 bool sctp_init_socket(unique_socket* socket, net_utils::socket_type socktype, const char* bind_addr_str, int bind_port);
 
+/**
+ * Description: Receives up to "capacity" datagrams from a socket with a single recvmmsg() call. Each datagram is
+ *              written into its own pre-allocated byte buffer. The caller may take ownership of a received buffer via
+ *              release(), in which case the slot is refilled on the next call to recv().
+ */
+class datagram_rx_batch
+{
+public:
+  explicit datagram_rx_batch(uint32_t capacity_);
+
+  /// Receives pending datagrams without blocking. Returns the number received, 0 if none pending or -1 on error
+  int recv(int fd);
+
+  uint32_t           capacity() const { return bufs.size(); }
+  uint32_t           size() const { return nof_msgs; }
+  byte_buffer_t*     get(uint32_t i) { return bufs[i].get(); }
+  const sockaddr_in& get_addr(uint32_t i) const { return addrs[i]; }
+  unique_byte_buffer_t release(uint32_t i) { return std::move(bufs[i]); }
+
+private:
+  std::vector<unique_byte_buffer_t> bufs;
+  std::vector<mmsghdr>              hdrs;
+  std::vector<iovec>                iovs;
+  std::vector<sockaddr_in>          addrs;
+  uint32_t                          nof_msgs = 0;
+};
+
+/**
+ * Description: Accumulates outgoing datagrams and transmits them with as few sendmmsg() calls as possible. The byte
+ *              buffers are held until flush() and returned to the pool afterwards.
+ */
+class datagram_tx_batch
+{
+public:
+  explicit datagram_tx_batch(uint32_t capacity_);
+
+  /// Queues a datagram for dest_addr. The caller must flush() beforehand if the batch is full
+  void push(unique_byte_buffer_t msg, const sockaddr_in& dest_addr);
+
+  /// Sends all queued datagrams through fd. Returns the number of datagrams that were sent successfully
+  uint32_t flush(int fd);
+
+  uint32_t capacity() const { return bufs.size(); }
+  uint32_t size() const { return nof_msgs; }
+  bool     empty() const { return nof_msgs == 0; }
+  bool     full() const { return nof_msgs == bufs.size(); }
+
+private:
+  std::vector<unique_byte_buffer_t> bufs;
+  std::vector<mmsghdr>              hdrs;
+  std::vector<iovec>                iovs;
+  std::vector<sockaddr_in>          addrs;
+  uint32_t                          nof_msgs = 0;
+};
+
 } // namespace net_utils
 
 /****************************
@@ -132,7 +188,7 @@ protected:
 };
 
 /**
- * Description - Instantiates a thread that will block waiting for IO from multiple sockets, via a select
+ * Description - Instantiates a thread that will block waiting for IO from multiple sockets, via epoll
  *               The user can register their own (socket fd, data handler) in this class via the
  *               add_socket_handler(fd, task) API or its other variants
  */
@@ -152,9 +208,10 @@ public:
   void run_thread() override;
 
 private:
-  const int thread_prio = 65;
+  const int                   thread_prio = 65;
+  static constexpr std::size_t max_events  = 64;
 
-  // used to unlock select
+  // used to unlock epoll_wait
   struct ctrl_cmd_t {
     enum class cmd_id_t { EXIT, NEW_FD, RM_FD };
     cmd_id_t cmd;
@@ -162,13 +219,14 @@ private:
     bool     signal_rm_complete;
     ctrl_cmd_t() { bzero(this, sizeof(ctrl_cmd_t)); }
   };
-  std::map<int, recv_callback_t>::iterator remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd);
+  void remove_socket_unprotected(int fd);
 
   // state
   std::mutex                     socket_mutex;
   std::map<int, recv_callback_t> active_sockets;
   std::atomic<bool>              running   = {false};
   int                            pipefd[2] = {-1, -1};
+  int                            epoll_fd  = -1;
   std::vector<int>               rem_fd_tmp_list;
   std::condition_variable        rem_cvar;
 };
@@ -200,6 +258,16 @@ make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& q
 socket_manager_itf::recv_callback_t
 make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue, recvfrom_callback_t rx_callback);
 
+/**
+ * Similar to make_sdu_handler, but for datagram sockets with bursty traffic (e.g. S1-U/N3). Each time the socket has
+ * data, up to batch_size datagrams are received with a single recvmmsg() into pre-allocated byte buffers, and the
+ * whole burst is dispatched into the "queue" as a single task that calls rx_callback once per datagram.
+ */
+socket_manager_itf::recv_callback_t make_sdu_batch_handler(srslog::basic_logger&      logger,
+                                                           srsran::task_queue_handle& queue,
+                                                           recvfrom_callback_t        rx_callback,
+                                                           uint32_t                   batch_size = 32);
+
 inline socket_manager& get_rx_io_manager()
 {
   static socket_manager io;
@@ -23,6 +23,7 @@
 #define SRSRAN_NGAP_PCAP_H
 
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 #include <string>
 
 namespace srsran {
@@ -44,8 +45,7 @@ public:
 
 private:
   bool        enable_write = false;
-  std::string filename;
-  FILE*       pcap_file            = nullptr;
+  pcap_writer writer;
   int         emergency_handler_id = -1;
 };
 
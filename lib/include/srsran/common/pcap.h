@@ -54,6 +54,27 @@ typedef struct pcaprec_hdr_s {
   unsigned int orig_len; /* actual length of packet */
 } pcaprec_hdr_t;
 
+/* pcapng block types */
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+/* pcapng option codes */
+#define PCAPNG_OPT_ENDOFOPT 0
+#define PCAPNG_OPT_IF_NAME 2
+
+/* pcapng Enhanced Packet Block, followed by the packet padded to 32 bits and the block length */
+typedef struct pcapng_epb_hdr_s {
+  unsigned int block_type;         /* PCAPNG_EPB_TYPE */
+  unsigned int block_total_length; /* length of the whole block, in octets */
+  unsigned int interface_id;       /* index of the Interface Description Block */
+  unsigned int timestamp_high;     /* upper 32 bits of the timestamp, in microseconds */
+  unsigned int timestamp_low;      /* lower 32 bits of the timestamp, in microseconds */
+  unsigned int captured_len;       /* number of octets of packet saved in file */
+  unsigned int orig_len;           /* actual length of packet */
+} pcapng_epb_hdr_t;
+
 /* radioType */
 #define FDD_RADIO 1
 #define TDD_RADIO 2
@@ -210,12 +231,20 @@ void DLT_PCAP_Close(FILE* fd);
 int LTE_PCAP_MAC_WritePDU(FILE* fd, MAC_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 int LTE_PCAP_MAC_UDP_WritePDU(FILE* fd, MAC_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 int LTE_PCAP_PACK_MAC_CONTEXT_TO_BUFFER(MAC_Context_Info_t* context, uint8_t* PDU, unsigned int length);
+int LTE_PCAP_PACK_MAC_UDP_CONTEXT_TO_BUFFER(MAC_Context_Info_t* context,
+                                            uint8_t*            buffer,
+                                            unsigned int        length,
+                                            unsigned int        pdu_length);
 
 /* Write an individual NAS PDU (PCAP packet header + nas-context + nas-pdu) */
 int LTE_PCAP_NAS_WritePDU(FILE* fd, NAS_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 
 /* Write an individual RLC PDU (PCAP packet header + UDP header + rlc-context + rlc-pdu) */
 int LTE_PCAP_RLC_WritePDU(FILE* fd, RLC_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
+int LTE_PCAP_PACK_RLC_CONTEXT_TO_BUFFER(RLC_Context_Info_t* context,
+                                        uint8_t*            buffer,
+                                        unsigned int        length,
+                                        unsigned int        pdu_length);
 
 /* Write an individual S1AP PDU (PCAP packet header + s1ap-context + s1ap-pdu) */
 int LTE_PCAP_S1AP_WritePDU(FILE* fd, S1AP_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
@@ -226,6 +255,10 @@ int LTE_PCAP_NGAP_WritePDU(FILE* fd, NGAP_Context_Info_t* context, const unsigne
 /* Write an individual NR MAC PDU (PCAP packet header + UDP header + nr-mac-context + mac-pdu) */
 int NR_PCAP_MAC_UDP_WritePDU(FILE* fd, mac_nr_context_info_t* context, const unsigned char* PDU, unsigned int length);
 int NR_PCAP_PACK_MAC_CONTEXT_TO_BUFFER(mac_nr_context_info_t* context, uint8_t* buffer, unsigned int length);
+int NR_PCAP_PACK_MAC_UDP_CONTEXT_TO_BUFFER(mac_nr_context_info_t* context,
+                                           uint8_t*               buffer,
+                                           unsigned int           length,
+                                           unsigned int           pdu_length);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_PCAP_FILTER_H
+#define SRSRAN_PCAP_FILTER_H
+
+#include "srsran/common/string_helpers.h"
+#include <bitset>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+namespace srsran {
+
+/**
+ * RNTI filter of the pcap classes. It is evaluated by the calling thread before the PDU is copied, so that the PDUs of
+ * the UEs that are not of interest cost a bit test. It must be configured before the pcap is opened. An empty list lets
+ * everything through.
+ */
+class pcap_filter
+{
+public:
+  /// Parses a comma-separated list of RNTIs, in decimal or 0x-prefixed hexadecimal.
+  /// @return false if any of the values is not valid
+  bool parse(const std::string& rnti_list)
+  {
+    reset();
+    for (const std::string& s : split_string(rnti_list, ',')) {
+      unsigned long rnti;
+      if (not parse_value(s, rnti) or rnti > UINT16_MAX) {
+        return false;
+      }
+      allow_rnti(rnti);
+    }
+    return true;
+  }
+
+  void reset()
+  {
+    rntis.reset();
+    rnti_filter = false;
+  }
+
+  void allow_rnti(uint16_t rnti)
+  {
+    rntis.set(rnti);
+    rnti_filter = true;
+  }
+
+  bool rnti_allowed(uint16_t rnti) const { return not rnti_filter or rntis.test(rnti); }
+
+private:
+  static bool parse_value(const std::string& s, unsigned long& value)
+  {
+    char* end = nullptr;
+    value     = strtoul(s.c_str(), &end, 0);
+    return not s.empty() and *end == '\0';
+  }
+
+  bool               rnti_filter = false;
+  std::bitset<65536> rntis;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_PCAP_FILTER_H
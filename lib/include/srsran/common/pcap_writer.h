@@ -0,0 +1,172 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_PCAP_WRITER_H
+#define SRSRAN_PCAP_WRITER_H
+
+#include "srsran/common/threads.h"
+#include "srsran/srslog/srslog.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace srsran {
+
+enum class pcap_format_t { pcap, pcapng };
+
+/**
+ * Asynchronous pcap file writer shared by all the pcap classes.
+ *
+ * Records are written into a ring of large aligned buffers. A writer reserves space in the current buffer with a CAS
+ * on its state word, which holds the buffer sequence number and fill level, and copies the record header, context
+ * and PDU in place. The writer that does not fit seals the buffer and moves on to the next one. A background thread
+ * writes every sealed buffer to the file with a single write() call, and seals the current buffer itself when the
+ * flush period expires. When all the buffers are waiting to be written, new records are dropped and counted.
+ * Optionally, the file is rotated once it reaches a maximum size.
+ *
+ * Records are either written as classic pcap or as pcapng, with one Interface Description Block per file, and can be
+ * truncated to a snap length. In triggered mode, the written buffers are only kept in a bounded in-memory history,
+ * which is dumped to the file together with the records of the following trigger_post_ms when trigger() is called.
+ */
+class pcap_writer : protected srsran::thread
+{
+public:
+  struct args_t {
+    /// Size of each write buffer.
+    uint32_t buffer_size = 1024 * 1024;
+    /// Number of write buffers. Rounded up to a power of two.
+    uint32_t nof_buffers = 4;
+    /// Maximum time a record waits in a write buffer before it is written to the file.
+    uint32_t flush_period_ms = 100;
+    /// File size, in bytes, that triggers a rotation. Zero disables the rotation.
+    uint64_t max_file_size = 0;
+    /// Number of rotated files that are kept. Zero keeps all of them.
+    uint32_t max_files = 0;
+    /// File format.
+    pcap_format_t format = pcap_format_t::pcap;
+    /// Name of the pcapng interface. Ignored by the pcap format.
+    std::string if_name;
+    /// Maximum number of bytes of each record, context included. Zero captures the full records.
+    uint32_t snap_len = 0;
+    /// Bytes of records kept in memory until a trigger. Zero disables the triggered mode.
+    uint32_t trigger_history_size = 0;
+    /// Time during which records are written to the file after a trigger.
+    uint32_t trigger_post_ms = 5000;
+  };
+
+  pcap_writer();
+  ~pcap_writer();
+  pcap_writer(const pcap_writer& other) = delete;
+  pcap_writer& operator=(const pcap_writer& other) = delete;
+
+  /// Opens the file, writes the pcap file header and starts the writer thread.
+  bool open(const std::string& filename, uint32_t dlt, const args_t& args_);
+  bool open(const std::string& filename, uint32_t dlt) { return open(filename, dlt, args_t{}); }
+
+  /// Writes all the pending records, stops the writer thread and closes the file.
+  void close();
+
+  bool is_open() const { return running.load(std::memory_order_relaxed); }
+
+  /// Adds a record made of the context header followed by the PDU. Thread-safe and lock-free.
+  /// @return false if the record was dropped
+  bool write(const uint8_t* context, uint32_t context_len, const uint8_t* pdu, uint32_t pdu_len);
+
+  /// Writes the history of a writer in triggered mode, and the records of the following trigger_post_ms, to the file.
+  void trigger();
+
+  /// Triggers all the open writers that are in triggered mode, e.g. upon a radio link failure.
+  static void trigger_all();
+
+  /// Number of records that were dropped since the file was opened.
+  uint64_t nof_dropped() const { return nof_dropped_records.load(std::memory_order_relaxed); }
+
+  const std::string& get_filename() const { return filename; }
+
+private:
+  /// The state word of a buffer holds its sequence number, the sealed flag and the number of reserved bytes.
+  static const uint64_t sealed_flag = uint64_t{1} << 31U;
+  static uint64_t       make_state(uint32_t seq, uint32_t nof_bytes) { return ((uint64_t)seq << 32U) | nof_bytes; }
+  static uint32_t       state_seq(uint64_t state) { return state >> 32U; }
+  static uint32_t       state_nof_bytes(uint64_t state) { return state & (sealed_flag - 1); }
+  static bool           state_sealed(uint64_t state) { return (state & sealed_flag) != 0; }
+
+  struct write_buffer_t {
+    std::atomic<uint64_t> state     = {0};
+    std::atomic<uint32_t> committed = {0};
+    uint8_t*              data      = nullptr;
+  };
+
+  struct aligned_free {
+    void operator()(uint8_t* p) const { free(p); }
+  };
+
+  void        run_thread() override;
+  bool        seal(write_buffer_t& buf, uint32_t seq, uint64_t state);
+  void        notify_writer_thread();
+  void        store_records(const uint8_t* data, uint32_t len);
+  void        write_history();
+  void        write_records(const uint8_t* data, uint32_t len);
+  uint32_t    record_len(const uint8_t* record) const;
+  bool        write_all(const uint8_t* data, uint32_t len);
+  bool        open_file();
+  bool        write_file_header();
+  void        close_file();
+  void        rotate_file();
+  std::string file_name(uint32_t idx) const;
+
+  srslog::basic_logger&   logger;
+  std::atomic<bool>       running             = {false};
+  std::atomic<uint32_t>   current_seq         = {0};
+  std::atomic<uint64_t>   nof_dropped_records = {0};
+  std::atomic<bool>       trigger_pending     = {false};
+  std::mutex              mutex;
+  std::condition_variable cvar;
+
+  // Write buffers. They are only reallocated by open(), so that late writers never access freed memory.
+  std::unique_ptr<write_buffer_t[]>        buffers;
+  std::unique_ptr<uint8_t[], aligned_free> memory;
+  uint32_t                                 nof_buffers = 0;
+  uint32_t                                 buffer_size = 0;
+
+  // Only accessed by the writer thread while the file is open
+  args_t      args;
+  std::string filename;
+  uint32_t    dlt        = 0;
+  int         fd         = -1;
+  uint32_t    file_idx   = 0;
+  uint64_t    file_size  = 0;
+  uint32_t    header_len = 0;
+
+  // History of the triggered mode. Only accessed by the writer thread
+  std::deque<std::vector<uint8_t> >     history;
+  uint64_t                              history_size = 0;
+  std::chrono::steady_clock::time_point trigger_deadline;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_PCAP_WRITER_H
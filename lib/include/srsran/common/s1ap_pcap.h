@@ -23,6 +23,7 @@
 #define SRSRAN_S1AP_PCAP_H
 
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 #include <string>
 
 namespace srsran {
@@ -39,13 +40,14 @@ public:
 
   void enable();
   void open(const char* filename_);
+  void open(const char* filename_, const pcap_writer::args_t& writer_args);
   void close();
+  void trigger() { writer.trigger(); }
   void write_s1ap(uint8_t* pdu, uint32_t pdu_len_bytes);
 
 private:
   bool        enable_write = false;
-  std::string filename;
-  FILE*       pcap_file            = nullptr;
+  pcap_writer writer;
   int         emergency_handler_id = -1;
 };
 
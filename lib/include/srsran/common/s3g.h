@@ -72,6 +72,22 @@ void s3g_deinitialize(S3G_STATE* state);
 
 void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks);
 
+/* Multi-buffer generation of Keystream.
+ * input nof_streams: number of independent keystreams.
+ * input k, iv: key and initialization variable of each keystream, as in
+ * s3g_initialize().
+ * input n: number of 32-bit words of each keystream.
+ * output ks: generated keystreams, ks[i] must have space for n[i] words.
+ * The keystreams are initialized and generated in parallel, as many as the
+ * SIMD registers of the target can hold.
+ */
+
+void s3g_generate_keystream_multi(uint32_t        nof_streams,
+                                  const uint32_t  k[][4],
+                                  const uint32_t  iv[][4],
+                                  const uint32_t* n,
+                                  uint32_t* const* ks);
+
 /* f8.
  * Input key: 128 bit Confidentiality Key.
  * Input count:32-bit Count, Frame dependent input.
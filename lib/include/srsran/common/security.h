@@ -26,8 +26,10 @@
  * Common security header - wraps ciphering/integrity check algorithms.
  *****************************************************************************/
 
+#include "srsran/adt/span.h"
 #include "srsran/common/common.h"
 #include "srsran/srslog/srslog.h"
+#include <memory>
 
 #include <vector>
 
@@ -253,6 +255,55 @@ uint8_t security_generate_res_star(const uint8_t* ck,
                                    const uint8_t* res,
                                    const size_t   res_len,
                                    uint8_t*       res_star);
+/******************************************************************************
+ * AES-128 key context for EEA2/EIA2
+ *****************************************************************************/
+
+/// Expanded AES-128 key schedule and CMAC subkeys of a security key. Deriving them is as expensive as ciphering a
+/// short PDU, so they are computed once when the key is configured and reused for every PDU. The AES rounds use
+/// AES-NI when the target supports it, otherwise mbedTLS.
+class aes128_key_ctx
+{
+public:
+  aes128_key_ctx();
+  explicit aes128_key_ctx(const uint8_t* key) : aes128_key_ctx() { set_key(key); }
+  ~aes128_key_ctx();
+
+  aes128_key_ctx(const aes128_key_ctx&) = delete;
+  aes128_key_ctx& operator=(const aes128_key_ctx&) = delete;
+  aes128_key_ctx(aes128_key_ctx&&) noexcept;
+  aes128_key_ctx& operator=(aes128_key_ctx&&) noexcept;
+
+  /// Expands the 128 bit key and derives the CMAC subkeys.
+  void set_key(const uint8_t* key);
+
+  /// Encrypts nof_blocks 16 byte blocks in place. Independent blocks are processed in parallel.
+  void encrypt_blocks(uint8_t (*blocks)[16], uint32_t nof_blocks) const;
+
+  const uint8_t* get_cmac_k1() const { return k1; }
+  const uint8_t* get_cmac_k2() const { return k2; }
+
+  /// Maximum number of blocks processed in parallel.
+  static constexpr uint32_t max_parallel_blocks = 8;
+
+private:
+  struct sw_ctx;
+
+  alignas(16) uint8_t     round_keys[11][16];
+  uint8_t                 k1[16];
+  uint8_t                 k2[16];
+  std::unique_ptr<sw_ctx> sw;
+};
+
+/// PDU of a batch of EEA2/EIA2 operations. For ciphering, out points to the output buffer (it can be the same as msg),
+/// for integrity it points to the 4 byte MAC.
+struct security_batch_pdu_t {
+  uint8_t* msg;
+  uint32_t msg_len;
+  uint32_t count;
+  uint8_t* out;
+};
+
 /******************************************************************************
  * Integrity Protection
  *****************************************************************************/
@@ -272,6 +323,20 @@ uint8_t security_128_eia2(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac);
 
+uint8_t security_128_eia2(const aes128_key_ctx& ctx,
+                          uint32_t              count,
+                          uint32_t              bearer,
+                          uint8_t               direction,
+                          const uint8_t*        msg,
+                          uint32_t              msg_len,
+                          uint8_t*              mac);
+
+/// Computes the EIA2 MAC of every PDU of the batch, interleaving the CMAC chains of several PDUs.
+void security_128_eia2_batch(const aes128_key_ctx&            ctx,
+                             uint32_t                         bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus);
+
 uint8_t security_128_eia3(const uint8_t* key,
                           uint32_t       count,
                           uint32_t       bearer,
@@ -293,6 +358,12 @@ uint8_t security_128_eea1(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/// Ciphers every PDU of the batch, running the SNOW 3G generators of several PDUs in parallel.
+void security_128_eea1_batch(const uint8_t*                   key,
+                             uint8_t                          bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus);
+
 uint8_t security_128_eea2(uint8_t* key,
                           uint32_t count,
                           uint8_t  bearer,
@@ -301,6 +372,20 @@ uint8_t security_128_eea2(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+uint8_t security_128_eea2(const aes128_key_ctx& ctx,
+                          uint32_t              count,
+                          uint8_t               bearer,
+                          uint8_t               direction,
+                          const uint8_t*        msg,
+                          uint32_t              msg_len,
+                          uint8_t*              msg_out);
+
+/// Ciphers every PDU of the batch, generating the key stream of several PDUs in parallel.
+void security_128_eea2_batch(const aes128_key_ctx&            ctx,
+                             uint8_t                          bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus);
+
 uint8_t security_128_eea3(uint8_t* key,
                           uint32_t count,
                           uint8_t  bearer,
@@ -309,6 +394,12 @@ uint8_t security_128_eea3(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/// Ciphers every PDU of the batch, running the ZUC generators of several PDUs in parallel.
+void security_128_eea3_batch(const uint8_t*                   key,
+                             uint8_t                          bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus);
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
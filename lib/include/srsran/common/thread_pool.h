@@ -34,6 +34,7 @@
 #include "srsran/srslog/srslog.h"
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -101,11 +102,17 @@ private:
   std::vector<std::condition_variable> cvar_worker = {};
 };
 
+/// Priority of the tasks pushed to a task_thread_pool. High priority tasks are always run first.
+enum class task_priority { high = 0, normal, nof_priorities };
+
+/// Pool of workers, each with its own task queues. Idle workers steal tasks from the queues of the other workers, so a
+/// slow task only delays the tasks that were queued behind it in the same worker queue until another worker is free.
 class task_thread_pool
 {
-  using task_t                             = srsran::move_callback<void(), default_move_callback_buffer_size, true>;
-  static constexpr uint32_t max_task_shift = 14;
-  static constexpr uint32_t max_task_num   = 1u << max_task_shift;
+  using task_t                              = srsran::move_callback<void(), default_move_callback_buffer_size, true>;
+  static constexpr uint32_t max_task_shift  = 14;
+  static constexpr uint32_t max_task_num    = 1u << max_task_shift;
+  static constexpr uint32_t max_nof_workers = 256;
 
 public:
   task_thread_pool(uint32_t nof_workers = 1, bool start_deferred = false, int32_t prio_ = -1, uint32_t mask_ = 255);
@@ -119,11 +126,23 @@ public:
   void start(int32_t prio_ = -1, uint32_t mask_ = 255);
   void set_nof_workers(uint32_t nof_workers);
 
-  void     push_task(task_t&& task);
+  /// When enabled, each worker is pinned to a single CPU of the pool CPU mask, instead of floating over all of them.
+  /// Must be called before start().
+  void set_worker_pinning(bool enable) { pin_workers = enable; }
+
+  void     push_task(task_t&& task, task_priority task_prio = task_priority::normal);
   uint32_t nof_pending_tasks() const;
   size_t   nof_workers() const { return workers.size(); }
 
 private:
+  /// Task queues of a worker. Accessed by the worker itself, by the pushers and by the workers stealing tasks.
+  struct worker_queue {
+    std::mutex         mutex;
+    std::deque<task_t> tasks[(size_t)task_priority::nof_priorities];
+    /// Number of tasks in the queue, read without the lock by the workers looking for tasks to steal
+    std::atomic<uint32_t> nof_tasks{0};
+  };
+
   class worker_t : public thread
   {
   public:
@@ -136,21 +155,34 @@ private:
 
   private:
     bool wait_task(task_t* task);
+    bool try_pop_task(task_t* task);
+    bool try_pop_task(worker_queue& q, task_t* task);
 
-    task_thread_pool* parent  = nullptr;
-    uint32_t          id_     = 0;
-    bool              running = false;
+    task_thread_pool* parent     = nullptr;
+    uint32_t          id_        = 0;
+    bool              running    = false;
+    int               pinned_cpu = -1;
   };
 
-  int32_t               prio = -1;
-  uint32_t              mask = 255;
+  void add_queues(uint32_t nof_workers);
+
+  int32_t               prio        = -1;
+  uint32_t              mask        = 255;
+  bool                  pin_workers = false;
   srslog::basic_logger& logger;
 
-  srsran::dyn_circular_buffer<task_t>     pending_tasks;
+  // The vector capacity is reserved at construction, so that queues can be added without invalidating the ones
+  // accessed by pushers and workers
+  std::vector<std::unique_ptr<worker_queue> > queues;
+  std::atomic<uint32_t>                       nof_queues{0};
+  std::atomic<uint32_t>                       next_queue{0};
+  std::atomic<uint32_t>                       nof_pending{0};
+  std::atomic<uint32_t>                       nof_sleeping{0};
+
   std::vector<std::unique_ptr<worker_t> > workers;
   mutable std::mutex                      queue_mutex;
   std::condition_variable                 cv_empty;
-  bool                                    running = false;
+  std::atomic<bool>                       running{false};
 };
 
 /// Class used to create a single worker with an input task queue with a single reader
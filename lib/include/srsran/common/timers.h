@@ -32,11 +32,13 @@
 #include "srsran/adt/intrusive_list.h"
 #include "srsran/adt/move_callback.h"
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <inttypes.h>
 #include <limits>
 #include <mutex>
+#include <thread>
 
 namespace srsran {
 
@@ -56,20 +58,26 @@ public:
  *   This deque will only grow in size. Erased timers are just tagged in the deque as empty, and can be reused for the
  *   creation of new timers. To avoid unnecessary runtime allocations, the user can set an initial capacity.
  * - free_list - intrusive forward linked list to keep track of the empty timers and speed up new timer creation.
- * - A large circular vector of size WHEEL_SIZE which works as a time wheel, storing and circularly indexing the
- *   currently running timers by their respective timeout value.
- *   For a number of running timers N, and uniform distribution of timeout values, the step_all() complexity
- *   should be O(N/WHEEL_SIZE). Thus, the performance should improve with a larger WHEEL_SIZE, at the expense of more
- *   used memory.
+ * - A hierarchical time wheel with NOF_LEVELS levels of WHEEL_SIZE slots each. Level L slots span WHEEL_SIZE^L ticks,
+ *   so a timer is inserted in O(1) regardless of its duration. When the slots of a level wrap around, the timers of the
+ *   next level slot are cascaded down to the lower levels.
+ * - pending_head - lock-free intrusive stack of timers whose state was changed by run()/stop()/set() from threads other
+ *   than the one calling step_all(). The time wheel is only accessed by the thread calling step_all(), which updates
+ *   the wheel directly when it starts/stops timers itself, and repositions the pending timers before stepping.
+ *   Thus, run()/stop() do not take any lock and do not contend with step_all().
+ * The allocation/deallocation of timers and the setting of callbacks are still protected by a mutex.
+ * step_all() must always be called from the same thread.
  */
 class timer_handler
 {
-  using tic_diff_t                      = uint32_t;
-  using tic_t                           = uint32_t;
-  constexpr static uint32_t INVALID_ID  = std::numeric_limits<uint32_t>::max();
-  constexpr static size_t   WHEEL_SHIFT = 16U;
-  constexpr static size_t   WHEEL_SIZE  = 1U << WHEEL_SHIFT;
-  constexpr static size_t   WHEEL_MASK  = WHEEL_SIZE - 1U;
+  using tic_diff_t                            = uint32_t;
+  using tic_t                                 = uint32_t;
+  constexpr static uint32_t INVALID_ID        = std::numeric_limits<uint32_t>::max();
+  constexpr static uint32_t INVALID_WHEEL_POS = std::numeric_limits<uint32_t>::max();
+  constexpr static size_t   WHEEL_SHIFT       = 10U;
+  constexpr static size_t   WHEEL_SIZE        = 1U << WHEEL_SHIFT;
+  constexpr static size_t   WHEEL_MASK        = WHEEL_SIZE - 1U;
+  constexpr static size_t   NOF_LEVELS        = 4U; ///< covers the whole 32-bit tic range
 
   constexpr static uint64_t   STOPPED_FLAG       = 0U;
   constexpr static uint64_t   RUNNING_FLAG       = static_cast<uint64_t>(1U) << 63U;
@@ -91,8 +99,13 @@ class timer_handler
     timer_handler& parent;
     // writes protected by backend lock
     bool                                  allocated = false;
-    std::atomic<uint64_t>                 state{0}; ///< read can be without lock, thus writes must be atomic
+    std::atomic<uint64_t>                 state{0}; ///< read and written without lock, thus writes must be atomic
     srsran::move_callback<void(uint32_t)> callback;
+    // pending stack of state changes to be applied to the time wheel
+    std::atomic<bool> pending{false};
+    timer_impl*       next_pending = nullptr;
+    // only accessed by the thread calling step_all()
+    uint32_t wheel_pos = INVALID_WHEEL_POS;
 
     explicit timer_impl(timer_handler& parent_, uint32_t id_) : parent(parent_), id(id_) {}
     timer_impl(const timer_impl&) = delete;
@@ -119,7 +132,6 @@ class timer_handler
                     "Invalid timer duration=%" PRIu32 ">%" PRIu32,
                     duration_,
                     MAX_TIMER_DURATION);
-      std::lock_guard<std::mutex> lock(parent.mutex);
       set_(duration_);
     }
 
@@ -134,17 +146,12 @@ class timer_handler
       callback = std::move(callback_);
     }
 
-    void run()
-    {
-      std::lock_guard<std::mutex> lock(parent.mutex);
-      parent.start_run_(*this);
-    }
+    void run() { parent.start_run_(*this); }
 
     void stop()
     {
-      std::lock_guard<std::mutex> lock(parent.mutex);
       // does not call callback
-      parent.stop_timer_(*this, false);
+      parent.stop_timer_(*this);
     }
 
     void deallocate()
@@ -156,15 +163,15 @@ class timer_handler
   private:
     void set_(uint32_t duration_)
     {
-      duration_ = std::max(duration_, 1U); // the next step will be one place ahead of current one
-      // called in locked context
+      duration_          = std::max(duration_, 1U); // the next step will be one place ahead of current one
       uint64_t old_state = state.load(std::memory_order_relaxed);
-      if (decode_is_running(old_state)) {
-        // if already running, just extends timer lifetime
-        parent.start_run_(*this, duration_);
-      } else {
-        state.store(encode_state(STOPPED_FLAG, duration_, 0), std::memory_order_relaxed);
+      while (not decode_is_running(old_state)) {
+        if (state.compare_exchange_weak(old_state, encode_state(STOPPED_FLAG, duration_, 0))) {
+          return;
+        }
       }
+      // if already running, just extends timer lifetime
+      parent.start_run_(*this, duration_);
     }
   };
 
@@ -234,7 +241,7 @@ public:
 
   explicit timer_handler(uint32_t capacity = 64)
   {
-    time_wheel.resize(WHEEL_SIZE);
+    time_wheel.resize(WHEEL_SIZE * NOF_LEVELS);
     // Pre-reserve timers
     while (timer_list.size() < capacity) {
       timer_list.emplace_back(*this, timer_list.size());
@@ -248,27 +255,48 @@ public:
 
   void step_all()
   {
-    std::unique_lock<std::mutex> lock(mutex);
-    uint32_t                     cur_time_local = cur_time.load(std::memory_order_relaxed) + 1;
-    auto&                        wheel_list     = time_wheel[cur_time_local & WHEEL_MASK];
-
-    for (auto it = wheel_list.begin(); it != wheel_list.end();) {
-      timer_impl& timer = timer_list[it->id];
-      ++it;
-      if (decode_timeout(timer.state.load(std::memory_order_relaxed)) == cur_time_local) {
-        // stop timer (callback has to see the timer has already expired)
-        stop_timer_(timer, true);
-
-        // Call callback if configured
-        if (not timer.callback.is_empty()) {
-          // unlock mutex. It can happen that the callback tries to run a timer too
-          lock.unlock();
-
-          timer.callback(timer.id);
-
-          // Lock again to keep protecting the wheel
-          lock.lock();
-        }
+    uint32_t cur_time_local = cur_time.load(std::memory_order_relaxed) + 1;
+    step_thread_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    wheel_tic         = cur_time_local;
+    wheel_min_timeout = cur_time_local;
+
+    // Reposition in the wheel the timers that were started/stopped by other threads since the last step
+    apply_pending_updates_();
+
+    // Cascade the timers of the upper levels, whose slots start at the current tic
+    for (size_t level = NOF_LEVELS - 1; level > 0; --level) {
+      if ((cur_time_local & ((1U << (level * WHEEL_SHIFT)) - 1U)) == 0) {
+        cascade_(level);
+      }
+    }
+
+    // Expire the timers of the current level 0 slot. Timers started from the callbacks never fall in this slot, as
+    // their timeout is at least one tic ahead
+    wheel_min_timeout = cur_time_local + 1;
+    auto& wheel_list  = time_wheel[cur_time_local & WHEEL_MASK];
+    while (not wheel_list.empty()) {
+      timer_impl& timer = wheel_list.front();
+      wheel_list.pop_front();
+      timer.wheel_pos = INVALID_WHEEL_POS;
+
+      uint64_t timer_state = timer.state.load(std::memory_order_acquire);
+      if (not decode_is_running(timer_state)) {
+        continue;
+      }
+      if (not is_due_(decode_timeout(timer_state), cur_time_local)) {
+        // the timer was restarted meanwhile by another thread. It will be repositioned in the next step
+        continue;
+      }
+      // stop timer (callback has to see the timer has already expired)
+      uint64_t expired_state = encode_state(EXPIRED_FLAG, decode_duration(timer_state), decode_timeout(timer_state));
+      if (not timer.state.compare_exchange_strong(timer_state, expired_state)) {
+        // lost race with a concurrent run()/stop(), which left the timer in the pending stack
+        continue;
+      }
+
+      // Call callback if configured. The callback may start/stop timers, including this one
+      if (not timer.callback.is_empty()) {
+        timer.callback(timer.id);
       }
     }
 
@@ -280,7 +308,7 @@ public:
     std::lock_guard<std::mutex> lock(mutex);
     // does not call callback
     for (timer_impl& timer : timer_list) {
-      stop_timer_(timer, false);
+      stop_timer_(timer);
     }
   }
 
@@ -292,10 +320,11 @@ public:
     return timer_list.size() - nof_free_timers;
   }
 
+  /// Counts the running timers. It iterates over all the timers, so it should only be used for testing/diagnostics.
   uint32_t nof_running_timers() const
   {
     std::lock_guard<std::mutex> lock(mutex);
-    return nof_timers_running_;
+    return std::count_if(timer_list.begin(), timer_list.end(), [](const timer_impl& t) { return t.is_running_(); });
   }
 
   constexpr static uint32_t max_timer_duration() { return MAX_TIMER_DURATION; }
@@ -341,7 +370,7 @@ private:
       // already deallocated
       return;
     }
-    stop_timer_(timer, false);
+    stop_timer_(timer);
     timer.allocated = false;
     timer.state.store(encode_state(STOPPED_FLAG, 0, 0), std::memory_order_relaxed);
     timer.callback = srsran::move_callback<void(uint32_t)>();
@@ -353,54 +382,143 @@ private:
   void start_run_(timer_impl& timer, uint32_t duration_ = 0)
   {
     uint64_t timer_old_state = timer.state.load(std::memory_order_relaxed);
-    duration_                = duration_ == 0 ? decode_duration(timer_old_state) : duration_;
-    uint32_t new_timeout     = cur_time.load(std::memory_order_relaxed) + duration_;
-    size_t   new_wheel_pos   = new_timeout & WHEEL_MASK;
-
-    uint32_t old_timeout = decode_timeout(timer_old_state);
-    bool     was_running = decode_is_running(timer_old_state);
-    if (was_running and (old_timeout & WHEEL_MASK) == new_wheel_pos) {
-      // If no change in timer wheel position. Just update absolute timeout
-      timer.state.store(encode_state(RUNNING_FLAG, duration_, new_timeout), std::memory_order_relaxed);
+    uint64_t new_state;
+    do {
+      uint32_t new_duration = duration_ == 0 ? decode_duration(timer_old_state) : duration_;
+      uint32_t new_timeout  = cur_time.load(std::memory_order_relaxed) + new_duration;
+      new_state             = encode_state(RUNNING_FLAG, new_duration, new_timeout);
+    } while (not timer.state.compare_exchange_weak(timer_old_state, new_state));
+
+    update_wheel_(timer);
+  }
+
+  /// called when user manually stops timer (as an alternative to expiry)
+  void stop_timer_(timer_impl& timer)
+  {
+    uint64_t timer_old_state = timer.state.load(std::memory_order_relaxed);
+    do {
+      if (not decode_is_running(timer_old_state)) {
+        return;
+      }
+    } while (not timer.state.compare_exchange_weak(
+        timer_old_state,
+        encode_state(STOPPED_FLAG, decode_duration(timer_old_state), decode_timeout(timer_old_state))));
+
+    update_wheel_(timer);
+  }
+
+  /// Updates the time wheel position of a timer whose state has changed. If called from a thread other than the one
+  /// calling step_all(), the update is deferred to the next step.
+  void update_wheel_(timer_impl& timer)
+  {
+    if (step_thread_id.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+      push_pending_(timer);
       return;
     }
-
-    // Stop timer if it was running, removing it from wheel in the process
-    if (was_running) {
-      time_wheel[old_timeout & WHEEL_MASK].pop(&timer);
-      nof_timers_running_--;
+    uint64_t timer_state = timer.state.load(std::memory_order_relaxed);
+    if (not decode_is_running(timer_state)) {
+      remove_from_wheel_(timer);
+      return;
     }
+    uint32_t new_wheel_pos = get_wheel_pos_(decode_timeout(timer_state));
+    if (new_wheel_pos != timer.wheel_pos) {
+      remove_from_wheel_(timer);
+      time_wheel[new_wheel_pos].push_front(&timer);
+      timer.wheel_pos = new_wheel_pos;
+    }
+  }
 
-    // Insert timer in wheel
-    time_wheel[new_wheel_pos].push_front(&timer);
-    timer.state.store(encode_state(RUNNING_FLAG, duration_, new_timeout), std::memory_order_relaxed);
-    nof_timers_running_++;
+  /// Signals the thread calling step_all() that the time wheel position of the timer needs to be updated
+  void push_pending_(timer_impl& timer)
+  {
+    if (timer.pending.exchange(true)) {
+      // already in the pending stack
+      return;
+    }
+    timer_impl* old_head = pending_head.load(std::memory_order_relaxed);
+    do {
+      timer.next_pending = old_head;
+    } while (not pending_head.compare_exchange_weak(old_head, &timer, std::memory_order_release));
   }
 
-  /// called when user manually stops timer (as an alternative to expiry)
-  void stop_timer_(timer_impl& timer, bool expiry)
+  /// Repositions in the time wheel the timers whose state was updated by other threads or timer callbacks
+  void apply_pending_updates_()
   {
-    uint64_t timer_old_state = timer.state.load(std::memory_order_relaxed);
-    if (not decode_is_running(timer_old_state)) {
+    if (pending_head.load(std::memory_order_relaxed) == nullptr) {
       return;
     }
+    timer_impl* timer = pending_head.exchange(nullptr, std::memory_order_acquire);
+    while (timer != nullptr) {
+      timer_impl* next = timer->next_pending;
+      // clear the flag before reading the state, so that later updates are pushed again to the stack
+      timer->pending.store(false);
+      remove_from_wheel_(*timer);
+      uint64_t timer_state = timer->state.load();
+      if (decode_is_running(timer_state)) {
+        insert_in_wheel_(*timer, decode_timeout(timer_state));
+      }
+      timer = next;
+    }
+  }
+
+  void cascade_(size_t level)
+  {
+    size_t                                           slot = (wheel_tic >> (level * WHEEL_SHIFT)) & WHEEL_MASK;
+    srsran::intrusive_double_linked_list<timer_impl> cascade_list = std::move(time_wheel[level * WHEEL_SIZE + slot]);
+    while (not cascade_list.empty()) {
+      timer_impl& timer = cascade_list.front();
+      cascade_list.pop_front();
+      timer.wheel_pos      = INVALID_WHEEL_POS;
+      uint64_t timer_state = timer.state.load(std::memory_order_acquire);
+      if (decode_is_running(timer_state)) {
+        insert_in_wheel_(timer, decode_timeout(timer_state));
+      }
+    }
+  }
 
-    // If already running, need to disconnect it from previous wheel
-    uint32_t old_timeout = decode_timeout(timer_old_state);
-    time_wheel[old_timeout & WHEEL_MASK].pop(&timer);
-    uint64_t new_state =
-        encode_state(expiry ? EXPIRED_FLAG : STOPPED_FLAG, decode_duration(timer_old_state), old_timeout);
-    timer.state.store(new_state, std::memory_order_relaxed);
-    nof_timers_running_--;
+  void remove_from_wheel_(timer_impl& timer)
+  {
+    if (timer.wheel_pos != INVALID_WHEEL_POS) {
+      time_wheel[timer.wheel_pos].pop(&timer);
+      timer.wheel_pos = INVALID_WHEEL_POS;
+    }
   }
 
-  std::atomic<tic_t> cur_time{0};
-  size_t             nof_timers_running_ = 0, nof_free_timers = 0;
+  /// Computes the position in the wheel level whose span covers the distance between the current wheel tic and the
+  /// timeout. Timers that are already due are placed in the slot of the earliest tic that is still going to be processed.
+  uint32_t get_wheel_pos_(tic_t timeout) const
+  {
+    if (is_due_(timeout, wheel_min_timeout)) {
+      timeout = wheel_min_timeout;
+    }
+    tic_diff_t delta = timeout - wheel_tic;
+    uint32_t   level = 0;
+    while (level < NOF_LEVELS - 1 and delta >= (1U << ((level + 1) * WHEEL_SHIFT))) {
+      ++level;
+    }
+    return level * WHEEL_SIZE + ((timeout >> (level * WHEEL_SHIFT)) & WHEEL_MASK);
+  }
+
+  void insert_in_wheel_(timer_impl& timer, tic_t timeout)
+  {
+    timer.wheel_pos = get_wheel_pos_(timeout);
+    time_wheel[timer.wheel_pos].push_front(&timer);
+  }
+
+  static bool is_due_(tic_t timeout, tic_t now) { return static_cast<int32_t>(timeout - now) <= 0; }
+
+  std::atomic<tic_t>           cur_time{0};
+  size_t                       nof_free_timers = 0;
+  std::atomic<timer_impl*>     pending_head{nullptr};
+  std::atomic<std::thread::id> step_thread_id{std::thread::id{}};
+  // only accessed by the thread calling step_all()
+  tic_t wheel_tic         = 0; ///< tic of the last wheel cascade
+  tic_t wheel_min_timeout = 1; ///< earliest tic whose wheel slot has not been processed yet
   // using a deque to maintain reference validity on emplace_back. Also, this deque will only grow.
   std::deque<timer_impl>                                         timer_list;
   srsran::intrusive_forward_list<timer_impl>                     free_list;
   std::vector<srsran::intrusive_double_linked_list<timer_impl> > time_wheel;
-  mutable std::mutex                                             mutex; // Protect priority queue
+  mutable std::mutex                                             mutex; // Protect timer allocation and callbacks
 };
 
 using unique_timer = timer_handler::unique_timer;
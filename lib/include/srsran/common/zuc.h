@@ -56,4 +56,8 @@ typedef struct {
 void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv);
 void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream);
 
+/* Initializes nof_streams independent keystreams with the keys k and ivs iv and generates len[i] words of keystream
+ * i into ks[i]. The keystreams are generated in parallel, as many as the SIMD registers of the target can hold. */
+void zuc_generate_keystream_multi(u32 nof_streams, const u8 k[][16], const u8 iv[][16], const u32* len, u32* const* ks);
+
 #endif // SRSRAN_ZUC_H
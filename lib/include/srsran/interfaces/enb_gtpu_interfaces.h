@@ -34,6 +34,7 @@ struct gtpu_args_t {
   std::string embms_m1u_if_addr;
   bool        embms_enable                 = false;
   uint32_t    indirect_tunnel_timeout_msec = 0;
+  uint32_t    max_tunnels                  = 0; ///< Size of the TEID table. 0 fits the tunnels of SRSENB_MAX_UES UEs
 };
 
 // GTPU interface for PDCP
@@ -35,6 +35,7 @@ struct mac_args_t {
   uint32_t                      nof_prealloc_ues; ///< Number of UE resources to pre-allocate at eNB startup
   uint32_t                      max_nof_kos;
   int                           rlf_min_ul_snr_estim;
+  uint32_t                      pusch_softbuffer_bits; ///< Bits per soft bit in the UL HARQ softbuffers (16, 8, 4)
 };
 
 /* Interface PHY -> MAC */
@@ -116,6 +116,8 @@ public:
   virtual bool modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtpc_f_teid_ie dw_user_fteid, uint32_t up_ctrl_teid) = 0;
   virtual bool delete_gtpu_tunnel(in_addr_t ue_ipv4)                                                              = 0;
   virtual bool delete_gtpc_tunnel(in_addr_t ue_ipv4)                                                              = 0;
+  virtual bool add_uplink_tunnel(uint32_t up_user_teid, in_addr_t ue_ipv4)                                        = 0;
+  virtual bool delete_uplink_tunnel(uint32_t up_user_teid)                                                        = 0;
   virtual void send_all_queued_packets(srsran::gtp_fteid_t                       dw_user_fteid,
                                        std::queue<srsran::unique_byte_buffer_t>& pkt_queue)                       = 0;
 };
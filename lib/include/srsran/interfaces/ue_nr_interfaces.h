@@ -242,6 +242,7 @@ struct phy_args_nr_t {
     dl.pdsch.measure_time     = true;
     dl.pdsch.sch.disable_simd = false;
     dl.pdsch.sch.max_nof_iter = 10;
+    dl.pdcch.polar_list_size  = 1;
     ul.nof_max_prb            = 106;
     ul.pusch.max_prb          = 106;
     ul.pusch.max_layers       = 1;
@@ -24,6 +24,7 @@
 
 #include "pdcp_interface_types.h"
 #include "srsran/common/byte_buffer.h"
+#include <vector>
 
 namespace srsue {
 
@@ -82,6 +83,13 @@ public:
   virtual bool is_registered()         = 0;
   virtual bool start_service_request() = 0;
   virtual void write_sdu(uint32_t eps_bearer_id, srsran::unique_byte_buffer_t sdu) = 0;
+  ///< Push a batch of SDUs for the same EPS bearer, e.g. the segments of a TCP super-packet read from the TUN device
+  virtual void write_sdus(uint32_t eps_bearer_id, std::vector<srsran::unique_byte_buffer_t> sdus)
+  {
+    for (srsran::unique_byte_buffer_t& sdu : sdus) {
+      write_sdu(eps_bearer_id, std::move(sdu));
+    }
+  }
   ///< Allow GW to query if a radio bearer for a given EPS bearer ID is currently active
   virtual bool has_active_radio_bearer(uint32_t eps_bearer_id) = 0;
 };
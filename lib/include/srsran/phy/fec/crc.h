@@ -38,6 +38,8 @@
 
 typedef struct SRSRAN_API {
   uint64_t table[256];
+  uint32_t table8[8][256]; ///< Slicing-by-8 tables, with the CRC aligned to the MSB of a 32 bit word
+  uint64_t fold_k[4];      ///< x^192, x^128, x^576 and x^512 modulo the polynomial, for carry-less multiply folding
   int      polynom;
   int      order;
   uint64_t crcinit;
@@ -32,19 +32,31 @@
 #define SRSRAN_SOFTBUFFER_H
 
 #include "srsran/config.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Storage of the soft bits combined across HARQ retransmissions
+ */
+typedef enum SRSRAN_API {
+  SRSRAN_SOFTBUFFER_LLR_16BIT = 0, ///< One 16-bit word per soft bit
+  SRSRAN_SOFTBUFFER_LLR_8BIT,      ///< One byte per soft bit, saturated
+  SRSRAN_SOFTBUFFER_LLR_4BIT,      ///< Two soft bits per byte, quantized and saturated
+} srsran_softbuffer_llr_t;
+
 typedef struct SRSRAN_API {
-  uint32_t  max_cb;
-  uint32_t  max_cb_size;
-  int16_t** buffer_f;
-  uint8_t** data;
-  bool*     cb_crc;
-  bool      tb_crc;
+  uint32_t                max_cb;
+  uint32_t                max_cb_size;
+  int16_t**               buffer_f;     ///< Soft bits of every code block, in the llr_format representation
+  uint8_t*                cb_llr_shift; ///< Scale of the 4-bit soft bits of every code block, as an LLR right shift
+  uint8_t**               data;
+  bool*                   cb_crc;
+  bool                    tb_crc;
+  srsran_softbuffer_llr_t llr_format;
 } srsran_softbuffer_rx_t;
 
 typedef struct SRSRAN_API {
@@ -67,6 +79,29 @@ SRSRAN_API int srsran_softbuffer_rx_init(srsran_softbuffer_rx_t* q, uint32_t nof
  */
 SRSRAN_API int srsran_softbuffer_rx_init_guru(srsran_softbuffer_rx_t* q, uint32_t max_cb, uint32_t max_cb_size);
 
+/**
+ * @brief Initialises Rx soft-buffer for a number of code blocks and their size, storing the soft bits in a compressed
+ * representation
+ * @param q The Rx soft-buffer pointer
+ * @param max_cb The maximum number of code blocks to allocate
+ * @param max_cb_size The code block size to allocate, in soft bits
+ * @param llr_format Soft bit representation
+ * @return It returns SRSRAN_SUCCESS if it allocates the soft-buffer successfully, otherwise it returns SRSRAN_ERROR
+ * code
+ */
+SRSRAN_API int srsran_softbuffer_rx_init_llr(srsran_softbuffer_rx_t* q,
+                                             uint32_t                max_cb,
+                                             uint32_t                max_cb_size,
+                                             srsran_softbuffer_llr_t llr_format);
+
+/**
+ * @brief Number of bytes taken by a number of soft bits
+ * @param llr_format Soft bit representation
+ * @param nof_llr Number of soft bits
+ * @return The number of bytes
+ */
+SRSRAN_API uint32_t srsran_softbuffer_llr_nof_bytes(srsran_softbuffer_llr_t llr_format, uint32_t nof_llr);
+
 SRSRAN_API void srsran_softbuffer_rx_reset(srsran_softbuffer_rx_t* p);
 
 SRSRAN_API void srsran_softbuffer_rx_reset_tbs(srsran_softbuffer_rx_t* q, uint32_t tbs);
@@ -31,6 +31,7 @@
 #define SRSRAN_RM_TURBO_H
 
 #include "srsran/config.h"
+#include "srsran/phy/fec/softbuffer.h"
 #include "srsran/phy/fec/turbo/turbodecoder.h"
 
 #ifndef SRSRAN_RX_NULL
@@ -86,4 +87,35 @@ SRSRAN_API int srsran_rm_turbo_rx_lut_(int16_t* input,
 SRSRAN_API int
 srsran_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx);
 
+/**
+ * Undoes rate matching for LTE Turbo Coder and soft-combines the result with the previous transmissions of the code
+ * block. Compressed soft-buffers are combined with saturation and updated with the compressed result.
+ *
+ * @param[in] input Input buffer of size in_len
+ * @param[out] output Combined LLRs for the turbo decoder, buffer of at least SOFTBUFFER_SIZE LLRs
+ * @param[in,out] w_buff Code block soft-buffer
+ * @param[in] w_format Soft bit representation of the soft-buffer
+ * @param[in,out] w_shift Scale of the 4-bit soft bits of the code block, updated after combining. Unused otherwise
+ * @param[in] cb_idx Code block table index
+ * @param[in] rv_idx Redundancy Version from DCI control message
+ * @return Error code
+ */
+SRSRAN_API int srsran_rm_turbo_rx_lut_combine(int16_t*                input,
+                                              int16_t*                output,
+                                              void*                   w_buff,
+                                              srsran_softbuffer_llr_t w_format,
+                                              uint8_t*                w_shift,
+                                              uint32_t                in_len,
+                                              uint32_t                cb_idx,
+                                              uint32_t                rv_idx);
+
+SRSRAN_API int srsran_rm_turbo_rx_lut_combine_8bit(int8_t*                 input,
+                                                   int8_t*                 output,
+                                                   void*                   w_buff,
+                                                   srsran_softbuffer_llr_t w_format,
+                                                   uint8_t*                w_shift,
+                                                   uint32_t                in_len,
+                                                   uint32_t                cb_idx,
+                                                   uint32_t                rv_idx);
+
 #endif // SRSRAN_RM_TURBO_H
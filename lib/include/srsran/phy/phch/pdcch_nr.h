@@ -45,9 +45,10 @@
  * @brief PDCCH configuration initialization arguments
  */
 typedef struct {
-  bool disable_simd;
-  bool measure_evm;
-  bool measure_time;
+  bool     disable_simd;
+  bool     measure_evm;
+  bool     measure_time;
+  uint32_t polar_list_size; ///< CRC-aided SCL polar decoder list size, 0 or 1 selects the SSC decoder
 } srsran_pdcch_nr_args_t;
 
 /**
@@ -66,6 +67,7 @@ typedef struct SRSRAN_API {
   uint8_t*               d;         // encoded bits
   uint8_t*               f;         // bits at the Rate matching output
   uint8_t*               allocated; // Allocated polar bit buffer, encoder input, decoder output
+  uint8_t*               candidates[SRSRAN_POLAR_DECODER_MAX_LIST_SIZE]; // List decoder outputs, first is allocated
   cf_t*                  symbols;
   srsran_modem_table_t   modem_table;
   srsran_evm_buffer_t*   evm_buffer;
@@ -85,6 +85,7 @@ typedef struct SRSRAN_API {
   srsran_uci_value_t uci;
   bool               crc;
   float              avg_iterations_block;
+  uint32_t           decode_time_us;
   float              evm;
   float              epre_dbfs;
 } srsran_pusch_res_t;
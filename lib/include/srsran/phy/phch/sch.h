@@ -53,11 +53,13 @@ typedef struct SRSRAN_API {
 
   uint32_t max_iterations;
   float    avg_iterations;
+  uint32_t decode_time_us; ///< Time spent decoding the code blocks of the last transport block, if it was measured
 
   bool llr_is_8bit;
 
   /* buffers */
   uint8_t*         cb_in;
+  int16_t*         llr_buffer;
   uint8_t*         parity_bits;
   void*            e;
   uint8_t*         temp_g_bits;
@@ -71,6 +73,9 @@ typedef struct SRSRAN_API {
 
   srsran_uci_cqi_pusch_t uci_cqi;
 
+  /* Code block decoder threads, NULL if the code blocks are decoded by the calling thread */
+  void* decoder_pool;
+
 } srsran_sch_t;
 
 SRSRAN_API int srsran_sch_init(srsran_sch_t* q);
@@ -81,6 +86,17 @@ SRSRAN_API void srsran_sch_set_max_noi(srsran_sch_t* q, uint32_t max_iterations)
 
 SRSRAN_API float srsran_sch_last_noi(srsran_sch_t* q);
 
+/**
+ * Starts nof_threads - 1 threads that decode, together with the calling thread, the code blocks of a transport block
+ * in parallel. Setting nof_threads to 0 or 1 stops the threads, so the code blocks are decoded one after the other.
+ * @param q SCH object, it must be initialised
+ * @param nof_threads Number of decoding threads, including the calling thread
+ * @return SRSRAN_SUCCESS if the threads are started, SRSRAN_ERROR otherwise
+ */
+SRSRAN_API int srsran_sch_set_decoder_threads(srsran_sch_t* q, uint32_t nof_threads);
+
+SRSRAN_API uint32_t srsran_sch_last_decode_time_us(srsran_sch_t* q);
+
 SRSRAN_API int srsran_dlsch_encode(srsran_sch_t* q, srsran_pdsch_cfg_t* cfg, uint8_t* data, uint8_t* e_bits);
 
 SRSRAN_API int srsran_dlsch_encode2(srsran_sch_t*       q,
@@ -76,6 +76,9 @@ typedef struct SRSRAN_API {
   /// LDPC Rate matcher
   srsran_ldpc_rm_t tx_rm;
   srsran_ldpc_rm_t rx_rm;
+
+  /// Code block decoder threads, NULL if all the code blocks are decoded by the calling thread
+  void* decoder_pool;
 } srsran_sch_nr_t;
 
 /**
@@ -85,7 +88,8 @@ typedef struct SRSRAN_API {
   bool     disable_simd;
   bool     decoder_use_flooded;
   float    decoder_scaling_factor;
-  uint32_t max_nof_iter; ///< Maximum number of LDPC iterations
+  uint32_t max_nof_iter;        ///< Maximum number of LDPC iterations
+  uint32_t nof_decoder_threads; ///< Number of threads decoding the code blocks of a TB, including the caller
 } srsran_sch_nr_args_t;
 
 /**
@@ -114,7 +114,7 @@ private:
   rlc_am_config_t cfg = {};
 
   // TX SDU buffers
-  unique_byte_buffer_t tx_sdu;
+  shared_byte_buffer_t tx_sdu;
 
   /****************************************************************************
    * State variables and counters
@@ -52,6 +52,10 @@ public:
 
   /// Returns true when the backend has been started, otherwise false.
   virtual bool is_running() const = 0;
+
+  /// Returns the number of log entries that have been discarded because the
+  /// backend queues were full.
+  virtual uint64_t get_nof_dropped_entries() const = 0;
 };
 
 } // namespace detail
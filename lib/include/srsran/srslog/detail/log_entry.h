@@ -48,6 +48,12 @@ struct log_entry {
   std::unique_ptr<flush_backend_cmd>                                             flush_cmd;
 };
 
+/// Orders log entries by their timestamp, so that the backend can merge the
+/// entries generated by different threads.
+struct log_entry_time_order {
+  bool operator()(const log_entry& lhs, const log_entry& rhs) const { return lhs.metadata.tp < rhs.metadata.tp; }
+};
+
 } // namespace detail
 
 } // namespace srslog
@@ -27,4 +27,9 @@
 #define SRSLOG_QUEUE_CAPACITY 8192
 #endif
 
+/// Capacity of the queue that each thread uses to send log entries to the backend. Must be a power of two.
+#ifndef SRSLOG_THREAD_QUEUE_CAPACITY
+#define SRSLOG_THREAD_QUEUE_CAPACITY 2048
+#endif
+
 #endif // SRSLOG_DETAIL_SUPPORT_BACKEND_CAPACITY_H
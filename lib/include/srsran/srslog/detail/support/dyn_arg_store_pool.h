@@ -24,6 +24,8 @@
 
 #include "srsran/srslog/bundled/fmt/printf.h"
 #include "srsran/srslog/detail/support/backend_capacity.h"
+#include <atomic>
+#include <vector>
 
 namespace srslog {
 
@@ -32,52 +34,99 @@ namespace detail {
 /// Keeps a pool of dynamic_format_arg_store objects. The main reason for this class is that the arg store objects are
 /// implemented with std::vectors, so we want to avoid allocating memory each time we create a new object. Instead,
 /// reserve memory for each vector during initialization and recycle the objects.
+/// The free objects are kept in a bounded lock-free MPMC queue, so that the threads generating log entries never
+/// block on each other or on the backend.
 class dyn_arg_store_pool
 {
+  using store_type = fmt::dynamic_format_arg_store<fmt::printf_context>;
+
+  struct cell {
+    std::atomic<size_t> seq;
+    store_type*         ptr;
+  };
+
 public:
-  dyn_arg_store_pool()
+  dyn_arg_store_pool() : pool(SRSLOG_QUEUE_CAPACITY), free_list(free_list_size())
   {
-    pool.resize(SRSLOG_QUEUE_CAPACITY);
+    for (size_t i = 0, e = free_list.size(); i != e; ++i) {
+      free_list[i].seq.store(i, std::memory_order_relaxed);
+    }
     for (auto& elem : pool) {
       // Reserve for 10 normal and 2 named arguments.
       elem.reserve(10, 2);
-    }
-    free_list.reserve(SRSLOG_QUEUE_CAPACITY);
-    for (auto& elem : pool) {
-      free_list.push_back(&elem);
+      dealloc_(&elem);
     }
   }
 
   /// Returns a pointer to a free dyn arg store object, otherwise returns nullptr.
-  fmt::dynamic_format_arg_store<fmt::printf_context>* alloc()
+  store_type* alloc()
   {
-    scoped_lock lock(m);
-    if (free_list.empty()) {
-      return nullptr;
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell&  c   = free_list[pos & (free_list.size() - 1)];
+      size_t seq = c.seq.load(std::memory_order_acquire);
+      auto   dif = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (dif == 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          store_type* p = c.ptr;
+          c.seq.store(pos + free_list.size(), std::memory_order_release);
+          return p;
+        }
+      } else if (dif < 0) {
+        return nullptr;
+      } else {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
     }
-
-    auto* p = free_list.back();
-    free_list.pop_back();
-
-    return p;
   }
 
   /// Deallocate the given dyn arg store object returning it to the pool.
-  void dealloc(fmt::dynamic_format_arg_store<fmt::printf_context>* p)
+  void dealloc(store_type* p)
   {
     if (!p) {
       return;
     }
 
     p->clear();
-    scoped_lock lock(m);
-    free_list.push_back(p);
+    dealloc_(p);
   }
 
 private:
-  std::vector<fmt::dynamic_format_arg_store<fmt::printf_context> > pool;
-  std::vector<fmt::dynamic_format_arg_store<fmt::printf_context>*> free_list;
-  mutable mutex                                                    m;
+  static size_t free_list_size()
+  {
+    size_t size = 1;
+    while (size < SRSLOG_QUEUE_CAPACITY) {
+      size <<= 1;
+    }
+    return size;
+  }
+
+  void dealloc_(store_type* p)
+  {
+    // The free list has room for all the objects of the pool, so it never gets full.
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell&  c   = free_list[pos & (free_list.size() - 1)];
+      size_t seq = c.seq.load(std::memory_order_acquire);
+      if (seq == pos) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          c.ptr = p;
+          c.seq.store(pos + 1, std::memory_order_release);
+          return;
+        }
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  std::vector<store_type> pool;
+  std::vector<cell>       free_list;
+  char                    pad0[64];
+  std::atomic<size_t>     enqueue_pos{0};
+  char                    pad1[64];
+  std::atomic<size_t>     dequeue_pos{0};
+  char                    pad2[64];
 };
 
 } // namespace detail
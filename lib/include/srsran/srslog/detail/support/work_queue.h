@@ -22,26 +22,125 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 #define SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 
-#include "srsran/adt/circular_buffer.h"
 #include "srsran/srslog/detail/support/backend_capacity.h"
 #include "srsran/srslog/detail/support/thread_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace srslog {
 
 namespace detail {
 
-//: TODO: this is a temp work queue.
+/// Bounded lock-free queue with a single producer and a single consumer.
+template <typename T>
+class spsc_queue
+{
+public:
+  explicit spsc_queue(size_t capacity) : slots(capacity), mask(capacity - 1)
+  {
+    assert(capacity > 0 && (capacity & mask) == 0 && "Capacity must be a power of two");
+  }
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  /// Inserts a new element into the back of the queue. Returns false when the
+  /// queue is full, in which case the value is left untouched.
+  /// NOTE: Should only be called by the producer.
+  bool try_push(T&& value)
+  {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - cached_head == slots.size()) {
+      cached_head = head.load(std::memory_order_acquire);
+      if (t - cached_head == slots.size()) {
+        return false;
+      }
+    }
+    slots[t & mask] = std::move(value);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Returns a pointer to the front element of the queue, or nullptr when it is
+  /// empty.
+  /// NOTE: Should only be called by the consumer.
+  T* front()
+  {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == cached_tail) {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if (h == cached_tail) {
+        return nullptr;
+      }
+    }
+    return &slots[h & mask];
+  }
+
+  /// Removes the front element of the queue, which must exist.
+  /// NOTE: Should only be called by the consumer.
+  void pop() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
 
-/// Thread safe generic data type work queue.
-template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY>
+  /// Returns the number of elements in the queue. The value may be outdated
+  /// when called concurrently with push and pop operations.
+  size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+  size_t capacity() const { return slots.size(); }
+
+private:
+  std::vector<T> slots;
+  const size_t   mask;
+  // Producer and consumer indexes are kept in separate cache lines to avoid
+  // false sharing.
+  char                pad0[64];
+  std::atomic<size_t> tail{0};
+  size_t              cached_head = 0;
+  char                pad1[64];
+  std::atomic<size_t> head{0};
+  size_t              cached_tail = 0;
+  char                pad2[64];
+};
+
+/// Default ordering of the work queue, where entries of different producers
+/// are popped in a round-robin fashion.
+struct round_robin_order {
+  template <typename T>
+  bool operator()(const T& lhs, const T& rhs) const
+  {
+    return false;
+  }
+};
+
+/// Returns a unique identifier for each work queue instance.
+inline uint64_t get_new_work_queue_id()
+{
+  static std::atomic<uint64_t> next_id{0};
+  return next_id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+/// Thread safe generic data type work queue with multiple producers and a
+/// single consumer. Each producer thread pushes elements into its own lock-free
+/// queue, which is created the first time the thread pushes to the work queue.
+/// The consumer merges the queues of all producers, popping first the element
+/// that goes first according to Compare. Elements pushed into a full producer
+/// queue are discarded and counted.
+template <typename T, size_t capacity = SRSLOG_THREAD_QUEUE_CAPACITY, typename Compare = round_robin_order>
 class work_queue
 {
-  srsran::dyn_circular_buffer<T> queue;
-  mutable mutex                  m;
-  static constexpr size_t        threshold = capacity * 0.98;
+  struct producer_queue {
+    producer_queue() : queue(capacity) {}
+
+    spsc_queue<T>         queue;
+    std::atomic<uint64_t> nof_dropped{0};
+  };
+
+  static constexpr size_t threshold = capacity * 0.98;
 
 public:
-  work_queue() : queue(capacity) {}
+  work_queue() = default;
 
   work_queue(const work_queue&) = delete;
   work_queue& operator=(const work_queue&) = delete;
@@ -50,64 +149,155 @@ public:
   /// queue is full, otherwise true.
   bool push(const T& value)
   {
-    m.lock();
-    // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
-      return false;
-    }
-    queue.push(value);
-    m.unlock();
-
-    return true;
+    T copy = value;
+    return push(std::move(copy));
   }
 
   /// Inserts a new element into the back of the queue. Returns false when the
   /// queue is full, otherwise true.
   bool push(T&& value)
   {
-    m.lock();
+    producer_queue& q = get_producer_queue();
     // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
+    if (!q.queue.try_push(std::move(value))) {
+      // Only the producer writes the counter, no need for an atomic increment.
+      q.nof_dropped.store(q.nof_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
       return false;
     }
-    queue.push(std::move(value));
-    m.unlock();
-
     return true;
   }
 
   /// Extracts the top most element from the queue if it exists.
   /// Returns a pair with a bool indicating if the pop has been successful.
+  /// NOTE: Should only be called by the consumer.
   std::pair<bool, T> try_pop()
   {
-    m.lock();
+    update_consumer_view();
 
-    if (queue.empty()) {
-      m.unlock();
-      return {false, T()};
+    producer_queue* selected = nullptr;
+    T*              top      = nullptr;
+    for (size_t i = 0, e = consumer_view.size(); i != e; ++i) {
+      producer_queue* q    = consumer_view[(next_idx + i) % e];
+      T*              item = q->queue.front();
+      if (item && (!top || Compare()(*item, *top))) {
+        selected = q;
+        top      = item;
+      }
     }
 
-    // Here we have been woken up normally.
-    T Item = std::move(queue.top());
-    queue.pop();
-
-    m.unlock();
+    if (!top) {
+      return {false, T()};
+    }
 
-    return {true, std::move(Item)};
+    next_idx = (next_idx + 1) % consumer_view.size();
+    T item   = std::move(*top);
+    selected->queue.pop();
+    return {true, std::move(item)};
   }
 
-  /// Capacity of the queue.
+  /// Capacity of the queue of each producer.
   size_t get_capacity() const { return capacity; }
 
-  /// Returns true when the queue is almost full, otherwise returns false.
+  /// Returns true when the queue of any producer is almost full, otherwise
+  /// returns false.
+  /// NOTE: Should only be called by the consumer.
   bool is_almost_full() const
+  {
+    for (const producer_queue* q : consumer_view) {
+      if (q->queue.size() > threshold) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Returns the number of elements that have been discarded because the
+  /// queue was full.
+  uint64_t get_nof_dropped() const
   {
     scoped_lock lock(m);
+    uint64_t    count = nof_dropped_removed;
+    for (const auto& q : producers) {
+      count += q->nof_dropped.load(std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+private:
+  /// Returns the queue of the calling thread, creating it if it does not exist.
+  producer_queue& get_producer_queue()
+  {
+    // Queues of the calling thread in each work queue instance. A thread usually
+    // pushes to a single instance, so a linear search is enough.
+    static thread_local std::vector<std::pair<uint64_t, std::shared_ptr<producer_queue> > > thread_queues;
 
-    return queue.size() > threshold;
+    for (const auto& e : thread_queues) {
+      if (e.first == id) {
+        return *e.second;
+      }
+    }
+
+    // Release the queues of the work queue instances that have been destroyed.
+    thread_queues.erase(std::remove_if(thread_queues.begin(),
+                                       thread_queues.end(),
+                                       [](const std::pair<uint64_t, std::shared_ptr<producer_queue> >& e) {
+                                         return e.second.use_count() == 1;
+                                       }),
+                        thread_queues.end());
+
+    std::shared_ptr<producer_queue> q = std::make_shared<producer_queue>();
+    {
+      scoped_lock lock(m);
+      producers.push_back(q);
+      version.fetch_add(1, std::memory_order_release);
+    }
+    thread_queues.emplace_back(id, q);
+    return *q;
   }
+
+  /// Refreshes the list of producer queues seen by the consumer, and releases
+  /// the queues of the threads that have finished once they are empty.
+  void update_consumer_view()
+  {
+    if (version.load(std::memory_order_acquire) == consumer_version && ++nof_pops_since_cleanup < cleanup_period) {
+      return;
+    }
+    nof_pops_since_cleanup = 0;
+
+    scoped_lock lock(m);
+    for (auto it = producers.begin(); it != producers.end();) {
+      // The work queue holds the last reference once the producer thread has exited.
+      if (it->use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((*it)->queue.front() == nullptr) {
+          nof_dropped_removed += (*it)->nof_dropped.load(std::memory_order_relaxed);
+          it = producers.erase(it);
+          continue;
+        }
+      }
+      ++it;
+    }
+    consumer_version = version.load(std::memory_order_relaxed);
+    consumer_view.clear();
+    for (const auto& q : producers) {
+      consumer_view.push_back(q.get());
+    }
+    next_idx = 0;
+  }
+
+  static constexpr unsigned cleanup_period = 1024;
+
+  const uint64_t                                id = get_new_work_queue_id();
+  mutable mutex                                 m;
+  std::vector<std::shared_ptr<producer_queue> > producers;
+  std::atomic<uint64_t>                         version{0};
+  uint64_t                                      nof_dropped_removed = 0;
+
+  // Consumer side state.
+  std::vector<producer_queue*> consumer_view;
+  uint64_t                     consumer_version       = 0;
+  unsigned                     nof_pops_since_cleanup = 0;
+  size_t                       next_idx               = 0;
 };
 
 } // namespace detail
@@ -195,6 +195,15 @@ sink& fetch_file_sink(const std::string&             path,
                       bool                           force_flush = false,
                       std::unique_ptr<log_formatter> f           = get_default_log_formatter());
 
+/// Returns an instance of a sink that writes log entries in a compact binary
+/// form into a memory mapped file in the specified path. Instead of formatting
+/// the messages, the sink stores the format string ids and the raw arguments,
+/// which are rendered later with the srslog_decode tool.
+/// Specifying a max_size value different to zero will make the sink create a
+/// new file each time the current file exceeds this value. The units of
+/// max_size are bytes.
+sink& fetch_binary_file_sink(const std::string& path, size_t max_size = 0);
+
 /// Returns an instance of a sink that writes into syslog
 /// preamble: The string  prepended to every message, If ident is "", the program name is used.
 /// log_local: custom unused facilities that syslog provides which can be used by the user
@@ -249,6 +258,10 @@ void init(backend_priority priority = backend_priority::normal);
 /// NOTE: This function does nothing if init() has not been called.
 void flush();
 
+/// Returns the number of log entries that have been discarded since init()
+/// because the backend could not keep up with the rate of generated entries.
+uint64_t get_nof_dropped_entries();
+
 /// Installs the specified error handler to receive any error messages generated
 /// by the framework.
 /// NOTE: This function should be called before init() and is NOT thread safe.
@@ -120,6 +120,8 @@ public:
 
   // GW/SDAP/RRC interface
   virtual void write_sdu(unique_byte_buffer_t sdu, int sn = -1) = 0;
+  // Writes several SDUs at once, so that they are ciphered in a single batch
+  virtual void write_sdus(std::vector<unique_byte_buffer_t> sdus);
 
   // RLC interface
   virtual void write_pdu(unique_byte_buffer_t pdu)               = 0;
@@ -169,11 +171,20 @@ protected:
 
   srsran::as_security_config_t sec_cfg = {};
 
+  // Key schedules of the AES based algorithms, expanded once when security is configured
+  aes128_key_ctx k_rrc_enc_ctx;
+  aes128_key_ctx k_up_enc_ctx;
+  aes128_key_ctx k_rrc_int_ctx;
+  aes128_key_ctx k_up_int_ctx;
+  // Scratch buffer of the TX batches
+  std::vector<security_batch_pdu_t> tx_cipher_batch;
+
   // Security functions
   void integrity_generate(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
   bool integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
   void cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* ct);
   void cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t count, uint8_t* msg);
+  void cipher_encrypt_batch(span<const security_batch_pdu_t> pdus);
 
   // Common packing functions
   bool            is_control_pdu(const unique_byte_buffer_t& pdu);
@@ -24,6 +24,7 @@
 
 #include "srsran/adt/circular_array.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/byte_buffer_chain.h"
 #include "srsran/common/common.h"
 #include "srsran/common/security.h"
 #include "srsran/common/threads.h"
@@ -51,7 +52,7 @@ public:
   bool            has_sdu(uint32_t sn) const
   {
     assert(sn != invalid_sn && "provided PDCP SN is invalid");
-    return sdus[sn].sdu != nullptr and sdus[sn].sdu->md.pdcp_sn == sn;
+    return sdus[sn].sdu.has_value() and sdus[sn].sdu.md.pdcp_sn == sn;
   }
   // Getter for the number of discard timers. Used for debugging.
   size_t nof_discard_timers() const;
@@ -61,7 +62,7 @@ public:
                uint32_t                              discard_timeout,
                srsran::move_callback<void(uint32_t)> callback);
 
-  unique_byte_buffer_t& operator[](uint32_t sn)
+  byte_buffer_chain& operator[](uint32_t sn)
   {
     assert(has_sdu(sn));
     return sdus[sn].sdu;
@@ -86,9 +87,10 @@ private:
 
   uint32_t increment_sn(uint32_t sn) { return (sn + 1) % sn_mod; }
 
+  // SDU copies are stored in size-classed segments, so that their memory footprint is proportional to their length.
   struct sdu_data {
-    srsran::unique_byte_buffer_t sdu;
-    srsran::unique_timer         discard_timer;
+    srsran::byte_buffer_chain sdu;
+    srsran::unique_timer      discard_timer;
   };
 
   uint32_t                                   count = 0;
@@ -126,6 +128,7 @@ public:
 
   // GW/RRC interface
   void write_sdu(unique_byte_buffer_t sdu, int sn = -1) override;
+  void write_sdus(std::vector<unique_byte_buffer_t> sdus) override;
 
   // RLC interface
   void write_pdu(unique_byte_buffer_t pdu) override;
@@ -166,6 +169,11 @@ private:
   uint32_t reordering_window = 0;
   uint32_t maximum_pdcp_sn   = 0;
 
+  // TX helpers. PDUs are built before being ciphered, so that several of them can be ciphered at once.
+  bool                  prepare_tx_pdu(unique_byte_buffer_t& sdu, int upper_sn, uint32_t& tx_count);
+  void                  send_tx_pdu(unique_byte_buffer_t pdu, uint32_t tx_count);
+  std::vector<uint32_t> tx_batch_counts;
+
   // PDU handlers
   void handle_control_pdu(srsran::unique_byte_buffer_t pdu);
   void handle_srb_pdu(srsran::unique_byte_buffer_t pdu);
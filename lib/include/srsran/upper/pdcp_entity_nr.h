@@ -55,6 +55,7 @@ public:
 
   // RRC interface
   void write_sdu(unique_byte_buffer_t sdu, int sn = -1) final;
+  void write_sdus(std::vector<unique_byte_buffer_t> sdus) final;
 
   // RLC interface
   void write_pdu(unique_byte_buffer_t pdu) final;
@@ -102,6 +103,11 @@ private:
   std::map<uint32_t, unique_byte_buffer_t> reorder_queue;
   timer_handler::unique_timer              reordering_timer;
 
+  // TX helpers. PDUs are built before being ciphered, so that several of them can be ciphered at once.
+  bool                  prepare_tx_pdu(unique_byte_buffer_t& sdu, uint32_t& tx_count);
+  void                  send_tx_pdu(unique_byte_buffer_t pdu, uint32_t tx_count);
+  std::vector<uint32_t> tx_batch_counts;
+
   // Pass to Upper Layers Helper function
   void deliver_all_consecutive_counts();
   void pass_to_upper_layers(unique_byte_buffer_t pdu);
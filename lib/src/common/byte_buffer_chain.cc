@@ -0,0 +1,243 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/byte_buffer_chain.h"
+#include "srsran/common/buffer_pool.h"
+
+namespace srsran {
+
+using small_block_pool  = concurrent_fixed_memory_pool<byte_buffer_small_block_size>;
+using medium_block_pool = concurrent_fixed_memory_pool<byte_buffer_medium_block_size>;
+
+static const size_t nof_small_blocks  = 16384;
+static const size_t nof_medium_blocks = 8192;
+
+static_assert(byte_buffer_chain_headroom + sizeof(detail::byte_buffer_segment) < byte_buffer_small_block_size,
+              "The small block size must fit the chain headroom");
+
+byte_buffer_chain::byte_buffer_chain(byte_buffer_chain&& other) noexcept :
+  md(other.md), head(other.head), tail(other.tail), nof_bytes(other.nof_bytes)
+{
+  other.head      = nullptr;
+  other.tail      = nullptr;
+  other.nof_bytes = 0;
+}
+
+byte_buffer_chain& byte_buffer_chain::operator=(byte_buffer_chain&& other) noexcept
+{
+  if (&other == this) {
+    return *this;
+  }
+  clear();
+  md              = other.md;
+  head            = other.head;
+  tail            = other.tail;
+  nof_bytes       = other.nof_bytes;
+  other.head      = nullptr;
+  other.tail      = nullptr;
+  other.nof_bytes = 0;
+  return *this;
+}
+
+byte_buffer_chain::segment* byte_buffer_chain::allocate_segment(uint32_t min_len)
+{
+  byte_buffer_size_class cls        = byte_buffer_size_class::small;
+  size_t                 block_size = byte_buffer_small_block_size;
+  void*                  block      = nullptr;
+  if (min_len + sizeof(segment) <= byte_buffer_small_block_size) {
+    block = small_block_pool::get_instance(nof_small_blocks)->allocate_node(block_size);
+  } else {
+    cls        = byte_buffer_size_class::medium;
+    block_size = byte_buffer_medium_block_size;
+    block      = medium_block_pool::get_instance(nof_medium_blocks)->allocate_node(block_size);
+  }
+  if (block == nullptr) {
+    return nullptr;
+  }
+  segment* seg  = new (block) segment();
+  seg->cls      = cls;
+  seg->capacity = block_size - sizeof(segment);
+  return seg;
+}
+
+void byte_buffer_chain::deallocate_segment(segment* seg)
+{
+  byte_buffer_size_class cls = seg->cls;
+  seg->~segment();
+  if (cls == byte_buffer_size_class::small) {
+    small_block_pool::get_instance(nof_small_blocks)->deallocate_node(seg);
+  } else {
+    medium_block_pool::get_instance(nof_medium_blocks)->deallocate_node(seg);
+  }
+}
+
+size_t byte_buffer_chain::nof_segments() const
+{
+  size_t count = 0;
+  for (const segment* seg = head; seg != nullptr; seg = seg->next) {
+    count++;
+  }
+  return count;
+}
+
+bool byte_buffer_chain::reserve_headroom(uint32_t headroom)
+{
+  if (head != nullptr) {
+    return nof_bytes == 0 and head->get_headroom() >= headroom;
+  }
+  head = allocate_segment(headroom);
+  if (head == nullptr) {
+    return false;
+  }
+  head->offset = headroom;
+  tail         = head;
+  return true;
+}
+
+bool byte_buffer_chain::append(const uint8_t* bytes, uint32_t len)
+{
+  if (head == nullptr and not reserve_headroom()) {
+    return false;
+  }
+  uint32_t tailroom  = tail->get_tailroom();
+  uint32_t remaining = len > tailroom ? len - tailroom : 0;
+
+  // Allocate the extra segments beforehand, so that the chain is left unmodified on pool depletion
+  segment* first_new = nullptr;
+  segment* last_new  = nullptr;
+  while (remaining > 0) {
+    segment* seg = allocate_segment(remaining);
+    if (seg == nullptr) {
+      while (first_new != nullptr) {
+        segment* next = first_new->next;
+        deallocate_segment(first_new);
+        first_new = next;
+      }
+      return false;
+    }
+    if (last_new == nullptr) {
+      first_new = seg;
+    } else {
+      last_new->next = seg;
+    }
+    last_new = seg;
+    remaining -= std::min(remaining, seg->capacity);
+  }
+
+  // Fill the tailroom of the last segment, and then the new segments
+  uint32_t n = std::min(len, tailroom);
+  memcpy(tail->data() + tail->length, bytes, n);
+  tail->length += n;
+  for (segment* seg = first_new; seg != nullptr; seg = seg->next) {
+    uint32_t seg_len = std::min(len - n, seg->capacity);
+    memcpy(seg->data(), bytes + n, seg_len);
+    seg->length = seg_len;
+    n += seg_len;
+    tail->next = seg;
+    tail       = seg;
+  }
+  nof_bytes += len;
+  return true;
+}
+
+bool byte_buffer_chain::prepend(const uint8_t* bytes, uint32_t len)
+{
+  if (head == nullptr or head->get_headroom() < len) {
+    return false;
+  }
+  head->offset -= len;
+  head->length += len;
+  memcpy(head->data(), bytes, len);
+  nof_bytes += len;
+  return true;
+}
+
+void byte_buffer_chain::trim_head(uint32_t len)
+{
+  while (len > 0 and head != nullptr) {
+    uint32_t n = std::min(len, head->length);
+    head->offset += n;
+    head->length -= n;
+    nof_bytes -= n;
+    len -= n;
+    if (head->length == 0 and head->next != nullptr) {
+      segment* next = head->next;
+      deallocate_segment(head);
+      head = next;
+    } else if (n == 0) {
+      break;
+    }
+  }
+}
+
+void byte_buffer_chain::clear()
+{
+  while (head != nullptr) {
+    segment* next = head->next;
+    deallocate_segment(head);
+    head = next;
+  }
+  tail      = nullptr;
+  nof_bytes = 0;
+  md        = {};
+}
+
+uint32_t byte_buffer_chain::copy_to(uint8_t* dst, uint32_t max_len) const
+{
+  uint32_t n = 0;
+  for (const segment* seg = head; seg != nullptr and n < max_len; seg = seg->next) {
+    uint32_t seg_len = std::min(seg->length, max_len - n);
+    memcpy(dst + n, seg->data(), seg_len);
+    n += seg_len;
+  }
+  return n;
+}
+
+byte_buffer_chain make_byte_buffer_chain(const byte_buffer_t& buf) noexcept
+{
+  byte_buffer_chain chain;
+  if (not chain.reserve_headroom() or not chain.append(buf.msg, buf.N_bytes)) {
+    srslog::fetch_basic_logger("POOL").error("Failed to allocate byte buffer chain of %d bytes", buf.N_bytes);
+    chain.clear();
+    return chain;
+  }
+  chain.md = buf.md;
+  return chain;
+}
+
+unique_byte_buffer_t make_byte_buffer(const byte_buffer_chain& chain) noexcept
+{
+  unique_byte_buffer_t buf = make_byte_buffer();
+  if (buf == nullptr) {
+    srslog::fetch_basic_logger("POOL").error("Failed to allocate byte buffer to linearize byte buffer chain");
+    return buf;
+  }
+  if (buf->get_tailroom() < chain.length()) {
+    srslog::fetch_basic_logger("POOL").error(
+        "Failed to linearize byte buffer chain. Payload too large (%d > %d)", chain.length(), buf->get_tailroom());
+    return nullptr;
+  }
+  buf->N_bytes = chain.copy_to(buf->msg, chain.length());
+  buf->md      = chain.md;
+  return buf;
+}
+
+} // namespace srsran
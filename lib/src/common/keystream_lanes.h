@@ -0,0 +1,124 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_KEYSTREAM_LANES_H
+#define SRSRAN_KEYSTREAM_LANES_H
+
+/*
+ * 32-bit lane operations used by the multi-buffer SNOW 3G and ZUC keystream generators. Each lane of a register holds
+ * the state of an independent keystream, and the S-box lookups are done with gathers. KEYSTREAM_LANES_HAVE_SIMD is only
+ * defined when a SIMD type is available; otherwise the generators process one keystream at a time.
+ */
+
+#include <cstdint>
+#include <utility>
+
+#if defined(LV_HAVE_AVX512) || defined(LV_HAVE_AVX2)
+#include <immintrin.h>
+#define KEYSTREAM_LANES_HAVE_SIMD
+#endif // defined(LV_HAVE_AVX512) || defined(LV_HAVE_AVX2)
+
+namespace srsran {
+
+#ifdef LV_HAVE_AVX512
+
+/// The zero-masked forms of the shifts and the gather are used because the plain ones start from an undefined register,
+/// which some GCC versions report as uninitialized.
+struct keystream_lanes {
+  static constexpr uint32_t  nof_lanes = 16;
+  static constexpr __mmask16 all_lanes = 0xffff;
+  using reg_t                          = __m512i;
+
+  static reg_t load(const uint32_t* ptr) { return _mm512_loadu_si512(ptr); }
+  static void  store(uint32_t* ptr, reg_t a) { _mm512_storeu_si512(ptr, a); }
+  static reg_t set1(uint32_t x) { return _mm512_set1_epi32((int)x); }
+  static reg_t bxor(reg_t a, reg_t b) { return _mm512_xor_si512(a, b); }
+  static reg_t band(reg_t a, reg_t b) { return _mm512_and_si512(a, b); }
+  static reg_t bor(reg_t a, reg_t b) { return _mm512_or_si512(a, b); }
+  static reg_t add(reg_t a, reg_t b) { return _mm512_add_epi32(a, b); }
+  template <int N>
+  static reg_t shl(reg_t a)
+  {
+    return _mm512_maskz_slli_epi32(all_lanes, a, N);
+  }
+  template <int N>
+  static reg_t shr(reg_t a)
+  {
+    return _mm512_maskz_srli_epi32(all_lanes, a, N);
+  }
+  template <int N>
+  static reg_t rotl(reg_t a)
+  {
+    return _mm512_maskz_rol_epi32(all_lanes, a, N);
+  }
+  /// Looks up table[idx] in every lane
+  static reg_t lookup(const uint32_t* table, reg_t idx)
+  {
+    return _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), all_lanes, idx, table, 4);
+  }
+};
+
+#elif defined(LV_HAVE_AVX2)
+
+struct keystream_lanes {
+  static constexpr uint32_t nof_lanes = 8;
+  using reg_t                         = __m256i;
+
+  static reg_t load(const uint32_t* ptr) { return _mm256_loadu_si256((const __m256i*)ptr); }
+  static void  store(uint32_t* ptr, reg_t a) { _mm256_storeu_si256((__m256i*)ptr, a); }
+  static reg_t set1(uint32_t x) { return _mm256_set1_epi32((int)x); }
+  static reg_t bxor(reg_t a, reg_t b) { return _mm256_xor_si256(a, b); }
+  static reg_t band(reg_t a, reg_t b) { return _mm256_and_si256(a, b); }
+  static reg_t bor(reg_t a, reg_t b) { return _mm256_or_si256(a, b); }
+  static reg_t add(reg_t a, reg_t b) { return _mm256_add_epi32(a, b); }
+  template <int N>
+  static reg_t shl(reg_t a)
+  {
+    return _mm256_slli_epi32(a, N);
+  }
+  template <int N>
+  static reg_t shr(reg_t a)
+  {
+    return _mm256_srli_epi32(a, N);
+  }
+  template <int N>
+  static reg_t rotl(reg_t a)
+  {
+    return _mm256_or_si256(_mm256_slli_epi32(a, N), _mm256_srli_epi32(a, 32 - N));
+  }
+  /// Looks up table[idx] in every lane
+  static reg_t lookup(const uint32_t* table, reg_t idx) { return _mm256_i32gather_epi32((const int*)table, idx, 4); }
+};
+
+#endif // LV_HAVE_AVX512
+
+/// Calls func(std::integral_constant<uint32_t, I>) for I = 0..N-1, so that the LFSR positions are compile time
+/// constants.
+template <typename Func, uint32_t... I>
+inline void keystream_unroll(Func&& func, std::integer_sequence<uint32_t, I...>)
+{
+  int dummy[] = {(func(std::integral_constant<uint32_t, I>{}), 0)...};
+  (void)dummy;
+}
+
+} // namespace srsran
+
+#endif // SRSRAN_KEYSTREAM_LANES_H
@@ -32,27 +32,27 @@ mac_pcap::~mac_pcap()
 }
 
 uint32_t mac_pcap::open(std::string filename_, uint32_t ue_id_)
+{
+  return open(filename_, ue_id_, pcap_writer::args_t{});
+}
+
+uint32_t mac_pcap::open(std::string filename_, uint32_t ue_id_, const pcap_writer::args_t& writer_args)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  if (pcap_file != nullptr) {
+  if (writer.is_open()) {
     logger.error("PCAP writer for %s already running. Close first.", filename_.c_str());
     return SRSRAN_ERROR;
   }
 
   // set UDP DLT
-  dlt       = UDP_DLT;
-  pcap_file = DLT_PCAP_Open(dlt, filename_.c_str());
-  if (pcap_file == nullptr) {
+  dlt = UDP_DLT;
+  if (not writer.open(filename_, dlt, writer_args)) {
     logger.error("Couldn't open %s to write PCAP", filename_.c_str());
     return SRSRAN_ERROR;
   }
 
-  filename = filename_;
-  ue_id    = ue_id_;
-  running  = true;
-
-  // start writer thread
-  start();
+  ue_id   = ue_id_;
+  running = true;
 
   return SRSRAN_SUCCESS;
 }
@@ -61,43 +61,40 @@ uint32_t mac_pcap::close()
 {
   {
     std::lock_guard<std::mutex> lock(mutex);
-    if (running == false || pcap_file == nullptr) {
+    if (running == false || not writer.is_open()) {
       return SRSRAN_ERROR;
     }
-
-    // tell writer thread to stop
-    running        = false;
-    pcap_pdu_t pdu = {};
-    queue.push_blocking(std::move(pdu));
+    running = false;
   }
 
-  wait_thread_finish();
-
-  // close file handle
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    srsran::console("Saving MAC PCAP (DLT=%d) to %s\n", dlt, filename.c_str());
-    DLT_PCAP_Close(pcap_file);
-    pcap_file = nullptr;
-  }
+  // write the pending PDUs and close the file
+  srsran::console("Saving MAC PCAP (DLT=%d) to %s\n", dlt, writer.get_filename().c_str());
+  writer.close();
 
   return SRSRAN_SUCCESS;
 }
 
-void mac_pcap::write_pdu(srsran::mac_pcap_base::pcap_pdu_t& pdu)
+// The PDU is packed and handed over to the file writer by the calling thread
+void mac_pcap::queue_pdu(srsran::mac_pcap_base::pcap_pdu_t& pdu, const uint8_t* payload, uint32_t payload_len)
 {
-  if (pdu.pdu != nullptr) {
-    switch (pdu.rat) {
-      case srsran_rat_t::lte:
-        LTE_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context, pdu.pdu->msg, pdu.pdu->N_bytes);
-        break;
-      case srsran_rat_t::nr:
-        NR_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context_nr, pdu.pdu->msg, pdu.pdu->N_bytes);
-        break;
-      default:
-        logger.error("Error writing PDU to PCAP. Unsupported RAT selected.");
-    }
+  uint8_t context_header[PCAP_CONTEXT_HEADER_MAX];
+  int     context_len;
+  switch (pdu.rat) {
+    case srsran_rat_t::lte:
+      context_len = LTE_PCAP_PACK_MAC_UDP_CONTEXT_TO_BUFFER(
+          &pdu.context, context_header, sizeof(context_header), payload_len);
+      break;
+    case srsran_rat_t::nr:
+      context_len = NR_PCAP_PACK_MAC_UDP_CONTEXT_TO_BUFFER(
+          &pdu.context_nr, context_header, sizeof(context_header), payload_len);
+      break;
+    default:
+      logger.error("Error writing PDU to PCAP. Unsupported RAT selected.");
+      return;
+  }
+  if (not writer.write(context_header, context_len, payload, payload_len)) {
+    logger.debug("Dropping PDU (%d B) in PCAP. Write buffers full.", payload_len);
   }
 }
 
-} // namespace srsran
\ No newline at end of file
+} // namespace srsran
@@ -76,7 +76,23 @@ void mac_pcap_base::run_thread()
   }
 }
 
-// Function called from PHY worker context, locking not needed as PDU queue is thread-safe
+void mac_pcap_base::queue_pdu(pcap_pdu_t& pdu, const uint8_t* payload, uint32_t payload_len)
+{
+  // try to allocate PDU buffer
+  pdu.pdu = srsran::make_byte_buffer();
+  if (pdu.pdu != nullptr && pdu.pdu->get_tailroom() >= payload_len) {
+    // copy payload into PDU buffer
+    memcpy(pdu.pdu->msg, payload, payload_len);
+    pdu.pdu->N_bytes = payload_len;
+    if (not queue.try_push(std::move(pdu))) {
+      logger.warning("Dropping PDU (%d B) in PCAP. Write queue full.", payload_len);
+    }
+  } else {
+    logger.warning("Dropping PDU in PCAP. No buffer available or not enough space (pdu_len=%d).", payload_len);
+  }
+}
+
+// Function called from PHY worker context, locking not needed as queue_pdu() is thread-safe
 void mac_pcap_base::pack_and_queue(uint8_t* payload,
                                    uint32_t payload_len,
                                    uint16_t ue_id,
@@ -88,7 +104,7 @@ void mac_pcap_base::pack_and_queue(uint8_t* payload,
                                    uint8_t  direction,
                                    uint8_t  rnti_type)
 {
-  if (running && payload != nullptr) {
+  if (running && payload != nullptr && filter.rnti_allowed(crnti)) {
     pcap_pdu_t pdu             = {};
     pdu.rat                    = srsran::srsran_rat_t::lte;
     pdu.context.radioType      = FDD_RADIO;
@@ -102,22 +118,11 @@ void mac_pcap_base::pack_and_queue(uint8_t* payload,
     pdu.context.sysFrameNumber = (uint16_t)(tti / 10);
     pdu.context.subFrameNumber = (uint16_t)(tti % 10);
 
-    // try to allocate PDU buffer
-    pdu.pdu = srsran::make_byte_buffer();
-    if (pdu.pdu != nullptr && pdu.pdu->get_tailroom() >= payload_len) {
-      // copy payload into PDU buffer
-      memcpy(pdu.pdu->msg, payload, payload_len);
-      pdu.pdu->N_bytes = payload_len;
-      if (not queue.try_push(std::move(pdu))) {
-        logger.warning("Dropping PDU (%d B) in PCAP. Write queue full.", payload_len);
-      }
-    } else {
-      logger.warning("Dropping PDU in PCAP. No buffer available or not enough space (pdu_len=%d).", payload_len);
-    }
+    queue_pdu(pdu, payload, payload_len);
   }
 }
 
-// Function called from PHY worker context, locking not needed as PDU queue is thread-safe
+// Function called from PHY worker context, locking not needed as queue_pdu() is thread-safe
 void mac_pcap_base::pack_and_queue_nr(uint8_t* payload,
                                       uint32_t payload_len,
                                       uint32_t tti,
@@ -127,7 +132,7 @@ void mac_pcap_base::pack_and_queue_nr(uint8_t* payload,
                                       uint8_t  direction,
                                       uint8_t  rnti_type)
 {
-  if (running && payload != nullptr) {
+  if (running && payload != nullptr && filter.rnti_allowed(crnti)) {
     pcap_pdu_t pdu                     = {};
     pdu.rat                            = srsran_rat_t::nr;
     pdu.context_nr.radioType           = FDD_RADIO;
@@ -139,18 +144,7 @@ void mac_pcap_base::pack_and_queue_nr(uint8_t* payload,
     pdu.context_nr.system_frame_number = tti / 10;
     pdu.context_nr.sub_frame_number    = tti % 10;
 
-    // try to allocate PDU buffer
-    pdu.pdu = srsran::make_byte_buffer();
-    if (pdu.pdu != nullptr && pdu.pdu->get_tailroom() >= payload_len) {
-      // copy payload into PDU buffer
-      memcpy(pdu.pdu->msg, payload, payload_len);
-      pdu.pdu->N_bytes = payload_len;
-      if (not queue.try_push(std::move(pdu))) {
-        logger.warning("Dropping PDU (%d B) in NR PCAP. Write queue full.", payload_len);
-      }
-    } else {
-      logger.warning("Dropping PDU in NR PCAP. No buffer available or not enough space (pdu_len=%d).", payload_len);
-    }
+    queue_pdu(pdu, payload, payload_len);
   }
 }
 
@@ -52,13 +52,8 @@ void nas_pcap::enable()
 
 uint32_t nas_pcap::open(std::string filename_, uint32_t ue_id_, srsran_rat_t rat_type)
 {
-  filename = filename_;
-  if (rat_type == srsran_rat_t::nr) {
-    pcap_file = DLT_PCAP_Open(NAS_5G_DLT, filename.c_str());
-  } else {
-    pcap_file = DLT_PCAP_Open(NAS_LTE_DLT, filename.c_str());
-  }
-  if (pcap_file == nullptr) {
+  uint32_t dlt = (rat_type == srsran_rat_t::nr) ? NAS_5G_DLT : NAS_LTE_DLT;
+  if (not writer.open(filename_, dlt)) {
     return SRSRAN_ERROR;
   }
   ue_id        = ue_id_;
@@ -68,18 +63,17 @@ uint32_t nas_pcap::open(std::string filename_, uint32_t ue_id_, srsran_rat_t rat
 
 void nas_pcap::close()
 {
-  fprintf(stdout, "Saving NAS PCAP file (DLT=%d) to %s \n", NAS_LTE_DLT, filename.c_str());
-  DLT_PCAP_Close(pcap_file);
-  pcap_file = nullptr;
+  if (not writer.is_open()) {
+    return;
+  }
+  fprintf(stdout, "Saving NAS PCAP file (DLT=%d) to %s \n", NAS_LTE_DLT, writer.get_filename().c_str());
+  writer.close();
 }
 
 void nas_pcap::write_nas(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
-  if (enable_write) {
-    NAS_Context_Info_t context;
-    if (pdu) {
-      LTE_PCAP_NAS_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
-    }
+  if (enable_write && pdu) {
+    writer.write(nullptr, 0, pdu, pdu_len_bytes);
   }
 }
 
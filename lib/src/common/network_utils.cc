@@ -21,7 +21,9 @@
 
 #include "srsran/common/network_utils.h"
 
+#include <array>
 #include <netinet/sctp.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h> // for the pipe
@@ -391,6 +393,107 @@ bool unique_socket::sctp_set_init_msg_opts(int max_init_attempts, int max_init_t
   return net_utils::sctp_set_init_msg_opts(sockfd, max_init_attempts, max_init_timeo);
 }
 
+/***************************************************************
+ *                 Batched datagram I/O
+ **************************************************************/
+
+namespace net_utils {
+
+datagram_rx_batch::datagram_rx_batch(uint32_t capacity_) :
+  bufs(std::max(capacity_, 1u)), hdrs(bufs.size()), iovs(bufs.size()), addrs(bufs.size())
+{}
+
+int datagram_rx_batch::recv(int fd)
+{
+  nof_msgs = 0;
+
+  // Refill the slots whose buffers were released by the caller. Stop at the first allocation failure.
+  uint32_t nof_slots = 0;
+  for (; nof_slots < bufs.size(); ++nof_slots) {
+    if (bufs[nof_slots] == nullptr) {
+      bufs[nof_slots] = make_byte_buffer("datagram_rx_batch");
+      if (bufs[nof_slots] == nullptr) {
+        break;
+      }
+    }
+    bufs[nof_slots]->clear();
+    iovs[nof_slots].iov_base            = bufs[nof_slots]->msg;
+    iovs[nof_slots].iov_len             = bufs[nof_slots]->get_tailroom();
+    hdrs[nof_slots]                     = {};
+    hdrs[nof_slots].msg_hdr.msg_name    = &addrs[nof_slots];
+    hdrs[nof_slots].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    hdrs[nof_slots].msg_hdr.msg_iov     = &iovs[nof_slots];
+    hdrs[nof_slots].msg_hdr.msg_iovlen  = 1;
+  }
+  if (nof_slots == 0) {
+    srslog::fetch_basic_logger(LOGSERVICE).error("Failed to allocate buffers to receive datagrams");
+    return -1;
+  }
+
+  int n = recvmmsg(fd, hdrs.data(), nof_slots, MSG_DONTWAIT, nullptr);
+  if (n < 0) {
+    if (errno == EAGAIN or errno == EWOULDBLOCK or errno == EINTR) {
+      return 0;
+    }
+    srslog::fetch_basic_logger(LOGSERVICE).error("Error receiving datagrams from socket=%d: %s", fd, strerror(errno));
+    return -1;
+  }
+  for (int i = 0; i < n; ++i) {
+    bufs[i]->N_bytes = hdrs[i].msg_len;
+  }
+  nof_msgs = n;
+  return n;
+}
+
+datagram_tx_batch::datagram_tx_batch(uint32_t capacity_) :
+  bufs(std::max(capacity_, 1u)), hdrs(bufs.size()), iovs(bufs.size()), addrs(bufs.size())
+{}
+
+void datagram_tx_batch::push(unique_byte_buffer_t msg, const sockaddr_in& dest_addr)
+{
+  srsran_assert(not full(), "Pushing datagram into full tx batch");
+  iovs[nof_msgs].iov_base            = msg->msg;
+  iovs[nof_msgs].iov_len             = msg->N_bytes;
+  addrs[nof_msgs]                    = dest_addr;
+  hdrs[nof_msgs]                     = {};
+  hdrs[nof_msgs].msg_hdr.msg_name    = &addrs[nof_msgs];
+  hdrs[nof_msgs].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+  hdrs[nof_msgs].msg_hdr.msg_iov     = &iovs[nof_msgs];
+  hdrs[nof_msgs].msg_hdr.msg_iovlen  = 1;
+  bufs[nof_msgs]                     = std::move(msg);
+  nof_msgs++;
+}
+
+uint32_t datagram_tx_batch::flush(int fd)
+{
+  uint32_t nof_sent = 0;
+  uint32_t idx      = 0;
+  while (idx < nof_msgs) {
+    int n = sendmmsg(fd, &hdrs[idx], nof_msgs - idx, 0);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // sendmmsg() only reports the error of the first datagram. Skip it and keep sending the rest.
+      srslog::fetch_basic_logger(LOGSERVICE).error("Error sending datagram to %s:%d: %s",
+                                                   get_ip(addrs[idx]).c_str(),
+                                                   get_port(addrs[idx]),
+                                                   strerror(errno));
+      idx++;
+      continue;
+    }
+    nof_sent += n;
+    idx += n;
+  }
+  for (uint32_t i = 0; i < nof_msgs; ++i) {
+    bufs[i].reset();
+  }
+  nof_msgs = 0;
+  return nof_sent;
+}
+
+} // namespace net_utils
+
 /***************************************************************
  *                 Rx Multisocket Handler
  **************************************************************/
@@ -400,6 +503,13 @@ socket_manager::socket_manager() : thread("RXsockets"), socket_manager_itf(srslo
   // register control pipe fd
   int fd = pipe(pipefd);
   srsran_assert(fd != -1, "Failed to open control pipe");
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  srsran_assert(epoll_fd != -1, "Failed to create epoll instance");
+  epoll_event ev = {};
+  ev.events      = EPOLLIN;
+  ev.data.fd     = pipefd[0];
+  fd             = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipefd[0], &ev);
+  srsran_assert(fd != -1, "Failed to register control pipe");
   start(thread_prio);
 }
 
@@ -431,6 +541,10 @@ void socket_manager::stop()
     pipefd[1] = -1;
     rxSockDebug("closed.");
   }
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
 }
 
 bool socket_manager::add_socket_handler(int fd, recv_callback_t handler)
@@ -495,68 +609,65 @@ bool socket_manager::remove_socket(int fd)
   return result;
 }
 
-std::map<int, socket_manager::recv_callback_t>::iterator
-socket_manager::remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd)
+void socket_manager::remove_socket_unprotected(int fd)
 {
   if (fd < 0) {
     rxSockError("fd to be removed is not valid");
-    return active_sockets.end();
+    return;
   }
-  auto it = active_sockets.find(fd);
-  it      = active_sockets.erase(it);
-  FD_CLR(fd, total_fd_set);
-  // assumes ordering
-  *max_fd = (active_sockets.empty()) ? pipefd[0] : std::max(pipefd[0], active_sockets.rbegin()->first);
+  active_sockets.erase(fd);
+  // the fd may have been closed already, in which case the kernel has dropped it from the epoll set
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
   rxSockDebug("Socket fd=%d has been successfully removed", fd);
-  return it;
 }
 
 void socket_manager::run_thread()
 {
   running = true;
-  fd_set total_fd_set, read_fd_set;
-  FD_ZERO(&total_fd_set);
-  int max_fd = 0;
-
-  FD_SET(pipefd[0], &total_fd_set);
-  max_fd = std::max(pipefd[0], max_fd);
+  std::array<epoll_event, max_events> events;
 
   while (running.load(std::memory_order_relaxed)) {
-    memcpy(&read_fd_set, &total_fd_set, sizeof(total_fd_set));
-    int n = select(max_fd + 1, &read_fd_set, nullptr, nullptr, nullptr);
+    int n = epoll_wait(epoll_fd, events.data(), events.size(), -1);
 
-    // handle select return
+    // handle epoll_wait return
     if (n == -1) {
-      rxSockError("Error from select(%d,...). Number of rx sockets: %d", max_fd + 1, (int)active_sockets.size() + 1);
+      if (errno != EINTR) {
+        rxSockError("Error from epoll_wait(): %s. Number of rx sockets: %d",
+                    strerror(errno),
+                    (int)active_sockets.size() + 1);
+      }
       continue;
     }
     if (n == 0) {
-      rxSockDebug("No data from select.");
+      rxSockDebug("No data from epoll_wait.");
       continue;
     }
 
     // Shared state area
     std::lock_guard<std::mutex> lock(socket_mutex);
 
-    // call read callback for all SCTP/TCP/UDP connections
-    for (auto handler_it = active_sockets.begin(); handler_it != active_sockets.end();) {
-      int              fd       = handler_it->first;
-      recv_callback_t& callback = handler_it->second;
-      if (not FD_ISSET(fd, &read_fd_set)) {
-        ++handler_it;
+    // call read callback for all SCTP/TCP/UDP connections with pending data
+    bool ctrl_pending = false;
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == pipefd[0]) {
+        ctrl_pending = true;
         continue;
       }
-      bool socket_valid = callback(fd);
+      auto handler_it = active_sockets.find(fd);
+      if (handler_it == active_sockets.end()) {
+        // removed while the event was pending
+        continue;
+      }
+      bool socket_valid = handler_it->second(fd);
       if (not socket_valid) {
         rxSockInfo("The socket fd=%d has been closed by peer", fd);
-        handler_it = remove_socket_unprotected(fd, &total_fd_set, &max_fd);
-      } else {
-        ++handler_it;
+        remove_socket_unprotected(fd);
       }
     }
 
     // handle ctrl messages
-    if (FD_ISSET(pipefd[0], &read_fd_set)) {
+    if (ctrl_pending) {
       ctrl_cmd_t msg;
       ssize_t    nrd = read(pipefd[0], &msg, sizeof(msg));
       if (nrd <= 0) {
@@ -569,19 +680,22 @@ void socket_manager::run_thread()
           return;
         case ctrl_cmd_t::cmd_id_t::NEW_FD:
           if (msg.new_fd >= 0) {
-            FD_SET(msg.new_fd, &total_fd_set);
-            max_fd = std::max(max_fd, msg.new_fd);
+            epoll_event ev = {};
+            ev.events      = EPOLLIN;
+            ev.data.fd     = msg.new_fd;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, msg.new_fd, &ev) == -1) {
+              rxSockError("Failed to add fd=%d to epoll set: %s", msg.new_fd, strerror(errno));
+            }
           } else {
             rxSockError("added fd is not valid");
           }
           break;
         case ctrl_cmd_t::cmd_id_t::RM_FD:
-          remove_socket_unprotected(msg.new_fd, &total_fd_set, &max_fd);
+          remove_socket_unprotected(msg.new_fd);
           if (msg.signal_rm_complete) {
             rem_fd_tmp_list.push_back(msg.new_fd);
             rem_cvar.notify_one();
           }
-          rxSockDebug("Socket fd=%d has been successfully removed", msg.new_fd);
           break;
         default:
           rxSockError("ctrl message command %d is not valid", (int)msg.cmd);
@@ -701,4 +815,61 @@ make_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue,
   return socket_manager_itf::recv_callback_t(recvfrom_pdu_task(logger, queue, std::move(rx_callback)));
 }
 
+/**
+ * Description: Functor for datagram sockets that drains up to batch_size datagrams with a single recvmmsg(...) into
+ * byte buffers that are kept allocated between calls, and dispatches the whole burst with a single queue push
+ */
+class recvmmsg_pdu_task
+{
+public:
+  using callback_t = recvfrom_callback_t;
+  explicit recvmmsg_pdu_task(srslog::basic_logger&      logger,
+                             srsran::task_queue_handle& queue_,
+                             callback_t                 func_,
+                             uint32_t                   batch_size) :
+    logger(logger), queue(queue_), func(std::move(func_)), batch(batch_size)
+  {}
+
+  bool operator()(int fd)
+  {
+    int n_recv = batch.recv(fd);
+    if (n_recv <= 0) {
+      // errors are logged by the batch
+      return true;
+    }
+    logger.debug("Received burst of %d datagrams from socket fd=%d", n_recv, fd);
+
+    std::vector<std::pair<srsran::unique_byte_buffer_t, sockaddr_in>> pdus;
+    pdus.reserve(n_recv);
+    for (int i = 0; i < n_recv; ++i) {
+      pdus.emplace_back(batch.release(i), batch.get_addr(i));
+    }
+
+    // Defer handling of the received burst to provided queue
+    queue.push(std::bind(
+        [this](std::vector<std::pair<srsran::unique_byte_buffer_t, sockaddr_in>>& sdus) {
+          for (auto& sdu : sdus) {
+            func(std::move(sdu.first), sdu.second);
+          }
+        },
+        std::move(pdus)));
+
+    return true;
+  }
+
+private:
+  srslog::basic_logger&        logger;
+  srsran::task_queue_handle&   queue;
+  callback_t                   func;
+  net_utils::datagram_rx_batch batch;
+};
+
+socket_manager_itf::recv_callback_t make_sdu_batch_handler(srslog::basic_logger&      logger,
+                                                           srsran::task_queue_handle& queue,
+                                                           recvfrom_callback_t        rx_callback,
+                                                           uint32_t                   batch_size)
+{
+  return socket_manager_itf::recv_callback_t(recvmmsg_pdu_task(logger, queue, std::move(rx_callback), batch_size));
+}
+
 } // namespace srsran
@@ -51,26 +51,21 @@ void ngap_pcap::enable()
 }
 void ngap_pcap::open(const char* filename_)
 {
-  filename     = filename_;
-  pcap_file    = DLT_PCAP_Open(NGAP_5G_DLT, filename.c_str());
-  enable_write = true;
+  enable_write = writer.open(filename_, NGAP_5G_DLT);
 }
 void ngap_pcap::close()
 {
-  if (!enable_write) {
+  if (!enable_write || !writer.is_open()) {
     return;
   }
-  fprintf(stdout, "Saving NGAP PCAP file (DLT=%d) to %s\n", NGAP_5G_DLT, filename.c_str());
-  DLT_PCAP_Close(pcap_file);
+  fprintf(stdout, "Saving NGAP PCAP file (DLT=%d) to %s\n", NGAP_5G_DLT, writer.get_filename().c_str());
+  writer.close();
 }
 
 void ngap_pcap::write_ngap(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
-  if (enable_write) {
-    NGAP_Context_Info_t context;
-    if (pdu) {
-      LTE_PCAP_NGAP_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
-    }
+  if (enable_write && pdu) {
+    writer.write(nullptr, 0, pdu, pdu_len_bytes);
   }
 }
 
@@ -0,0 +1,484 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/pcap_writer.h"
+#include "srsran/common/pcap.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+
+namespace srsran {
+
+/// Buffers are page aligned, so that they can be handed over to the kernel in full pages.
+static const size_t   write_buffer_alignment = 4096;
+static const uint32_t min_write_buffer_size  = 64 * 1024;
+
+/// Appends a value in host byte order, which is the byte order of the pcapng section
+template <typename T>
+static void put_value(std::vector<uint8_t>& v, T value)
+{
+  const uint8_t* ptr = (const uint8_t*)&value;
+  v.insert(v.end(), ptr, ptr + sizeof(T));
+}
+
+/// Writers in triggered mode, so that trigger_all() can reach them
+static std::mutex                 triggered_writers_mutex;
+static std::vector<pcap_writer*> triggered_writers;
+
+pcap_writer::pcap_writer() : thread("PCAP_WRITER"), logger(srslog::fetch_basic_logger("COMN")) {}
+
+pcap_writer::~pcap_writer()
+{
+  close();
+}
+
+bool pcap_writer::open(const std::string& filename_, uint32_t dlt_, const args_t& args_)
+{
+  if (running.load(std::memory_order_relaxed)) {
+    logger.error("PCAP writer for %s already running. Close first.", filename.c_str());
+    return false;
+  }
+
+  args     = args_;
+  filename = filename_;
+  dlt      = dlt_;
+  file_idx = 0;
+  if (not open_file()) {
+    return false;
+  }
+
+  // (Re)allocate the write buffers. The number of buffers is a power of two, so that the sequence numbers wrap around.
+  uint32_t nof_buffers_ = 1;
+  while (nof_buffers_ < std::max(args.nof_buffers, 2U)) {
+    nof_buffers_ <<= 1U;
+  }
+  uint32_t buffer_size_ = std::min(std::max(args.buffer_size, min_write_buffer_size), (uint32_t)sealed_flag - 1);
+  buffer_size_          = (buffer_size_ + write_buffer_alignment - 1) & ~(write_buffer_alignment - 1);
+  if (memory == nullptr or nof_buffers_ != nof_buffers or buffer_size_ != buffer_size) {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, write_buffer_alignment, (size_t)nof_buffers_ * buffer_size_) != 0) {
+      logger.error("Couldn't allocate %d PCAP write buffers of %d bytes", nof_buffers_, buffer_size_);
+      close_file();
+      return false;
+    }
+    memory.reset((uint8_t*)ptr);
+    buffers.reset(new write_buffer_t[nof_buffers_]);
+    nof_buffers = nof_buffers_;
+    buffer_size = buffer_size_;
+  }
+  for (uint32_t i = 0; i < nof_buffers; ++i) {
+    buffers[i].data = &memory[(size_t)i * buffer_size];
+    buffers[i].committed.store(0, std::memory_order_relaxed);
+    buffers[i].state.store(make_state(i, 0), std::memory_order_relaxed);
+  }
+  current_seq.store(0, std::memory_order_relaxed);
+  nof_dropped_records.store(0, std::memory_order_relaxed);
+  trigger_pending.store(false, std::memory_order_relaxed);
+  history.clear();
+  history_size     = 0;
+  trigger_deadline = std::chrono::steady_clock::time_point{};
+
+  running.store(true, std::memory_order_release);
+  start();
+
+  if (args.trigger_history_size > 0) {
+    std::lock_guard<std::mutex> lock(triggered_writers_mutex);
+    triggered_writers.push_back(this);
+  }
+  return true;
+}
+
+void pcap_writer::close()
+{
+  if (not running.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+
+  if (args.trigger_history_size > 0) {
+    std::lock_guard<std::mutex> lock(triggered_writers_mutex);
+    triggered_writers.erase(std::remove(triggered_writers.begin(), triggered_writers.end(), this),
+                            triggered_writers.end());
+  }
+
+  notify_writer_thread();
+  wait_thread_finish();
+  close_file();
+
+  if (nof_dropped() > 0) {
+    logger.warning("Dropped %" PRIu64 " PDUs while writing PCAP %s", nof_dropped(), filename.c_str());
+  }
+}
+
+bool pcap_writer::write(const uint8_t* context, uint32_t context_len, const uint8_t* pdu, uint32_t pdu_len)
+{
+  if (not running.load(std::memory_order_acquire)) {
+    return false;
+  }
+  uint32_t orig_len = context_len + pdu_len;
+  uint32_t cap_len  = (args.snap_len > 0) ? std::min(orig_len, args.snap_len) : orig_len;
+  uint32_t len;
+  if (args.format == pcap_format_t::pcapng) {
+    // The packet is padded to 32 bits and followed by a copy of the block length
+    len = sizeof(pcapng_epb_hdr_t) + ((cap_len + 3U) & ~3U) + sizeof(uint32_t);
+  } else {
+    len = sizeof(pcaprec_hdr_t) + cap_len;
+  }
+  if (len > buffer_size) {
+    nof_dropped_records.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Reserve space for the record in the current buffer
+  uint32_t        seq;
+  write_buffer_t* buf;
+  uint64_t        state;
+  while (true) {
+    seq   = current_seq.load(std::memory_order_acquire);
+    buf   = &buffers[seq & (nof_buffers - 1)];
+    state = buf->state.load(std::memory_order_acquire);
+    if (state_seq(state) != seq) {
+      if (current_seq.load(std::memory_order_acquire) == seq) {
+        // All the buffers are waiting to be written to the file
+        nof_dropped_records.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      continue;
+    }
+    if (state_sealed(state)) {
+      // The writer that sealed the buffer is about to move on to the next one
+      std::this_thread::yield();
+      continue;
+    }
+    if (state_nof_bytes(state) + len > buffer_size) {
+      if (seal(*buf, seq, state)) {
+        notify_writer_thread();
+      }
+      continue;
+    }
+    if (buf->state.compare_exchange_weak(state, state + len, std::memory_order_acquire)) {
+      break;
+    }
+  }
+
+  // Pack the record in place, timestamped with the time the PDU was handed over
+  uint8_t*       ptr = buf->data + state_nof_bytes(state);
+  struct timeval t;
+  gettimeofday(&t, nullptr);
+  if (args.format == pcap_format_t::pcapng) {
+    uint64_t         ts = (uint64_t)t.tv_sec * 1000000 + t.tv_usec;
+    pcapng_epb_hdr_t block_header;
+    block_header.block_type         = PCAPNG_EPB_TYPE;
+    block_header.block_total_length = len;
+    block_header.interface_id       = 0;
+    block_header.timestamp_high     = ts >> 32U;
+    block_header.timestamp_low      = ts & 0xffffffffU;
+    block_header.captured_len       = cap_len;
+    block_header.orig_len           = orig_len;
+    memcpy(ptr, &block_header, sizeof(pcapng_epb_hdr_t));
+    ptr += sizeof(pcapng_epb_hdr_t);
+  } else {
+    pcaprec_hdr_t packet_header;
+    packet_header.ts_sec   = t.tv_sec;
+    packet_header.ts_usec  = t.tv_usec;
+    packet_header.incl_len = cap_len;
+    packet_header.orig_len = orig_len;
+    memcpy(ptr, &packet_header, sizeof(pcaprec_hdr_t));
+    ptr += sizeof(pcaprec_hdr_t);
+  }
+  uint32_t nof_context_bytes = std::min(context_len, cap_len);
+  if (nof_context_bytes > 0) {
+    memcpy(ptr, context, nof_context_bytes);
+    ptr += nof_context_bytes;
+  }
+  memcpy(ptr, pdu, cap_len - nof_context_bytes);
+  ptr += cap_len - nof_context_bytes;
+  if (args.format == pcap_format_t::pcapng) {
+    uint8_t* block_end = buf->data + state_nof_bytes(state) + len - sizeof(uint32_t);
+    memset(ptr, 0, block_end - ptr);
+    memcpy(block_end, &len, sizeof(uint32_t));
+  }
+
+  buf->committed.fetch_add(len, std::memory_order_release);
+  return true;
+}
+
+bool pcap_writer::seal(write_buffer_t& buf, uint32_t seq, uint64_t state)
+{
+  if (not buf.state.compare_exchange_strong(state, state | sealed_flag, std::memory_order_acq_rel)) {
+    return false;
+  }
+  current_seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acq_rel);
+  return true;
+}
+
+void pcap_writer::trigger()
+{
+  if (running.load(std::memory_order_relaxed) and args.trigger_history_size > 0) {
+    trigger_pending.store(true, std::memory_order_release);
+    notify_writer_thread();
+  }
+}
+
+void pcap_writer::trigger_all()
+{
+  std::lock_guard<std::mutex> lock(triggered_writers_mutex);
+  for (pcap_writer* w : triggered_writers) {
+    w->trigger();
+  }
+}
+
+void pcap_writer::notify_writer_thread()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+  }
+  cvar.notify_one();
+}
+
+void pcap_writer::run_thread()
+{
+  std::chrono::milliseconds flush_period(args.flush_period_ms);
+  auto                      last_flush = std::chrono::steady_clock::now();
+
+  uint32_t seq = 0;
+  while (true) {
+    if (trigger_pending.exchange(false, std::memory_order_acq_rel)) {
+      write_history();
+    }
+
+    write_buffer_t& buf   = buffers[seq & (nof_buffers - 1)];
+    uint64_t        state = buf.state.load(std::memory_order_acquire);
+
+    if (not state_sealed(state)) {
+      // Seal the current buffer when the flush period expires or when closing, so that its records are written even
+      // if it is not full
+      bool stopping = not running.load(std::memory_order_acquire);
+      if (stopping or std::chrono::steady_clock::now() - last_flush >= flush_period) {
+        if (state_nof_bytes(state) > 0) {
+          seal(buf, seq, state);
+          continue;
+        }
+        if (stopping) {
+          break;
+        }
+        last_flush = std::chrono::steady_clock::now();
+      }
+      std::unique_lock<std::mutex> lock(mutex);
+      cvar.wait_for(lock, flush_period, [&buf, this]() {
+        return state_sealed(buf.state.load(std::memory_order_acquire)) or not running.load(std::memory_order_acquire) or
+               trigger_pending.load(std::memory_order_acquire);
+      });
+      continue;
+    }
+
+    // Wait for the writers that are still copying their records into the sealed buffer
+    uint32_t nof_bytes = state_nof_bytes(state);
+    while (buf.committed.load(std::memory_order_acquire) != nof_bytes) {
+      std::this_thread::yield();
+    }
+    store_records(buf.data, nof_bytes);
+
+    // Recycle the buffer for the sequence number that will use it next
+    buf.committed.store(0, std::memory_order_relaxed);
+    buf.state.store(make_state(seq + nof_buffers, 0), std::memory_order_release);
+    seq++;
+    last_flush = std::chrono::steady_clock::now();
+  }
+}
+
+void pcap_writer::store_records(const uint8_t* data, uint32_t len)
+{
+  if (args.trigger_history_size == 0 or std::chrono::steady_clock::now() < trigger_deadline) {
+    write_records(data, len);
+    return;
+  }
+
+  // Keep the most recent buffers in the history, up to trigger_history_size bytes
+  history.emplace_back(data, data + len);
+  history_size += len;
+  while (history.size() > 1 and history_size > args.trigger_history_size) {
+    history_size -= history.front().size();
+    history.pop_front();
+  }
+}
+
+void pcap_writer::write_history()
+{
+  logger.info("PCAP %s triggered. Writing %" PRIu64 " bytes of history", filename.c_str(), history_size);
+  for (const std::vector<uint8_t>& chunk : history) {
+    write_records(chunk.data(), chunk.size());
+  }
+  history.clear();
+  history_size     = 0;
+  trigger_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(args.trigger_post_ms);
+}
+
+void pcap_writer::write_records(const uint8_t* data, uint32_t len)
+{
+  while (len > 0) {
+    uint32_t chunk_len = len;
+    if (args.max_file_size > 0) {
+      // Only write the records that fit in the current file
+      chunk_len = 0;
+      while (chunk_len < len) {
+        uint32_t rec_len = record_len(data + chunk_len);
+        if (file_size + chunk_len + rec_len > args.max_file_size and (chunk_len > 0 or file_size > header_len)) {
+          break;
+        }
+        chunk_len += rec_len;
+      }
+      if (chunk_len == 0) {
+        rotate_file();
+        continue;
+      }
+    }
+    write_all(data, chunk_len);
+    file_size += chunk_len;
+    data += chunk_len;
+    len -= chunk_len;
+  }
+}
+
+uint32_t pcap_writer::record_len(const uint8_t* record) const
+{
+  if (args.format == pcap_format_t::pcapng) {
+    pcapng_epb_hdr_t block_header;
+    memcpy(&block_header, record, sizeof(pcapng_epb_hdr_t));
+    return block_header.block_total_length;
+  }
+  pcaprec_hdr_t packet_header;
+  memcpy(&packet_header, record, sizeof(pcaprec_hdr_t));
+  return sizeof(pcaprec_hdr_t) + packet_header.incl_len;
+}
+
+bool pcap_writer::write_all(const uint8_t* data, uint32_t len)
+{
+  if (fd < 0) {
+    return false;
+  }
+  while (len > 0) {
+    ssize_t n = ::write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger.error("Error writing PCAP %s: %s", file_name(file_idx).c_str(), strerror(errno));
+      return false;
+    }
+    data += n;
+    len -= n;
+  }
+  return true;
+}
+
+std::string pcap_writer::file_name(uint32_t idx) const
+{
+  return idx == 0 ? filename : filename + "." + std::to_string(idx);
+}
+
+bool pcap_writer::open_file()
+{
+  std::string name = file_name(file_idx);
+  fd               = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    logger.error("Couldn't open %s to write PCAP: %s", name.c_str(), strerror(errno));
+    return false;
+  }
+  return write_file_header();
+}
+
+bool pcap_writer::write_file_header()
+{
+  uint32_t snap_len = (args.snap_len > 0) ? args.snap_len : 65535;
+
+  if (args.format == pcap_format_t::pcap) {
+    pcap_hdr_t file_header = {
+        0xa1b2c3d4, /* magic number */
+        2,
+        4,        /* version number is 2.4 */
+        0,        /* timezone */
+        0,        /* sigfigs - apparently all tools do this */
+        snap_len, /* snaplen */
+        dlt       /* Data Link Type (DLT) */
+    };
+    header_len = sizeof(pcap_hdr_t);
+    file_size  = header_len;
+    return write_all((const uint8_t*)&file_header, sizeof(pcap_hdr_t));
+  }
+
+  // pcapng Section Header Block followed by the Interface Description Block of the records
+  std::vector<uint8_t> header;
+  put_value<uint32_t>(header, PCAPNG_SHB_TYPE);
+  put_value<uint32_t>(header, 28);
+  put_value<uint32_t>(header, PCAPNG_BYTE_ORDER_MAGIC);
+  put_value<uint16_t>(header, 1); // version 1.0
+  put_value<uint16_t>(header, 0);
+  put_value<uint64_t>(header, UINT64_MAX); // section length not specified
+  put_value<uint32_t>(header, 28);
+
+  size_t idb_start = header.size();
+  put_value<uint32_t>(header, PCAPNG_IDB_TYPE);
+  put_value<uint32_t>(header, 0); // block length, set below
+  put_value<uint16_t>(header, dlt);
+  put_value<uint16_t>(header, 0);
+  put_value<uint32_t>(header, snap_len);
+  if (not args.if_name.empty()) {
+    put_value<uint16_t>(header, PCAPNG_OPT_IF_NAME);
+    put_value<uint16_t>(header, args.if_name.size());
+    header.insert(header.end(), args.if_name.begin(), args.if_name.end());
+    header.resize((header.size() + 3U) & ~(size_t)3U, 0);
+    put_value<uint16_t>(header, PCAPNG_OPT_ENDOFOPT);
+    put_value<uint16_t>(header, 0);
+  }
+  uint32_t idb_len = header.size() - idb_start + sizeof(uint32_t);
+  put_value<uint32_t>(header, idb_len);
+  memcpy(&header[idb_start + sizeof(uint32_t)], &idb_len, sizeof(uint32_t));
+
+  header_len = header.size();
+  file_size  = header_len;
+  return write_all(header.data(), header.size());
+}
+
+void pcap_writer::close_file()
+{
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+void pcap_writer::rotate_file()
+{
+  close_file();
+  file_idx++;
+  if (args.max_files > 0 and file_idx >= args.max_files) {
+    ::unlink(file_name(file_idx - args.max_files).c_str());
+  }
+  if (open_file()) {
+    logger.info("Rotated PCAP to %s", file_name(file_idx).c_str());
+  }
+}
+
+} // namespace srsran
@@ -32,10 +32,14 @@ void rlc_pcap::enable(bool en)
 }
 
 void rlc_pcap::open(const char* filename, const rlc_config_t& config)
+{
+  open(filename, config, pcap_writer::args_t{});
+}
+
+void rlc_pcap::open(const char* filename, const rlc_config_t& config, const pcap_writer::args_t& writer_args)
 {
   fprintf(stdout, "Opening RLC PCAP with DLT=%d\n", UDP_DLT);
-  pcap_file    = DLT_PCAP_Open(UDP_DLT, filename);
-  enable_write = true;
+  enable_write = writer.open(filename, UDP_DLT, writer_args);
 
   if (config.rlc_mode == rlc_mode_t::am) {
     mode      = RLC_AM_MODE;
@@ -54,7 +58,7 @@ void rlc_pcap::open(const char* filename, const rlc_config_t& config)
 void rlc_pcap::close()
 {
   fprintf(stdout, "Saving RLC PCAP file\n");
-  DLT_PCAP_Close(pcap_file);
+  writer.close();
 }
 
 void rlc_pcap::set_ue_id(uint16_t ue_id_)
@@ -83,7 +87,10 @@ void rlc_pcap::pack_and_write(uint8_t* pdu,
     context.channelId            = channel_id;
     context.pduLength            = pdu_len_bytes;
     if (pdu) {
-      LTE_PCAP_RLC_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      uint8_t context_header[PCAP_CONTEXT_HEADER_MAX];
+      int     context_len =
+          LTE_PCAP_PACK_RLC_CONTEXT_TO_BUFFER(&context, context_header, sizeof(context_header), pdu_len_bytes);
+      writer.write(context_header, context_len, pdu, pdu_len_bytes);
     }
   }
 }
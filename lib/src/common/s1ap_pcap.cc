@@ -51,26 +51,25 @@ void s1ap_pcap::enable()
 }
 void s1ap_pcap::open(const char* filename_)
 {
-  filename     = filename_;
-  pcap_file    = DLT_PCAP_Open(S1AP_LTE_DLT, filename.c_str());
-  enable_write = true;
+  open(filename_, pcap_writer::args_t{});
+}
+void s1ap_pcap::open(const char* filename_, const pcap_writer::args_t& writer_args)
+{
+  enable_write = writer.open(filename_, S1AP_LTE_DLT, writer_args);
 }
 void s1ap_pcap::close()
 {
-  if (!enable_write) {
+  if (!enable_write || !writer.is_open()) {
     return;
   }
-  fprintf(stdout, "Saving S1AP PCAP file (DLT=%d) to %s\n", S1AP_LTE_DLT, filename.c_str());
-  DLT_PCAP_Close(pcap_file);
+  fprintf(stdout, "Saving S1AP PCAP file (DLT=%d) to %s\n", S1AP_LTE_DLT, writer.get_filename().c_str());
+  writer.close();
 }
 
 void s1ap_pcap::write_s1ap(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
-  if (enable_write) {
-    S1AP_Context_Info_t context;
-    if (pdu) {
-      LTE_PCAP_S1AP_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
-    }
+  if (enable_write && pdu) {
+    writer.write(nullptr, 0, pdu, pdu_len_bytes);
   }
 }
 
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/common/s3g.h"
+#include "keystream_lanes.h"
 
 /* S-box SQ */
 static const uint8_t SQ[256] = {
@@ -280,6 +281,64 @@ uint32_t s3g_s2(uint32_t w)
   return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) | (((uint32_t)r2) << 8) | (((uint32_t)r3)));
 }
 
+/*********************************************************************
+    Name: s3g_get_tables
+
+    Description: Lookup tables of the multiplication and division by
+                 alpha and of the S-Boxes S1 and S2, split by input
+                 byte. They are generated once from the functions
+                 above.
+
+    Document Reference: Specification of the 3GPP Confidentiality and
+                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
+                            Section 3.3 and Section 3.4
+*********************************************************************/
+struct s3g_tables_t {
+  uint32_t mul_alpha[256];
+  uint32_t div_alpha[256];
+  // s1[i][b] is the contribution to S1 of byte b at position i, counting from the MSB
+  uint32_t s1[4][256];
+  uint32_t s2[4][256];
+};
+
+/* Column of the MixColumn operation of the S-Box for a single non-zero input byte at position pos. */
+static uint32_t s3g_sbox_column(uint8_t s, uint32_t pos, uint8_t c)
+{
+  uint8_t x = s3g_mul_x(s, c);
+  uint8_t r[4];
+  for (uint32_t j = 0; j < 4; j++) {
+    r[j] = s;
+  }
+  r[pos]           = x;
+  r[(pos + 1) % 4] = x ^ s;
+  return (((uint32_t)r[0]) << 24) | (((uint32_t)r[1]) << 16) | (((uint32_t)r[2]) << 8) | ((uint32_t)r[3]);
+}
+
+static s3g_tables_t s3g_build_tables()
+{
+  s3g_tables_t t;
+  for (uint32_t b = 0; b < 256; b++) {
+    t.mul_alpha[b] = s3g_mul_alpha((uint8_t)b);
+    t.div_alpha[b] = s3g_div_alpha((uint8_t)b);
+    for (uint32_t pos = 0; pos < 4; pos++) {
+      t.s1[pos][b] = s3g_sbox_column(S[b], pos, 0x1b);
+      t.s2[pos][b] = s3g_sbox_column(SQ[b], pos, 0x69);
+    }
+  }
+  return t;
+}
+
+static const s3g_tables_t& s3g_get_tables()
+{
+  static const s3g_tables_t tables = s3g_build_tables();
+  return tables;
+}
+
+static inline uint32_t s3g_sbox_lookup(const uint32_t (*t)[256], uint32_t w)
+{
+  return t[0][w >> 24] ^ t[1][(w >> 16) & 0xff] ^ t[2][(w >> 8) & 0xff] ^ t[3][w & 0xff];
+}
+
 /*********************************************************************
     Name: s3g_clock_lfsr
 
@@ -291,10 +350,10 @@ uint32_t s3g_s2(uint32_t w)
 *********************************************************************/
 void s3g_clock_lfsr(S3G_STATE* state, uint32_t f)
 {
-  uint32_t v = (((state->lfsr[0] << 8) & 0xffffff00) ^ (s3g_mul_alpha((uint8_t)((state->lfsr[0] >> 24) & 0xff))) ^
-                (state->lfsr[2]) ^ ((state->lfsr[11] >> 8) & 0x00ffffff) ^
-                (s3g_div_alpha((uint8_t)((state->lfsr[11]) & 0xff))) ^ (f));
-  uint8_t  i;
+  const s3g_tables_t& t = s3g_get_tables();
+  uint32_t            v = ((state->lfsr[0] << 8) & 0xffffff00) ^ t.mul_alpha[state->lfsr[0] >> 24] ^ state->lfsr[2] ^
+               ((state->lfsr[11] >> 8) & 0x00ffffff) ^ t.div_alpha[state->lfsr[11] & 0xff] ^ f;
+  uint8_t i;
 
   for (i = 0; i < 15; i++) {
     state->lfsr[i] = state->lfsr[i + 1];
@@ -316,9 +375,10 @@ uint32_t s3g_clock_fsm(S3G_STATE* state)
   uint32_t f = ((state->lfsr[15] + state->fsm[0]) & 0xffffffff) ^ state->fsm[1];
   uint32_t r = (state->fsm[1] + (state->fsm[2] ^ state->lfsr[5])) & 0xffffffff;
 
-  state->fsm[2] = s3g_s2(state->fsm[1]);
-  state->fsm[1] = s3g_s1(state->fsm[0]);
-  state->fsm[0] = r;
+  const s3g_tables_t& t = s3g_get_tables();
+  state->fsm[2]         = s3g_sbox_lookup(t.s2, state->fsm[1]);
+  state->fsm[1]         = s3g_sbox_lookup(t.s1, state->fsm[0]);
+  state->fsm[0]         = r;
 
   return f;
 }
@@ -408,6 +468,159 @@ void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks)
   }
 }
 
+#ifdef KEYSTREAM_LANES_HAVE_SIMD
+
+namespace {
+
+using lanes     = srsran::keystream_lanes;
+using s3g_reg_t = lanes::reg_t;
+
+/* State of keystream_lanes::nof_lanes SNOW 3G generators clocked in lockstep. The LFSR is a ring buffer, s[p] being
+ * s_0 of the specification, so that clocking it does not move any data. */
+struct s3g_multi_state_t {
+  s3g_reg_t s[16];
+  s3g_reg_t r1, r2, r3;
+};
+
+inline s3g_reg_t s3g_sbox_lanes(const uint32_t (*t)[256], s3g_reg_t w)
+{
+  const s3g_reg_t mask = lanes::set1(0xff);
+  s3g_reg_t       r    = lanes::lookup(t[0], lanes::shr<24>(w));
+  r = lanes::bxor(r, lanes::lookup(t[1], lanes::band(lanes::shr<16>(w), mask)));
+  r = lanes::bxor(r, lanes::lookup(t[2], lanes::band(lanes::shr<8>(w), mask)));
+  return lanes::bxor(r, lanes::lookup(t[3], lanes::band(w, mask)));
+}
+
+/* Clocks the FSM and the LFSR of all lanes once, with the LFSR starting at position P. In initialisation mode the
+ * output of the FSM is fed back into the LFSR, otherwise the keystream word is returned. */
+template <uint32_t P, bool init>
+inline s3g_reg_t s3g_clock_lanes(const s3g_tables_t& t, s3g_multi_state_t& st)
+{
+  s3g_reg_t* s = st.s;
+
+  // FSM
+  s3g_reg_t f = lanes::bxor(lanes::add(s[(P + 15) % 16], st.r1), st.r2);
+  s3g_reg_t r = lanes::add(st.r2, lanes::bxor(st.r3, s[(P + 5) % 16]));
+  st.r3       = s3g_sbox_lanes(t.s2, st.r2);
+  st.r2       = s3g_sbox_lanes(t.s1, st.r1);
+  st.r1       = r;
+
+  s3g_reg_t z = lanes::bxor(f, s[P]);
+
+  // LFSR
+  const s3g_reg_t s0  = s[P];
+  const s3g_reg_t s11 = s[(P + 11) % 16];
+  s3g_reg_t       v   = lanes::bxor(lanes::shl<8>(s0), s[(P + 2) % 16]);
+  v                   = lanes::bxor(v, lanes::lookup(t.mul_alpha, lanes::shr<24>(s0)));
+  v                   = lanes::bxor(v, lanes::shr<8>(s11));
+  v                   = lanes::bxor(v, lanes::lookup(t.div_alpha, lanes::band(s11, lanes::set1(0xff))));
+  if (init) {
+    v = lanes::bxor(v, f);
+  }
+  s[P] = v;
+
+  return z;
+}
+
+} // namespace
+
+static void s3g_generate_keystream_lanes(uint32_t        nof_lanes,
+                                         const uint32_t  k[][4],
+                                         const uint32_t  iv[][4],
+                                         const uint32_t* n,
+                                         uint32_t* const* ks)
+{
+  constexpr uint32_t  L = lanes::nof_lanes;
+  const s3g_tables_t& t = s3g_get_tables();
+
+  // Initial state of every lane, as in s3g_initialize(). Unused lanes are left with a zero key.
+  alignas(64) uint32_t init[16][L] = {};
+  uint32_t             max_n       = 0;
+  for (uint32_t l = 0; l < nof_lanes; l++) {
+    init[15][l] = k[l][3] ^ iv[l][0];
+    init[14][l] = k[l][2];
+    init[13][l] = k[l][1];
+    init[12][l] = k[l][0] ^ iv[l][1];
+    init[11][l] = k[l][3] ^ 0xffffffff;
+    init[10][l] = k[l][2] ^ 0xffffffff ^ iv[l][2];
+    init[9][l]  = k[l][1] ^ 0xffffffff ^ iv[l][3];
+    init[8][l]  = k[l][0] ^ 0xffffffff;
+    init[7][l]  = k[l][3];
+    init[6][l]  = k[l][2];
+    init[5][l]  = k[l][1];
+    init[4][l]  = k[l][0];
+    init[3][l]  = k[l][3] ^ 0xffffffff;
+    init[2][l]  = k[l][2] ^ 0xffffffff;
+    init[1][l]  = k[l][1] ^ 0xffffffff;
+    init[0][l]  = k[l][0] ^ 0xffffffff;
+    max_n       = (n[l] > max_n) ? n[l] : max_n;
+  }
+
+  s3g_multi_state_t st;
+  for (uint32_t i = 0; i < 16; i++) {
+    st.s[i] = lanes::load(init[i]);
+  }
+  st.r1 = st.r2 = st.r3 = lanes::set1(0);
+
+  // 32 clocks in initialisation mode leave the LFSR aligned at position 0
+  for (uint32_t i = 0; i < 2; i++) {
+    srsran::keystream_unroll([&](auto p) { s3g_clock_lanes<decltype(p)::value, true>(t, st); },
+                             std::make_integer_sequence<uint32_t, 16>{});
+  }
+
+  // Clock once discarding the output, the keystream then starts at position 1
+  s3g_clock_lanes<0, false>(t, st);
+
+  alignas(64) uint32_t z[16][L];
+  for (uint32_t offset = 0; offset < max_n; offset += 16) {
+    srsran::keystream_unroll(
+        [&](auto i) { lanes::store(z[i], s3g_clock_lanes<(decltype(i)::value + 1) % 16, false>(t, st)); },
+        std::make_integer_sequence<uint32_t, 16>{});
+
+    // Write out the words of every lane that it needs
+    for (uint32_t l = 0; l < nof_lanes; l++) {
+      for (uint32_t i = 0; i < 16 && offset + i < n[l]; i++) {
+        ks[l][offset + i] = z[i][l];
+      }
+    }
+  }
+}
+
+#endif // KEYSTREAM_LANES_HAVE_SIMD
+
+/*********************************************************************
+    Name: s3g_generate_keystream_multi
+
+    Description: Generation of several independent keystreams.
+
+    Document Reference: Specification of the 3GPP Confidentiality and
+                            Integrity Algorithms UEA2 & UIA2 D2 v1.1
+                            Section 4.1 and Section 4.2
+*********************************************************************/
+void s3g_generate_keystream_multi(uint32_t        nof_streams,
+                                  const uint32_t  k[][4],
+                                  const uint32_t  iv[][4],
+                                  const uint32_t* n,
+                                  uint32_t* const* ks)
+{
+#ifdef KEYSTREAM_LANES_HAVE_SIMD
+  for (uint32_t i = 0; i < nof_streams; i += srsran::keystream_lanes::nof_lanes) {
+    uint32_t nof_lanes = nof_streams - i;
+    if (nof_lanes > srsran::keystream_lanes::nof_lanes) {
+      nof_lanes = srsran::keystream_lanes::nof_lanes;
+    }
+    s3g_generate_keystream_lanes(nof_lanes, &k[i], &iv[i], &n[i], &ks[i]);
+  }
+#else  // KEYSTREAM_LANES_HAVE_SIMD
+  for (uint32_t i = 0; i < nof_streams; i++) {
+    S3G_STATE state;
+    s3g_initialize(&state, (uint32_t*)k[i], (uint32_t*)iv[i]);
+    s3g_generate_keystream(&state, n[i], ks[i]);
+    s3g_deinitialize(&state);
+  }
+#endif // KEYSTREAM_LANES_HAVE_SIMD
+}
+
 /* MUL64x.
  * Input V: a 64-bit input.
  * Input c: a 64-bit input.
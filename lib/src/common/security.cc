@@ -24,6 +24,7 @@
 #include "srsran/common/liblte_security.h"
 #include "srsran/common/s3g.h"
 #include "srsran/common/ssl.h"
+#include "srsran/common/zuc.h"
 #include "srsran/config.h"
 #include <arpa/inet.h>
 
@@ -827,7 +828,8 @@ uint8_t security_128_eia2(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac)
 {
-  return liblte_security_128_eia2(key, count, bearer, direction, msg, msg_len, mac);
+  aes128_key_ctx ctx(key);
+  return security_128_eia2(ctx, count, bearer, direction, msg, msg_len, mac);
 }
 
 uint8_t security_128_eia3(const uint8_t* key,
@@ -871,7 +873,8 @@ uint8_t security_128_eea2(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out)
 {
-  return liblte_security_encryption_eea2(key, count, bearer, direction, msg, msg_len * 8, msg_out);
+  aes128_key_ctx ctx(key);
+  return security_128_eea2(ctx, count, bearer, direction, msg, msg_len, msg_out);
 }
 
 uint8_t security_128_eea3(uint8_t* key,
@@ -885,6 +888,106 @@ uint8_t security_128_eea3(uint8_t* key,
   return liblte_security_encryption_eea3(key, count, bearer, direction, msg, msg_len * 8, msg_out);
 }
 
+/// XORs the keystreams of a group of PDUs, generated word by word, into the PDUs.
+static void security_apply_keystream(span<const security_batch_pdu_t> pdus, const uint32_t* const* ks)
+{
+  for (uint32_t i = 0; i < pdus.size(); i++) {
+    const security_batch_pdu_t& pdu = pdus[i];
+    uint32_t                    j   = 0;
+    for (; j + 4 <= pdu.msg_len; j += 4) {
+      uint32_t w;
+      memcpy(&w, &pdu.msg[j], 4);
+      w ^= htonl(ks[i][j / 4]);
+      memcpy(&pdu.out[j], &w, 4);
+    }
+    for (; j < pdu.msg_len; j++) {
+      pdu.out[j] = pdu.msg[j] ^ (uint8_t)(ks[i][j / 4] >> (24 - 8 * (j % 4)));
+    }
+  }
+}
+
+/// Maximum number of PDUs whose keystreams are generated together.
+static const uint32_t security_stream_batch_size = 16;
+
+void security_128_eea1_batch(const uint8_t*                   key,
+                             uint8_t                          bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus)
+{
+  uint32_t  k[security_stream_batch_size][4];
+  uint32_t  iv[security_stream_batch_size][4];
+  uint32_t  n[security_stream_batch_size];
+  uint32_t* ks[security_stream_batch_size];
+
+  std::vector<uint32_t> ks_buffer;
+  for (uint32_t first = 0; first < pdus.size(); first += security_stream_batch_size) {
+    span<const security_batch_pdu_t> group =
+        pdus.subspan(first, std::min(security_stream_batch_size, (uint32_t)pdus.size() - first));
+
+    uint32_t nof_words = 0;
+    for (uint32_t i = 0; i < group.size(); i++) {
+      // Key and IV as in liblte_security_encryption_eea1()
+      for (int32_t j = 3; j >= 0; j--) {
+        k[i][j] = (key[4 * (3 - j) + 0] << 24) | (key[4 * (3 - j) + 1] << 16) | (key[4 * (3 - j) + 2] << 8) |
+                  (key[4 * (3 - j) + 3]);
+      }
+      iv[i][3] = group[i].count;
+      iv[i][2] = ((bearer & 0x1F) << 27) | ((direction & 0x01) << 26);
+      iv[i][1] = iv[i][3];
+      iv[i][0] = iv[i][2];
+      n[i]     = (group[i].msg_len + 3) / 4;
+      nof_words += n[i];
+    }
+    ks_buffer.resize(nof_words);
+    for (uint32_t i = 0, offset = 0; i < group.size(); offset += n[i], i++) {
+      ks[i] = &ks_buffer[offset];
+    }
+
+    s3g_generate_keystream_multi(group.size(), k, iv, n, ks);
+    security_apply_keystream(group, ks);
+  }
+}
+
+void security_128_eea3_batch(const uint8_t*                   key,
+                             uint8_t                          bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus)
+{
+  uint8_t   k[security_stream_batch_size][16];
+  uint8_t   iv[security_stream_batch_size][16];
+  uint32_t  n[security_stream_batch_size];
+  uint32_t* ks[security_stream_batch_size];
+
+  std::vector<uint32_t> ks_buffer;
+  for (uint32_t first = 0; first < pdus.size(); first += security_stream_batch_size) {
+    span<const security_batch_pdu_t> group =
+        pdus.subspan(first, std::min(security_stream_batch_size, (uint32_t)pdus.size() - first));
+
+    uint32_t nof_words = 0;
+    for (uint32_t i = 0; i < group.size(); i++) {
+      // IV as in liblte_security_encryption_eea3()
+      uint32_t count = group[i].count;
+      memcpy(k[i], key, 16);
+      iv[i][0] = (count >> 24) & 0xFF;
+      iv[i][1] = (count >> 16) & 0xFF;
+      iv[i][2] = (count >> 8) & 0xFF;
+      iv[i][3] = count & 0xFF;
+      iv[i][4] = ((bearer & 0x1F) << 3) | ((direction & 0x01) << 2);
+      iv[i][5] = iv[i][6] = iv[i][7] = 0;
+      memcpy(&iv[i][8], &iv[i][0], 8);
+      n[i] = (group[i].msg_len + 3) / 4;
+      nof_words += n[i];
+    }
+    ks_buffer.resize(nof_words);
+    for (uint32_t i = 0, offset = 0; i < group.size(); offset += n[i], i++) {
+      ks[i] = &ks_buffer[offset];
+    }
+
+    zuc_generate_keystream_multi(group.size(), k, iv, n, ks);
+    security_apply_keystream(group, ks);
+  }
+}
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
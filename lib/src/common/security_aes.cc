@@ -0,0 +1,410 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/security.h"
+#include "srsran/common/ssl.h"
+#include "srsran/config.h"
+#include <cstring>
+#include <endian.h>
+
+#if defined(LV_HAVE_SSE) && defined(__AES__)
+#include <immintrin.h>
+#define HAVE_AESNI
+#endif // defined(LV_HAVE_SSE) && defined(__AES__)
+
+namespace srsran {
+
+/// Software fallback, used when AES-NI is not available.
+struct aes128_key_ctx::sw_ctx {
+  aes_context ctx;
+};
+
+aes128_key_ctx::aes128_key_ctx() = default;
+
+aes128_key_ctx::~aes128_key_ctx() = default;
+
+aes128_key_ctx::aes128_key_ctx(aes128_key_ctx&&) noexcept = default;
+
+aes128_key_ctx& aes128_key_ctx::operator=(aes128_key_ctx&&) noexcept = default;
+
+#ifdef HAVE_AESNI
+
+static inline __m128i aes128_expand_step(__m128i key, __m128i keygened)
+{
+  keygened = _mm_shuffle_epi32(keygened, 0xff);
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, keygened);
+}
+
+#define AES128_EXPAND(k, rcon) aes128_expand_step(k, _mm_aeskeygenassist_si128(k, rcon))
+
+static void aes128_expand_key(const uint8_t* key, uint8_t (*round_keys)[16])
+{
+  __m128i rk[11];
+  rk[0]  = _mm_loadu_si128((const __m128i*)key);
+  rk[1]  = AES128_EXPAND(rk[0], 0x01);
+  rk[2]  = AES128_EXPAND(rk[1], 0x02);
+  rk[3]  = AES128_EXPAND(rk[2], 0x04);
+  rk[4]  = AES128_EXPAND(rk[3], 0x08);
+  rk[5]  = AES128_EXPAND(rk[4], 0x10);
+  rk[6]  = AES128_EXPAND(rk[5], 0x20);
+  rk[7]  = AES128_EXPAND(rk[6], 0x40);
+  rk[8]  = AES128_EXPAND(rk[7], 0x80);
+  rk[9]  = AES128_EXPAND(rk[8], 0x1b);
+  rk[10] = AES128_EXPAND(rk[9], 0x36);
+  for (uint32_t i = 0; i < 11; i++) {
+    _mm_store_si128((__m128i*)round_keys[i], rk[i]);
+  }
+}
+
+#undef AES128_EXPAND
+
+#endif // HAVE_AESNI
+
+/// Multiplies the 128 bit value by x in GF(2^128), as used for deriving the CMAC subkeys (RFC 4493).
+static void cmac_double(const uint8_t* in, uint8_t* out)
+{
+  for (uint32_t i = 0; i < 15; i++) {
+    out[i] = (uint8_t)((in[i] << 1U) | (in[i + 1] >> 7U));
+  }
+  out[15] = (uint8_t)(in[15] << 1U);
+  if (in[0] & 0x80U) {
+    out[15] ^= 0x87U;
+  }
+}
+
+void aes128_key_ctx::set_key(const uint8_t* key)
+{
+#ifdef HAVE_AESNI
+  aes128_expand_key(key, round_keys);
+#else  // HAVE_AESNI
+  if (sw == nullptr) {
+    sw.reset(new sw_ctx);
+  }
+  aes_setkey_enc(&sw->ctx, key, 128);
+#endif // HAVE_AESNI
+
+  // Subkey generation
+  uint8_t block[1][16] = {};
+  encrypt_blocks(block, 1);
+  cmac_double(block[0], k1);
+  cmac_double(k1, k2);
+}
+
+#ifdef HAVE_AESNI
+
+/// Encrypts N blocks with interleaved AES rounds. N is a compile time constant so that the state stays in registers.
+template <uint32_t N>
+static inline void aes128_encrypt_n(const uint8_t (*round_keys)[16], uint8_t (*blocks)[16])
+{
+  __m128i x[N];
+  __m128i rk = _mm_load_si128((const __m128i*)round_keys[0]);
+  for (uint32_t i = 0; i < N; i++) {
+    x[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)blocks[i]), rk);
+  }
+  for (uint32_t r = 1; r < 10; r++) {
+    rk = _mm_load_si128((const __m128i*)round_keys[r]);
+    for (uint32_t i = 0; i < N; i++) {
+      x[i] = _mm_aesenc_si128(x[i], rk);
+    }
+  }
+  rk = _mm_load_si128((const __m128i*)round_keys[10]);
+  for (uint32_t i = 0; i < N; i++) {
+    _mm_storeu_si128((__m128i*)blocks[i], _mm_aesenclast_si128(x[i], rk));
+  }
+}
+
+#endif // HAVE_AESNI
+
+void aes128_key_ctx::encrypt_blocks(uint8_t (*blocks)[16], uint32_t nof_blocks) const
+{
+#ifdef HAVE_AESNI
+  for (; nof_blocks >= 8; nof_blocks -= 8, blocks += 8) {
+    aes128_encrypt_n<8>(round_keys, blocks);
+  }
+  if (nof_blocks >= 4) {
+    aes128_encrypt_n<4>(round_keys, blocks);
+    nof_blocks -= 4;
+    blocks += 4;
+  }
+  for (; nof_blocks > 0; nof_blocks--, blocks++) {
+    aes128_encrypt_n<1>(round_keys, blocks);
+  }
+#else  // HAVE_AESNI
+  for (uint32_t i = 0; i < nof_blocks; i++) {
+    aes_crypt_ecb(&sw->ctx, AES_ENCRYPT, blocks[i], blocks[i]);
+  }
+#endif // HAVE_AESNI
+}
+
+/******************************************************************************
+ * EEA2: AES-128 in counter mode (TS 33.401 Annex B.1.3)
+ *****************************************************************************/
+
+namespace {
+
+/// Accumulates key stream blocks of one or several PDUs and applies them in groups.
+class eea2_keystream
+{
+public:
+  explicit eea2_keystream(const aes128_key_ctx& ctx_) : ctx(ctx_) {}
+
+  /// Adds the block of a PDU, which is ciphered once the group is complete.
+  void add_block(const uint8_t* counter_block, const uint8_t* in, uint8_t* out, uint32_t nof_bytes)
+  {
+    memcpy(blocks[nof_pending], counter_block, 16);
+    pending[nof_pending] = {in, out, nof_bytes};
+    if (++nof_pending == aes128_key_ctx::max_parallel_blocks) {
+      flush();
+    }
+  }
+
+  /// Ciphers all the pending blocks.
+  void flush()
+  {
+    ctx.encrypt_blocks(blocks, nof_pending);
+    for (uint32_t i = 0; i < nof_pending; i++) {
+      const pending_block_t& p = pending[i];
+      if (p.nof_bytes == 16) {
+        uint64_t in[2], ks[2];
+        memcpy(in, p.in, 16);
+        memcpy(ks, blocks[i], 16);
+        in[0] ^= ks[0];
+        in[1] ^= ks[1];
+        memcpy(p.out, in, 16);
+        continue;
+      }
+      for (uint32_t j = 0; j < p.nof_bytes; j++) {
+        p.out[j] = p.in[j] ^ blocks[i][j];
+      }
+    }
+    nof_pending = 0;
+  }
+
+private:
+  struct pending_block_t {
+    const uint8_t* in;
+    uint8_t*       out;
+    uint32_t       nof_bytes;
+  };
+
+  const aes128_key_ctx& ctx;
+  uint8_t               blocks[aes128_key_ctx::max_parallel_blocks][16];
+  pending_block_t       pending[aes128_key_ctx::max_parallel_blocks];
+  uint32_t              nof_pending = 0;
+};
+
+} // namespace
+
+/// Adds all the blocks of a PDU to the key stream generator.
+static void eea2_add_pdu(eea2_keystream& ks,
+                         uint32_t        count,
+                         uint8_t         bearer,
+                         uint8_t         direction,
+                         const uint8_t*  msg,
+                         uint32_t        msg_len,
+                         uint8_t*        out)
+{
+  // Initial counter block: COUNT, BEARER and DIRECTION followed by zeros, the last 64 bits are the block counter
+  uint8_t counter[16] = {};
+  counter[0]          = (count >> 24U) & 0xffU;
+  counter[1]          = (count >> 16U) & 0xffU;
+  counter[2]          = (count >> 8U) & 0xffU;
+  counter[3]          = count & 0xffU;
+  counter[4]          = ((bearer & 0x1fU) << 3U) | ((direction & 0x01U) << 2U);
+
+  for (uint64_t i = 0, offset = 0; offset < msg_len; i++, offset += 16) {
+    uint64_t block_counter = htobe64(i);
+    memcpy(&counter[8], &block_counter, 8);
+    ks.add_block(counter, &msg[offset], &out[offset], std::min(16U, msg_len - (uint32_t)offset));
+  }
+}
+
+uint8_t security_128_eea2(const aes128_key_ctx& ctx,
+                          uint32_t              count,
+                          uint8_t               bearer,
+                          uint8_t               direction,
+                          const uint8_t*        msg,
+                          uint32_t              msg_len,
+                          uint8_t*              msg_out)
+{
+  if (msg == nullptr || msg_out == nullptr) {
+    return SRSRAN_ERROR;
+  }
+
+  eea2_keystream ks(ctx);
+  eea2_add_pdu(ks, count, bearer, direction, msg, msg_len, msg_out);
+  ks.flush();
+
+  return SRSRAN_SUCCESS;
+}
+
+void security_128_eea2_batch(const aes128_key_ctx&            ctx,
+                             uint8_t                          bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus)
+{
+  eea2_keystream ks(ctx);
+  for (const security_batch_pdu_t& pdu : pdus) {
+    eea2_add_pdu(ks, pdu.count, bearer, direction, pdu.msg, pdu.msg_len, pdu.out);
+  }
+  ks.flush();
+}
+
+/******************************************************************************
+ * EIA2: AES-128 CMAC (TS 33.401 Annex B.2.3, RFC 4493)
+ *****************************************************************************/
+
+namespace {
+
+/// State of the CMAC chain of a PDU. The message authenticated is COUNT, BEARER and DIRECTION (8 bytes) followed by
+/// the PDU.
+struct eia2_chain_t {
+  const uint8_t* msg;
+  uint32_t       msg_len;
+  uint8_t        header[8];
+  uint32_t       nof_blocks;
+  uint8_t*       mac;
+
+  void init(uint32_t count, uint32_t bearer, uint8_t direction, const uint8_t* msg_, uint32_t msg_len_, uint8_t* mac_)
+  {
+    msg        = msg_;
+    msg_len    = msg_len_;
+    mac        = mac_;
+    header[0]  = (count >> 24U) & 0xffU;
+    header[1]  = (count >> 16U) & 0xffU;
+    header[2]  = (count >> 8U) & 0xffU;
+    header[3]  = count & 0xffU;
+    header[4]  = (uint8_t)((bearer << 3U) | (direction << 2U));
+    header[5]  = 0;
+    header[6]  = 0;
+    header[7]  = 0;
+    nof_blocks = (msg_len + 8 + 15) / 16;
+  }
+
+  /// XORs the i-th message block into the state, applying the padding and subkey to the last one.
+  void add_block(uint32_t i, const aes128_key_ctx& ctx, uint8_t* state) const
+  {
+    uint8_t  block[16] = {};
+    uint32_t nof_bytes = 0;
+    if (i == 0) {
+      memcpy(block, header, 8);
+      nof_bytes = 8 + std::min(8U, msg_len);
+      memcpy(&block[8], msg, nof_bytes - 8);
+    } else {
+      uint32_t offset = 16 * i - 8;
+      nof_bytes       = std::min(16U, msg_len - offset);
+      memcpy(block, &msg[offset], nof_bytes);
+    }
+
+    if (i == nof_blocks - 1) {
+      const uint8_t* subkey = ctx.get_cmac_k1();
+      if (nof_bytes < 16) {
+        block[nof_bytes] = 0x80;
+        subkey           = ctx.get_cmac_k2();
+      }
+      for (uint32_t j = 0; j < 16; j++) {
+        block[j] ^= subkey[j];
+      }
+    }
+
+    for (uint32_t j = 0; j < 16; j++) {
+      state[j] ^= block[j];
+    }
+  }
+};
+
+} // namespace
+
+/// Computes the CMAC of up to max_parallel_blocks PDUs, advancing their chains in lockstep.
+static void eia2_run_chains(const aes128_key_ctx& ctx, const eia2_chain_t* chains, uint32_t nof_chains)
+{
+  uint8_t  state[aes128_key_ctx::max_parallel_blocks][16] = {};
+  uint32_t max_blocks                                     = 0;
+  for (uint32_t c = 0; c < nof_chains; c++) {
+    max_blocks = std::max(max_blocks, chains[c].nof_blocks);
+  }
+
+  for (uint32_t i = 0; i < max_blocks; i++) {
+    // Chains that are already finished keep being encrypted, but their result is not used
+    uint8_t saved[aes128_key_ctx::max_parallel_blocks][16] = {};
+    for (uint32_t c = 0; c < nof_chains; c++) {
+      if (i < chains[c].nof_blocks) {
+        chains[c].add_block(i, ctx, state[c]);
+      } else {
+        memcpy(saved[c], state[c], 16);
+      }
+    }
+    ctx.encrypt_blocks(state, nof_chains);
+    for (uint32_t c = 0; c < nof_chains; c++) {
+      if (i >= chains[c].nof_blocks) {
+        memcpy(state[c], saved[c], 16);
+      }
+    }
+  }
+
+  for (uint32_t c = 0; c < nof_chains; c++) {
+    memcpy(chains[c].mac, state[c], 4);
+  }
+}
+
+uint8_t security_128_eia2(const aes128_key_ctx& ctx,
+                          uint32_t              count,
+                          uint32_t              bearer,
+                          uint8_t               direction,
+                          const uint8_t*        msg,
+                          uint32_t              msg_len,
+                          uint8_t*              mac)
+{
+  if (msg == nullptr || mac == nullptr) {
+    return SRSRAN_ERROR;
+  }
+
+  eia2_chain_t chain;
+  chain.init(count, bearer, direction, msg, msg_len, mac);
+  eia2_run_chains(ctx, &chain, 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+void security_128_eia2_batch(const aes128_key_ctx&            ctx,
+                             uint32_t                         bearer,
+                             uint8_t                          direction,
+                             span<const security_batch_pdu_t> pdus)
+{
+  eia2_chain_t chains[aes128_key_ctx::max_parallel_blocks];
+  uint32_t     nof_chains = 0;
+
+  for (const security_batch_pdu_t& pdu : pdus) {
+    chains[nof_chains++].init(pdu.count, bearer, direction, pdu.msg, pdu.msg_len, pdu.out);
+    if (nof_chains == aes128_key_ctx::max_parallel_blocks) {
+      eia2_run_chains(ctx, chains, nof_chains);
+      nof_chains = 0;
+    }
+  }
+  if (nof_chains > 0) {
+    eia2_run_chains(ctx, chains, nof_chains);
+  }
+}
+
+} // namespace srsran
@@ -23,7 +23,10 @@
 #include "srsran/srslog/srslog.h"
 #include <assert.h>
 #include <chrono>
+#include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
+#include <unistd.h>
 
 #define DEBUG 0
 #define debug_thread(fmt, ...)                                                                                         \
@@ -268,13 +271,15 @@ std::string thread_pool::get_id()
 }
 
 /**************************************************************************
- *  task_thread_pool - uses a queue to enqueue callables, that start
- *  once a worker is available
+ *  task_thread_pool - uses a queue per worker to enqueue callables, that
+ *  start once a worker is available. Idle workers steal from other queues
  *************************************************************************/
 
 task_thread_pool::task_thread_pool(uint32_t nof_workers, bool start_deferred, int32_t prio_, uint32_t mask_) :
-  logger(srslog::fetch_basic_logger("POOL")), pending_tasks(max_task_num), workers(std::max(1u, nof_workers))
+  logger(srslog::fetch_basic_logger("POOL")), workers(std::max(1u, nof_workers))
 {
+  queues.reserve(max_nof_workers);
+  add_queues(workers.size());
   if (not start_deferred) {
     start(prio_, mask_);
   }
@@ -285,6 +290,18 @@ task_thread_pool::~task_thread_pool()
   stop();
 }
 
+void task_thread_pool::add_queues(uint32_t nof_workers)
+{
+  if (nof_workers > max_nof_workers) {
+    logger.error("Number of workers %u exceeds the maximum of %u", nof_workers, uint32_t(max_nof_workers));
+    nof_workers = max_nof_workers;
+  }
+  while (queues.size() < nof_workers) {
+    queues.emplace_back(new worker_queue());
+  }
+  nof_queues.store(queues.size(), std::memory_order_release);
+}
+
 void task_thread_pool::set_nof_workers(uint32_t nof_workers)
 {
   std::lock_guard<std::mutex> lock(queue_mutex);
@@ -293,9 +310,10 @@ void task_thread_pool::set_nof_workers(uint32_t nof_workers)
     return;
   }
   uint32_t old_size = workers.size();
-  workers.resize(nof_workers);
+  add_queues(nof_workers);
+  workers.resize(queues.size());
   if (running) {
-    for (uint32_t i = old_size; i < nof_workers; ++i) {
+    for (uint32_t i = old_size; i < workers.size(); ++i) {
       workers[i].reset(new worker_t(this, i));
     }
   }
@@ -338,23 +356,42 @@ void task_thread_pool::stop()
   }
 }
 
-void task_thread_pool::push_task(task_t&& task)
+/// Identifies the pool and queue of the worker running in the current thread, if any.
+static thread_local const void* this_worker_pool     = nullptr;
+static thread_local uint32_t    this_worker_queue_id = 0;
+
+void task_thread_pool::push_task(task_t&& task, task_priority task_prio)
 {
+  if (nof_pending.fetch_add(1) >= max_task_num) {
+    nof_pending.fetch_sub(1);
+    logger.error("Cannot push anymore tasks into the queue, maximum size is %u", uint32_t(max_task_num));
+    return;
+  }
+
+  // Tasks pushed by a worker of this pool stay in its own queue, while tasks pushed from other threads are spread
+  // across the workers
+  uint32_t qidx = (this_worker_pool == this) ? this_worker_queue_id
+                                             : next_queue.fetch_add(1, std::memory_order_relaxed) %
+                                                   nof_queues.load(std::memory_order_acquire);
   {
-    std::lock_guard<std::mutex> lock(queue_mutex);
-    if (pending_tasks.full()) {
-      logger.error("Cannot push anymore tasks into the queue, maximum size is %u", uint32_t(max_task_num));
-      return;
+    worker_queue&               q = *queues[qidx];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks[(size_t)task_prio].push_back(std::move(task));
+    q.nof_tasks.fetch_add(1, std::memory_order_release);
+  }
+
+  // Only wake up a worker if there is any sleeping. Pairs with the sequence of wait_task()
+  if (nof_sleeping.load() > 0) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex);
     }
-    pending_tasks.push(std::move(task));
+    cv_empty.notify_one();
   }
-  cv_empty.notify_one();
 }
 
 uint32_t task_thread_pool::nof_pending_tasks() const
 {
-  std::lock_guard<std::mutex> lock(queue_mutex);
-  return pending_tasks.size();
+  return nof_pending.load(std::memory_order_relaxed);
 }
 
 task_thread_pool::worker_t::worker_t(srsran::task_thread_pool* parent_, uint32_t my_id) :
@@ -362,6 +399,22 @@ task_thread_pool::worker_t::worker_t(srsran::task_thread_pool* parent_, uint32_t
 {
   if (parent->mask == 255) {
     start(parent->prio);
+  } else if (parent->pin_workers) {
+    // pin the worker to the n-th CPU of the mask, in a round-robin fashion. The affinity is set by the worker thread
+    // itself, as the thread attributes only cover the first 8 CPUs
+    uint32_t nof_cpus = std::min<long>(sysconf(_SC_NPROCESSORS_CONF), sizeof(parent->mask) * 8);
+    uint32_t cpus[sizeof(parent->mask) * 8], nof_mask_cpus = 0;
+    for (uint32_t i = 0; i < nof_cpus; ++i) {
+      if ((parent->mask & (1u << i)) != 0) {
+        cpus[nof_mask_cpus++] = i;
+      }
+    }
+    if (nof_mask_cpus > 0) {
+      pinned_cpu = cpus[my_id % nof_mask_cpus];
+      start(parent->prio);
+    } else {
+      start_cpu_mask(parent->prio, parent->mask);
+    }
   } else {
     start_cpu_mask(parent->prio, parent->mask);
   }
@@ -372,24 +425,70 @@ void task_thread_pool::worker_t::stop()
   wait_thread_finish();
 }
 
-bool task_thread_pool::worker_t::wait_task(task_t* task)
+bool task_thread_pool::worker_t::try_pop_task(worker_queue& q, task_t* task)
 {
-  std::unique_lock<std::mutex> lock(parent->queue_mutex);
-  while (parent->running and parent->pending_tasks.empty()) {
-    parent->cv_empty.wait(lock);
-  }
-  if (not parent->running) {
+  if (q.nof_tasks.load(std::memory_order_acquire) == 0) {
     return false;
   }
-  if (task) {
-    *task = std::move(parent->pending_tasks.top());
+  std::lock_guard<std::mutex> lock(q.mutex);
+  for (size_t p = 0; p < (size_t)task_priority::nof_priorities; ++p) {
+    if (not q.tasks[p].empty()) {
+      *task = std::move(q.tasks[p].front());
+      q.tasks[p].pop_front();
+      q.nof_tasks.fetch_sub(1, std::memory_order_relaxed);
+      parent->nof_pending.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
   }
-  parent->pending_tasks.pop();
-  return true;
+  return false;
+}
+
+bool task_thread_pool::worker_t::try_pop_task(task_t* task)
+{
+  uint32_t nof_queues = parent->nof_queues.load(std::memory_order_acquire);
+
+  // Pop the highest priority task of the worker own queue. Only steal from the other workers when it is empty, so
+  // priorities are only strict within a queue
+  for (uint32_t count = 0; count < nof_queues; ++count) {
+    if (try_pop_task(*parent->queues[(id_ + count) % nof_queues], task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool task_thread_pool::worker_t::wait_task(task_t* task)
+{
+  while (parent->running.load(std::memory_order_relaxed)) {
+    if (try_pop_task(task)) {
+      return true;
+    }
+
+    // No tasks found. Sleep until a new task is pushed
+    std::unique_lock<std::mutex> lock(parent->queue_mutex);
+    parent->nof_sleeping.fetch_add(1);
+    while (parent->running and parent->nof_pending.load() == 0) {
+      parent->cv_empty.wait(lock);
+    }
+    parent->nof_sleeping.fetch_sub(1);
+  }
+  return false;
 }
 
 void task_thread_pool::worker_t::run_thread()
 {
+  this_worker_pool     = parent;
+  this_worker_queue_id = id_;
+
+  if (pinned_cpu >= 0) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(pinned_cpu, &cpuset);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+      parent->logger.warning("Could not pin %s to CPU %d", get_name().c_str(), pinned_cpu);
+    }
+  }
+
   // main loop
   task_t task;
   while (wait_task(&task)) {
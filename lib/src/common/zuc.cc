@@ -30,6 +30,7 @@
 ---------------------------------------------------------*/
 
 #include "srsran/common/zuc.h"
+#include "keystream_lanes.h"
 
 #define MAKEU32(a, b, c, d) (((u32)(a) << 24) | ((u32)(b) << 16) | ((u32)(c) << 8) | ((u32)(d)))
 #define MulByPow2(x, k) ((((x) << k) | ((x) >> (31 - k))) & 0x7FFFFFFF)
@@ -252,3 +253,190 @@ void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keyst
     LFSRWithWorkMode(state);
   }
 }
+
+#ifdef KEYSTREAM_LANES_HAVE_SIMD
+
+namespace {
+
+using lanes     = srsran::keystream_lanes;
+using zuc_reg_t = lanes::reg_t;
+
+/* S-Boxes S0 and S1 shifted to the position of the byte they are applied to, so that the S-Box of a word is the OR
+ * of four lookups. */
+struct zuc_tables_t {
+  u32 s[4][256];
+};
+
+zuc_tables_t zuc_build_tables()
+{
+  zuc_tables_t t;
+  for (u32 b = 0; b < 256; b++) {
+    t.s[0][b] = (u32)S0[b] << 24;
+    t.s[1][b] = (u32)S1[b] << 16;
+    t.s[2][b] = (u32)S0[b] << 8;
+    t.s[3][b] = (u32)S1[b];
+  }
+  return t;
+}
+
+const zuc_tables_t& zuc_get_tables()
+{
+  static const zuc_tables_t tables = zuc_build_tables();
+  return tables;
+}
+
+/* State of keystream_lanes::nof_lanes ZUC generators clocked in lockstep. The LFSR is a ring buffer, s[p] being
+ * LFSR_S0, so that clocking it does not move any data. */
+struct zuc_multi_state_t {
+  zuc_reg_t s[16];
+  zuc_reg_t r1, r2;
+};
+
+/* c = a + b mod (2^31 – 1), as AddM() */
+inline zuc_reg_t zuc_add_mod(zuc_reg_t a, zuc_reg_t b)
+{
+  zuc_reg_t c = lanes::add(a, b);
+  return lanes::add(lanes::band(c, lanes::set1(0x7FFFFFFF)), lanes::shr<31>(c));
+}
+
+/* MulByPow2() */
+template <int K>
+inline zuc_reg_t zuc_mul_pow2(zuc_reg_t x)
+{
+  return lanes::band(lanes::bor(lanes::shl<K>(x), lanes::shr<31 - K>(x)), lanes::set1(0x7FFFFFFF));
+}
+
+/* L1() */
+inline zuc_reg_t zuc_l1_lanes(zuc_reg_t x)
+{
+  zuc_reg_t r = lanes::bxor(x, lanes::rotl<2>(x));
+  r           = lanes::bxor(r, lanes::rotl<10>(x));
+  r           = lanes::bxor(r, lanes::rotl<18>(x));
+  return lanes::bxor(r, lanes::rotl<24>(x));
+}
+
+/* L2() */
+inline zuc_reg_t zuc_l2_lanes(zuc_reg_t x)
+{
+  zuc_reg_t r = lanes::bxor(x, lanes::rotl<8>(x));
+  r           = lanes::bxor(r, lanes::rotl<14>(x));
+  r           = lanes::bxor(r, lanes::rotl<22>(x));
+  return lanes::bxor(r, lanes::rotl<30>(x));
+}
+
+inline zuc_reg_t zuc_sbox_lanes(const zuc_tables_t& t, zuc_reg_t w)
+{
+  const zuc_reg_t mask = lanes::set1(0xff);
+  zuc_reg_t       r    = lanes::lookup(t.s[0], lanes::shr<24>(w));
+  r = lanes::bor(r, lanes::lookup(t.s[1], lanes::band(lanes::shr<16>(w), mask)));
+  r = lanes::bor(r, lanes::lookup(t.s[2], lanes::band(lanes::shr<8>(w), mask)));
+  return lanes::bor(r, lanes::lookup(t.s[3], lanes::band(w, mask)));
+}
+
+/* Runs BitReorganization, F and the LFSR of all lanes once, with the LFSR starting at position P. In initialisation
+ * mode the output of F is fed back into the LFSR, otherwise the keystream word is returned. */
+template <uint32_t P, bool init>
+inline zuc_reg_t zuc_clock_lanes(const zuc_tables_t& t, zuc_multi_state_t& st)
+{
+  zuc_reg_t*      s   = st.s;
+  const zuc_reg_t s0  = s[P];
+  const zuc_reg_t s15 = s[(P + 15) % 16];
+
+  // BitReorganization
+  zuc_reg_t x0 = lanes::bor(lanes::shl<1>(lanes::band(s15, lanes::set1(0x7FFF8000))),
+                            lanes::band(s[(P + 14) % 16], lanes::set1(0xFFFF)));
+  zuc_reg_t x1 = lanes::bor(lanes::shl<16>(s[(P + 11) % 16]), lanes::shr<15>(s[(P + 9) % 16]));
+  zuc_reg_t x2 = lanes::bor(lanes::shl<16>(s[(P + 7) % 16]), lanes::shr<15>(s[(P + 5) % 16]));
+  zuc_reg_t x3 = lanes::bor(lanes::shl<16>(s[(P + 2) % 16]), lanes::shr<15>(s0));
+
+  // F
+  zuc_reg_t w  = lanes::add(lanes::bxor(x0, st.r1), st.r2);
+  zuc_reg_t w1 = lanes::add(st.r1, x1);
+  zuc_reg_t w2 = lanes::bxor(st.r2, x2);
+  zuc_reg_t u  = zuc_l1_lanes(lanes::bor(lanes::shl<16>(w1), lanes::shr<16>(w2)));
+  zuc_reg_t v  = zuc_l2_lanes(lanes::bor(lanes::shl<16>(w2), lanes::shr<16>(w1)));
+  st.r1        = zuc_sbox_lanes(t, u);
+  st.r2        = zuc_sbox_lanes(t, v);
+
+  // LFSR
+  zuc_reg_t f = zuc_add_mod(s0, zuc_mul_pow2<8>(s0));
+  f           = zuc_add_mod(f, zuc_mul_pow2<20>(s[(P + 4) % 16]));
+  f           = zuc_add_mod(f, zuc_mul_pow2<21>(s[(P + 10) % 16]));
+  f           = zuc_add_mod(f, zuc_mul_pow2<17>(s[(P + 13) % 16]));
+  f           = zuc_add_mod(f, zuc_mul_pow2<15>(s15));
+  if (init) {
+    f = zuc_add_mod(f, lanes::shr<1>(w));
+  }
+  s[P] = f;
+
+  return lanes::bxor(w, x3);
+}
+
+} // namespace
+
+static void
+zuc_generate_keystream_lanes(u32 nof_lanes, const u8 k[][16], const u8 iv[][16], const u32* len, u32* const* ks)
+{
+  constexpr u32       L = lanes::nof_lanes;
+  const zuc_tables_t& t = zuc_get_tables();
+
+  // Initial state of every lane, as in zuc_initialize(). Unused lanes are left with a zero key.
+  alignas(64) u32 init[16][L] = {};
+  u32             max_len     = 0;
+  for (u32 l = 0; l < nof_lanes; l++) {
+    for (u32 i = 0; i < 16; i++) {
+      init[i][l] = MAKEU31(k[l][i], EK_d[i], iv[l][i]);
+    }
+    max_len = (len[l] > max_len) ? len[l] : max_len;
+  }
+
+  zuc_multi_state_t st;
+  for (u32 i = 0; i < 16; i++) {
+    st.s[i] = lanes::load(init[i]);
+  }
+  st.r1 = st.r2 = lanes::set1(0);
+
+  // 32 rounds in initialisation mode leave the LFSR aligned at position 0
+  for (u32 i = 0; i < 2; i++) {
+    srsran::keystream_unroll([&](auto p) { zuc_clock_lanes<decltype(p)::value, true>(t, st); },
+                             std::make_integer_sequence<uint32_t, 16>{});
+  }
+
+  // Clock once discarding the output of F, the keystream then starts at position 1
+  zuc_clock_lanes<0, false>(t, st);
+
+  alignas(64) u32 z[16][L];
+  for (u32 offset = 0; offset < max_len; offset += 16) {
+    srsran::keystream_unroll(
+        [&](auto i) { lanes::store(z[i], zuc_clock_lanes<(decltype(i)::value + 1) % 16, false>(t, st)); },
+        std::make_integer_sequence<uint32_t, 16>{});
+
+    // Write out the words of every lane that it needs
+    for (u32 l = 0; l < nof_lanes; l++) {
+      for (u32 i = 0; i < 16 && offset + i < len[l]; i++) {
+        ks[l][offset + i] = z[i][l];
+      }
+    }
+  }
+}
+
+#endif // KEYSTREAM_LANES_HAVE_SIMD
+
+void zuc_generate_keystream_multi(u32 nof_streams, const u8 k[][16], const u8 iv[][16], const u32* len, u32* const* ks)
+{
+#ifdef KEYSTREAM_LANES_HAVE_SIMD
+  for (u32 i = 0; i < nof_streams; i += srsran::keystream_lanes::nof_lanes) {
+    u32 nof_lanes = nof_streams - i;
+    if (nof_lanes > srsran::keystream_lanes::nof_lanes) {
+      nof_lanes = srsran::keystream_lanes::nof_lanes;
+    }
+    zuc_generate_keystream_lanes(nof_lanes, &k[i], &iv[i], &len[i], &ks[i]);
+  }
+#else  // KEYSTREAM_LANES_HAVE_SIMD
+  for (u32 i = 0; i < nof_streams; i++) {
+    zuc_state_t state;
+    zuc_initialize(&state, k[i], (u8*)iv[i]);
+    zuc_generate_keystream(&state, len[i], ks[i]);
+  }
+#endif // KEYSTREAM_LANES_HAVE_SIMD
+}
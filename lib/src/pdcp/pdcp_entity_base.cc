@@ -44,6 +44,23 @@ void pdcp_entity_base::config_security(const as_security_config_t& sec_cfg_)
   logger.debug(sec_cfg.k_up_enc.data(), 32, "K_up_enc");
   logger.debug(sec_cfg.k_rrc_int.data(), 32, "K_rrc_int");
   logger.debug(sec_cfg.k_up_int.data(), 32, "K_up_int");
+
+  // Expand the AES key schedules once, instead of for every PDU
+  if (sec_cfg.cipher_algo == CIPHERING_ALGORITHM_ID_128_EEA2) {
+    k_rrc_enc_ctx.set_key(&sec_cfg.k_rrc_enc[16]);
+    k_up_enc_ctx.set_key(&sec_cfg.k_up_enc[16]);
+  }
+  if (sec_cfg.integ_algo == INTEGRITY_ALGORITHM_ID_128_EIA2) {
+    k_rrc_int_ctx.set_key(&sec_cfg.k_rrc_int[16]);
+    k_up_int_ctx.set_key(&sec_cfg.k_up_int[16]);
+  }
+}
+
+void pdcp_entity_base::write_sdus(std::vector<unique_byte_buffer_t> sdus)
+{
+  for (unique_byte_buffer_t& sdu : sdus) {
+    write_sdu(std::move(sdu));
+  }
 }
 
 /****************************************************************************
@@ -67,7 +84,8 @@ void pdcp_entity_base::integrity_generate(uint8_t* msg, uint32_t msg_len, uint32
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
+      security_128_eia2(
+          is_srb() ? k_rrc_int_ctx : k_up_int_ctx, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
@@ -105,7 +123,8 @@ bool pdcp_entity_base::integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
+      security_128_eia2(
+          is_srb() ? k_rrc_int_ctx : k_up_int_ctx, count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
@@ -162,8 +181,8 @@ void pdcp_entity_base::cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t c
       memcpy(ct, ct_tmp, msg_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
-      memcpy(ct, ct_tmp, msg_len);
+      security_128_eea2(
+          is_srb() ? k_rrc_enc_ctx : k_up_enc_ctx, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
@@ -202,8 +221,8 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
       memcpy(msg, msg_tmp, ct_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
-      memcpy(msg, msg_tmp, ct_len);
+      security_128_eea2(
+          is_srb() ? k_rrc_enc_ctx : k_up_enc_ctx, count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
@@ -215,6 +234,37 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
   logger.debug(msg, ct_len, "Cipher decrypt output msg");
 }
 
+void pdcp_entity_base::cipher_encrypt_batch(span<const security_batch_pdu_t> pdus)
+{
+  if (pdus.empty()) {
+    return;
+  }
+
+  uint8_t* k_enc = is_srb() ? sec_cfg.k_rrc_enc.data() : sec_cfg.k_up_enc.data();
+
+  logger.debug("Cipher encrypt batch: %zd PDUs, Bearer ID: %d, Direction %s",
+               pdus.size(),
+               cfg.bearer_id,
+               cfg.tx_direction == SECURITY_DIRECTION_DOWNLINK ? "Downlink" : "Uplink");
+
+  switch (sec_cfg.cipher_algo) {
+    case CIPHERING_ALGORITHM_ID_128_EEA1:
+      security_128_eea1_batch(&k_enc[16], cfg.bearer_id - 1, cfg.tx_direction, pdus);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2:
+      security_128_eea2_batch(is_srb() ? k_rrc_enc_ctx : k_up_enc_ctx, cfg.bearer_id - 1, cfg.tx_direction, pdus);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA3:
+      security_128_eea3_batch(&k_enc[16], cfg.bearer_id - 1, cfg.tx_direction, pdus);
+      break;
+    default:
+      for (const security_batch_pdu_t& pdu : pdus) {
+        cipher_encrypt(pdu.msg, pdu.msg_len, pdu.count, pdu.out);
+      }
+      break;
+  }
+}
+
 /****************************************************************************
  * Common pack functions
  ***************************************************************************/
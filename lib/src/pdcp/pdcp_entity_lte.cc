@@ -144,20 +144,60 @@ void pdcp_entity_lte::reset()
 
 // GW/RRC interface
 void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
+{
+  uint32_t tx_count;
+  if (not prepare_tx_pdu(sdu, upper_sn, tx_count)) {
+    return;
+  }
+
+  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+    cipher_encrypt(
+        &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_count, &sdu->msg[cfg.hdr_len_bytes]);
+  }
+
+  send_tx_pdu(std::move(sdu), tx_count);
+}
+
+void pdcp_entity_lte::write_sdus(std::vector<unique_byte_buffer_t> sdus)
+{
+  // Build all the PDUs first, so that they can be ciphered in one go
+  tx_cipher_batch.clear();
+  tx_batch_counts.resize(sdus.size());
+  for (uint32_t i = 0; i < sdus.size(); i++) {
+    if (not prepare_tx_pdu(sdus[i], -1, tx_batch_counts[i])) {
+      sdus[i] = nullptr;
+      continue;
+    }
+    if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+      uint8_t* payload = &sdus[i]->msg[cfg.hdr_len_bytes];
+      tx_cipher_batch.push_back({payload, sdus[i]->N_bytes - cfg.hdr_len_bytes, tx_batch_counts[i], payload});
+    }
+  }
+
+  cipher_encrypt_batch(tx_cipher_batch);
+
+  for (uint32_t i = 0; i < sdus.size(); i++) {
+    if (sdus[i] != nullptr) {
+      send_tx_pdu(std::move(sdus[i]), tx_batch_counts[i]);
+    }
+  }
+}
+
+bool pdcp_entity_lte::prepare_tx_pdu(unique_byte_buffer_t& sdu, int upper_sn, uint32_t& tx_count)
 {
   if (!active) {
     logger.warning("Dropping %s SDU due to inactive bearer", rb_name.c_str());
-    return;
+    return false;
   }
 
   if (rlc->is_suspended(lcid)) {
     logger.warning("Trying to send SDU while re-establishment is in progress. Dropping SDU. LCID=%d", lcid);
-    return;
+    return false;
   }
 
   if (rlc->sdu_queue_is_full(lcid)) {
     logger.info(sdu->msg, sdu->N_bytes, "Dropping %s SDU due to full queue", rb_name.c_str());
-    return;
+    return false;
   }
 
   // Get COUNT to be used with this packet
@@ -168,7 +208,7 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
     used_sn = upper_sn; // SN provided by the upper layers, due to handover.
   }
 
-  uint32_t tx_count = COUNT(st.tx_hfn, used_sn); // Normal scenario
+  tx_count = COUNT(st.tx_hfn, used_sn); // Normal scenario
 
   // If the bearer is mapped to RLC AM, save TX_COUNT and a copy of the PDU.
   // This will be used for reestablishment, where unack'ed PDUs will be re-transmitted.
@@ -179,7 +219,7 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
     if (not store_sdu(used_sn, sdu)) {
       // Could not store the SDU, discarding
       logger.warning("Could not store SDU. Discarding SN=%d", used_sn);
-      return;
+      return false;
     }
   }
   // check for pending security config in transmit direction
@@ -202,19 +242,6 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
     append_mac(sdu, mac);
   }
 
-  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
-    cipher_encrypt(
-        &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_count, &sdu->msg[cfg.hdr_len_bytes]);
-  }
-
-  logger.info(sdu->msg,
-              sdu->N_bytes,
-              "TX %s PDU, SN=%d, integrity=%s, encryption=%s",
-              rb_name.c_str(),
-              used_sn,
-              srsran_direction_text[integrity_direction],
-              srsran_direction_text[encryption_direction]);
-
   // Set SDU metadata for RLC AM
   sdu->md.pdcp_sn = used_sn;
 
@@ -227,14 +254,27 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu, int upper_sn)
     }
   }
 
+  return true;
+}
+
+void pdcp_entity_lte::send_tx_pdu(unique_byte_buffer_t pdu, uint32_t tx_count)
+{
+  logger.info(pdu->msg,
+              pdu->N_bytes,
+              "TX %s PDU, SN=%d, integrity=%s, encryption=%s",
+              rb_name.c_str(),
+              SN(tx_count),
+              srsran_direction_text[integrity_direction],
+              srsran_direction_text[encryption_direction]);
+
   // Pass PDU to lower layers
   metrics.num_tx_pdus++;
-  metrics.num_tx_pdu_bytes += sdu->N_bytes;
+  metrics.num_tx_pdu_bytes += pdu->N_bytes;
   // Count TX'd bytes as if they were ACK'd if RLC is UM
   if (rlc->rb_is_um(lcid)) {
     metrics.num_tx_acked_bytes = metrics.num_tx_pdu_bytes;
   }
-  rlc->write_sdu(lcid, std::move(sdu));
+  rlc->write_sdu(lcid, std::move(pdu));
 }
 
 // RLC interface
@@ -769,10 +809,10 @@ void pdcp_entity_lte::notify_delivery(const pdcp_sn_vector_t& pdcp_sns)
       // Metrics
       auto& sdu = (*undelivered_sdus)[sn];
       tx_pdu_ack_latency_ms.push(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                     std::chrono::high_resolution_clock::now() - sdu->get_timestamp())
+                                     std::chrono::high_resolution_clock::now() - sdu.get_timestamp())
                                      .count());
-      metrics.num_tx_acked_bytes += sdu->N_bytes;
-      metrics.num_tx_buffered_pdus_bytes -= sdu->N_bytes;
+      metrics.num_tx_acked_bytes += sdu.length();
+      metrics.num_tx_buffered_pdus_bytes -= sdu.length();
 
       // Remove PDU and disarm timer.
       undelivered_sdus->clear_sdu(sn);
@@ -902,9 +942,9 @@ bool undelivered_sdus_queue::add_sdu(uint32_t                              sn,
     }
   }
 
-  // Allocate buffer and exit on error
-  srsran::unique_byte_buffer_t tmp = make_byte_buffer();
-  if (tmp == nullptr) {
+  // Copy SDU into a buffer sized to its length, and exit on error
+  srsran::byte_buffer_chain tmp = make_byte_buffer_chain(*sdu);
+  if (not tmp.has_value()) {
     return false;
   }
 
@@ -917,15 +957,13 @@ bool undelivered_sdus_queue::add_sdu(uint32_t                              sn,
   }
   // Add SDU
   count++;
-  sdus[sn].sdu             = std::move(tmp);
-  sdus[sn].sdu->md.pdcp_sn = sn;
-  sdus[sn].sdu->N_bytes    = sdu->N_bytes;
-  memcpy(sdus[sn].sdu->msg, sdu->msg, sdu->N_bytes);
+  sdus[sn].sdu            = std::move(tmp);
+  sdus[sn].sdu.md.pdcp_sn = sn;
   if (discard_timeout > 0) {
     sdus[sn].discard_timer.set(discard_timeout, std::move(callback));
     sdus[sn].discard_timer.run();
   }
-  sdus[sn].sdu->set_timestamp(); // Metrics
+  sdus[sn].sdu.set_timestamp(); // Metrics
   bytes += sdu->N_bytes;
   return true;
 }
@@ -936,9 +974,9 @@ bool undelivered_sdus_queue::clear_sdu(uint32_t sn)
     return false;
   }
   count--;
-  bytes -= sdus[sn].sdu->N_bytes;
+  bytes -= sdus[sn].sdu.length();
   sdus[sn].discard_timer.stop();
-  sdus[sn].sdu.reset();
+  sdus[sn].sdu.clear();
   // Find next FMS, if necessary
   if (sn == fms) {
     update_fms();
@@ -953,14 +991,14 @@ void undelivered_sdus_queue::clear()
   fms   = 0;
   for (uint32_t sn = 0; sn < capacity; sn++) {
     sdus[sn].discard_timer.stop();
-    sdus[sn].sdu.reset();
+    sdus[sn].sdu.clear();
   }
 }
 
 size_t undelivered_sdus_queue::nof_discard_timers() const
 {
   return std::count_if(sdus.begin(), sdus.end(), [](const sdu_data& s) {
-    return s.sdu != nullptr and s.discard_timer.is_valid() and s.discard_timer.is_running();
+    return s.sdu.has_value() and s.discard_timer.is_valid() and s.discard_timer.is_running();
   });
 }
 
@@ -1001,12 +1039,10 @@ std::map<uint32_t, srsran::unique_byte_buffer_t> undelivered_sdus_queue::get_buf
 {
   std::map<uint32_t, srsran::unique_byte_buffer_t> fwd_sdus;
   for (auto& sdu : sdus) {
-    if (sdu.sdu != nullptr) {
-      // TODO: Find ways to avoid deep copy
-      srsran::unique_byte_buffer_t fwd_sdu = make_byte_buffer();
+    if (sdu.sdu.has_value()) {
+      srsran::unique_byte_buffer_t fwd_sdu = make_byte_buffer(sdu.sdu);
       if (fwd_sdu != nullptr) {
-        *fwd_sdu = *sdu.sdu;
-        fwd_sdus.emplace(sdu.sdu->md.pdcp_sn, std::move(fwd_sdu));
+        fwd_sdus.emplace(sdu.sdu.md.pdcp_sn, std::move(fwd_sdu));
       } else {
         srslog::fetch_basic_logger("PDCP").warning("Can't allocate buffer to forward buffered SDUs.");
       }
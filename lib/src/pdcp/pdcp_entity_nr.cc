@@ -101,6 +101,50 @@ void pdcp_entity_nr::reset()
 
 // SDAP/RRC interface
 void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
+{
+  uint32_t tx_count;
+  if (not prepare_tx_pdu(sdu, tx_count)) {
+    return;
+  }
+
+  // TS 38.323, section 5.8: Ciphering
+  // The data unit that is ciphered is the MAC-I and the
+  // data part of the PDCP Data PDU except the
+  // SDAP header and the SDAP Control PDU if included in the PDCP SDU.
+  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+    cipher_encrypt(
+        &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_count, &sdu->msg[cfg.hdr_len_bytes]);
+  }
+
+  send_tx_pdu(std::move(sdu), tx_count);
+}
+
+void pdcp_entity_nr::write_sdus(std::vector<unique_byte_buffer_t> sdus)
+{
+  // Build all the PDUs first, so that they can be ciphered in one go
+  tx_cipher_batch.clear();
+  tx_batch_counts.resize(sdus.size());
+  for (uint32_t i = 0; i < sdus.size(); i++) {
+    if (not prepare_tx_pdu(sdus[i], tx_batch_counts[i])) {
+      sdus[i] = nullptr;
+      continue;
+    }
+    if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+      uint8_t* payload = &sdus[i]->msg[cfg.hdr_len_bytes];
+      tx_cipher_batch.push_back({payload, sdus[i]->N_bytes - cfg.hdr_len_bytes, tx_batch_counts[i], payload});
+    }
+  }
+
+  cipher_encrypt_batch(tx_cipher_batch);
+
+  for (uint32_t i = 0; i < sdus.size(); i++) {
+    if (sdus[i] != nullptr) {
+      send_tx_pdu(std::move(sdus[i]), tx_batch_counts[i]);
+    }
+  }
+}
+
+bool pdcp_entity_nr::prepare_tx_pdu(unique_byte_buffer_t& sdu, uint32_t& tx_count)
 {
   // Log SDU
   logger.info(sdu->msg,
@@ -113,13 +157,13 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
 
   if (rlc->sdu_queue_is_full(lcid)) {
     logger.info(sdu->msg, sdu->N_bytes, "Dropping %s SDU due to full queue", rb_name.c_str());
-    return;
+    return false;
   }
 
   // Check for COUNT overflow
   if (tx_overflow) {
     logger.warning("TX_NEXT has overflowed. Dropping packet");
-    return;
+    return false;
   }
   if (tx_next + 1 == 0) {
     tx_overflow = true;
@@ -152,34 +196,30 @@ void pdcp_entity_nr::write_sdu(unique_byte_buffer_t sdu, int sn)
     append_mac(sdu, mac);
   }
 
-  // TS 38.323, section 5.8: Ciphering
-  // The data unit that is ciphered is the MAC-I and the
-  // data part of the PDCP Data PDU except the
-  // SDAP header and the SDAP Control PDU if included in the PDCP SDU.
-  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
-    cipher_encrypt(
-        &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_next, &sdu->msg[cfg.hdr_len_bytes]);
-  }
-
   // Set meta-data for RLC AM
   sdu->md.pdcp_sn = tx_next;
 
-  logger.info(sdu->msg,
-              sdu->N_bytes,
+  // Increment TX_NEXT
+  tx_count = tx_next++;
+
+  return true;
+}
+
+void pdcp_entity_nr::send_tx_pdu(unique_byte_buffer_t pdu, uint32_t tx_count)
+{
+  logger.info(pdu->msg,
+              pdu->N_bytes,
               "TX %s PDU (%dB), HFN=%d, SN=%d, integrity=%s, encryption=%s",
               rb_name.c_str(),
-              sdu->N_bytes,
-              HFN(tx_next),
-              SN(tx_next),
+              pdu->N_bytes,
+              HFN(tx_count),
+              SN(tx_count),
               srsran_direction_text[integrity_direction],
               srsran_direction_text[encryption_direction]);
 
   // Check if PDCP is associated with more than on RLC entity TODO
   // Write to lower layers
-  rlc->write_sdu(lcid, std::move(sdu));
-
-  // Increment TX_NEXT
-  tx_next++;
+  rlc->write_sdu(lcid, std::move(pdu));
 }
 
 // RLC interface
@@ -22,11 +22,24 @@
 #include "srsran/phy/fec/crc.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <string.h>
 
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif // LV_HAVE_SSE
 
+// Carry-less multiply folding is used for long buffers when the target supports it
+#if defined(LV_HAVE_SSE) && defined(__PCLMUL__)
+#define CRC_HAVE_CLMUL
+#endif // defined(LV_HAVE_SSE) && defined(__PCLMUL__)
+
+// Minimum number of bytes for using carry-less multiply folding
+#define CRC_CLMUL_MIN_NBYTES 64
+
+// Number of bits packed at once when computing the CRC of unpacked bits
+#define CRC_PACK_NBITS 2048
+
 static void gen_crc_table(srsran_crc_t* h)
 {
   uint32_t pad        = (h->order < 8) ? (8 - h->order) : 0;
@@ -45,6 +58,164 @@ static void gen_crc_table(srsran_crc_t* h)
     }
     h->table[i] = (crc >> pad) & h->crcmask;
   }
+
+  // Slicing-by-8 tables, the CRC is aligned to the MSB so that any order up to 32 shares the same algorithm
+  uint32_t shift = 32 - h->order;
+  for (uint32_t i = 0; i < 256; i++) {
+    h->table8[0][i] = (uint32_t)h->table[i] << shift;
+  }
+  for (uint32_t k = 1; k < 8; k++) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t prev   = h->table8[k - 1][i];
+      h->table8[k][i] = (prev << 8U) ^ h->table8[0][prev >> 24U];
+    }
+  }
+}
+
+// Computes x^n modulo the CRC polynomial
+static uint64_t gen_crc_xpow_mod(const srsran_crc_t* h, uint32_t n)
+{
+  uint64_t r = 1;
+  for (uint32_t i = 0; i < n; i++) {
+    bool bit = r & h->crchighbit;
+    r <<= 1U;
+    if (bit) {
+      r ^= (uint64_t)h->polynom;
+    }
+  }
+  return r & h->crcmask;
+}
+
+static void gen_crc_fold_constants(srsran_crc_t* h)
+{
+  h->fold_k[0] = gen_crc_xpow_mod(h, 128 + 64);
+  h->fold_k[1] = gen_crc_xpow_mod(h, 128);
+  h->fold_k[2] = gen_crc_xpow_mod(h, 512 + 64);
+  h->fold_k[3] = gen_crc_xpow_mod(h, 512);
+}
+
+// Updates the CRC register with a number of bytes using the slicing-by-8 tables
+static uint32_t crc_update_slice8(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t nbytes)
+{
+  uint32_t shift = 32 - h->order;
+  uint32_t r     = crc << shift;
+
+  for (; nbytes >= 8; nbytes -= 8, data += 8) {
+    uint32_t x = r ^ ((uint32_t)data[0] << 24U | (uint32_t)data[1] << 16U | (uint32_t)data[2] << 8U | data[3]);
+    r          = h->table8[7][x >> 24U] ^ h->table8[6][(x >> 16U) & 0xffU] ^ h->table8[5][(x >> 8U) & 0xffU] ^
+        h->table8[4][x & 0xffU] ^ h->table8[3][data[4]] ^ h->table8[2][data[5]] ^ h->table8[1][data[6]] ^
+        h->table8[0][data[7]];
+  }
+
+  for (; nbytes > 0; nbytes--, data++) {
+    r = (r << 8U) ^ h->table8[0][(r >> 24U) ^ *data];
+  }
+
+  return r >> shift;
+}
+
+#ifdef CRC_HAVE_CLMUL
+// Folds the 128 bit accumulator a distance given by the constants k and adds the next block
+static inline __m128i crc_fold_clmul(__m128i acc, __m128i k, __m128i next)
+{
+  __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+  __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+// Reverses the byte order of a 128 bit block
+static inline __m128i crc_bswap_clmul(__m128i x)
+{
+  return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+// Loads 16 bytes so that the first byte is the most significant
+static inline __m128i crc_load_clmul(const uint8_t* data)
+{
+  return crc_bswap_clmul(_mm_loadu_si128((const __m128i*)data));
+}
+
+// Updates the CRC register with a number of bytes (at least CRC_CLMUL_MIN_NBYTES) folding 128 bit blocks. The
+// accumulator keeps a polynomial congruent to the data modulo the CRC polynomial, and it is finally reduced with the
+// slicing-by-8 tables along with the remaining bytes.
+static uint32_t crc_update_clmul(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t nbytes)
+{
+  const __m128i k1 = _mm_set_epi64x((long long)h->fold_k[0], (long long)h->fold_k[1]);
+  const __m128i k4 = _mm_set_epi64x((long long)h->fold_k[2], (long long)h->fold_k[3]);
+
+  // The initial CRC value is added to the first bits of the data
+  __m128i x0 = _mm_xor_si128(crc_load_clmul(data), _mm_set_epi64x((long long)((uint64_t)crc << (64U - h->order)), 0));
+  __m128i x1 = crc_load_clmul(data + 16);
+  __m128i x2 = crc_load_clmul(data + 32);
+  __m128i x3 = crc_load_clmul(data + 48);
+  data += 64;
+  nbytes -= 64;
+
+  // Fold four blocks in parallel to hide the multiplication latency
+  for (; nbytes >= 64; nbytes -= 64, data += 64) {
+    x0 = crc_fold_clmul(x0, k4, crc_load_clmul(data));
+    x1 = crc_fold_clmul(x1, k4, crc_load_clmul(data + 16));
+    x2 = crc_fold_clmul(x2, k4, crc_load_clmul(data + 32));
+    x3 = crc_fold_clmul(x3, k4, crc_load_clmul(data + 48));
+  }
+
+  __m128i x = crc_fold_clmul(x0, k1, x1);
+  x         = crc_fold_clmul(x, k1, x2);
+  x         = crc_fold_clmul(x, k1, x3);
+  for (; nbytes >= 16; nbytes -= 16, data += 16) {
+    x = crc_fold_clmul(x, k1, crc_load_clmul(data));
+  }
+
+  uint8_t acc[16];
+  _mm_storeu_si128((__m128i*)acc, crc_bswap_clmul(x));
+
+  crc = crc_update_slice8(h, 0, acc, 16);
+  return crc_update_slice8(h, crc, data, nbytes);
+}
+#endif // CRC_HAVE_CLMUL
+
+// Updates the CRC register with a number of bytes, selecting the fastest available method
+static uint32_t crc_update(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t nbytes)
+{
+#ifdef CRC_HAVE_CLMUL
+  if (nbytes >= CRC_CLMUL_MIN_NBYTES) {
+    return crc_update_clmul(h, crc, data, nbytes);
+  }
+#endif // CRC_HAVE_CLMUL
+  return crc_update_slice8(h, crc, data, nbytes);
+}
+
+// Packs unpacked bits (one bit per byte, MSB first) into bytes
+static void crc_pack_bits(const uint8_t* bits, uint8_t* bytes, uint32_t nbytes)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX2
+  // Reverse the bytes within each group of 8, so the first bit ends up in the MSB of the mask byte
+  const __m256i reverse = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  for (; i + 4 <= nbytes; i += 4) {
+    __m256i v    = _mm256_loadu_si256((const __m256i*)&bits[8 * i]);
+    __m256i mask = _mm256_shuffle_epi8(_mm256_cmpgt_epi8(v, _mm256_setzero_si256()), reverse);
+    uint32_t m   = (uint32_t)_mm256_movemask_epi8(mask);
+    memcpy(&bytes[i], &m, sizeof(m));
+  }
+#endif // LV_HAVE_AVX2
+
+#ifdef LV_HAVE_SSE
+  const __m128i reverse_sse = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  for (; i + 2 <= nbytes; i += 2) {
+    __m128i  v    = _mm_loadu_si128((const __m128i*)&bits[8 * i]);
+    __m128i  mask = _mm_shuffle_epi8(_mm_cmpgt_epi8(v, _mm_setzero_si128()), reverse_sse);
+    uint16_t m    = (uint16_t)_mm_movemask_epi8(mask);
+    memcpy(&bytes[i], &m, sizeof(m));
+  }
+#endif // LV_HAVE_SSE
+
+  for (; i < nbytes; i++) {
+    uint8_t* ptr = (uint8_t*)&bits[8 * i];
+    bytes[i]     = (uint8_t)(srsran_bit_pack(&ptr, 8) & 0xffU);
+  }
 }
 
 uint64_t reversecrcbit(uint32_t crc, int nbits, srsran_crc_t* h)
@@ -86,56 +257,36 @@ int srsran_crc_init(srsran_crc_t* h, uint32_t crc_poly, int crc_order)
     return -1;
   }
 
-  // generate lookup table
+  // generate lookup tables
   gen_crc_table(h);
+  gen_crc_fold_constants(h);
 
   return 0;
 }
 
 uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
 {
-  int      i, k, len8, res8, a = 0;
   uint32_t crc = 0;
-  uint8_t* pter;
-
-  srsran_crc_set_init(h, 0);
+  int      len8 = (len >> 3);
+  int      res8 = (len - (len8 << 3));
 
-  // Pack bits into bytes
-  len8 = (len >> 3);
-  res8 = (len - (len8 << 3));
-  if (res8 > 0) {
-    a = 1;
+  // Calculate CRC over the complete bytes, packing the bits in chunks
+  uint8_t packed[CRC_PACK_NBITS / 8];
+  for (int i = 0; i < len8 * 8; i += CRC_PACK_NBITS) {
+    uint32_t nbytes = SRSRAN_MIN(len8 * 8 - i, CRC_PACK_NBITS) / 8;
+    crc_pack_bits(&data[i], packed, nbytes);
+    crc = crc_update(h, crc, packed, nbytes);
   }
+  h->crcinit = crc;
 
-  // Calculate CRC
-  for (i = 0; i < len8 + a; i++) {
-    pter = (uint8_t*)(data + 8 * i);
-    uint8_t byte;
-    if (i == len8) {
-      byte = 0x00;
-      for (k = 0; k < res8; k++) {
-        byte |= ((uint8_t) * (pter + k)) << (7 - k);
-      }
-    } else {
-#ifdef LV_HAVE_SSE
-      // Get 8 Bit
-      __m64 mask = _mm_cmpgt_pi8(*((__m64*)pter), _mm_set1_pi8(0));
-
-      // Reverse
-      mask = _mm_shuffle_pi8(mask, _mm_set_pi8(0, 1, 2, 3, 4, 5, 6, 7));
-
-      // Get mask and write
-      byte = (uint8_t)_mm_movemask_pi8(mask);
-#else  /* LV_HAVE_SSE */
-      byte = (uint8_t)(srsran_bit_pack(&pter, 8) & 0xFF);
-#endif /* LV_HAVE_SSE */
+  // Calculate CRC over the remaining bits and reverse CRC res8 positions
+  if (res8 > 0) {
+    uint8_t byte = 0x00;
+    for (int k = 0; k < res8; k++) {
+      byte |= (uint8_t)(data[len8 * 8 + k] << (7 - k));
     }
     srsran_crc_checksum_put_byte(h, byte);
-  }
-  crc = (uint32_t)srsran_crc_checksum_get(h);
-
-  // Reverse CRC res8 positions
-  if (a == 1) {
+    crc = (uint32_t)srsran_crc_checksum_get(h);
     crc = reversecrcbit(crc, 8 - res8, h);
   }
 
@@ -146,16 +297,8 @@ uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
 // len is multiple of 8
 uint32_t srsran_crc_checksum_byte(srsran_crc_t* h, const uint8_t* data, int len)
 {
-  int      i;
-  uint32_t crc = 0;
-
-  srsran_crc_set_init(h, 0);
-
-  // Calculate CRC
-  for (i = 0; i < len / 8; i++) {
-    srsran_crc_checksum_put_byte(h, data[i]);
-  }
-  crc = (uint32_t)srsran_crc_checksum_get(h);
+  uint32_t crc = crc_update(h, 0, data, len / 8);
+  h->crcinit   = crc;
 
   return crc;
 }
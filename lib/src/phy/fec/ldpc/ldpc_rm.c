@@ -40,6 +40,10 @@
 
 #include "srsran/phy/utils/debug.h"
 
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
 //#define debug
 /*!
  * \brief Look-up table: k0 indices
@@ -103,8 +107,7 @@ struct pRM_rx_s {
  * \brief Describes an rate dematcher (char version).
  */
 struct pRM_rx_c {
-  int8_t*   tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
-  uint32_t* indices;       /*!< \brief Pointer to a temporal buffer with the indices for bit-selection. */
+  int8_t* tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
 };
 
 /*!
@@ -288,6 +291,28 @@ static void bit_selection_rm_rx_s(const int16_t* input,
   }
 }
 
+/*!
+ * Adds a run of soft bits to consecutive codeword positions, saturating the result to +/-max.
+ */
+static void combine_rm_rx_c(const int8_t* input, int8_t* output, const uint32_t len, const int8_t max)
+{
+  uint32_t i = 0;
+#ifdef LV_HAVE_AVX2
+  const __m256i max_vec = _mm256_set1_epi8(max);
+  const __m256i min_vec = _mm256_set1_epi8((int8_t)-max);
+  for (; i + 32 <= len; i += 32) {
+    __m256i x = _mm256_adds_epi8(_mm256_loadu_si256((const __m256i*)&output[i]),
+                                 _mm256_loadu_si256((const __m256i*)&input[i]));
+    x         = _mm256_max_epi8(_mm256_min_epi8(x, max_vec), min_vec);
+    _mm256_storeu_si256((__m256i*)&output[i], x);
+  }
+#endif
+  for (; i < len; i++) {
+    int32_t tmp = (int32_t)output[i] + input[i];
+    output[i]   = (int8_t)SRSRAN_MIN(SRSRAN_MAX(tmp, -max), max);
+  }
+}
+
 /*!
  * Undoes bit selection for the rate-dematching block (int8_t).
  * The output has the codeword length N. It inserts filler bits as INFINITY symbols
@@ -295,11 +320,12 @@ static void bit_selection_rm_rx_s(const int16_t* input,
  * missing symbol. Repeated symbols are added.
  * The input memory *output shall be either initialized to all zeros or to the
  * result of previous redundancy versions is available.
+ * The selected bits are consecutive codeword positions, except for the filler bits and the circular buffer wrap, so
+ * they are combined in runs.
  */
 static void bit_selection_rm_rx_c(const int8_t*  input,
                                   const uint32_t in_len,
                                   int8_t*        output,
-                                  uint32_t*      indices,
                                   const uint32_t ini_exclude,
                                   const uint32_t end_exclude,
                                   const uint32_t k0,
@@ -307,18 +333,6 @@ static void bit_selection_rm_rx_c(const int8_t*  input,
 {
   uint32_t E = in_len;
 
-  uint32_t k    = 0;
-  uint32_t j    = 0;
-  uint32_t icwd = 0;
-  while (k < E) {
-    icwd = (k0 + j) % Ncb;
-    if (!(icwd >= ini_exclude && icwd < end_exclude)) { // avoid filler bits
-      indices[k] = icwd;
-      k          = k + 1;
-    }
-    j = j + 1;
-  } // while
-
   // set filler bits to INFINITY
   const long infinity8 = (1U << 7U) - 1; // Max positive value in 8-bit representation
   for (uint32_t i = ini_exclude; i < end_exclude; i++) {
@@ -329,16 +343,21 @@ static void bit_selection_rm_rx_c(const int8_t*  input,
   const int16_t infinity7 =
       (1U << 6U) - 1; // Messages use a 15-bit quantization. Soft bits use the remaining bit to denote infinity.
   // input is assume to be quantized from -infinity15 to infinity15. Only filler bits can be infinity16
-  long tmp = 0;
-  for (uint32_t i = 0; i < E; i++) {
-    tmp = (long)output[indices[i]] + input[i];
-    if (tmp > infinity7) {
-      tmp = infinity7;
+  uint32_t k    = 0;
+  uint32_t icwd = k0 % Ncb;
+  while (k < E) {
+    if (icwd >= ini_exclude && icwd < end_exclude) { // avoid filler bits
+      icwd = end_exclude;
     }
-    if (tmp < -infinity7) {
-      tmp = -infinity7;
+    if (icwd >= Ncb) {
+      icwd = 0;
+      continue;
     }
-    output[indices[i]] = (int8_t)tmp;
+    uint32_t end = (icwd < ini_exclude) ? ini_exclude : Ncb;
+    uint32_t len = SRSRAN_MIN(end - icwd, E - k);
+    combine_rm_rx_c(&input[k], &output[icwd], len, (int8_t)infinity7);
+    k += len;
+    icwd += len;
   }
 }
 
@@ -509,12 +528,6 @@ int srsran_ldpc_rm_rx_init_c(srsran_ldpc_rm_t* p)
     return -1;
   }
 
-  if ((pp->indices = srsran_vec_u32_malloc(MAXE)) == NULL) {
-    free(pp->tmp_rm_symbol);
-    free(pp);
-    return -1;
-  }
-
   return 0;
 }
 
@@ -571,9 +584,6 @@ void srsran_ldpc_rm_rx_free_c(srsran_ldpc_rm_t* q)
       if (qq->tmp_rm_symbol != NULL) {
         free(qq->tmp_rm_symbol);
       }
-      if (qq->indices != NULL) {
-        free(qq->indices);
-      }
       free(qq);
     }
   }
@@ -690,15 +700,14 @@ int srsran_ldpc_rm_rx_c(srsran_ldpc_rm_t*        q,
 
   struct pRM_rx_c* pp            = q->ptr;
   int8_t*          tmp_rm_symbol = pp->tmp_rm_symbol;
-  uint32_t*        indices       = pp->indices;
   uint32_t         end_exclude   = q->K - 2 * q->ls;
   uint32_t         ini_exclude   = end_exclude - q->F;
 
   if (q->mod_order == 1) { // interleaver can be skipped
-    bit_selection_rm_rx_c(input, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx_c(input, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   } else {
     bit_interleaver_rm_rx_c(input, tmp_rm_symbol, q->E, q->mod_order);
-    bit_selection_rm_rx_c(tmp_rm_symbol, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx_c(tmp_rm_symbol, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   }
 
   // Return the number of useful LLR
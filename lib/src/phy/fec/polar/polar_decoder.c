@@ -37,6 +37,7 @@
 #include <math.h>
 #include <string.h>
 
+#include "polar_decoder_scl_c.h"
 #include "polar_decoder_ssc_c.h"
 #include "polar_decoder_ssc_c_avx2.h"
 #include "polar_decoder_ssc_f.h"
@@ -114,6 +115,40 @@ static int decode_ssc_c_avx2(void*           o,
 }
 #endif // LV_HAVE_AVX2
 
+/*! SCL Polar decoder with int8_t LLR inputs, it gives all the candidate messages. */
+static int decode_list_scl_c(void*           o,
+                             const int8_t*   symbols,
+                             uint8_t**       data,
+                             const uint8_t   n,
+                             const uint16_t* frozen_set,
+                             const uint16_t  frozen_set_size)
+{
+  srsran_polar_decoder_t* q = o;
+
+  if (init_polar_decoder_scl_c(q->ptr, symbols, n, frozen_set, frozen_set_size) < 0) {
+    return -1;
+  }
+
+  return polar_decoder_scl_c(q->ptr, data, q->list_size);
+}
+
+/*! SCL Polar decoder with int8_t LLR inputs, it gives the most likely message. */
+static int decode_scl_c(void*           o,
+                        const int8_t*   symbols,
+                        uint8_t*        data,
+                        const uint8_t   n,
+                        const uint16_t* frozen_set,
+                        const uint16_t  frozen_set_size)
+{
+  srsran_polar_decoder_t* q = o;
+
+  if (init_polar_decoder_scl_c(q->ptr, symbols, n, frozen_set, frozen_set_size) < 0) {
+    return -1;
+  }
+
+  return (polar_decoder_scl_c(q->ptr, &data, 1) < 0) ? -1 : 0;
+}
+
 /*! Destructor of a (float) SSC polar decoder. */
 static void free_ssc_f(void* o)
 {
@@ -144,6 +179,13 @@ static void free_ssc_c_avx2(void* o)
 }
 #endif
 
+/*! Destructor of a (int8_t) SCL polar decoder. */
+static void free_scl_c(void* o)
+{
+  srsran_polar_decoder_t* q = o;
+  delete_polar_decoder_scl_c(q->ptr);
+}
+
 /*! Initializes a polar decoder structure to use the SSC polar decoder algorithm with float LLR inputs. */
 static int init_ssc_f(srsran_polar_decoder_t* q)
 {
@@ -203,9 +245,39 @@ static int init_ssc_c_avx2(srsran_polar_decoder_t* q)
 }
 #endif
 
+/*! Initializes a polar decoder structure to use the SCL polar decoder algorithm with uint8_t LLR inputs. */
+static int init_scl_c(srsran_polar_decoder_t* q, bool avx2)
+{
+  q->decode_c      = decode_scl_c;
+  q->decode_list_c = decode_list_scl_c;
+  q->free          = free_scl_c;
+
+  if (avx2) {
+    q->ptr = create_polar_decoder_scl_c_avx2(q->nMax, q->list_size);
+  } else {
+    q->ptr = create_polar_decoder_scl_c(q->nMax, q->list_size);
+  }
+
+  if (q->ptr == NULL) {
+    ERROR("create_polar_decoder_scl_c failed");
+    return -1;
+  }
+  return 0;
+}
+
 int srsran_polar_decoder_init(srsran_polar_decoder_t* q, srsran_polar_decoder_type_t type, const uint8_t nMax)
 {
-  q->nMax = nMax;
+  return srsran_polar_decoder_init_list(q, type, nMax, SRSRAN_POLAR_DECODER_DEFAULT_LIST_SIZE);
+}
+
+int srsran_polar_decoder_init_list(srsran_polar_decoder_t*     q,
+                                   srsran_polar_decoder_type_t type,
+                                   const uint8_t               nMax,
+                                   const uint8_t               list_size)
+{
+  q->nMax          = nMax;
+  q->list_size     = 1;
+  q->decode_list_c = NULL;
   switch (type) {
     case SRSRAN_POLAR_DECODER_SSC_F:
       return init_ssc_f(q);
@@ -216,6 +288,14 @@ int srsran_polar_decoder_init(srsran_polar_decoder_t* q, srsran_polar_decoder_ty
 #ifdef LV_HAVE_AVX2
     case SRSRAN_POLAR_DECODER_SSC_C_AVX2:
       return init_ssc_c_avx2(q);
+#endif
+    case SRSRAN_POLAR_DECODER_SCL_C:
+      q->list_size = list_size;
+      return init_scl_c(q, false);
+#ifdef LV_HAVE_AVX2
+    case SRSRAN_POLAR_DECODER_SCL_C_AVX2:
+      q->list_size = list_size;
+      return init_scl_c(q, true);
 #endif
     default:
       ERROR("Decoder not implemented");
@@ -273,3 +353,22 @@ int srsran_polar_decoder_decode_c(srsran_polar_decoder_t* q,
 
   return -1;
 }
+
+int srsran_polar_decoder_decode_list_c(srsran_polar_decoder_t* q,
+                                       const int8_t*           llr,
+                                       uint8_t**               data_decoded,
+                                       const uint8_t           n,
+                                       const uint16_t*         frozen_set,
+                                       const uint16_t          frozen_set_size)
+{
+  if (q->nMax < n) {
+    return -1;
+  }
+
+  // SSC decoders give a single candidate
+  if (q->decode_list_c == NULL) {
+    return (srsran_polar_decoder_decode_c(q, llr, data_decoded[0], n, frozen_set, frozen_set_size) < 0) ? -1 : 1;
+  }
+
+  return q->decode_list_c(q, llr, data_decoded, n, frozen_set, frozen_set_size);
+}
@@ -0,0 +1,686 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file polar_decoder_scl_c.c
+ * \brief Definition of the Fast-SSC list (SCL) polar decoder working with 8-bit integer-valued LLRs.
+ * \date 2022
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ * The decoder follows up to \f$L\f$ decoding paths, ranked by their path metric (the sum of the absolute LLR values
+ * of the decisions that contradict the hard decision). Besides the ::SCL_RATE_R nodes, which are split into their two
+ * children, the decoding tree is pruned at ::SCL_RATE_0, ::SCL_RATE_1, ::SCL_REP (repetition) and ::SCL_SPC (single
+ * parity-check) nodes, whose list decisions are taken at once as in the Fast-SSCL algorithm:
+ *  - ::SCL_RATE_1 nodes only fork on their \f$\min(L - 1, N_v)\f$ least reliable bits;
+ *  - ::SCL_REP nodes fork on the value of the repeated bit;
+ *  - ::SCL_SPC nodes fork on their \f$\min(L, N_v)\f$ least reliable bits, keeping the parity with the least
+ *    reliable one.
+ *
+ * Forking a path does not copy any LLR or partial-sum buffer: every path keeps, per stage, the index of the path whose
+ * buffer holds its data, and only writes to its own buffers (lazy copy). Since all paths write a given stage at the
+ * same point of the decoding tree, a buffer referenced by other paths is never modified before they read it.
+ *
+ */
+
+#include "polar_decoder_scl_c.h"
+#include "../utils_avx2.h"
+#include "polar_decoder_vector.h"
+#include "polar_decoder_vector_avx2.h"
+#include "srsran/phy/fec/polar/polar_code.h"
+#include "srsran/phy/fec/polar/polar_decoder.h"
+#include "srsran/phy/fec/polar/polar_encoder.h"
+#include "srsran/phy/utils/vector.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+#endif // LV_HAVE_AVX2
+
+/*!
+ * \brief Maximum number of decoding paths.
+ */
+#define SCL_MAX_L SRSRAN_POLAR_DECODER_MAX_LIST_SIZE
+
+/*!
+ * \brief Maximum number of path candidates when forking all the decoding paths.
+ */
+#define SCL_MAX_CANDIDATES (2 * SCL_MAX_L)
+
+/*!
+ * \brief Types of node in a Fast-SSC list decoder.
+ */
+typedef enum {
+  SCL_RATE_0 = 0, /*!< \brief All the bits are frozen. */
+  SCL_RATE_R,     /*!< \brief Generic node, decoded through its children. */
+  SCL_RATE_1,     /*!< \brief None of the bits is frozen. */
+  SCL_REP,        /*!< \brief Repetition node, all the bits but the last one are frozen. */
+  SCL_SPC,        /*!< \brief Single parity-check node, only the first bit is frozen. */
+} scl_node_type_t;
+
+/*!
+ * \brief Describes an SCL polar decoder (8-bit version).
+ */
+struct pSCL_c {
+  uint8_t  nMax;          /*!< \brief \f$log_2\f$ of the maximum code size. */
+  uint8_t  list_size;     /*!< \brief Maximum number of decoding paths. */
+  uint8_t  code_size_log; /*!< \brief \f$log_2\f$ of the current code size. */
+  uint8_t  nof_paths;     /*!< \brief Number of active decoding paths. */
+  uint8_t  path[SCL_MAX_L]; /*!< \brief Slots of the active decoding paths. */
+  int32_t  pm[SCL_MAX_L];   /*!< \brief Path metric of each slot. */
+  uint8_t  llr_src[SCL_MAX_L][NMAX_LOG + 1];  /*!< \brief Slot whose buffer holds the LLRs of each stage. */
+  uint8_t  beta_src[SCL_MAX_L][NMAX_LOG + 1]; /*!< \brief Slot whose buffer holds the left partial sums of a stage. */
+  int8_t*  llr[SCL_MAX_L][NMAX_LOG + 1];      /*!< \brief LLR buffers, \f$2^s\f$ values at stage \f$s\f$. */
+  uint8_t* beta[SCL_MAX_L][NMAX_LOG + 1];     /*!< \brief Partial sums of the left child node at each stage. */
+  uint8_t* est_bit[SCL_MAX_L];                /*!< \brief Partial sums of the node being decoded, per slot. */
+  uint16_t flip_pos[SCL_MAX_L][SCL_MAX_L];    /*!< \brief Least reliable bits of the current node, per slot. */
+  uint8_t  spc_flip[SCL_MAX_L];               /*!< \brief True if the least reliable bit of an SPC node is flipped. */
+  uint8_t  decision[SCL_MAX_L];               /*!< \brief Decision taken by each slot in the last fork. */
+  int8_t*  llr_buffer;                        /*!< \brief Memory of the LLR buffers. */
+  uint8_t* bit_buffer;                        /*!< \brief Memory of the partial sums buffers. */
+  uint8_t* node_type[NMAX_LOG + 1];           /*!< \brief Node type (::scl_node_type_t) at each stage. */
+  uint8_t* frozen;                            /*!< \brief Frozen bit indicator of the current code. */
+  srsran_polar_encoder_t enc;                 /*!< \brief Polar encoder, it recovers the message from a codeword. */
+  void (*f)(const int8_t* x, const int8_t* y, int8_t* z, const uint16_t len); /*!< \brief Pointer to the function-f. */
+  void (*g)(const uint8_t* b,
+            const int8_t*  x,
+            const int8_t*  y,
+            int8_t*        z,
+            const uint16_t len); /*!< \brief Pointer to the function-g. */
+  uint32_t (*select)(const int32_t* metric,
+                     const uint32_t nof_candidates,
+                     const uint32_t list_size); /*!< \brief Pointer to the path metric sorting function. */
+};
+
+/*!
+ * Returns a bit mask with the \a list_size candidates of lowest metric. Ties are resolved in favor of the candidate
+ * with the lowest index.
+ */
+static uint32_t select_paths(const int32_t* metric, const uint32_t nof_candidates, const uint32_t list_size)
+{
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < nof_candidates; i++) {
+    uint32_t rank = 0;
+    for (uint32_t j = 0; j < nof_candidates; j++) {
+      rank += (metric[j] < metric[i]) || (metric[j] == metric[i] && j < i);
+    }
+    if (rank < list_size) {
+      mask |= 1U << i;
+    }
+  }
+  return mask;
+}
+
+#ifdef LV_HAVE_AVX2
+/*!
+ * AVX2 version of select_paths(): the rank of each candidate is obtained by comparing its metric against all the
+ * metrics at once. The candidate index is appended to the metric so that all the keys are different.
+ */
+static uint32_t select_paths_avx2(const int32_t* metric, const uint32_t nof_candidates, const uint32_t list_size)
+{
+  int32_t key[SCL_MAX_CANDIDATES];
+  for (uint32_t i = 0; i < SCL_MAX_CANDIDATES; i++) {
+    key[i] = (i < nof_candidates) ? (int32_t)(((uint32_t)metric[i] << 4U) | i) : INT32_MAX;
+  }
+
+  __m256i m_key0 = _mm256_loadu_si256((__m256i*)&key[0]);
+  __m256i m_key1 = _mm256_loadu_si256((__m256i*)&key[8]);
+
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < nof_candidates; i++) {
+    __m256i m_k    = _mm256_set1_epi32(key[i]);
+    int     lower0 = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(m_k, m_key0)));
+    int     lower1 = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(m_k, m_key1)));
+    if ((uint32_t)__builtin_popcount(lower0 | (lower1 << 8)) < list_size) {
+      mask |= 1U << i;
+    }
+  }
+  return mask;
+}
+
+/*!
+ * Same as srsran_vec_function_g_bccc() with AVX2 instructions. Unlike srsran_vec_function_g_bccc_avx2(), the bits
+ * are represented by {0, 1}.
+ */
+static void function_g_bccc_avx2(const uint8_t* b, const int8_t* x, const int8_t* y, int8_t* z, const uint16_t len)
+{
+  if (len < SRSRAN_AVX2_B_SIZE) {
+    srsran_vec_function_g_bccc(b, x, y, z, len);
+    return;
+  }
+
+  const __m256i M_1      = _mm256_set1_epi8(1);
+  const __m256i M_NEG127 = _mm256_set1_epi8(-127);
+
+  for (int i = 0; i < len; i += SRSRAN_AVX2_B_SIZE) {
+    __m256i m_x = _mm256_loadu_si256((__m256i*)&x[i]);
+    __m256i m_y = _mm256_loadu_si256((__m256i*)&y[i]);
+    __m256i m_b = _mm256_loadu_si256((__m256i*)&b[i]);
+
+    // 1 - 2b gives +1 for the bit 0 and -1 for the bit 1
+    __m256i m_s  = _mm256_sub_epi8(M_1, _mm256_add_epi8(m_b, m_b));
+    __m256i m_z  = _mm256_adds_epi8(_mm256_sign_epi8(m_x, m_s), m_y);
+    __m256i m_sz = _mm256_max_epi8(M_NEG127, m_z);
+
+    _mm256_storeu_si256((__m256i*)&z[i], m_sz);
+  }
+}
+
+/*!
+ * Calls srsran_vec_function_f_ccc_avx2() for vectors of at least \ref SRSRAN_AVX2_B_SIZE LLRs and
+ * srsran_vec_function_f_ccc() otherwise.
+ */
+static void function_f_ccc_avx2(const int8_t* x, const int8_t* y, int8_t* z, const uint16_t len)
+{
+  if (len < SRSRAN_AVX2_B_SIZE) {
+    srsran_vec_function_f_ccc(x, y, z, len);
+  } else {
+    srsran_vec_function_f_ccc_avx2(x, y, z, len);
+  }
+}
+#endif // LV_HAVE_AVX2
+
+/*!
+ * Computes the node types of the decoding tree for the given frozen set.
+ */
+static void compute_node_type_scl(struct pSCL_c* pp, const uint16_t* frozen_set, const uint16_t frozen_set_size)
+{
+  uint8_t  n         = pp->code_size_log;
+  uint16_t code_size = 1U << n;
+
+  memset(pp->frozen, 0, code_size);
+  for (uint16_t i = 0; i < frozen_set_size; i++) {
+    pp->frozen[frozen_set[i]] = 1;
+  }
+
+  for (uint16_t j = 0; j < code_size; j++) {
+    pp->node_type[0][j] = pp->frozen[j] ? SCL_RATE_0 : SCL_RATE_1;
+  }
+
+  for (uint8_t s = 1; s <= n; s++) {
+    const uint8_t* child = pp->node_type[s - 1];
+    for (uint16_t j = 0; j < (1U << (n - s)); j++) {
+      uint8_t left  = child[2 * j];
+      uint8_t right = child[2 * j + 1];
+      uint8_t type  = SCL_RATE_R;
+      if (left == SCL_RATE_0 && right == SCL_RATE_0) {
+        type = SCL_RATE_0;
+      } else if (left == SCL_RATE_1 && right == SCL_RATE_1) {
+        type = SCL_RATE_1;
+      } else if (left == SCL_RATE_0 && (right == SCL_REP || (s == 1 && right == SCL_RATE_1))) {
+        type = SCL_REP;
+      } else if ((left == SCL_SPC || (s == 2 && left == SCL_REP)) && right == SCL_RATE_1) {
+        type = SCL_SPC;
+      }
+      pp->node_type[s][j] = type;
+    }
+  }
+}
+
+/*!
+ * Finds the \a nof_pos least reliable LLRs (lowest absolute value) and writes their positions in \a pos, sorted by
+ * increasing reliability.
+ */
+static void least_reliable(const int8_t* llr, const uint16_t len, uint16_t* pos, const uint32_t nof_pos)
+{
+  int32_t  val[SCL_MAX_L];
+  uint32_t count = 0;
+
+  for (uint16_t i = 0; i < len; i++) {
+    int32_t a = abs(llr[i]);
+    if (count == nof_pos && a >= val[count - 1]) {
+      continue;
+    }
+
+    // Insert in order, dropping the last one if the list is full
+    uint32_t j = (count < nof_pos) ? count++ : count - 1;
+    for (; j > 0 && val[j - 1] > a; j--) {
+      val[j] = val[j - 1];
+      pos[j] = pos[j - 1];
+    }
+    val[j] = a;
+    pos[j] = i;
+  }
+}
+
+/*!
+ * Copies the state of the path in slot \a src into slot \a dst, for a node at \a stage starting at bit \a bit_pos.
+ * Only the indexes to the LLR and partial sums buffers are copied (lazy copy), together with the partial sums of the
+ * current node.
+ */
+static void clone_path(struct pSCL_c* pp, uint8_t dst, uint8_t src, uint8_t stage, uint16_t bit_pos)
+{
+  uint8_t n = pp->code_size_log;
+  memcpy(pp->llr_src[dst], pp->llr_src[src], n + 1);
+  memcpy(pp->beta_src[dst], pp->beta_src[src], n + 1);
+  memcpy(pp->flip_pos[dst], pp->flip_pos[src], sizeof(pp->flip_pos[dst]));
+  memcpy(pp->est_bit[dst] + bit_pos, pp->est_bit[src] + bit_pos, 1U << stage);
+  pp->spc_flip[dst] = pp->spc_flip[src];
+}
+
+/*!
+ * Forks every active path into the decision 0, with metric \a metric[2 * i], and the decision 1, with metric
+ * \a metric[2 * i + 1], where \a i is the path index in \a pp->path. Then, it keeps the best \a pp->list_size paths.
+ * The decision taken by each surviving slot is written in \a pp->decision.
+ */
+static void fork_paths(struct pSCL_c* pp, const int32_t* metric, uint8_t stage, uint16_t bit_pos)
+{
+  uint32_t nof_candidates = 2 * pp->nof_paths;
+  uint32_t mask           = (1U << nof_candidates) - 1;
+  if (nof_candidates > pp->list_size) {
+    mask = pp->select(metric, nof_candidates, pp->list_size);
+  }
+
+  // Collect the slots that become free: the ones not used yet and the ones of the paths without any survivor
+  uint8_t used[SCL_MAX_L] = {};
+  uint8_t free_slot[SCL_MAX_L];
+  uint8_t nof_free = 0;
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    if ((mask >> (2 * i)) & 3U) {
+      used[pp->path[i]] = 1;
+    }
+  }
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    if (!used[l]) {
+      free_slot[nof_free++] = l;
+    }
+  }
+
+  // The first survivor of a path stays in its slot and the second one moves to a free slot
+  uint8_t nof_paths = 0;
+  uint8_t path[SCL_MAX_L];
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t  l    = pp->path[i];
+    uint32_t keep = (mask >> (2 * i)) & 3U;
+    if (keep == 3U) {
+      uint8_t k = free_slot[--nof_free];
+      clone_path(pp, k, l, stage, bit_pos);
+      pp->pm[k]         = metric[2 * i + 1];
+      pp->decision[k]   = 1;
+      path[nof_paths++] = k;
+    }
+    if (keep) {
+      pp->decision[l]   = (keep == 2U);
+      pp->pm[l]         = metric[2 * i + pp->decision[l]];
+      path[nof_paths++] = l;
+    }
+  }
+
+  memcpy(pp->path, path, nof_paths);
+  pp->nof_paths = nof_paths;
+}
+
+/*!
+ * Returns the LLRs at \a stage of the path in slot \a l.
+ */
+static inline const int8_t* path_llr(const struct pSCL_c* pp, uint8_t l, uint8_t stage)
+{
+  return pp->llr[pp->llr_src[l][stage]][stage];
+}
+
+/*!
+ * All bits below a ::SCL_RATE_0 node are 0. The path metrics increase with the LLRs in favor of the bit 1.
+ */
+static void rate_0_node(struct pSCL_c* pp, uint8_t stage, uint16_t bit_pos)
+{
+  uint16_t len = 1U << stage;
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t       l   = pp->path[i];
+    const int8_t* llr = path_llr(pp, l, stage);
+    int32_t       pm  = 0;
+    for (uint16_t j = 0; j < len; j++) {
+      pm -= (llr[j] < 0) ? llr[j] : 0;
+    }
+    pp->pm[l] += pm;
+    memset(pp->est_bit[l] + bit_pos, 0, len);
+  }
+}
+
+/*!
+ * ::SCL_RATE_1 nodes take the hard decision on all the bits, then fork on the \f$\min(L - 1, N_v)\f$ least
+ * reliable ones, one after the other.
+ */
+static void rate_1_node(struct pSCL_c* pp, uint8_t stage, uint16_t bit_pos)
+{
+  uint16_t len      = 1U << stage;
+  uint32_t nof_flip = SRSRAN_MIN(pp->list_size - 1U, len);
+  int32_t  metric[SCL_MAX_CANDIDATES];
+
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t       l   = pp->path[i];
+    const int8_t* llr = path_llr(pp, l, stage);
+    srsran_vec_hard_bit_cc(llr, pp->est_bit[l] + bit_pos, len);
+    least_reliable(llr, len, pp->flip_pos[l], nof_flip);
+  }
+
+  for (uint32_t t = 0; t < nof_flip; t++) {
+    for (uint32_t i = 0; i < pp->nof_paths; i++) {
+      uint8_t l         = pp->path[i];
+      metric[2 * i]     = pp->pm[l];
+      metric[2 * i + 1] = pp->pm[l] + abs(path_llr(pp, l, stage)[pp->flip_pos[l][t]]);
+    }
+    fork_paths(pp, metric, stage, bit_pos);
+    for (uint32_t i = 0; i < pp->nof_paths; i++) {
+      uint8_t l = pp->path[i];
+      pp->est_bit[l][bit_pos + pp->flip_pos[l][t]] ^= pp->decision[l];
+    }
+  }
+}
+
+/*!
+ * ::SCL_REP nodes fork on the repeated bit: all the bits are either 0 or 1.
+ */
+static void rep_node(struct pSCL_c* pp, uint8_t stage, uint16_t bit_pos)
+{
+  uint16_t len = 1U << stage;
+  int32_t  metric[SCL_MAX_CANDIDATES];
+
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t       l   = pp->path[i];
+    const int8_t* llr = path_llr(pp, l, stage);
+    int32_t       pm0 = 0;
+    int32_t       pm1 = 0;
+    for (uint16_t j = 0; j < len; j++) {
+      pm0 -= (llr[j] < 0) ? llr[j] : 0;
+      pm1 += (llr[j] > 0) ? llr[j] : 0;
+    }
+    metric[2 * i]     = pp->pm[l] + pm0;
+    metric[2 * i + 1] = pp->pm[l] + pm1;
+  }
+
+  fork_paths(pp, metric, stage, bit_pos);
+
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t l = pp->path[i];
+    memset(pp->est_bit[l] + bit_pos, pp->decision[l], len);
+  }
+}
+
+/*!
+ * ::SCL_SPC nodes take the hard decision on all the bits and satisfy the parity by flipping the least reliable one.
+ * Then, they fork on the next \f$\min(L, N_v) - 1\f$ least reliable bits: each flip also flips the least
+ * reliable bit, so that the parity is kept.
+ */
+static void spc_node(struct pSCL_c* pp, uint8_t stage, uint16_t bit_pos)
+{
+  uint16_t len      = 1U << stage;
+  uint32_t nof_flip = SRSRAN_MIN(pp->list_size, len);
+  int32_t  metric[SCL_MAX_CANDIDATES];
+
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t       l   = pp->path[i];
+    const int8_t* llr = path_llr(pp, l, stage);
+    uint8_t*      bit = pp->est_bit[l] + bit_pos;
+    srsran_vec_hard_bit_cc(llr, bit, len);
+    least_reliable(llr, len, pp->flip_pos[l], nof_flip);
+
+    uint8_t parity = 0;
+    for (uint16_t j = 0; j < len; j++) {
+      parity ^= bit[j];
+    }
+    bit[pp->flip_pos[l][0]] ^= parity;
+    pp->pm[l] += parity ? abs(llr[pp->flip_pos[l][0]]) : 0;
+    pp->spc_flip[l] = parity;
+  }
+
+  for (uint32_t t = 1; t < nof_flip; t++) {
+    for (uint32_t i = 0; i < pp->nof_paths; i++) {
+      uint8_t       l     = pp->path[i];
+      const int8_t* llr   = path_llr(pp, l, stage);
+      int32_t       a_min = abs(llr[pp->flip_pos[l][0]]);
+      metric[2 * i]       = pp->pm[l];
+      metric[2 * i + 1]   = pp->pm[l] + abs(llr[pp->flip_pos[l][t]]) + (pp->spc_flip[l] ? -a_min : a_min);
+    }
+    fork_paths(pp, metric, stage, bit_pos);
+    for (uint32_t i = 0; i < pp->nof_paths; i++) {
+      uint8_t l = pp->path[i];
+      if (pp->decision[l]) {
+        pp->est_bit[l][bit_pos + pp->flip_pos[l][t]] ^= 1;
+        pp->est_bit[l][bit_pos + pp->flip_pos[l][0]] ^= 1;
+        pp->spc_flip[l] ^= 1;
+      }
+    }
+  }
+}
+
+static void decode_node(struct pSCL_c* pp, uint8_t stage, uint16_t bit_pos);
+
+/*!
+ * ::SCL_RATE_R nodes decode their left child with the LLRs given by function-f, then their right child with the LLRs
+ * given by function-g and, finally, combine the partial sums of both.
+ */
+static void rate_r_node(struct pSCL_c* pp, uint8_t stage, uint16_t bit_pos)
+{
+  uint8_t  child = stage - 1;
+  uint16_t half  = 1U << child;
+
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t       l   = pp->path[i];
+    const int8_t* llr = path_llr(pp, l, stage);
+    pp->f(llr, llr + half, pp->llr[l][child], half);
+    pp->llr_src[l][child] = l;
+  }
+
+  decode_node(pp, child, bit_pos);
+
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t       l   = pp->path[i];
+    const int8_t* llr = path_llr(pp, l, stage);
+    memcpy(pp->beta[l][child], pp->est_bit[l] + bit_pos, half);
+    pp->beta_src[l][child] = l;
+    pp->g(pp->beta[l][child], llr, llr + half, pp->llr[l][child], half);
+    pp->llr_src[l][child] = l;
+  }
+
+  decode_node(pp, child, bit_pos + half);
+
+  for (uint32_t i = 0; i < pp->nof_paths; i++) {
+    uint8_t l = pp->path[i];
+    srsran_vec_xor_bbb(pp->beta[pp->beta_src[l][child]][child],
+                       pp->est_bit[l] + bit_pos + half,
+                       pp->est_bit[l] + bit_pos,
+                       half);
+  }
+}
+
+/*!
+ * Switches between the different types of node. On return, the partial sums of the node are in the \a est_bit buffer
+ * of every surviving path.
+ */
+static void decode_node(struct pSCL_c* pp, uint8_t stage, uint16_t bit_pos)
+{
+  switch (pp->node_type[stage][bit_pos >> stage]) {
+    case SCL_RATE_0:
+      rate_0_node(pp, stage, bit_pos);
+      break;
+    case SCL_RATE_1:
+      rate_1_node(pp, stage, bit_pos);
+      break;
+    case SCL_REP:
+      rep_node(pp, stage, bit_pos);
+      break;
+    case SCL_SPC:
+      spc_node(pp, stage, bit_pos);
+      break;
+    default:
+      rate_r_node(pp, stage, bit_pos);
+      break;
+  }
+}
+
+void delete_polar_decoder_scl_c(void* p)
+{
+  struct pSCL_c* pp = p;
+
+  if (p != NULL) {
+    free(pp->llr_buffer);
+    free(pp->bit_buffer);
+    srsran_polar_encoder_free(&pp->enc);
+    free(pp);
+  }
+}
+
+static void* create_polar_decoder_scl(const uint8_t nMax, const uint8_t list_size)
+{
+  struct pSCL_c* pp = NULL;
+
+  if (nMax > NMAX_LOG || list_size < 2 || list_size > SCL_MAX_L) {
+    ERROR("Invalid SCL polar decoder parameters (nMax=%d, list_size=%d)", nMax, list_size);
+    return NULL;
+  }
+
+  if ((pp = SRSRAN_MEM_ALLOC(struct pSCL_c, 1)) == NULL) {
+    return NULL;
+  }
+  SRSRAN_MEM_ZERO(pp, struct pSCL_c, 1);
+
+  pp->nMax      = nMax;
+  pp->list_size = list_size;
+  pp->f         = srsran_vec_function_f_ccc;
+  pp->g         = srsran_vec_function_g_bccc;
+  pp->select    = select_paths;
+
+  if (srsran_polar_encoder_init(&pp->enc, SRSRAN_POLAR_ENCODER_PIPELINED, nMax) < 0) {
+    free(pp);
+    return NULL;
+  }
+
+  // Every path has 2^(s) LLRs and partial sums for each stage s = 0, ..., nMax, placed at offset 2^s. Thus, each path
+  // needs 2^(nMax + 1) values.
+  uint32_t path_size = 1U << (nMax + 1U);
+  uint32_t code_size = 1U << nMax;
+
+  pp->llr_buffer = srsran_vec_i8_malloc(list_size * path_size);
+  // Partial sums per stage, plus the node partial sums of each path, the node types and the frozen bits
+  pp->bit_buffer = srsran_vec_u8_malloc(list_size * (path_size + code_size) + path_size + code_size);
+  if (pp->llr_buffer == NULL || pp->bit_buffer == NULL) {
+    delete_polar_decoder_scl_c(pp);
+    return NULL;
+  }
+
+  uint8_t* bit_ptr = pp->bit_buffer;
+  for (uint8_t l = 0; l < list_size; l++) {
+    for (uint8_t s = 0; s <= nMax; s++) {
+      pp->llr[l][s]  = pp->llr_buffer + l * path_size + (1U << s);
+      pp->beta[l][s] = bit_ptr + (1U << s);
+    }
+    pp->est_bit[l] = bit_ptr + path_size;
+    bit_ptr += path_size + code_size;
+  }
+
+  // Stage s has 2^(nMax - s) nodes, placed at offset 2^(nMax - s)
+  for (uint8_t s = 0; s <= nMax; s++) {
+    pp->node_type[s] = bit_ptr + (1U << (nMax - s));
+  }
+  pp->frozen = bit_ptr + path_size;
+
+  return pp;
+}
+
+void* create_polar_decoder_scl_c(const uint8_t nMax, const uint8_t list_size)
+{
+  return create_polar_decoder_scl(nMax, list_size);
+}
+
+void* create_polar_decoder_scl_c_avx2(const uint8_t nMax, const uint8_t list_size)
+{
+  struct pSCL_c* pp = create_polar_decoder_scl(nMax, list_size);
+
+#ifdef LV_HAVE_AVX2
+  if (pp != NULL) {
+    pp->f      = function_f_ccc_avx2;
+    pp->g      = function_g_bccc_avx2;
+    pp->select = select_paths_avx2;
+  }
+#endif // LV_HAVE_AVX2
+
+  return pp;
+}
+
+int init_polar_decoder_scl_c(void*           p,
+                             const int8_t*   input_llr,
+                             const uint8_t   code_size_log,
+                             const uint16_t* frozen_set,
+                             const uint16_t  frozen_set_size)
+{
+  struct pSCL_c* pp = p;
+
+  if (p == NULL || code_size_log > pp->nMax) {
+    return -1;
+  }
+
+  pp->code_size_log = code_size_log;
+  uint16_t code_size = 1U << code_size_log;
+
+  // The channel LLRs are stored in the first slot and shared by all the paths. -128 is saturated to -127, so that
+  // all the LLRs have a valid absolute value.
+  int8_t* llr = pp->llr[0][code_size_log];
+  for (uint16_t i = 0; i < code_size; i++) {
+    llr[i] = (input_llr[i] < -127) ? -127 : input_llr[i];
+  }
+  for (uint8_t l = 0; l < pp->list_size; l++) {
+    pp->llr_src[l][code_size_log] = 0;
+  }
+
+  // Start from a single path
+  pp->nof_paths = 1;
+  pp->path[0]   = 0;
+  pp->pm[0]     = 0;
+
+  compute_node_type_scl(pp, frozen_set, frozen_set_size);
+
+  return 0;
+}
+
+int polar_decoder_scl_c(void* p, uint8_t** data_decoded, const uint8_t max_candidates)
+{
+  struct pSCL_c* pp = p;
+
+  if (p == NULL || data_decoded == NULL) {
+    return -1;
+  }
+
+  decode_node(pp, pp->code_size_log, 0);
+
+  // Sort the surviving paths by increasing path metric
+  uint8_t path[SCL_MAX_L];
+  memcpy(path, pp->path, pp->nof_paths);
+  for (uint32_t i = 1; i < pp->nof_paths; i++) {
+    uint8_t l = path[i];
+    uint8_t j = i;
+    for (; j > 0 && pp->pm[path[j - 1]] > pp->pm[l]; j--) {
+      path[j] = path[j - 1];
+    }
+    path[j] = l;
+  }
+
+  // The message is the polar transform of the codeword partial sums
+  uint32_t nof_candidates = SRSRAN_MIN(max_candidates, pp->nof_paths);
+  for (uint32_t i = 0; i < nof_candidates; i++) {
+    srsran_polar_encoder_encode(&pp->enc, pp->est_bit[path[i]], data_decoded[i], pp->code_size_log);
+  }
+
+  return (int)nof_candidates;
+}
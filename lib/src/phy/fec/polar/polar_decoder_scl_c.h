@@ -0,0 +1,89 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file polar_decoder_scl_c.h
+ * \brief Declaration of the Fast-SSC list (SCL) polar decoder working with 8-bit integer-valued LLRs.
+ * \date 2022
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#ifndef POLAR_DECODER_SCL_C_H
+#define POLAR_DECODER_SCL_C_H
+#include <stdint.h>
+
+/*!
+ * Creates an (8-bit) SCL polar decoder structure of type pSCL_c, and allocates memory for the decoding buffers of
+ * \a list_size paths.
+ *
+ * \param[in] nMax \f$log_2\f$ of the maximum number of bits in the codeword.
+ * \param[in] list_size Maximum number of decoding paths (2 to \ref SRSRAN_POLAR_DECODER_MAX_LIST_SIZE).
+ * \return A pointer to a pSCL_c structure if the function executes correctly, NULL otherwise.
+ */
+void* create_polar_decoder_scl_c(const uint8_t nMax, const uint8_t list_size);
+
+/*!
+ * Same as create_polar_decoder_scl_c(), but the LLR updates and the path metric sorting use AVX2 instructions.
+ *
+ * \param[in] nMax \f$log_2\f$ of the maximum number of bits in the codeword.
+ * \param[in] list_size Maximum number of decoding paths (2 to \ref SRSRAN_POLAR_DECODER_MAX_LIST_SIZE).
+ * \return A pointer to a pSCL_c structure if the function executes correctly, NULL otherwise.
+ */
+void* create_polar_decoder_scl_c_avx2(const uint8_t nMax, const uint8_t list_size);
+
+/*!
+ * The (8-bit) SCL polar decoder "destructor": it frees all the resources allocated to the decoder.
+ *
+ * \param[in, out] p A pointer to the dismantled decoder.
+ */
+void delete_polar_decoder_scl_c(void* p);
+
+/*!
+ * Initializes an (8-bit) SCL polar decoder before processing a new codeword.
+ *
+ * \param[in, out] p A void pointer used to declare a pSCL_c structure.
+ * \param[in] llr LLRs for the new codeword.
+ * \param[in] code_size_log \f$log_2\f$ of the number of bits in the codeword.
+ * \param[in] frozen_set The position of the frozen bits in increasing order.
+ * \param[in] frozen_set_size The size of the frozen_set.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int init_polar_decoder_scl_c(void*           p,
+                             const int8_t*   llr,
+                             const uint8_t   code_size_log,
+                             const uint16_t* frozen_set,
+                             const uint16_t  frozen_set_size);
+
+/*!
+ * Decodes the codeword given to init_polar_decoder_scl_c() and writes the surviving candidate messages, sorted by
+ * increasing path metric (most likely first). Each of the \a data_decoded buffers must fit \f$2^{code\_size\_log}\f$
+ * bits.
+ *
+ * \param[in] p A pointer to the desired decoder.
+ * \param[out] data_decoded Array of at least \a max_candidates pointers to the decoded messages.
+ * \param[in] max_candidates Maximum number of candidate messages to write.
+ * \return The number of candidate messages written if the function executes correctly, -1 otherwise.
+ */
+int polar_decoder_scl_c(void* p, uint8_t** data_decoded, const uint8_t max_candidates);
+
+#endif // POLAR_DECODER_SCL_C_H
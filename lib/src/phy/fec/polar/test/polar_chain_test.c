@@ -44,6 +44,10 @@
  *  - <b>-s \<number\></b>  SNR [dB, Default 3.00 dB] -- Use 100 for scan, and 101 for noiseless.
  *  - <b>-o \<number\></b>  Print output results [Default 0] -- Use 0 for detailed, Use 1 for 1 line, Use 2 for vector
  * form.
+ *  - <b>-l \<number\></b>  List size of the SCL decoder [Default 8].
+ *
+ * The last bits of each message are a CRC (24 bits for nMax = 9, 11 or 6 bits for nMax = 10, as in TS 38.212), so
+ * the SCL decoder is also run CRC-aided: the first of its candidates passing the CRC is selected.
  *
  * Example 1: BCH - ./polar_chain_test -n9 -k56 -e864 -i0 -s101 -o1
  *
@@ -61,7 +65,9 @@
 #include "math.h"
 
 #include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/common/timestamp.h"
+#include "srsran/phy/fec/crc.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/phy_logger.h"
@@ -102,13 +108,14 @@ static uint8_t  nMax         = 9;   /*!< \brief Maximum \f$log_2(N)\f$, where \f
 static uint8_t  bil          = 0;   /*!< \brief If bil = 0 channel interleaver disabled. */
 static double   snr_db       = 3;   /*!< \brief SNR in dB (101 for no noise, 100 for scan). */
 static int      print_output = 0;   /*!< \brief print output form (0 for detailed, 1 for one line, 2 for vector). */
+static uint8_t  list_size    = 8;   /*!< \brief List size of the SCL decoder. */
 
 /*!
  * \brief Prints test help when a wrong parameter is passed as input.
  */
 void usage(char* prog)
 {
-  printf("Usage: %s [-nX] [-kX] [-eX] [-iX] [-sX] [-oX]\n", prog);
+  printf("Usage: %s [-nX] [-kX] [-eX] [-iX] [-sX] [-oX] [-lX]\n", prog);
   printf("\t-n nMax [Default %d]\n", nMax);
   printf("\t-k Message size [Default %d]\n", K);
   printf("\t-e Rate matching size [Default %d]\n", E);
@@ -116,6 +123,7 @@ void usage(char* prog)
   printf("\t-s SNR [dB, Default %.2f dB] -- Use 100 for scan, and 101 for noiseless\n", snr_db);
   printf("\t-o Print output results [Default %d] -- Use 0 for detailed, Use 1 for 1 line, Use 2 for vector form\n",
          print_output);
+  printf("\t-l SCL decoder list size [Default %d]\n", list_size);
 }
 
 /*!
@@ -124,7 +132,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt = 0;
-  while ((opt = getopt(argc, argv, "n:k:e:i:s:o:")) != -1) {
+  while ((opt = getopt(argc, argv, "n:k:e:i:s:o:l:")) != -1) {
     //  printf("opt : %d\n", opt);
     switch (opt) {
       case 'e':
@@ -145,6 +153,9 @@ void parse_args(int argc, char** argv)
       case 'o':
         print_output = (int)strtol(optarg, NULL, 10);
         break;
+      case 'l':
+        list_size = (uint8_t)strtol(optarg, NULL, 10);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -162,6 +173,8 @@ int main(int argc, char** argv)
   uint8_t* data_rx_s      = NULL;
   uint8_t* data_rx_c      = NULL;
   uint8_t* data_rx_c_avx2 = NULL;
+  uint8_t* data_rx_scl    = NULL;
+  uint8_t* data_rx_cascl  = NULL;
 
   uint8_t* input_enc       = NULL; // input encoder
   uint8_t* output_enc      = NULL; // output encoder
@@ -183,6 +196,10 @@ int main(int argc, char** argv)
   uint8_t* output_dec_s      = NULL; // output decoder
   uint8_t* output_dec_c      = NULL; // output decoder
   uint8_t* output_dec_c_avx2 = NULL; // output decoder
+  uint8_t* output_dec_scl    = NULL; // output decoder
+  uint8_t* output_dec_cascl  = NULL; // output decoder, one codeword per candidate
+
+  uint8_t* candidates[SRSRAN_POLAR_DECODER_MAX_LIST_SIZE] = {};
 
   double var[SNR_POINTS + 1];
 
@@ -199,11 +216,15 @@ int main(int argc, char** argv)
 #ifdef LV_HAVE_AVX2
   int errors_symb_c_avx2 = 0;
 #endif
+  int errors_symb_scl   = 0;
+  int errors_symb_cascl = 0;
 
   int n_error_words[SNR_POINTS + 1];
   int n_error_words_s[SNR_POINTS + 1];
   int n_error_words_c[SNR_POINTS + 1];
   int n_error_words_c_avx2[SNR_POINTS + 1];
+  int n_error_words_scl[SNR_POINTS + 1];
+  int n_error_words_cascl[SNR_POINTS + 1];
 
   int last_i_batch[SNR_POINTS + 1];
 
@@ -212,6 +233,8 @@ int main(int argc, char** argv)
   double         elapsed_time_dec_s[SNR_POINTS + 1];
   double         elapsed_time_dec_c[SNR_POINTS + 1];
   double         elapsed_time_dec_c_avx2[SNR_POINTS + 1];
+  double         elapsed_time_dec_scl[SNR_POINTS + 1];
+  double         elapsed_time_dec_cascl[SNR_POINTS + 1];
 
   double elapsed_time_enc[SNR_POINTS + 1];
   double elapsed_time_enc_avx2[SNR_POINTS + 1];
@@ -228,12 +251,14 @@ int main(int argc, char** argv)
   srsran_polar_code_t    code;
   srsran_polar_encoder_t enc;
   srsran_polar_decoder_t dec;
-  srsran_polar_decoder_t dec_s; // 16-bit
-  srsran_polar_decoder_t dec_c; // 8-bit
+  srsran_polar_decoder_t dec_s;   // 16-bit
+  srsran_polar_decoder_t dec_c;   // 8-bit
+  srsran_polar_decoder_t dec_scl; // 8-bit, list
   srsran_polar_rm_t      rm_tx;
   srsran_polar_rm_t      rm_rx_f;
   srsran_polar_rm_t      rm_rx_s;
   srsran_polar_rm_t      rm_rx_c;
+  srsran_crc_t           crc;
 
 #ifdef LV_HAVE_AVX2
   srsran_polar_encoder_t enc_avx2;
@@ -278,6 +303,28 @@ int main(int argc, char** argv)
   srsran_polar_decoder_init(&dec_c_avx2, SRSRAN_POLAR_DECODER_SSC_C_AVX2, nMax);
 #endif // LV_HAVE_AVX2
 
+  // initialize a POLAR list decoder (8 bit, avx2 if available)
+#ifdef LV_HAVE_AVX2
+  srsran_polar_decoder_type_t scl_type = SRSRAN_POLAR_DECODER_SCL_C_AVX2;
+#else  // LV_HAVE_AVX2
+  srsran_polar_decoder_type_t scl_type = SRSRAN_POLAR_DECODER_SCL_C;
+#endif // LV_HAVE_AVX2
+  if (srsran_polar_decoder_init_list(&dec_scl, scl_type, nMax, list_size) < SRSRAN_SUCCESS) {
+    ERROR("Error initializing the SCL decoder with list size %d", list_size);
+    exit(-1);
+  }
+
+  // initialize the CRC of the messages, as in TS 38.212 for the downlink and uplink configurations
+  uint32_t crc_len = 24;
+  if (nMax == 10) {
+    crc_len = (K >= 31) ? 11 : 6;
+  }
+  uint32_t crc_poly = (crc_len == 24) ? SRSRAN_LTE_CRC24C : (crc_len == 11) ? SRSRAN_LTE_CRC11 : SRSRAN_LTE_CRC6;
+  if (K <= crc_len || srsran_crc_init(&crc, crc_poly, (int)crc_len) < SRSRAN_SUCCESS) {
+    ERROR("Error initializing the %d-bit CRC for K=%d", crc_len, K);
+    exit(-1);
+  }
+
 #ifdef DATA_ALL_ONES
 #else
   srsran_random_t random_gen = srsran_random_init(0);
@@ -288,6 +335,8 @@ int main(int argc, char** argv)
   data_rx_s      = srsran_vec_u8_malloc(K * BATCH_SIZE);
   data_rx_c      = srsran_vec_u8_malloc(K * BATCH_SIZE);
   data_rx_c_avx2 = srsran_vec_u8_malloc(K * BATCH_SIZE);
+  data_rx_scl    = srsran_vec_u8_malloc(K * BATCH_SIZE);
+  data_rx_cascl  = srsran_vec_u8_malloc(K * BATCH_SIZE);
 
   input_enc       = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
   output_enc      = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
@@ -309,14 +358,21 @@ int main(int argc, char** argv)
   output_dec_s      = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
   output_dec_c      = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
   output_dec_c_avx2 = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
+  output_dec_scl    = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
+  output_dec_cascl  = srsran_vec_u8_malloc(NMAX * SRSRAN_POLAR_DECODER_MAX_LIST_SIZE);
 
   if (!data_tx || !data_rx || !data_rx_s || !data_rx_c || !data_rx_c_avx2 || !input_enc || !output_enc ||
       !output_enc_avx2 || !rm_codeword || !rm_llr || !rm_llr_s || !rm_llr_c || !rm_llr_c_avx2 || !llr || !llr_s ||
-      !llr_c || !llr_c_avx2 || !output_dec || !output_dec_s || !output_dec_c || !output_dec_c_avx2) {
+      !llr_c || !llr_c_avx2 || !output_dec || !output_dec_s || !output_dec_c || !output_dec_c_avx2 || !data_rx_scl ||
+      !output_dec_scl || !data_rx_cascl || !output_dec_cascl) {
     perror("malloc");
     exit(-1);
   }
 
+  for (int l = 0; l < SRSRAN_POLAR_DECODER_MAX_LIST_SIZE; l++) {
+    candidates[l] = output_dec_cascl + l * NMAX;
+  }
+
   // if snr_db = 100 compute a rage from SNR_MIN to SNR_MAX with SNR_POINTS
   // else use the specified SNR.
   double snr_inc = NAN;
@@ -359,11 +415,15 @@ int main(int argc, char** argv)
     elapsed_time_dec_s[i_snr]      = 0;
     elapsed_time_dec_c[i_snr]      = 0;
     elapsed_time_dec_c_avx2[i_snr] = 0;
+    elapsed_time_dec_scl[i_snr]    = 0;
+    elapsed_time_dec_cascl[i_snr]  = 0;
 
     n_error_words[i_snr]        = 0;
     n_error_words_s[i_snr]      = 0;
     n_error_words_c[i_snr]      = 0;
     n_error_words_c_avx2[i_snr] = 0;
+    n_error_words_scl[i_snr]    = 0;
+    n_error_words_cascl[i_snr]  = 0;
 
     int i_batch = 0;
     printf("\nBatch:\n  ");
@@ -404,6 +464,11 @@ int main(int argc, char** argv)
       }
 #endif
 
+      // the last crc_len bits of each message are its CRC
+      for (int i = 0; i < BATCH_SIZE; i++) {
+        srsran_crc_attach(&crc, data_tx + i * K, (int)(K - crc_len));
+      }
+
       // get polar code, compute frozen_set (F_set), message_set (K_set) and parity bit set (PC_set)
       if (srsran_polar_code_get(&code, K, E, nMax) == -1) {
         return -1;
@@ -591,6 +656,63 @@ int main(int argc, char** argv)
         }
       }
 
+      // 8-bit list decoding, same LLRs as the 8-bit decoder
+      gettimeofday(&t[1], NULL);
+      for (j = 0; j < BATCH_SIZE; j++) {
+        srsran_polar_decoder_decode_c(
+            &dec_scl, llr_c + j * code.N, output_dec_scl + j * code.N, code.n, code.F_set, code.F_set_size);
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      elapsed_time_dec_scl[i_snr] += t[0].tv_sec + 1e-6 * t[0].tv_usec;
+
+      // extract message bits
+      for (j = 0; j < BATCH_SIZE; j++) {
+        srsran_polar_chanalloc_rx(
+            output_dec_scl + j * code.N, data_rx_scl + j * K, code.K, code.nPC, code.K_set, code.PC_set);
+      }
+
+      // check errors 8-bits list decoder
+      for (int i = 0; i < BATCH_SIZE; i++) {
+        errors_symb_scl = srsran_bit_diff(data_tx + i * K, data_rx_scl + i * K, K);
+
+        if (errors_symb_scl != 0) {
+          n_error_words_scl[i_snr]++;
+        }
+      }
+
+      // 8-bit CRC-aided list decoding, the first candidate passing the CRC is selected (the most likely one if none)
+      gettimeofday(&t[1], NULL);
+      for (j = 0; j < BATCH_SIZE; j++) {
+        uint8_t* msg            = data_rx_cascl + j * K;
+        int      nof_candidates = srsran_polar_decoder_decode_list_c(
+            &dec_scl, llr_c + j * code.N, candidates, code.n, code.F_set, code.F_set_size);
+        if (nof_candidates < SRSRAN_SUCCESS) {
+          ERROR("Error decoding the list of candidates");
+          exit(-1);
+        }
+        bool crc_ok = false;
+        for (int l = 0; l < nof_candidates && !crc_ok; l++) {
+          srsran_polar_chanalloc_rx(candidates[l], msg, code.K, code.nPC, code.K_set, code.PC_set);
+          crc_ok = srsran_crc_match(&crc, msg, (int)(K - crc_len));
+        }
+        if (!crc_ok) {
+          srsran_polar_chanalloc_rx(candidates[0], msg, code.K, code.nPC, code.K_set, code.PC_set);
+        }
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      elapsed_time_dec_cascl[i_snr] += t[0].tv_sec + 1e-6 * t[0].tv_usec;
+
+      // check errors 8-bits CRC-aided list decoder
+      for (int i = 0; i < BATCH_SIZE; i++) {
+        errors_symb_cascl = srsran_bit_diff(data_tx + i * K, data_rx_cascl + i * K, K);
+
+        if (errors_symb_cascl != 0) {
+          n_error_words_cascl[i_snr]++;
+        }
+      }
+
 #ifdef LV_HAVE_AVX2
       // 8-bit avx2 decoding
       // 8-bit quantization
@@ -670,6 +792,18 @@ int main(int argc, char** argv)
       }
       printf("];\n");
 #endif // LV_HAVE_AVX2
+
+      printf("WER_8_SCL=[");
+      for (int i_snr = 0; i_snr < snr_points; i_snr++) {
+        printf("%e ", (float)n_error_words_scl[i_snr] / last_i_batch[i_snr] / BATCH_SIZE);
+      }
+      printf("];\n");
+
+      printf("WER_8_CASCL=[");
+      for (int i_snr = 0; i_snr < snr_points; i_snr++) {
+        printf("%e ", (float)n_error_words_cascl[i_snr] / last_i_batch[i_snr] / BATCH_SIZE);
+      }
+      printf("];\n");
       break;
     case 1:
       for (int i_snr = 0; i_snr < snr_points; i_snr++) {
@@ -705,6 +839,20 @@ int main(int argc, char** argv)
                last_i_batch[i_snr] * BATCH_SIZE * code.N,
                last_i_batch[i_snr] * BATCH_SIZE * code.N / (1000000 * elapsed_time_dec_c_avx2[i_snr]));
 #endif // LV_HAVE_AVX2
+        printf("SNR: %3.1f\t INT8-SCL%d  WER: %.8f %d/%d \t dec_thrput(Mbps): %.2f\n",
+               snr_db_vec[i_snr],
+               list_size,
+               (double)n_error_words_scl[i_snr] / last_i_batch[i_snr] / BATCH_SIZE,
+               n_error_words_scl[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * code.N,
+               last_i_batch[i_snr] * BATCH_SIZE * code.N / (1000000 * elapsed_time_dec_scl[i_snr]));
+        printf("SNR: %3.1f\t INT8-CASCL%d  WER: %.8f %d/%d \t dec_thrput(Mbps): %.2f\n",
+               snr_db_vec[i_snr],
+               list_size,
+               (double)n_error_words_cascl[i_snr] / last_i_batch[i_snr] / BATCH_SIZE,
+               n_error_words_cascl[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * code.N,
+               last_i_batch[i_snr] * BATCH_SIZE * code.N / (1000000 * elapsed_time_dec_cascl[i_snr]));
         printf("\n");
       }
 
@@ -767,8 +915,34 @@ int main(int argc, char** argv)
                last_i_batch[i_snr] * BATCH_SIZE / elapsed_time_dec_c_avx2[i_snr],
                last_i_batch[i_snr] * BATCH_SIZE * K / elapsed_time_dec_c_avx2[i_snr],
                last_i_batch[i_snr] * BATCH_SIZE * code.N / elapsed_time_dec_c_avx2[i_snr]);
+        printf("Latency decoder:\n  %.2f us/word\n",
+               1e6 * elapsed_time_dec_c_avx2[i_snr] / (last_i_batch[i_snr] * BATCH_SIZE));
 #endif // LV_HAVE_AVX2
 
+        printf("\n**** FIXED POINT (8 bits, SCL, L=%d) ****", list_size);
+        printf("\nEstimated word error rate:\n  %e (%d errors)\n",
+               (double)n_error_words_scl[i_snr] / last_i_batch[i_snr] / BATCH_SIZE,
+               n_error_words_scl[i_snr]);
+
+        printf("Estimated throughput decoder:\n  %e word/s\n  %e bit/s (information)\n  %e bit/s (encoded)\n",
+               last_i_batch[i_snr] * BATCH_SIZE / elapsed_time_dec_scl[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * K / elapsed_time_dec_scl[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * code.N / elapsed_time_dec_scl[i_snr]);
+        printf("Latency decoder:\n  %.2f us/word\n",
+               1e6 * elapsed_time_dec_scl[i_snr] / (last_i_batch[i_snr] * BATCH_SIZE));
+
+        printf("\n**** FIXED POINT (8 bits, CRC-aided SCL, L=%d, CRC%d) ****", list_size, crc_len);
+        printf("\nEstimated word error rate:\n  %e (%d errors)\n",
+               (double)n_error_words_cascl[i_snr] / last_i_batch[i_snr] / BATCH_SIZE,
+               n_error_words_cascl[i_snr]);
+
+        printf("Estimated throughput decoder:\n  %e word/s\n  %e bit/s (information)\n  %e bit/s (encoded)\n",
+               last_i_batch[i_snr] * BATCH_SIZE / elapsed_time_dec_cascl[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * K / elapsed_time_dec_cascl[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * code.N / elapsed_time_dec_cascl[i_snr]);
+        printf("Latency decoder:\n  %.2f us/word\n",
+               1e6 * elapsed_time_dec_cascl[i_snr] / (last_i_batch[i_snr] * BATCH_SIZE));
+
         printf("\n");
       }
       break;
@@ -799,6 +973,10 @@ int main(int argc, char** argv)
   free(output_dec_c);
 
   free(output_dec_c_avx2);
+  free(output_dec_scl);
+  free(data_rx_scl);
+  free(output_dec_cascl);
+  free(data_rx_cascl);
   free(output_enc_avx2);
   free(data_rx_c_avx2);
 
@@ -812,6 +990,7 @@ int main(int argc, char** argv)
   srsran_polar_decoder_free(&dec);
   srsran_polar_decoder_free(&dec_s);
   srsran_polar_decoder_free(&dec_c);
+  srsran_polar_decoder_free(&dec_scl);
   srsran_polar_rm_rx_free_f(&rm_rx_f);
   srsran_polar_rm_rx_free_s(&rm_rx_s);
   srsran_polar_rm_rx_free_c(&rm_rx_c);
@@ -854,8 +1033,23 @@ int main(int argc, char** argv)
 #endif // LV_HAVE_AVX2
     printf("\r");
 
+    if (n_error_words_scl[0] > expected_errors) {
+      printf("\n(8 bit, list) Test failed!\n\n");
+    } else {
+      printf("\n(8 bit, list) Test completed successfully!\n\n");
+    }
+    printf("\r");
+
+    if (n_error_words_cascl[0] > expected_errors) {
+      printf("\n(8 bit, CRC-aided list) Test failed!\n\n");
+    } else {
+      printf("\n(8 bit, CRC-aided list) Test completed successfully!\n\n");
+    }
+    printf("\r");
+
     exit((n_error_words[0] > expected_errors) || (n_error_words_s[0] > expected_errors) ||
-         (n_error_words_c[0] > expected_errors)
+         (n_error_words_c[0] > expected_errors) || (n_error_words_scl[0] > expected_errors) ||
+         (n_error_words_cascl[0] > expected_errors)
 #ifdef LV_HAVE_AVX2
          || (n_error_words_c_avx2[0] > expected_errors)
 #endif // LV_HAVE_AVX2
@@ -877,6 +1071,15 @@ int main(int argc, char** argv)
         exit(-1);
       }
 #endif // LV_HAVE_AVX2
+      if (n_error_words_scl[i_snr] > 10 * n_error_words[i_snr]) {
+        perror("8-bit list performance at SNR = %d too low!");
+        exit(-1);
+      }
+      // the transmitted message always passes its CRC, so CRC aiding can only remove errors
+      if (n_error_words_cascl[i_snr] > n_error_words_scl[i_snr]) {
+        perror("8-bit CRC-aided list performance at SNR = %d worse than without CRC!");
+        exit(-1);
+      }
     }
 
     printf("\nTest completed successfully!\n\n");
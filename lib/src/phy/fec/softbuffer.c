@@ -46,7 +46,28 @@ int srsran_softbuffer_rx_init(srsran_softbuffer_rx_t* q, uint32_t nof_prb)
   return srsran_softbuffer_rx_init_guru(q, max_cb, max_cb_size);
 }
 
+uint32_t srsran_softbuffer_llr_nof_bytes(srsran_softbuffer_llr_t llr_format, uint32_t nof_llr)
+{
+  switch (llr_format) {
+    case SRSRAN_SOFTBUFFER_LLR_8BIT:
+      return nof_llr;
+    case SRSRAN_SOFTBUFFER_LLR_4BIT:
+      return (nof_llr + 1) / 2;
+    case SRSRAN_SOFTBUFFER_LLR_16BIT:
+    default:
+      return nof_llr * sizeof(int16_t);
+  }
+}
+
 int srsran_softbuffer_rx_init_guru(srsran_softbuffer_rx_t* q, uint32_t max_cb, uint32_t max_cb_size)
+{
+  return srsran_softbuffer_rx_init_llr(q, max_cb, max_cb_size, SRSRAN_SOFTBUFFER_LLR_16BIT);
+}
+
+int srsran_softbuffer_rx_init_llr(srsran_softbuffer_rx_t* q,
+                                  uint32_t                max_cb,
+                                  uint32_t                max_cb_size,
+                                  srsran_softbuffer_llr_t llr_format)
 {
   int ret = SRSRAN_ERROR;
 
@@ -61,6 +82,7 @@ int srsran_softbuffer_rx_init_guru(srsran_softbuffer_rx_t* q, uint32_t max_cb, u
   // Set internal attributes
   q->max_cb      = max_cb;
   q->max_cb_size = max_cb_size;
+  q->llr_format  = llr_format;
 
   q->buffer_f = SRSRAN_MEM_ALLOC(int16_t*, q->max_cb);
   if (!q->buffer_f) {
@@ -69,6 +91,12 @@ int srsran_softbuffer_rx_init_guru(srsran_softbuffer_rx_t* q, uint32_t max_cb, u
   }
   SRSRAN_MEM_ZERO(q->buffer_f, int16_t*, q->max_cb);
 
+  q->cb_llr_shift = SRSRAN_MEM_ALLOC(uint8_t, q->max_cb);
+  if (!q->cb_llr_shift) {
+    perror("malloc");
+    goto clean_exit;
+  }
+
   q->data = SRSRAN_MEM_ALLOC(uint8_t*, q->max_cb);
   if (!q->data) {
     perror("malloc");
@@ -83,7 +111,7 @@ int srsran_softbuffer_rx_init_guru(srsran_softbuffer_rx_t* q, uint32_t max_cb, u
   }
 
   for (uint32_t i = 0; i < q->max_cb; i++) {
-    q->buffer_f[i] = srsran_vec_i16_malloc(q->max_cb_size);
+    q->buffer_f[i] = (int16_t*)srsran_vec_u8_malloc(srsran_softbuffer_llr_nof_bytes(q->llr_format, q->max_cb_size));
     if (!q->buffer_f[i]) {
       perror("malloc");
       goto clean_exit;
@@ -120,6 +148,9 @@ void srsran_softbuffer_rx_free(srsran_softbuffer_rx_t* q)
       }
       free(q->buffer_f);
     }
+    if (q->cb_llr_shift) {
+      free(q->cb_llr_shift);
+    }
     if (q->data) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->data[i]) {
@@ -155,7 +186,10 @@ void srsran_softbuffer_rx_reset_cb(srsran_softbuffer_rx_t* q, uint32_t nof_cb)
     }
     for (uint32_t i = 0; i < nof_cb; i++) {
       if (q->buffer_f[i]) {
-        srsran_vec_i16_zero(q->buffer_f[i], q->max_cb_size);
+        srsran_vec_u8_zero((uint8_t*)q->buffer_f[i], srsran_softbuffer_llr_nof_bytes(q->llr_format, q->max_cb_size));
+      }
+      if (q->cb_llr_shift) {
+        q->cb_llr_shift[i] = 0;
       }
       if (q->data[i]) {
         srsran_vec_u8_zero(q->data[i], q->max_cb_size / 8);
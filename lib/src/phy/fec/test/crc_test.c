@@ -71,6 +71,24 @@ void parse_args(int argc, char** argv)
   }
 }
 
+// Bit by bit CRC computation, used as reference
+static uint32_t crc_reference(const uint8_t* bits, int len)
+{
+  uint64_t mask    = ((uint64_t)1 << crc_length) - 1;
+  uint64_t highbit = (uint64_t)1 << (crc_length - 1);
+  uint64_t crc     = 0;
+
+  for (int i = 0; i < len; i++) {
+    bool feedback = ((crc & highbit) != 0) ^ (bits[i] != 0);
+    crc           = (crc << 1U) & mask;
+    if (feedback) {
+      crc ^= crc_poly & mask;
+    }
+  }
+
+  return (uint32_t)crc;
+}
+
 int main(int argc, char** argv)
 {
   int          i;
@@ -111,12 +129,31 @@ int main(int argc, char** argv)
 
   INFO("checksum=%x", crc_word);
 
-  free(data);
+  // check the packed bytes version over the complete bytes
+  int      nof_bytes = num_bits / 8;
+  uint8_t* bytes     = srsran_vec_u8_malloc(nof_bytes + 1);
+  if (!bytes) {
+    perror("malloc");
+    exit(-1);
+  }
+  uint8_t* ptr = data;
+  for (i = 0; i < nof_bytes; i++) {
+    bytes[i] = (uint8_t)srsran_bit_pack(&ptr, 8);
+  }
+  uint32_t crc_byte_word = srsran_crc_checksum_byte(&crc_p, bytes, nof_bytes * 8);
+  if (crc_byte_word != crc_reference(data, nof_bytes * 8)) {
+    ERROR("Packed bytes checksum %x does not match the reference", crc_byte_word);
+    exit(-1);
+  }
+  free(bytes);
 
   // check if generated word is as expected
   if (get_expected_word(num_bits, crc_length, crc_poly, seed, &expected_word)) {
     ERROR("Test parameters not defined in test_results.h");
     exit(-1);
   }
+
+  free(data);
+
   exit(expected_word != crc_word);
 }
@@ -482,6 +482,410 @@ int srsran_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len,
   }
 }
 
+/* Soft bits kept in a compressed soft-buffer are the combined LLRs shifted right, rounded and saturated to
+ * +/-RM_TURBO_LLR8_MAX (8-bit) or +/-RM_TURBO_LLR4_MAX (4-bit). The 8-bit soft bits use a fixed shift. Seven levels are
+ * too few for a fixed scale, the LLR magnitude depends on the SNR, the modulation and the number of combined
+ * transmissions. The 4-bit shift is chosen for every code block after combining, as the smallest one that leaves the
+ * mean magnitude of the non-zero soft bits below RM_TURBO_LLR4_MEAN, and kept in the soft-buffer. Near the waterfall
+ * the 4-bit soft bits still cost about 0.2 dB with 16QAM and up to 0.5 dB with 64QAM over 16-bit soft bits. */
+#define RM_TURBO_LLR8_SHIFT_S 2      // 16-bit LLR, 8-bit soft bit
+#define RM_TURBO_LLR4_MAX_SHIFT_S 12 // 16-bit LLR, 4-bit soft bit
+#define RM_TURBO_LLR4_MAX_SHIFT_B 4  // 8-bit LLR, 4-bit soft bit
+#define RM_TURBO_LLR4_MEAN 4
+#define RM_TURBO_LLR8_MAX 127
+#define RM_TURBO_LLR4_MAX 7
+
+/* Number of LLRs at the turbo decoder input for a code block, including the sub-block alignment */
+static uint32_t rm_turbo_rx_len(uint32_t cb_idx)
+{
+#if SRSRAN_TDEC_EXPECT_INPUT_SB == 1
+  return 3 * (srsran_cbsegm_cbsize(cb_idx) + 32) + 12;
+#else
+  return 3 * srsran_cbsegm_cbsize(cb_idx) + 12;
+#endif
+}
+
+static inline int32_t rm_turbo_llr_saturate(int32_t x, int32_t max)
+{
+  return SRSRAN_MIN(SRSRAN_MAX(x, -max), max);
+}
+
+/* Same saturation as the 16-bit SIMD additions */
+static inline int32_t rm_turbo_llr_saturate_s(int32_t x)
+{
+  return SRSRAN_MIN(SRSRAN_MAX(x, INT16_MIN), INT16_MAX);
+}
+
+static inline int32_t rm_turbo_llr_compress(int32_t x, uint32_t shift, int32_t max)
+{
+  return rm_turbo_llr_saturate((x + (1 << (shift - 1))) >> shift, max);
+}
+
+/* Smallest 4-bit shift for LLRs whose non-zero magnitudes add up to sum over count LLRs */
+static inline uint32_t rm_turbo_llr4_shift(uint64_t sum, uint64_t count, uint32_t max_shift)
+{
+  uint32_t shift = 1;
+  while (shift < max_shift && sum >= count * ((uint64_t)RM_TURBO_LLR4_MEAN << shift)) {
+    shift++;
+  }
+  return shift;
+}
+
+static uint32_t rm_turbo_llr4_shift_s(const int16_t* llr, uint32_t len)
+{
+  uint64_t sum   = 0;
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    uint32_t x = (uint32_t)abs(llr[i]);
+    sum += x;
+    count += (x != 0);
+  }
+  return rm_turbo_llr4_shift(sum, count, RM_TURBO_LLR4_MAX_SHIFT_S);
+}
+
+static uint32_t rm_turbo_llr4_shift_b(const int8_t* llr, uint32_t len)
+{
+  uint64_t sum   = 0;
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    uint32_t x = (uint32_t)abs(llr[i]);
+    sum += x;
+    count += (x != 0);
+  }
+  return rm_turbo_llr4_shift(sum, count, RM_TURBO_LLR4_MAX_SHIFT_B);
+}
+
+static inline int32_t rm_turbo_llr4_get(const uint8_t* w, uint32_t i)
+{
+  uint32_t nibble = (i & 1U) ? (w[i / 2] >> 4U) : (w[i / 2] & 0x0fU);
+  return (int32_t)(nibble ^ 0x08U) - 0x08;
+}
+
+static inline void rm_turbo_llr4_set(uint8_t* w, uint32_t i, int32_t x)
+{
+  uint8_t nibble = (uint8_t)x & 0x0fU;
+  if (i & 1U) {
+    w[i / 2] = (uint8_t)((w[i / 2] & 0x0fU) | (nibble << 4U));
+  } else {
+    w[i / 2] = (uint8_t)((w[i / 2] & 0xf0U) | nibble);
+  }
+}
+
+#ifdef LV_HAVE_AVX2
+
+/* Unpacks 64 4-bit soft bits into two vectors of 32 sign-extended bytes */
+static inline void rm_turbo_llr4_unpack_avx2(__m256i w, __m256i* a, __m256i* b)
+{
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  const __m256i sign = _mm256_set1_epi8(0x08);
+
+  __m256i lo = _mm256_and_si256(w, mask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(w, 4), mask);
+  lo         = _mm256_sub_epi8(_mm256_xor_si256(lo, sign), sign);
+  hi         = _mm256_sub_epi8(_mm256_xor_si256(hi, sign), sign);
+
+  // Reorder the 64-bit words so that the in-lane unpacks keep the soft bit order
+  lo = _mm256_permute4x64_epi64(lo, 0xD8);
+  hi = _mm256_permute4x64_epi64(hi, 0xD8);
+  *a = _mm256_unpacklo_epi8(lo, hi);
+  *b = _mm256_unpackhi_epi8(lo, hi);
+}
+
+/* Packs two vectors of 32 bytes within +/-RM_TURBO_LLR4_MAX into 64 4-bit soft bits */
+static inline __m256i rm_turbo_llr4_pack_avx2(__m256i a, __m256i b)
+{
+  const __m256i mask_lo = _mm256_set1_epi16(0x000f);
+  const __m256i mask_hi = _mm256_set1_epi16(0x00f0);
+
+  a = _mm256_or_si256(_mm256_and_si256(a, mask_lo), _mm256_and_si256(_mm256_srli_epi16(a, 4), mask_hi));
+  b = _mm256_or_si256(_mm256_and_si256(b, mask_lo), _mm256_and_si256(_mm256_srli_epi16(b, 4), mask_hi));
+  return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+}
+
+/* Rounds, shifts and saturates two vectors of 16 16-bit LLRs into 32 bytes */
+static inline __m256i rm_turbo_llr_compress_s_avx2(__m256i x0, __m256i x1, uint32_t shift, int8_t max)
+{
+  const __m256i round = _mm256_set1_epi16((int16_t)(1 << (shift - 1)));
+  const __m128i count = _mm_cvtsi32_si128((int)shift);
+
+  x0        = _mm256_sra_epi16(_mm256_adds_epi16(x0, round), count);
+  x1        = _mm256_sra_epi16(_mm256_adds_epi16(x1, round), count);
+  __m256i b = _mm256_permute4x64_epi64(_mm256_packs_epi16(x0, x1), 0xD8);
+  return _mm256_max_epi8(_mm256_min_epi8(b, _mm256_set1_epi8(max)), _mm256_set1_epi8((int8_t)-max));
+}
+
+/* Expands 32 soft bits into two vectors of 16 16-bit LLRs */
+static inline void rm_turbo_llr_expand_s_avx2(__m256i w, uint32_t shift, __m256i* x0, __m256i* x1)
+{
+  const __m128i count = _mm_cvtsi32_si128((int)shift);
+
+  *x0 = _mm256_sll_epi16(_mm256_cvtepi8_epi16(_mm256_castsi256_si128(w)), count);
+  *x1 = _mm256_sll_epi16(_mm256_cvtepi8_epi16(_mm256_extracti128_si256(w, 1)), count);
+}
+
+/* Combines 32 16-bit LLRs with the expanded soft bits and returns the compressed result */
+static inline __m256i rm_turbo_combine_s_avx2_32(int16_t* llr, __m256i w, uint32_t shift, int8_t max)
+{
+  __m256i w0, w1;
+  rm_turbo_llr_expand_s_avx2(w, shift, &w0, &w1);
+  __m256i x0 = _mm256_adds_epi16(_mm256_loadu_si256((__m256i*)&llr[0]), w0);
+  __m256i x1 = _mm256_adds_epi16(_mm256_loadu_si256((__m256i*)&llr[16]), w1);
+  _mm256_storeu_si256((__m256i*)&llr[0], x0);
+  _mm256_storeu_si256((__m256i*)&llr[16], x1);
+  return rm_turbo_llr_compress_s_avx2(x0, x1, shift, max);
+}
+
+static uint32_t rm_turbo_combine_s_avx2(int16_t* llr, int8_t* w, uint32_t len)
+{
+  uint32_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i w_old = _mm256_loadu_si256((__m256i*)&w[i]);
+    __m256i w_new = rm_turbo_combine_s_avx2_32(&llr[i], w_old, RM_TURBO_LLR8_SHIFT_S, RM_TURBO_LLR8_MAX);
+    _mm256_storeu_si256((__m256i*)&w[i], w_new);
+  }
+  return i;
+}
+
+/* Adds the 4-bit soft bits, scaled by the given shift, to the 16-bit LLRs */
+static uint32_t rm_turbo_llr4_add_s_avx2(int16_t* llr, const uint8_t* w, uint32_t shift, uint32_t len)
+{
+  uint32_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    __m256i a, b, x[4];
+    rm_turbo_llr4_unpack_avx2(_mm256_loadu_si256((__m256i*)&w[i / 2]), &a, &b);
+    rm_turbo_llr_expand_s_avx2(a, shift, &x[0], &x[1]);
+    rm_turbo_llr_expand_s_avx2(b, shift, &x[2], &x[3]);
+    for (uint32_t k = 0; k < 4; k++) {
+      __m256i* ptr = (__m256i*)&llr[i + 16 * k];
+      _mm256_storeu_si256(ptr, _mm256_adds_epi16(_mm256_loadu_si256(ptr), x[k]));
+    }
+  }
+  return i;
+}
+
+/* Compresses the 16-bit LLRs into 4-bit soft bits with the given shift */
+static uint32_t rm_turbo_llr4_write_s_avx2(const int16_t* llr, uint8_t* w, uint32_t shift, uint32_t len)
+{
+  uint32_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    __m256i a = rm_turbo_llr_compress_s_avx2(_mm256_loadu_si256((__m256i*)&llr[i]),
+                                             _mm256_loadu_si256((__m256i*)&llr[i + 16]),
+                                             shift,
+                                             RM_TURBO_LLR4_MAX);
+    __m256i b = rm_turbo_llr_compress_s_avx2(_mm256_loadu_si256((__m256i*)&llr[i + 32]),
+                                             _mm256_loadu_si256((__m256i*)&llr[i + 48]),
+                                             shift,
+                                             RM_TURBO_LLR4_MAX);
+    _mm256_storeu_si256((__m256i*)&w[i / 2], rm_turbo_llr4_pack_avx2(a, b));
+  }
+  return i;
+}
+
+/* Arithmetic right shift of 32 bytes, rounded and saturated to +/-RM_TURBO_LLR4_MAX */
+static inline __m256i rm_turbo_llr4_compress_b_avx2(__m256i x, uint32_t shift)
+{
+  const __m256i mask  = _mm256_set1_epi8((int8_t)(0xff >> shift));
+  const __m256i sign  = _mm256_set1_epi8((int8_t)(0x80 >> shift));
+  const __m128i count = _mm_cvtsi32_si128((int)shift);
+
+  x = _mm256_adds_epi8(x, _mm256_set1_epi8((int8_t)(1 << (shift - 1))));
+  x = _mm256_and_si256(_mm256_srl_epi16(x, count), mask);
+  x = _mm256_sub_epi8(_mm256_xor_si256(x, sign), sign);
+  return _mm256_max_epi8(_mm256_min_epi8(x, _mm256_set1_epi8(RM_TURBO_LLR4_MAX)),
+                         _mm256_set1_epi8(-RM_TURBO_LLR4_MAX));
+}
+
+/* Combines 32 8-bit LLRs with the soft bits, already scaled to the LLR range, and returns the saturated result */
+static inline __m256i rm_turbo_combine_b_avx2_32(int8_t* llr, __m256i w, int8_t max)
+{
+  __m256i x = _mm256_adds_epi8(_mm256_loadu_si256((__m256i*)llr), w);
+  x         = _mm256_max_epi8(_mm256_min_epi8(x, _mm256_set1_epi8(max)), _mm256_set1_epi8((int8_t)-max));
+  _mm256_storeu_si256((__m256i*)llr, x);
+  return x;
+}
+
+static uint32_t rm_turbo_combine_b_avx2(int8_t* llr, int8_t* w, uint32_t len)
+{
+  uint32_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i x = rm_turbo_combine_b_avx2_32(&llr[i], _mm256_loadu_si256((__m256i*)&w[i]), RM_TURBO_LLR8_MAX);
+    _mm256_storeu_si256((__m256i*)&w[i], x);
+  }
+  return i;
+}
+
+/* Adds the 4-bit soft bits, scaled by the given shift, to the 8-bit LLRs */
+static uint32_t rm_turbo_llr4_add_b_avx2(int8_t* llr, const uint8_t* w, uint32_t shift, uint32_t len)
+{
+  uint32_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    __m256i a, b;
+    rm_turbo_llr4_unpack_avx2(_mm256_loadu_si256((__m256i*)&w[i / 2]), &a, &b);
+    for (uint32_t k = 0; k < shift; k++) {
+      a = _mm256_adds_epi8(a, a);
+      b = _mm256_adds_epi8(b, b);
+    }
+    rm_turbo_combine_b_avx2_32(&llr[i], a, INT8_MAX);
+    rm_turbo_combine_b_avx2_32(&llr[i + 32], b, INT8_MAX);
+  }
+  return i;
+}
+
+/* Compresses the 8-bit LLRs into 4-bit soft bits with the given shift */
+static uint32_t rm_turbo_llr4_write_b_avx2(const int8_t* llr, uint8_t* w, uint32_t shift, uint32_t len)
+{
+  uint32_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    __m256i a = rm_turbo_llr4_compress_b_avx2(_mm256_loadu_si256((__m256i*)&llr[i]), shift);
+    __m256i b = rm_turbo_llr4_compress_b_avx2(_mm256_loadu_si256((__m256i*)&llr[i + 32]), shift);
+    _mm256_storeu_si256((__m256i*)&w[i / 2], rm_turbo_llr4_pack_avx2(a, b));
+  }
+  return i;
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+/* Adds the soft bits to the 16-bit LLRs and stores back the saturated and compressed result */
+static void
+rm_turbo_combine_s(int16_t* llr, void* w_buff, srsran_softbuffer_llr_t w_format, uint8_t* w_shift, uint32_t len)
+{
+  uint32_t i = 0;
+  if (w_format == SRSRAN_SOFTBUFFER_LLR_8BIT) {
+    int8_t* w = (int8_t*)w_buff;
+#ifdef LV_HAVE_AVX2
+    i = rm_turbo_combine_s_avx2(llr, w, len);
+#endif
+    for (; i < len; i++) {
+      int32_t x = rm_turbo_llr_saturate_s(llr[i] + w[i] * (1 << RM_TURBO_LLR8_SHIFT_S));
+      w[i]      = (int8_t)rm_turbo_llr_compress(x, RM_TURBO_LLR8_SHIFT_S, RM_TURBO_LLR8_MAX);
+      llr[i]    = (int16_t)x;
+    }
+    return;
+  }
+
+  // Expand the 4-bit soft bits with the shift they were stored with, then store them back with the new one
+  uint8_t* w     = (uint8_t*)w_buff;
+  uint32_t shift = *w_shift;
+#ifdef LV_HAVE_AVX2
+  i = rm_turbo_llr4_add_s_avx2(llr, w, shift, len);
+#endif
+  for (; i < len; i++) {
+    llr[i] = (int16_t)rm_turbo_llr_saturate_s(llr[i] + rm_turbo_llr4_get(w, i) * (1 << shift));
+  }
+
+  shift    = rm_turbo_llr4_shift_s(llr, len);
+  *w_shift = (uint8_t)shift;
+  i        = 0;
+#ifdef LV_HAVE_AVX2
+  i = rm_turbo_llr4_write_s_avx2(llr, w, shift, len);
+#endif
+  for (; i < len; i++) {
+    rm_turbo_llr4_set(w, i, rm_turbo_llr_compress(llr[i], shift, RM_TURBO_LLR4_MAX));
+  }
+}
+
+/* Adds the soft bits to the 8-bit LLRs and stores back the saturated and compressed result */
+static void
+rm_turbo_combine_b(int8_t* llr, void* w_buff, srsran_softbuffer_llr_t w_format, uint8_t* w_shift, uint32_t len)
+{
+  uint32_t i = 0;
+  if (w_format == SRSRAN_SOFTBUFFER_LLR_8BIT) {
+    int8_t* w = (int8_t*)w_buff;
+#ifdef LV_HAVE_AVX2
+    i = rm_turbo_combine_b_avx2(llr, w, len);
+#endif
+    for (; i < len; i++) {
+      w[i]   = (int8_t)rm_turbo_llr_saturate(llr[i] + w[i], RM_TURBO_LLR8_MAX);
+      llr[i] = w[i];
+    }
+    return;
+  }
+
+  // Expand the 4-bit soft bits with the shift they were stored with, then store them back with the new one
+  uint8_t* w     = (uint8_t*)w_buff;
+  uint32_t shift = *w_shift;
+#ifdef LV_HAVE_AVX2
+  i = rm_turbo_llr4_add_b_avx2(llr, w, shift, len);
+#endif
+  for (; i < len; i++) {
+    llr[i] = (int8_t)rm_turbo_llr_saturate(llr[i] + rm_turbo_llr4_get(w, i) * (1 << shift), INT8_MAX);
+  }
+
+  shift    = rm_turbo_llr4_shift_b(llr, len);
+  *w_shift = (uint8_t)shift;
+  i        = 0;
+#ifdef LV_HAVE_AVX2
+  i = rm_turbo_llr4_write_b_avx2(llr, w, shift, len);
+#endif
+  for (; i < len; i++) {
+    rm_turbo_llr4_set(w, i, rm_turbo_llr_compress(llr[i], shift, RM_TURBO_LLR4_MAX));
+  }
+}
+
+int srsran_rm_turbo_rx_lut_combine(int16_t*                input,
+                                   int16_t*                output,
+                                   void*                   w_buff,
+                                   srsran_softbuffer_llr_t w_format,
+                                   uint8_t*                w_shift,
+                                   uint32_t                in_len,
+                                   uint32_t                cb_idx,
+                                   uint32_t                rv_idx)
+{
+  if (cb_idx >= SRSRAN_NOF_TC_CB_SIZES) {
+    printf("Invalid inputs rv_idx=%d, cb_idx=%d\n", rv_idx, cb_idx);
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+  uint32_t out_len = rm_turbo_rx_len(cb_idx);
+
+  // Uncompressed soft-buffers are combined in place
+  if (w_format == SRSRAN_SOFTBUFFER_LLR_16BIT) {
+    int ret = srsran_rm_turbo_rx_lut(input, (int16_t*)w_buff, in_len, cb_idx, rv_idx);
+    if (ret == SRSRAN_SUCCESS) {
+      srsran_vec_i16_copy(output, (int16_t*)w_buff, out_len);
+    }
+    return ret;
+  }
+
+  srsran_vec_i16_zero(output, out_len);
+  int ret = srsran_rm_turbo_rx_lut(input, output, in_len, cb_idx, rv_idx);
+  if (ret == SRSRAN_SUCCESS) {
+    rm_turbo_combine_s(output, w_buff, w_format, w_shift, out_len);
+  }
+  return ret;
+}
+
+int srsran_rm_turbo_rx_lut_combine_8bit(int8_t*                 input,
+                                        int8_t*                 output,
+                                        void*                   w_buff,
+                                        srsran_softbuffer_llr_t w_format,
+                                        uint8_t*                w_shift,
+                                        uint32_t                in_len,
+                                        uint32_t                cb_idx,
+                                        uint32_t                rv_idx)
+{
+  if (cb_idx >= SRSRAN_NOF_TC_CB_SIZES) {
+    printf("Invalid inputs rv_idx=%d, cb_idx=%d\n", rv_idx, cb_idx);
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+  uint32_t out_len = rm_turbo_rx_len(cb_idx);
+
+  // Uncompressed soft-buffers are combined in place, keeping one byte per soft bit
+  if (w_format == SRSRAN_SOFTBUFFER_LLR_16BIT) {
+    int ret = srsran_rm_turbo_rx_lut_8bit(input, (int8_t*)w_buff, in_len, cb_idx, rv_idx);
+    if (ret == SRSRAN_SUCCESS) {
+      srsran_vec_i8_copy(output, (int8_t*)w_buff, out_len);
+    }
+    return ret;
+  }
+
+  srsran_vec_i8_zero(output, out_len);
+  int ret = srsran_rm_turbo_rx_lut_8bit(input, output, in_len, cb_idx, rv_idx);
+  if (ret == SRSRAN_SUCCESS) {
+    rm_turbo_combine_b(output, w_buff, w_format, w_shift, out_len);
+  }
+  return ret;
+}
+
 #ifdef LV_HAVE_SSE
 
 #define SAVE_OUTPUT_16_SSE(j)                                                                                          \
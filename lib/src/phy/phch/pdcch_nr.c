@@ -152,6 +152,7 @@ static int pdcch_nr_init_common(srsran_pdcch_nr_t* q, const srsran_pdcch_nr_args
   }
 
   q->meas_time_en = args->measure_time;
+  SRSRAN_MEM_ZERO(q->candidates, uint8_t*, SRSRAN_POLAR_DECODER_MAX_LIST_SIZE);
 
   q->c = srsran_vec_u8_malloc(SRSRAN_PDCCH_MAX_RE * 2);
   if (q->c == NULL) {
@@ -226,18 +227,29 @@ int srsran_pdcch_nr_init_rx(srsran_pdcch_nr_t* q, const srsran_pdcch_nr_args_t*
     return SRSRAN_ERROR;
   }
 
-  srsran_polar_decoder_type_t decoder_type = SRSRAN_POLAR_DECODER_SSC_C;
+  bool                        list_decoder = args->polar_list_size > 1;
+  srsran_polar_decoder_type_t decoder_type = list_decoder ? SRSRAN_POLAR_DECODER_SCL_C : SRSRAN_POLAR_DECODER_SSC_C;
 
 #ifdef LV_HAVE_AVX2
   if (!args->disable_simd) {
-    decoder_type = SRSRAN_POLAR_DECODER_SSC_C_AVX2;
+    decoder_type = list_decoder ? SRSRAN_POLAR_DECODER_SCL_C_AVX2 : SRSRAN_POLAR_DECODER_SSC_C_AVX2;
   }
 #endif // LV_HAVE_AVX2
 
-  if (srsran_polar_decoder_init(&q->decoder, decoder_type, NMAX_LOG) < SRSRAN_SUCCESS) {
+  uint8_t list_size = (uint8_t)SRSRAN_MIN(args->polar_list_size, SRSRAN_POLAR_DECODER_MAX_LIST_SIZE);
+  if (srsran_polar_decoder_init_list(&q->decoder, decoder_type, NMAX_LOG, list_size) < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
+  // The first candidate is decoded in the allocated buffer, the rest need their own buffer
+  q->candidates[0] = q->allocated;
+  for (uint32_t i = 1; i < q->decoder.list_size; i++) {
+    q->candidates[i] = srsran_vec_u8_malloc(NMAX);
+    if (q->candidates[i] == NULL) {
+      return SRSRAN_ERROR;
+    }
+  }
+
   if (srsran_polar_rm_rx_init_c(&q->rm) < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
@@ -263,6 +275,12 @@ void srsran_pdcch_nr_free(srsran_pdcch_nr_t* q)
   } else {
     srsran_polar_decoder_free(&q->decoder);
     srsran_polar_rm_rx_free_c(&q->rm);
+
+    for (uint32_t i = 1; i < SRSRAN_POLAR_DECODER_MAX_LIST_SIZE; i++) {
+      if (q->candidates[i]) {
+        free(q->candidates[i]);
+      }
+    }
   }
 
   if (q->c) {
@@ -569,6 +587,42 @@ int srsran_pdcch_nr_encode(srsran_pdcch_nr_t* q, const srsran_dci_msg_nr_t* dci_
   return SRSRAN_SUCCESS;
 }
 
+/* Recovers the DCI of a decoder candidate into q->c, with an offset of 24 bits, and checks its RNTI scrambled CRC */
+static bool pdcch_nr_candidate_crc(srsran_pdcch_nr_t* q,
+                                   uint32_t           candidate,
+                                   const uint8_t*     unpacked_rnti,
+                                   uint32_t*          checksum1,
+                                   uint32_t*          checksum2)
+{
+  // De-allocate channel
+  uint8_t c_prime[SRSRAN_POLAR_INTERLEAVER_K_MAX_IL];
+  srsran_polar_chanalloc_rx(q->candidates[candidate], c_prime, q->code.K, q->code.nPC, q->code.K_set, q->code.PC_set);
+
+  // Set first L bits to ones, c will have an offset of 24 bits
+  uint8_t* c = q->c;
+  srsran_bit_unpack(UINT32_MAX, &c, 24U);
+
+  // De-interleave
+  srsran_polar_interleaver_run_u8(c_prime, c, q->K, false);
+
+  // Print c
+  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_INFO && !is_handler_registered()) {
+    PDCCH_INFO_RX("candidate=%d; c_prime=", candidate);
+    srsran_vec_fprint_hex(stdout, c_prime, q->K);
+    PDCCH_INFO_RX("c=");
+    srsran_vec_fprint_hex(stdout, c, q->K);
+  }
+
+  // De-Scramble CRC with RNTI
+  srsran_vec_xor_bbb(unpacked_rnti, &c[q->K - 16], &c[q->K - 16], 16);
+
+  // Check CRC
+  uint8_t* ptr = &c[q->K - 24];
+  *checksum1   = srsran_crc_checksum(&q->crc24c, q->c, q->K);
+  *checksum2   = srsran_bit_pack(&ptr, 24);
+  return *checksum1 == *checksum2;
+}
+
 int srsran_pdcch_nr_decode(srsran_pdcch_nr_t*      q,
                            cf_t*                   slot_symbols,
                            srsran_dmrs_pdcch_ce_t* ce,
@@ -654,44 +708,29 @@ int srsran_pdcch_nr_decode(srsran_pdcch_nr_t*      q,
     srsran_vec_fprint_bs(stdout, d, q->K);
   }
 
-  // Decode
-  if (srsran_polar_decoder_decode_c(&q->decoder, d, q->allocated, q->code.n, q->code.F_set, q->code.F_set_size) <
-      SRSRAN_SUCCESS) {
+  // Decode, the SSC decoders produce a single candidate
+  int nof_candidates = srsran_polar_decoder_decode_list_c(
+      &q->decoder, d, q->candidates, q->code.n, q->code.F_set, q->code.F_set_size);
+  if (nof_candidates < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
-  // De-allocate channel
-  uint8_t c_prime[SRSRAN_POLAR_INTERLEAVER_K_MAX_IL];
-  srsran_polar_chanalloc_rx(q->allocated, c_prime, q->code.K, q->code.nPC, q->code.K_set, q->code.PC_set);
-
-  // Set first L bits to ones, c will have an offset of 24 bits
-  uint8_t* c = q->c;
-  srsran_bit_unpack(UINT32_MAX, &c, 24U);
-
-  // De-interleave
-  srsran_polar_interleaver_run_u8(c_prime, c, q->K, false);
-
-  // Print c
-  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_INFO && !is_handler_registered()) {
-    PDCCH_INFO_RX("c_prime=");
-    srsran_vec_fprint_hex(stdout, c_prime, q->K);
-    PDCCH_INFO_RX("c=");
-    srsran_vec_fprint_hex(stdout, c, q->K);
-  }
-
   // Unpack RNTI
   uint8_t  unpacked_rnti[16] = {};
   uint8_t* ptr               = unpacked_rnti;
   srsran_bit_unpack(dci_msg->ctx.rnti, &ptr, 16);
 
-  // De-Scramble CRC with RNTI
-  srsran_vec_xor_bbb(unpacked_rnti, &c[q->K - 16], &c[q->K - 16], 16);
-
-  // Check CRC
-  ptr                = &c[q->K - 24];
-  uint32_t checksum1 = srsran_crc_checksum(&q->crc24c, q->c, q->K);
-  uint32_t checksum2 = srsran_bit_pack(&ptr, 24);
-  res->crc           = checksum1 == checksum2;
+  // Select the first candidate, in path metric order, that passes the CRC. If none does, keep the best path metric.
+  uint32_t checksum1 = 0;
+  uint32_t checksum2 = 0;
+  res->crc           = false;
+  for (int i = 0; i < nof_candidates && !res->crc; i++) {
+    res->crc = pdcch_nr_candidate_crc(q, i, unpacked_rnti, &checksum1, &checksum2);
+  }
+  if (!res->crc && nof_candidates > 1) {
+    pdcch_nr_candidate_crc(q, 0, unpacked_rnti, &checksum1, &checksum2);
+  }
+  uint8_t* c = &q->c[24];
 
   if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_INFO && !is_handler_registered()) {
     PDCCH_INFO_RX("CRC={%06x, %06x}; msg=", checksum1, checksum2);
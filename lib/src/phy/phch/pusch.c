@@ -453,8 +453,9 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
     ret      = srsran_ulsch_decode(&q->ul_sch, cfg, q->q, q->g, c, out->data, &out->uci);
     out->crc = (ret == 0);
 
-    // Save number of iterations
+    // Save number of iterations and code block decoding time
     out->avg_iterations_block = q->ul_sch.avg_iterations;
+    out->decode_time_us       = srsran_sch_last_decode_time_us(&q->ul_sch);
 
     // Save O_cqi for power control
     cfg->last_O_cqi = srsran_cqi_size(&cfg->uci_cfg.cqi);
@@ -535,7 +536,7 @@ uint32_t srsran_pusch_rx_info(srsran_pusch_cfg_t*    cfg,
   }
 
   if (cfg->meas_time_en) {
-    len = srsran_print_check(str, str_len, len, ", t=%d us", cfg->meas_time_value);
+    len = srsran_print_check(str, str_len, len, ", t=%d us, t_dec=%d us", cfg->meas_time_value, res->decode_time_us);
   }
   return len;
 }
@@ -19,6 +19,7 @@
  *
  */
 
+#include "sch_cb_pool.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
@@ -31,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/time.h>
 
 #define SRSRAN_PDSCH_MIN_TDEC_ITERS 2
 #define SRSRAN_PDSCH_MAX_TDEC_ITERS 10
@@ -137,6 +139,154 @@ uint32_t srsran_sch_find_Ioffset_cqi(float beta)
 
 #define SCH_MAX_G_BITS (SRSRAN_MAX_PRB * 12 * 12 * 12)
 
+/**
+ * Decoding of a single code block: rate dematching and turbo decoding with CRC early stop. It carries everything needed
+ * to run it, so it can be picked by any of the decoder threads.
+ */
+typedef struct {
+  uint32_t                cb_idx;
+  void*                   e_bits;         // Rate matched LLRs of the code block, 8 or 16 bit
+  uint32_t                n_e;            // Number of rate matched LLRs
+  uint32_t                cb_len;         // Code block length, including the CRC
+  uint32_t                cb_len_idx;     // Code block length index
+  uint32_t                rlen;           // Code block length without the code block CRC
+  uint32_t                len_crc;        // Number of bits covered by the CRC
+  bool                    use_cb_crc;     // Code block CRC or, for a single code block, transport block CRC
+  bool                    llr_is_8bit;    // LLR representation
+  uint32_t                rv;             // Redundancy version
+  uint32_t                max_iterations; // Maximum number of turbo decoder iterations
+  void*                   w_buff;         // Soft-buffer of the code block
+  srsran_softbuffer_llr_t w_format;       // Soft bit representation of the soft-buffer
+  uint8_t*                w_shift;        // Scale of the 4-bit soft bits of the code block
+  uint8_t*                data;           // Decoded code block output, without the code block CRC
+
+  // Results
+  int      ret;
+  bool     crc_ok;
+  uint32_t nof_iterations;
+} sch_cb_job_t;
+
+/* Objects used to decode a code block, they cannot be shared between threads */
+typedef struct {
+  srsran_tdec_t* decoder;
+  srsran_crc_t*  crc_tb;
+  srsran_crc_t*  crc_cb;
+  uint8_t*       cb_buffer;  // Decoded code block, including the CRC
+  int16_t*       llr_buffer; // Combined LLRs of the code block, for compressed soft-buffers
+} sch_cb_decoder_t;
+
+/* Decoder objects of a pool thread, the pool runs the code blocks with its first member. It does not own an SCH object,
+ * because freeing it would free the shared rate matching tables */
+typedef struct {
+  sch_cb_decoder_t d;
+  srsran_tdec_t    decoder;
+  srsran_crc_t     crc_tb;
+  srsran_crc_t     crc_cb;
+} sch_decoder_thread_t;
+
+static void sch_cb_job_run(const sch_cb_decoder_t* d, sch_cb_job_t* job)
+{
+  job->ret            = SRSRAN_SUCCESS;
+  job->crc_ok         = false;
+  job->nof_iterations = 0;
+
+  // Uncompressed soft-buffers are decoded in place, compressed ones are combined into the decoder LLR buffer
+  void* llr = job->w_buff;
+  if (job->w_format == SRSRAN_SOFTBUFFER_LLR_16BIT) {
+    if (job->llr_is_8bit) {
+      if (srsran_rm_turbo_rx_lut_8bit(job->e_bits, job->w_buff, job->n_e, job->cb_len_idx, job->rv)) {
+        job->ret = SRSRAN_ERROR;
+        return;
+      }
+    } else {
+      if (srsran_rm_turbo_rx_lut(job->e_bits, job->w_buff, job->n_e, job->cb_len_idx, job->rv)) {
+        job->ret = SRSRAN_ERROR;
+        return;
+      }
+    }
+  } else {
+    llr = d->llr_buffer;
+    if (job->llr_is_8bit) {
+      if (srsran_rm_turbo_rx_lut_combine_8bit(
+              job->e_bits, llr, job->w_buff, job->w_format, job->w_shift, job->n_e, job->cb_len_idx, job->rv)) {
+        job->ret = SRSRAN_ERROR;
+        return;
+      }
+    } else {
+      if (srsran_rm_turbo_rx_lut_combine(
+              job->e_bits, llr, job->w_buff, job->w_format, job->w_shift, job->n_e, job->cb_len_idx, job->rv)) {
+        job->ret = SRSRAN_ERROR;
+        return;
+      }
+    }
+  }
+
+  srsran_tdec_new_cb(d->decoder, job->cb_len);
+
+  // Run iterations and use CRC for early stopping. The code block is decoded into a temporal buffer because its CRC
+  // overlaps the next code block output, which may be decoded by another thread.
+  srsran_crc_t* crc_ptr = job->use_cb_crc ? d->crc_cb : d->crc_tb;
+  do {
+    if (job->llr_is_8bit) {
+      srsran_tdec_iteration_8bit(d->decoder, (int8_t*)llr, d->cb_buffer);
+    } else {
+      srsran_tdec_iteration(d->decoder, (int16_t*)llr, d->cb_buffer);
+    }
+    job->nof_iterations++;
+
+    // CRC is OK and ran the minimum number of iterations
+    if (!srsran_crc_checksum_byte(crc_ptr, d->cb_buffer, job->len_crc) &&
+        (job->nof_iterations >= SRSRAN_PDSCH_MIN_TDEC_ITERS)) {
+      job->crc_ok = true;
+    }
+  } while (job->nof_iterations < job->max_iterations && !job->crc_ok);
+
+  memcpy(job->data, d->cb_buffer, job->rlen / 8);
+}
+
+static void sch_decoder_pool_run(void* ctx, void* job)
+{
+  sch_cb_job_run((const sch_cb_decoder_t*)ctx, (sch_cb_job_t*)job);
+}
+
+static int sch_decoder_thread_init(void* ctx, const void* arg)
+{
+  sch_decoder_thread_t* h = (sch_decoder_thread_t*)ctx;
+  if (srsran_crc_init(&h->crc_tb, SRSRAN_LTE_CRC24A, 24) || srsran_crc_init(&h->crc_cb, SRSRAN_LTE_CRC24B, 24)) {
+    ERROR("Error initiating CRC");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_tdec_init(&h->decoder, SRSRAN_TCOD_MAX_LEN_CB)) {
+    ERROR("Error initiating Turbo Decoder");
+    return SRSRAN_ERROR;
+  }
+  h->d.cb_buffer = srsran_vec_u8_malloc((SRSRAN_TCOD_MAX_LEN_CB + 8) / 8);
+  if (!h->d.cb_buffer) {
+    return SRSRAN_ERROR;
+  }
+  h->d.llr_buffer = srsran_vec_i16_malloc(SOFTBUFFER_SIZE);
+  if (!h->d.llr_buffer) {
+    return SRSRAN_ERROR;
+  }
+  h->d.decoder = &h->decoder;
+  h->d.crc_tb  = &h->crc_tb;
+  h->d.crc_cb  = &h->crc_cb;
+  return SRSRAN_SUCCESS;
+}
+
+static void sch_decoder_thread_free(void* ctx)
+{
+  sch_decoder_thread_t* h = (sch_decoder_thread_t*)ctx;
+  srsran_tdec_free(&h->decoder);
+  if (h->d.cb_buffer) {
+    free(h->d.cb_buffer);
+  }
+  if (h->d.llr_buffer) {
+    free(h->d.llr_buffer);
+  }
+}
+
+
 int srsran_sch_init(srsran_sch_t* q)
 {
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
@@ -172,6 +322,12 @@ int srsran_sch_init(srsran_sch_t* q)
       goto clean;
     }
 
+    // Combined LLRs of a code block, when the soft-buffer is compressed
+    q->llr_buffer = srsran_vec_i16_malloc(SOFTBUFFER_SIZE);
+    if (!q->llr_buffer) {
+      goto clean;
+    }
+
     q->parity_bits = srsran_vec_u8_malloc((3 * SRSRAN_TCOD_MAX_LEN_CB + 16) / 8);
     if (!q->parity_bits) {
       goto clean;
@@ -205,6 +361,9 @@ void srsran_sch_free(srsran_sch_t* q)
   if (q->cb_in) {
     free(q->cb_in);
   }
+  if (q->llr_buffer) {
+    free(q->llr_buffer);
+  }
   if (q->parity_bits) {
     free(q->parity_bits);
   }
@@ -217,9 +376,34 @@ void srsran_sch_free(srsran_sch_t* q)
   srsran_tdec_free(&q->decoder);
   srsran_tcod_free(&q->encoder);
   srsran_uci_cqi_free(&q->uci_cqi);
+  sch_cb_pool_free((sch_cb_pool_t*)q->decoder_pool);
   bzero(q, sizeof(srsran_sch_t));
 }
 
+int srsran_sch_set_decoder_threads(srsran_sch_t* q, uint32_t nof_threads)
+{
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  sch_cb_pool_free((sch_cb_pool_t*)q->decoder_pool);
+  q->decoder_pool = NULL;
+
+  if (nof_threads > 1) {
+    q->decoder_pool = sch_cb_pool_create(nof_threads - 1,
+                                         sizeof(sch_decoder_thread_t),
+                                         sch_decoder_thread_init,
+                                         NULL,
+                                         sch_decoder_thread_free,
+                                         sch_decoder_pool_run);
+    if (q->decoder_pool == NULL) {
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 void srsran_sch_set_max_noi(srsran_sch_t* q, uint32_t max_iterations)
 {
   if (max_iterations == 0) {
@@ -234,6 +418,11 @@ float srsran_sch_last_noi(srsran_sch_t* q)
   return q->avg_iterations;
 }
 
+uint32_t srsran_sch_last_decode_time_us(srsran_sch_t* q)
+{
+  return q->decode_time_us;
+}
+
 /* Encode a transport block according to 36.212 5.3.2
  *
  */
@@ -387,6 +576,8 @@ bool decode_tb_cb(srsran_sch_t*           q,
 
   q->avg_iterations = 0;
 
+  sch_cb_job_t jobs[SRSRAN_MAX_CODEBLOCKS];
+  uint32_t     nof_jobs = 0;
   for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
     /* Do not process blocks with CRC Ok */
     if (softbuffer->cb_crc[cb_idx] == false) {
@@ -406,65 +597,22 @@ bool decode_tb_cb(srsran_sch_t*           q,
         rp   = (cb_segm->C - gamma) * n_e + (cb_idx - (cb_segm->C - gamma)) * n_e2;
       }
 
-      if (q->llr_is_8bit) {
-        if (srsran_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*)softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching");
-          return SRSRAN_ERROR;
-        }
-      } else {
-        if (srsran_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching");
-          return SRSRAN_ERROR;
-        }
-      }
-
-      srsran_tdec_new_cb(&q->decoder, cb_len);
-
-      // Run iterations and use CRC for early stopping
-      bool     early_stop = false;
-      uint32_t cb_noi     = 0;
-      do {
-        if (q->llr_is_8bit) {
-          srsran_tdec_iteration_8bit(&q->decoder, (int8_t*)softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        } else {
-          srsran_tdec_iteration(&q->decoder, softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        }
-        q->avg_iterations++;
-        cb_noi++;
-
-        uint32_t      len_crc;
-        srsran_crc_t* crc_ptr;
-
-        if (cb_segm->C > 1) {
-          len_crc = cb_len;
-          crc_ptr = &q->crc_cb;
-        } else {
-          len_crc = cb_segm->tbs + 24;
-          crc_ptr = &q->crc_tb;
-        }
-
-        // CRC is OK and ran the minimum number of iterations
-        if (!srsran_crc_checksum_byte(crc_ptr, &data[cb_idx * rlen / 8], len_crc) &&
-            (cb_noi >= SRSRAN_PDSCH_MIN_TDEC_ITERS)) {
-          softbuffer->cb_crc[cb_idx] = true;
-          early_stop                 = true;
-
-          // CRC is error and exceeded maximum iterations for this CB.
-          // Early stop the whole transport block.
-        }
-
-      } while (cb_noi < q->max_iterations && !early_stop);
-
-      INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
-           cb_idx,
-           rp,
-           n_e2,
-           cb_len,
-           early_stop ? "OK" : "KO",
-           rlen,
-           cb_noi,
-           q->max_iterations);
-
+      sch_cb_job_t* job   = &jobs[nof_jobs++];
+      job->cb_idx         = cb_idx;
+      job->e_bits         = q->llr_is_8bit ? (void*)&e_bits_b[rp] : (void*)&e_bits_s[rp];
+      job->n_e            = n_e2;
+      job->cb_len         = cb_len;
+      job->cb_len_idx     = cb_len_idx;
+      job->rlen           = rlen;
+      job->len_crc        = cb_segm->C > 1 ? cb_len : cb_segm->tbs + 24;
+      job->use_cb_crc     = cb_segm->C > 1;
+      job->llr_is_8bit    = q->llr_is_8bit;
+      job->rv             = rv;
+      job->max_iterations = q->max_iterations;
+      job->w_buff         = softbuffer->buffer_f[cb_idx];
+      job->w_format       = softbuffer->llr_format;
+      job->w_shift        = &softbuffer->cb_llr_shift[cb_idx];
+      job->data           = &data[cb_idx * rlen / 8];
     } else {
       // Copy decoded data from previous transmissions
       uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
@@ -473,6 +621,35 @@ bool decode_tb_cb(srsran_sch_t*           q,
     }
   }
 
+  // Decode the code blocks, in parallel if there are decoder threads and more than one code block
+  sch_cb_decoder_t d = {&q->decoder, &q->crc_tb, &q->crc_cb, q->cb_in, q->llr_buffer};
+  if (q->decoder_pool != NULL && nof_jobs > 1) {
+    sch_cb_pool_decode((sch_cb_pool_t*)q->decoder_pool, &d, jobs, sizeof(sch_cb_job_t), nof_jobs);
+  } else {
+    for (uint32_t i = 0; i < nof_jobs; i++) {
+      sch_cb_job_run(&d, &jobs[i]);
+    }
+  }
+
+  for (uint32_t i = 0; i < nof_jobs; i++) {
+    const sch_cb_job_t* job = &jobs[i];
+    if (job->ret < SRSRAN_SUCCESS) {
+      ERROR("Error in rate matching");
+      return false;
+    }
+    softbuffer->cb_crc[job->cb_idx] = job->crc_ok;
+    q->avg_iterations += job->nof_iterations;
+
+    INFO("CB %d: n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
+         job->cb_idx,
+         job->n_e,
+         job->cb_len,
+         job->crc_ok ? "OK" : "KO",
+         job->rlen,
+         job->nof_iterations,
+         job->max_iterations);
+  }
+
   softbuffer->tb_crc = true;
   for (int i = 0; i < cb_segm->C && softbuffer->tb_crc; i++) {
     /* If one CB failed return false */
@@ -513,7 +690,8 @@ static int decode_tb(srsran_sch_t*           q,
                      uint32_t                rv,
                      uint32_t                nof_e_bits,
                      int16_t*                e_bits,
-                     uint8_t*                data)
+                     uint8_t*                data,
+                     bool                    meas_time_en)
 {
   // Check inputs
   if (q == NULL || data == NULL || softbuffer == NULL || e_bits == NULL || cb_segm == NULL || Qm == 0) {
@@ -526,6 +704,8 @@ static int decode_tb(srsran_sch_t*           q,
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
 
+  q->decode_time_us = 0;
+
   // Check segmentation is valid
   if (cb_segm->tbs == 0 || cb_segm->C == 0) {
     return SRSRAN_SUCCESS;
@@ -544,8 +724,17 @@ static int decode_tb(srsran_sch_t*           q,
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
 
-  // Process Codeblocks
+  // Process Codeblocks, the decoding time is only measured when requested by the caller
+  struct timeval t[3];
+  if (meas_time_en) {
+    gettimeofday(&t[1], NULL);
+  }
   bool cb_crc_ok = decode_tb_cb(q, softbuffer, cb_segm, Qm, rv, nof_e_bits, e_bits, data);
+  if (meas_time_en) {
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    q->decode_time_us = (uint32_t)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+  }
 
   // If any of the CBs CRC is KO
   if (!cb_crc_ok) {
@@ -605,7 +794,8 @@ int srsran_dlsch_decode2(srsran_sch_t*       q,
                    cfg->grant.tb[tb_idx].rv,
                    cfg->grant.tb[tb_idx].nof_bits,
                    e_bits,
-                   data);
+                   data,
+                   cfg->meas_time_en);
 }
 
 /**
@@ -1187,7 +1377,8 @@ int srsran_ulsch_decode(srsran_sch_t*       q,
   // Decode ULSCH
   if (cb_segm.tbs > 0) {
     uint32_t G = nb_q / Qm - Q_prime_ri - Q_prime_cqi;
-    ret        = decode_tb(q, cfg->softbuffers.rx, &cb_segm, Qm, cfg->grant.tb.rv, G * Qm, &g_bits[e_offset], data);
+    ret        = decode_tb(
+        q, cfg->softbuffers.rx, &cb_segm, Qm, cfg->grant.tb.rv, G * Qm, &g_bits[e_offset], data, cfg->meas_time_en);
   }
   return ret;
 }
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "sch_cb_pool.h"
+#include "srsran/config.h"
+#include "srsran/phy/utils/debug.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct {
+  pthread_t      thread;
+  bool           started;
+  sch_cb_pool_t* pool;
+  void*          ctx;
+} sch_cb_pool_thread_t;
+
+struct sch_cb_pool_s {
+  pthread_mutex_t       mutex;
+  pthread_cond_t        cvar_start;
+  pthread_cond_t        cvar_done;
+  uint8_t*              jobs;     // Jobs of the current transport block, owned by the caller
+  uint32_t              job_size; // Size of a job
+  uint32_t              nof_jobs; // Number of jobs of the current transport block
+  uint32_t              next_job; // Index of the next job to pick
+  uint32_t              nof_done; // Number of completed jobs
+  uint64_t              batch_id; // Incremented for every transport block, it wakes up the threads
+  bool                  quit;
+  sch_cb_pool_run_t     run;
+  sch_cb_pool_free_t    free_ctx;
+  uint8_t*              ctx;      // Decoder contexts of the threads
+  uint32_t              ctx_size; // Size of a decoder context
+  uint32_t              nof_ctx;  // Number of initialised decoder contexts
+  uint32_t              nof_threads;
+  sch_cb_pool_thread_t* threads;
+};
+
+/* Picks and decodes code blocks of the current transport block until there are none left */
+static void sch_cb_pool_work(sch_cb_pool_t* pool, void* ctx)
+{
+  pthread_mutex_lock(&pool->mutex);
+  while (pool->next_job < pool->nof_jobs) {
+    void* job = pool->jobs + (size_t)pool->job_size * pool->next_job++;
+    pthread_mutex_unlock(&pool->mutex);
+
+    pool->run(ctx, job);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->nof_done++;
+    if (pool->nof_done == pool->nof_jobs) {
+      pthread_cond_signal(&pool->cvar_done);
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+static void* sch_cb_pool_thread(void* arg)
+{
+  sch_cb_pool_thread_t* h        = (sch_cb_pool_thread_t*)arg;
+  sch_cb_pool_t*        pool     = h->pool;
+  uint64_t              batch_id = 0;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (!pool->quit) {
+    // Wait for a new transport block
+    if (pool->batch_id == batch_id) {
+      pthread_cond_wait(&pool->cvar_start, &pool->mutex);
+      continue;
+    }
+    batch_id = pool->batch_id;
+    pthread_mutex_unlock(&pool->mutex);
+
+    sch_cb_pool_work(pool, h->ctx);
+
+    pthread_mutex_lock(&pool->mutex);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  return NULL;
+}
+
+void sch_cb_pool_decode(sch_cb_pool_t* pool, void* ctx, void* jobs, uint32_t job_size, uint32_t nof_jobs)
+{
+  pthread_mutex_lock(&pool->mutex);
+  pool->jobs     = (uint8_t*)jobs;
+  pool->job_size = job_size;
+  pool->nof_jobs = nof_jobs;
+  pool->next_job = 0;
+  pool->nof_done = 0;
+  pool->batch_id++;
+  pthread_cond_broadcast(&pool->cvar_start);
+  pthread_mutex_unlock(&pool->mutex);
+
+  sch_cb_pool_work(pool, ctx);
+
+  // Wait for the code blocks picked by the pool threads
+  pthread_mutex_lock(&pool->mutex);
+  while (pool->nof_done < pool->nof_jobs) {
+    pthread_cond_wait(&pool->cvar_done, &pool->mutex);
+  }
+  pool->jobs     = NULL;
+  pool->nof_jobs = 0;
+  pool->next_job = 0;
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+void sch_cb_pool_free(sch_cb_pool_t* pool)
+{
+  if (pool == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->quit = true;
+  pthread_cond_broadcast(&pool->cvar_start);
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (pool->threads) {
+    for (uint32_t i = 0; i < pool->nof_threads; i++) {
+      if (pool->threads[i].started) {
+        pthread_join(pool->threads[i].thread, NULL);
+      }
+    }
+    free(pool->threads);
+  }
+
+  // The contexts are freed once no thread uses them
+  if (pool->ctx) {
+    for (uint32_t i = 0; i < pool->nof_ctx; i++) {
+      pool->free_ctx(pool->ctx + (size_t)pool->ctx_size * i);
+    }
+    free(pool->ctx);
+  }
+
+  pthread_cond_destroy(&pool->cvar_start);
+  pthread_cond_destroy(&pool->cvar_done);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool);
+}
+
+sch_cb_pool_t* sch_cb_pool_create(uint32_t           nof_threads,
+                                  uint32_t           ctx_size,
+                                  sch_cb_pool_init_t init,
+                                  const void*        init_arg,
+                                  sch_cb_pool_free_t free_ctx,
+                                  sch_cb_pool_run_t  run)
+{
+  sch_cb_pool_t* pool = calloc(1, sizeof(sch_cb_pool_t));
+  if (pool == NULL) {
+    ERROR("Allocating decoder pool");
+    return NULL;
+  }
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->cvar_start, NULL);
+  pthread_cond_init(&pool->cvar_done, NULL);
+  pool->run      = run;
+  pool->free_ctx = free_ctx;
+  pool->ctx_size = ctx_size;
+
+  pool->ctx     = calloc(nof_threads, ctx_size);
+  pool->threads = calloc(nof_threads, sizeof(sch_cb_pool_thread_t));
+  if (pool->ctx == NULL || pool->threads == NULL) {
+    ERROR("Allocating decoder threads");
+    sch_cb_pool_free(pool);
+    return NULL;
+  }
+  pool->nof_threads = nof_threads;
+
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    sch_cb_pool_thread_t* h = &pool->threads[i];
+    h->pool                 = pool;
+    h->ctx                  = pool->ctx + (size_t)ctx_size * i;
+    pool->nof_ctx++;
+    if (init(h->ctx, init_arg) < SRSRAN_SUCCESS) {
+      ERROR("Initialising decoder thread %d", i);
+      sch_cb_pool_free(pool);
+      return NULL;
+    }
+    if (pthread_create(&h->thread, NULL, sch_cb_pool_thread, h)) {
+      ERROR("Creating decoder thread %d", i);
+      sch_cb_pool_free(pool);
+      return NULL;
+    }
+    h->started = true;
+  }
+
+  return pool;
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#ifndef SRSRAN_SCH_CB_POOL_H
+#define SRSRAN_SCH_CB_POOL_H
+
+#include <stdint.h>
+
+/**
+ * Thread pool shared by the LTE and NR shared channel decoders to decode the code blocks of a transport block in
+ * parallel. Each thread keeps its own decoder context, initialised and freed through the given callbacks, and the
+ * thread decoding a transport block also picks code blocks with its own context.
+ */
+typedef struct sch_cb_pool_s sch_cb_pool_t;
+
+typedef int (*sch_cb_pool_init_t)(void* ctx, const void* arg); ///< Initialises a thread decoder context
+typedef void (*sch_cb_pool_free_t)(void* ctx);                 ///< Frees a thread decoder context
+typedef void (*sch_cb_pool_run_t)(void* ctx, void* job);       ///< Decodes one code block job with a decoder context
+
+/**
+ * @brief Creates a pool of decoder threads
+ * @param nof_threads Number of threads, not including the thread that decodes the transport blocks
+ * @param ctx_size Size of the decoder context of each thread
+ * @param init Decoder context initialisation, called with init_arg before the thread starts
+ * @param free_ctx Decoder context release, also called for contexts that failed to initialise
+ * @param run Code block decoding
+ * @return The pool, or NULL on error
+ */
+sch_cb_pool_t* sch_cb_pool_create(uint32_t           nof_threads,
+                                  uint32_t           ctx_size,
+                                  sch_cb_pool_init_t init,
+                                  const void*        init_arg,
+                                  sch_cb_pool_free_t free_ctx,
+                                  sch_cb_pool_run_t  run);
+
+/**
+ * @brief Decodes a set of code block jobs with the calling thread and the pool threads, and waits for all of them
+ * @param ctx Decoder context of the calling thread
+ * @param jobs Array of nof_jobs jobs of job_size bytes each
+ */
+void sch_cb_pool_decode(sch_cb_pool_t* pool, void* ctx, void* jobs, uint32_t job_size, uint32_t nof_jobs);
+
+/**
+ * @brief Stops the threads and frees their decoder contexts. A NULL pool is ignored
+ */
+void sch_cb_pool_free(sch_cb_pool_t* pool);
+
+#endif // SRSRAN_SCH_CB_POOL_H
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/phy/phch/sch_nr.h"
+#include "sch_cb_pool.h"
 #include "srsran/config.h"
 #include "srsran/phy/fec/cbsegm.h"
 #include "srsran/phy/fec/ldpc/ldpc_common.h"
@@ -32,6 +33,23 @@
 #define SCH_INFO_TX(...) INFO("SCH Tx: " __VA_ARGS__)
 #define SCH_INFO_RX(...) INFO("SCH Rx: " __VA_ARGS__)
 
+/**
+ * @brief Decoding of a single rate-dematched code block. It carries everything needed to run it, so it can be picked by
+ * any of the decoder threads
+ */
+typedef struct {
+  uint32_t           cb_idx; ///< Code block index within the transport block
+  int8_t*            llr;    ///< Rate-dematched LLRs, stored in the soft-buffer
+  uint32_t           n_llr;  ///< Number of LLRs
+  srsran_basegraph_t bg;     ///< Base graph
+  uint32_t           Z;      ///< Lifting size
+  uint32_t           L_tb;   ///< Transport block CRC length, used for early stop if the code block has no CRC
+  uint32_t           L_cb;   ///< Code block CRC length
+  uint32_t           cb_len; ///< Number of information bits, excluding the code block CRC
+  uint8_t*           data;   ///< Packed information bits output, only written if the CRC matches
+  int                ret;    ///< Decoder return value: number of iterations, 0 if the CRC did not match, or error
+} sch_nr_cb_job_t;
+
 srsran_basegraph_t srsran_sch_nr_select_basegraph(uint32_t tbs, double R)
 {
   // if A ≤ 292 , or if A ≤ 3824 and R ≤ 0.67 , or if R ≤ 0 . 25 , LDPC base graph 2 is used;
@@ -216,6 +234,52 @@ static inline int sch_nr_init_common(srsran_sch_nr_t* q)
   return SRSRAN_SUCCESS;
 }
 
+static void sch_nr_cb_job_run(srsran_sch_nr_t* q, sch_nr_cb_job_t* job)
+{
+  srsran_ldpc_decoder_t* decoder = (job->bg == BG1) ? q->decoder_bg1[job->Z] : q->decoder_bg2[job->Z];
+
+  // Select CB or TB early stop CRC
+  srsran_crc_t* crc = (job->L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
+  if (job->L_cb) {
+    crc = &q->crc_cb;
+  }
+
+  // Decode. if CRC=KO, then ret=0
+  job->ret = srsran_ldpc_decoder_decode_crc_c(decoder, job->llr, q->temp_cb, job->n_llr, crc);
+
+  // CB Debug trace
+  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+    DEBUG("CB %d:", job->cb_idx);
+    srsran_vec_fprint_hex(stdout, q->temp_cb, job->cb_len);
+  }
+
+  // Pack only if CRC is match
+  if (job->ret > 0) {
+    srsran_bit_pack_vector(q->temp_cb, job->data, job->cb_len);
+  }
+}
+
+static void sch_nr_decoder_pool_run(void* ctx, void* job)
+{
+  sch_nr_cb_job_run((srsran_sch_nr_t*)ctx, (sch_nr_cb_job_t*)job);
+}
+
+/**
+ * @brief Initialises the SCH receiver of a decoder thread, it provides the decoders, CRC and temporal buffers
+ */
+static int sch_nr_decoder_thread_init(void* ctx, const void* arg)
+{
+  // The threads decode with their own SCH objects, which do not have threads
+  srsran_sch_nr_args_t thread_args = *(const srsran_sch_nr_args_t*)arg;
+  thread_args.nof_decoder_threads  = 0;
+  return srsran_sch_nr_init_rx((srsran_sch_nr_t*)ctx, &thread_args);
+}
+
+static void sch_nr_decoder_thread_free(void* ctx)
+{
+  srsran_sch_nr_free((srsran_sch_nr_t*)ctx);
+}
+
 int srsran_sch_nr_init_tx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
 {
   int ret = sch_nr_init_common(q);
@@ -356,6 +420,20 @@ int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
     return SRSRAN_ERROR;
   }
 
+  // Decode the code blocks in parallel if more than one thread is requested
+  if (args->nof_decoder_threads > 1 && q->decoder_pool == NULL) {
+    q->decoder_pool = sch_cb_pool_create(args->nof_decoder_threads - 1,
+                                         sizeof(srsran_sch_nr_t),
+                                         sch_nr_decoder_thread_init,
+                                         args,
+                                         sch_nr_decoder_thread_free,
+                                         sch_nr_decoder_pool_run);
+    if (q->decoder_pool == NULL) {
+      ERROR("Error: creating LDPC decoder threads");
+      return SRSRAN_ERROR;
+    }
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -402,6 +480,9 @@ void srsran_sch_nr_free(srsran_sch_nr_t* q)
 
   srsran_ldpc_rm_tx_free(&q->tx_rm);
   srsran_ldpc_rm_rx_free_c(&q->rx_rm);
+
+  sch_cb_pool_free((sch_cb_pool_t*)q->decoder_pool);
+  q->decoder_pool = NULL;
 }
 
 static inline int sch_nr_encode(srsran_sch_nr_t*        q,
@@ -568,6 +649,12 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
     return SRSRAN_ERROR;
   }
 
+  // The LDPC decoder takes the 8-bit soft bits straight from the soft-buffer
+  if (tb->softbuffer.rx->llr_format == SRSRAN_SOFTBUFFER_LLR_4BIT) {
+    ERROR("4-bit soft-buffers are not supported by the LDPC decoder");
+    return SRSRAN_ERROR;
+  }
+
   // Protect PDU access
   if (!res->payload) {
     ERROR("Missing payload pointer!");
@@ -607,8 +694,10 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
   uint32_t cb_ok = 0;
   res->crc       = false;
 
-  // For each code block...
-  uint32_t j = 0;
+  // Rate dematch the code blocks to decode
+  sch_nr_cb_job_t jobs[SRSRAN_SCH_NR_MAX_NOF_CB_LDPC];
+  uint32_t        nof_jobs = 0;
+  uint32_t        j        = 0;
   for (uint32_t r = 0; r < cfg.C; r++) {
     bool    decoded   = tb->softbuffer.rx->cb_crc[r];
     int8_t* rm_buffer = (int8_t*)tb->softbuffer.tx->buffer_b[r];
@@ -654,42 +743,48 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
       return SRSRAN_ERROR;
     }
 
-    // Select CB or TB early stop CRC
-    srsran_crc_t* crc = (cfg.L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
-    if (cfg.L_cb) {
-      crc = &q->crc_cb;
+    sch_nr_cb_job_t* job = &jobs[nof_jobs++];
+    job->cb_idx          = r;
+    job->llr             = rm_buffer;
+    job->n_llr           = (uint32_t)n_llr;
+    job->bg              = cfg.bg;
+    job->Z               = cfg.Z;
+    job->L_tb            = cfg.L_tb;
+    job->L_cb            = cfg.L_cb;
+    job->cb_len          = cfg.Kp - cfg.L_cb;
+    job->data            = tb->softbuffer.rx->data[r];
+    job->ret             = SRSRAN_ERROR;
+
+    input_ptr += E;
+  }
+
+  // Decode the code blocks, in parallel if there are decoder threads and more than one code block
+  if (q->decoder_pool != NULL && nof_jobs > 1) {
+    sch_cb_pool_decode((sch_cb_pool_t*)q->decoder_pool, q, jobs, sizeof(sch_nr_cb_job_t), nof_jobs);
+  } else {
+    for (uint32_t i = 0; i < nof_jobs; i++) {
+      sch_nr_cb_job_run(q, &jobs[i]);
     }
+  }
 
-    // Decode. if CRC=KO, then ret=0
-    int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
-    if (ret < SRSRAN_SUCCESS) {
+  for (uint32_t i = 0; i < nof_jobs; i++) {
+    const sch_nr_cb_job_t* job = &jobs[i];
+    if (job->ret < SRSRAN_SUCCESS) {
       ERROR("Error decoding CB");
       return SRSRAN_ERROR;
     }
 
     // Compute number of iterations
-    uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
+    uint32_t n_iter_cb = (job->ret == 0) ? decoder->max_nof_iter : (uint32_t)job->ret;
     nof_iter_sum += n_iter_cb;
 
-    // Check if CB is all zeros
-    uint32_t cb_len = cfg.Kp - cfg.L_cb;
+    tb->softbuffer.rx->cb_crc[job->cb_idx] = (job->ret != 0);
+    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s", job->cb_idx, cfg.C, n_iter_cb, job->ret != 0 ? "OK" : "KO");
 
-    tb->softbuffer.rx->cb_crc[r] = (ret != 0);
-    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s", r, cfg.C, n_iter_cb, tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO");
-
-    // CB Debug trace
-    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-      DEBUG("CB %d/%d:", r, cfg.C);
-      srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
-    }
-
-    // Pack and count CRC OK only if CRC is match
-    if (tb->softbuffer.rx->cb_crc[r]) {
-      srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[r], cb_len);
+    // Count CRC OK only if CRC is match
+    if (tb->softbuffer.rx->cb_crc[job->cb_idx]) {
       cb_ok++;
     }
-
-    input_ptr += E;
   }
   // Set average number of iterations
   res->avg_iter = (float)nof_iter_sum / (float)cfg.C;
@@ -56,10 +56,16 @@ int          freq_hop      = -1;
 int          riv           = -1;
 uint32_t     mcs_idx       = 0;
 bool         enable_64_qam = false;
+uint32_t     nof_threads   = 1;
+uint32_t     llr_bits      = 16;
+float        snr_db        = NAN;
+uint32_t     nof_tx        = 1;
+float        max_bler      = 0.0f;
+float        max_bler_diff = NAN;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [csrnfvmtF] \n", prog);
+  printf("Usage: %s [csrnfvmtFwSTBD] \n", prog);
   printf("\n\tCell specific parameters:\n");
   printf("\t\t-n number of PRB [Default %d]\n", cell.nof_prb);
   printf("\t\t-c cell id [Default %d]\n", cell.id);
@@ -84,6 +90,14 @@ void usage(char* prog)
   printf("\n\tOther parameters:\n");
   printf("\t\t-p enable_64qam [Default %s]\n", enable_64_qam ? "enabled" : "disabled");
   printf("\t\t-s number of subframes [Default %d]\n", subframe);
+  printf("\t\t-t number of turbo decoder threads [Default %d]\n", nof_threads);
+  printf("\t\t-w soft-buffer soft bit width (16, 8 or 4) [Default %d]\n", llr_bits);
+
+  printf("\n\tChannel and HARQ parameters:\n");
+  printf("\t\t-S SNR in dB, adds AWGN [Default none]\n");
+  printf("\t\t-T maximum number of transmissions of a TB [Default %d]\n", nof_tx);
+  printf("\t\t-B maximum BLER after the last transmission [Default %.2f]\n", max_bler);
+  printf("\t\t-D maximum BLER increase over a 16-bit soft-buffer decoding the same signal [Default none]\n");
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
@@ -139,7 +153,7 @@ void parse_extensive_param(char* param, char* arg)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "msLFrncpvf")) != -1) {
+  while ((opt = getopt(argc, argv, "msLFrncpvftwSTBD")) != -1) {
     switch (opt) {
       case 'm':
         mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -165,6 +179,24 @@ void parse_args(int argc, char** argv)
       case 'c':
         cell.id = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 't':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'w':
+        llr_bits = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'T':
+        nof_tx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'B':
+        max_bler = strtof(argv[optind], NULL);
+        break;
+      case 'D':
+        max_bler_diff = strtof(argv[optind], NULL);
+        break;
       case 'p':
         parse_extensive_param(argv[optind], argv[optind + 1]);
         optind++;
@@ -187,12 +219,14 @@ int main(int argc, char** argv)
   srsran_pusch_t         pusch_rx   = {};
   uint8_t*               data       = NULL;
   uint8_t*               data_rx    = NULL;
+  uint8_t*               data_ref   = NULL;
   cf_t*                  sf_symbols = NULL;
   int                    ret        = -1;
   struct timeval         t[3];
   srsran_pusch_cfg_t     cfg           = {};
   srsran_softbuffer_tx_t softbuffer_tx = {};
   srsran_softbuffer_rx_t softbuffer_rx = {};
+  srsran_softbuffer_rx_t softbuffer_ref = {};
   srsran_crc_t           crc_tb;
 
   ZERO_OBJECT(uci_data_tx);
@@ -243,6 +277,10 @@ int main(int argc, char** argv)
     ERROR("Error creating PUSCH object");
     goto quit;
   }
+  if (srsran_sch_set_decoder_threads(&pusch_rx.ul_sch, nof_threads)) {
+    ERROR("Error creating turbo decoder threads");
+    goto quit;
+  }
 
   uint16_t rnti = 62;
   dci.rnti      = rnti;
@@ -267,12 +305,32 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
+  data_ref = srsran_vec_u8_malloc(150000);
+  if (!data_ref) {
+    perror("malloc");
+    exit(-1);
+  }
+
   if (srsran_softbuffer_tx_init(&softbuffer_tx, 100)) {
     ERROR("Error initiating soft buffer");
     goto quit;
   }
 
-  if (srsran_softbuffer_rx_init(&softbuffer_rx, 100)) {
+  srsran_softbuffer_llr_t llr_format = SRSRAN_SOFTBUFFER_LLR_16BIT;
+  if (llr_bits == 8) {
+    llr_format = SRSRAN_SOFTBUFFER_LLR_8BIT;
+  } else if (llr_bits == 4) {
+    llr_format = SRSRAN_SOFTBUFFER_LLR_4BIT;
+  } else if (llr_bits != 16) {
+    ERROR("Invalid soft bit width %d", llr_bits);
+    goto quit;
+  }
+  if (srsran_softbuffer_rx_init_llr(&softbuffer_rx, SRSRAN_MAX_CODEBLOCKS, SOFTBUFFER_SIZE, llr_format)) {
+    ERROR("Error initiating soft buffer");
+    goto quit;
+  }
+  if (srsran_softbuffer_rx_init_llr(
+          &softbuffer_ref, SRSRAN_MAX_CODEBLOCKS, SOFTBUFFER_SIZE, SRSRAN_SOFTBUFFER_LLR_16BIT)) {
     ERROR("Error initiating soft buffer");
     goto quit;
   }
@@ -280,9 +338,15 @@ int main(int argc, char** argv)
   srsran_chest_ul_res_init(&chest_res, cell.nof_prb);
   srsran_chest_ul_res_set_identity(&chest_res);
 
+  // Without noise the channel estimate is ideal, otherwise the equalizer gets the actual noise variance
+  float noise_var = !isnan(snr_db) ? srsran_convert_dB_to_power(-snr_db) : 0.0f;
+  chest_res.noise_estimate = noise_var;
+
   cfg.enable_64qam     = enable_64_qam;
   uint64_t decode_us   = 0;
   uint64_t decode_bits = 0;
+  uint32_t nof_tb_err  = 0;
+  uint32_t nof_ref_err = 0;
 
   for (int n = 0; n < subframe; n++) {
     ret = SRSRAN_SUCCESS;
@@ -293,6 +357,7 @@ int main(int argc, char** argv)
 
     srsran_softbuffer_tx_reset(&softbuffer_tx);
     srsran_softbuffer_rx_reset(&softbuffer_rx);
+    srsran_softbuffer_rx_reset(&softbuffer_ref);
 
     // Generate random data
     for (uint32_t i = 0; i < cfg.grant.tb.tbs / 8; i++) {
@@ -309,36 +374,77 @@ int main(int argc, char** argv)
     pdata.ptr          = data;
     pdata.uci          = uci_data_tx.value;
     cfg.uci_cfg        = uci_data_tx.cfg;
-    cfg.softbuffers.tx = &softbuffer_tx;
 
-    if (srsran_pusch_encode(&pusch_tx, &ul_sf, &cfg, &pdata, sf_symbols)) {
-      ERROR("Error encoding TB");
-      exit(-1);
-    }
-    if (rv_idx > 0) {
-      cfg.grant.tb.rv = rv_idx;
+    srsran_pusch_res_t pusch_res = {};
+    pusch_res.data               = data_rx;
+    int r                        = SRSRAN_SUCCESS;
+
+    // The reference receives the same signal, combined in a 16-bit soft-buffer
+    srsran_pusch_res_t ref_res = {};
+    ref_res.data               = data_ref;
+    bool rx_done               = false;
+    bool ref_done              = isnan(snr_db) || isnan(max_bler_diff);
+
+    // Retransmit the TB until it is decoded, combining the transmissions in the soft-buffer
+    const uint32_t rv_seq[4] = {0, 2, 3, 1};
+    for (uint32_t tx = 0; tx < nof_tx && !(rx_done && ref_done); tx++) {
+      cfg.grant.tb.rv    = rv_seq[tx % 4];
+      cfg.softbuffers.tx = &softbuffer_tx;
       if (srsran_pusch_encode(&pusch_tx, &ul_sf, &cfg, &pdata, sf_symbols)) {
         ERROR("Error encoding TB");
         exit(-1);
       }
-    }
+      if (rv_idx > 0 && tx == 0) {
+        cfg.grant.tb.rv = rv_idx;
+        if (srsran_pusch_encode(&pusch_tx, &ul_sf, &cfg, &pdata, sf_symbols)) {
+          ERROR("Error encoding TB");
+          exit(-1);
+        }
+      }
 
-    srsran_pusch_res_t pusch_res = {};
-    pusch_res.data               = data_rx;
-    cfg.softbuffers.rx           = &softbuffer_rx;
-    memcpy(&cfg.uci_cfg, &uci_data_tx.cfg, sizeof(srsran_uci_cfg_t));
+      if (!isnan(snr_db)) {
+        srsran_ch_awgn_c(sf_symbols, sf_symbols, noise_var, nof_re);
+      }
+
+      if (!ref_done) {
+        cfg.softbuffers.rx = &softbuffer_ref;
+        memcpy(&cfg.uci_cfg, &uci_data_tx.cfg, sizeof(srsran_uci_cfg_t));
+        if (srsran_pusch_decode(&pusch_rx, &ul_sf, &cfg, &chest_res, sf_symbols, &ref_res)) {
+          ERROR("Error decoding TB");
+          exit(-1);
+        }
+        ref_done = ref_res.crc;
+      }
 
-    gettimeofday(&t[1], NULL);
-    int r = srsran_pusch_decode(&pusch_rx, &ul_sf, &cfg, &chest_res, sf_symbols, &pusch_res);
-    gettimeofday(&t[2], NULL);
+      if (!rx_done) {
+        cfg.softbuffers.rx = &softbuffer_rx;
+        memcpy(&cfg.uci_cfg, &uci_data_tx.cfg, sizeof(srsran_uci_cfg_t));
+        gettimeofday(&t[1], NULL);
+        r = srsran_pusch_decode(&pusch_rx, &ul_sf, &cfg, &chest_res, sf_symbols, &pusch_res);
+        gettimeofday(&t[2], NULL);
+        if (r) {
+          break;
+        }
+        rx_done = pusch_res.crc;
+      }
+    }
+    if (!isnan(snr_db) && !isnan(max_bler_diff) && !ref_res.crc) {
+      nof_ref_err++;
+    }
     if (r) {
       printf("Error returned while decoding\n");
       ret = SRSRAN_ERROR;
     }
 
     if (memcmp(data_rx, data, (size_t)cfg.grant.tb.tbs / 8) != 0) {
-      printf("Unmatched data detected\n");
-      ret = SRSRAN_ERROR;
+      // Decoding errors are expected over a noisy channel, they are checked against the maximum BLER
+      if (!isnan(snr_db)) {
+        INFO("TB error at subframe %d", n);
+        nof_tb_err++;
+      } else {
+        printf("Unmatched data detected\n");
+        ret = SRSRAN_ERROR;
+      }
     } else {
       INFO("Rx Data is Ok");
     }
@@ -399,12 +505,33 @@ int main(int argc, char** argv)
   }
 
   printf("Decoded Rate: %f Mbps\n", (double)decode_bits / (double)decode_us);
+
+  if (!isnan(snr_db)) {
+    float bler = (float)nof_tb_err / (float)subframe;
+    printf("SNR: %.1f dB, soft bits: %d bit, transmissions: %d, BLER: %.3f (max %.3f)\n",
+           snr_db,
+           llr_bits,
+           nof_tx,
+           bler,
+           max_bler);
+    if (bler > max_bler) {
+      ret = SRSRAN_ERROR;
+    }
+    if (!isnan(max_bler_diff)) {
+      float bler_ref = (float)nof_ref_err / (float)subframe;
+      printf("16-bit soft bits BLER: %.3f, increase: %.3f (max %.3f)\n", bler_ref, bler - bler_ref, max_bler_diff);
+      if (bler - bler_ref > max_bler_diff) {
+        ret = SRSRAN_ERROR;
+      }
+    }
+  }
 quit:
   srsran_chest_ul_res_free(&chest_res);
   srsran_pusch_free(&pusch_tx);
   srsran_pusch_free(&pusch_rx);
   srsran_softbuffer_tx_free(&softbuffer_tx);
   srsran_softbuffer_rx_free(&softbuffer_rx);
+  srsran_softbuffer_rx_free(&softbuffer_ref);
   srsran_random_free(random_h);
   if (sf_symbols) {
     free(sf_symbols);
@@ -415,6 +542,9 @@ quit:
   if (data_rx) {
     free(data_rx);
   }
+  if (data_ref) {
+    free(data_ref);
+  }
   if (ret) {
     printf("Error\n");
   } else {
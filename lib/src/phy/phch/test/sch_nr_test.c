@@ -26,13 +26,19 @@
 #include "srsran/phy/utils/vector.h"
 #include <getopt.h>
 #include <srsran/phy/utils/random.h>
+#include <sys/time.h>
+
+#define TIMED_LLR_AMP 10.0f
+#define TIMED_LLR_NOISE_STD 4.0f
 
 static srsran_carrier_nr_t carrier = SRSRAN_DEFAULT_CARRIER_NR;
 
-static uint32_t            n_prb     = 0;  // Set to 0 for steering
-static uint32_t            mcs       = 30; // Set to 30 for steering
-static uint32_t            rv        = 4;  // Set to 30 for steering
-static srsran_sch_cfg_nr_t pdsch_cfg = {};
+static uint32_t            n_prb       = 0;  // Set to 0 for steering
+static uint32_t            mcs         = 30; // Set to 30 for steering
+static uint32_t            rv          = 4;  // Set to 30 for steering
+static uint32_t            nof_threads = 1;
+static uint32_t            nof_timed   = 0; // Set to 0 to skip the decoder throughput measurement
+static srsran_sch_cfg_nr_t pdsch_cfg   = {};
 
 static void usage(char* prog)
 {
@@ -44,13 +50,16 @@ static void usage(char* prog)
   printf("\t-T Provide MCS table (64qam, 256qam, 64qamLowSE) [Default %s]\n",
          srsran_mcs_table_to_str(pdsch_cfg.sch_cfg.mcs_table));
   printf("\t-L Provide number of layers [Default %d]\n", carrier.max_mimo_layers);
+  printf("\t-t Number of LDPC decoder threads [Default %d]\n", nof_threads);
+  printf("\t-n Number of timed decodes per transport block, compared against a single thread [Default %d]\n",
+         nof_timed);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "PpmTLvr")) != -1) {
+  while ((opt = getopt(argc, argv, "PpmTLvrtn")) != -1) {
     switch (opt) {
       case 'P':
         carrier.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -70,6 +79,12 @@ int parse_args(int argc, char** argv)
       case 'L':
         carrier.max_mimo_layers = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 't':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_timed = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -82,12 +97,40 @@ int parse_args(int argc, char** argv)
   return SRSRAN_SUCCESS;
 }
 
+// Decodes the same transport block nof_timed times and accumulates the decoding time
+static int decode_timed(srsran_sch_nr_t* q, srsran_sch_tb_t* tb, int8_t* llr, uint8_t* data_rx, uint64_t* decode_us)
+{
+  struct timeval t[3];
+
+  for (uint32_t i = 0; i < nof_timed; i++) {
+    srsran_softbuffer_rx_reset(tb->softbuffer.rx);
+
+    srsran_sch_tb_res_nr_t res = {};
+    res.payload                = data_rx;
+    gettimeofday(&t[1], NULL);
+    int r = srsran_dlsch_nr_decode(q, &pdsch_cfg.sch_cfg, tb, llr, &res);
+    gettimeofday(&t[2], NULL);
+    if (r < SRSRAN_SUCCESS || !res.crc) {
+      return SRSRAN_ERROR;
+    }
+
+    get_time_interval(t);
+    *decode_us += (uint64_t)t[0].tv_sec * 1000000UL + (uint64_t)t[0].tv_usec;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
-  int             ret       = SRSRAN_ERROR;
-  srsran_sch_nr_t sch_nr_tx = {};
-  srsran_sch_nr_t sch_nr_rx = {};
-  srsran_random_t rand_gen  = srsran_random_init(1234);
+  int             ret              = SRSRAN_ERROR;
+  srsran_sch_nr_t sch_nr_tx        = {};
+  srsran_sch_nr_t sch_nr_rx        = {};
+  srsran_sch_nr_t sch_nr_rx_single = {};
+  srsran_random_t rand_gen         = srsran_random_init(1234);
+  uint64_t        decode_bits      = 0;
+  uint64_t        decode_us        = 0;
+  uint64_t        decode_single_us = 0;
 
   uint8_t* data_tx = srsran_vec_u8_malloc(1024 * 1024);
   uint8_t* encoded = srsran_vec_u8_malloc(1024 * 1024 * 8);
@@ -110,6 +153,7 @@ int main(int argc, char** argv)
   args.decoder_use_flooded    = false;
   args.decoder_scaling_factor = 0.8;
   args.max_nof_iter           = 20;
+  args.nof_decoder_threads    = nof_threads;
   if (srsran_sch_nr_init_tx(&sch_nr_tx, &args) < SRSRAN_SUCCESS) {
     ERROR("Error initiating SCH NR for Tx");
     goto clean_exit;
@@ -120,6 +164,20 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
+  // Single threaded receiver the decoder threads are measured against
+  if (nof_timed > 0) {
+    args.nof_decoder_threads = 1;
+    if (srsran_sch_nr_init_rx(&sch_nr_rx_single, &args) < SRSRAN_SUCCESS) {
+      ERROR("Error initiating SCH NR for Rx");
+      goto clean_exit;
+    }
+
+    if (srsran_sch_nr_set_carrier(&sch_nr_rx_single, &carrier)) {
+      ERROR("Error setting SCH NR carrier");
+      goto clean_exit;
+    }
+  }
+
   if (srsran_sch_nr_set_carrier(&sch_nr_tx, &carrier)) {
     ERROR("Error setting SCH NR carrier");
     goto clean_exit;
@@ -227,6 +285,22 @@ int main(int argc, char** argv)
             srsran_vec_fprint_byte(stdout, data_rx, tb.tbs / 8);
             goto clean_exit;
           }
+
+          if (nof_timed > 0) {
+            // Noisy LLR so the decoder iterates as it would on a real channel
+            for (uint32_t i = 0; i < tb.nof_bits; i++) {
+              float v = (encoded[i] ? -TIMED_LLR_AMP : +TIMED_LLR_AMP) +
+                        srsran_random_gauss_dist(rand_gen, TIMED_LLR_NOISE_STD);
+              llr[i]  = (int8_t)SRSRAN_MAX(SRSRAN_MIN(v, INT8_MAX), -INT8_MAX);
+            }
+
+            if (decode_timed(&sch_nr_rx_single, &tb, llr, data_rx, &decode_single_us) < SRSRAN_SUCCESS ||
+                decode_timed(&sch_nr_rx, &tb, llr, data_rx, &decode_us) < SRSRAN_SUCCESS) {
+              ERROR("Failed timed decode; n_prb=%d; mcs=%d; TBS=%d;", n_prb, mcs, tb.tbs);
+              goto clean_exit;
+            }
+            decode_bits += (uint64_t)tb.tbs * nof_timed;
+          }
         }
 
         INFO("n_prb=%d; mcs=%d; rv=%d TBS=%d; PASSED!\n", n_prb, mcs, rv, tb.tbs);
@@ -234,12 +308,18 @@ int main(int argc, char** argv)
     }
   }
 
+  if (decode_us > 0 && decode_single_us > 0) {
+    printf("Decoded Rate (1 thread): %f Mbps\n", (double)decode_bits / (double)decode_single_us);
+    printf("Decoded Rate (%d threads): %f Mbps\n", nof_threads, (double)decode_bits / (double)decode_us);
+  }
+
   ret = SRSRAN_SUCCESS;
 
 clean_exit:
   srsran_random_free(rand_gen);
   srsran_sch_nr_free(&sch_nr_tx);
   srsran_sch_nr_free(&sch_nr_rx);
+  srsran_sch_nr_free(&sch_nr_rx_single);
   if (data_tx) {
     free(data_tx);
   }
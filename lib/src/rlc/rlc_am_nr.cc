@@ -209,18 +209,14 @@ uint32_t rlc_am_nr_tx::build_new_pdu(uint8_t* payload, uint32_t nof_bytes)
   // NOTE: from now on, we can't return from this function anymore before increasing tx_next
   rlc_amd_tx_pdu_nr& tx_pdu = tx_window->add_pdu(st.tx_next);
   tx_pdu.pdcp_sn            = tx_sdu->md.pdcp_sn;
-  tx_pdu.sdu_buf            = srsran::make_byte_buffer();
-  if (tx_pdu.sdu_buf == nullptr) {
-    RlcError("Couldn't allocate PDU in %s().", __FUNCTION__);
-    return 0;
-  }
 
-  // Copy SDU into TX window SDU info
-  memcpy(tx_pdu.sdu_buf->msg, tx_sdu->msg, tx_sdu->N_bytes);
-  tx_pdu.sdu_buf->N_bytes = tx_sdu->N_bytes;
+  // Hand the SDU over to the TX window. The header is written directly into the payload, so that the stored SDU
+  // remains untouched for retransmissions and is copied only once.
+  tx_pdu.sdu_buf = std::move(tx_sdu);
+  const byte_buffer_t& sdu = *tx_pdu.sdu_buf;
 
   // Segment new SDU if necessary
-  if (tx_sdu->N_bytes + min_hdr_size > nof_bytes) {
+  if (sdu.N_bytes + min_hdr_size > nof_bytes) {
     RlcInfo("trying to build PDU segment from SDU.");
     return build_new_sdu_segment(tx_pdu, payload, nof_bytes);
   }
@@ -228,7 +224,7 @@ uint32_t rlc_am_nr_tx::build_new_pdu(uint8_t* payload, uint32_t nof_bytes)
   // Prepare header
   rlc_am_nr_pdu_header_t hdr = {};
   hdr.dc                     = RLC_DC_FIELD_DATA_PDU;
-  hdr.p                      = get_pdu_poll(st.tx_next, false, tx_sdu->N_bytes);
+  hdr.p                      = get_pdu_poll(st.tx_next, false, sdu.N_bytes);
   hdr.si                     = rlc_nr_si_field_t::full_sdu;
   hdr.sn_size                = cfg.tx_sn_field_length;
   hdr.sn                     = st.tx_next;
@@ -236,18 +232,18 @@ uint32_t rlc_am_nr_tx::build_new_pdu(uint8_t* payload, uint32_t nof_bytes)
   log_rlc_am_nr_pdu_header_to_string(logger.info, hdr, rb_name);
 
   // Write header
-  uint32_t len = rlc_am_nr_write_data_pdu_header(hdr, tx_sdu.get());
-  if (len > nof_bytes) {
+  uint32_t hdr_len = rlc_am_nr_write_data_pdu_header(hdr, payload);
+  if (hdr_len + sdu.N_bytes > nof_bytes) {
     RlcError("error writing AMD PDU header");
   }
 
   // Update TX Next
   st.tx_next = (st.tx_next + 1) % mod_nr;
 
-  memcpy(payload, tx_sdu->msg, tx_sdu->N_bytes);
-  RlcDebug("wrote RLC PDU - %d bytes", tx_sdu->N_bytes);
+  memcpy(&payload[hdr_len], sdu.msg, sdu.N_bytes);
+  RlcDebug("wrote RLC PDU - %d bytes", hdr_len + sdu.N_bytes);
 
-  return tx_sdu->N_bytes;
+  return hdr_len + sdu.N_bytes;
 }
 
 /**
@@ -258,7 +254,7 @@ uint32_t rlc_am_nr_tx::build_new_pdu(uint8_t* payload, uint32_t nof_bytes)
  * \param [nof_bytes] is the number of bytes the RLC is allowed to fill.
  *
  * \returns the number of bytes written to the payload buffer.
- * \remark: This functions assumes that the SDU has already been copied to tx_pdu.sdu_buf.
+ * \remark: This functions assumes that the SDU has already been moved to tx_pdu.sdu_buf.
  */
 uint32_t rlc_am_nr_tx::build_new_sdu_segment(rlc_amd_tx_pdu_nr& tx_pdu, uint8_t* payload, uint32_t nof_bytes)
 {
@@ -326,7 +322,7 @@ uint32_t rlc_am_nr_tx::build_new_sdu_segment(rlc_amd_tx_pdu_nr& tx_pdu, uint8_t*
  * \param [nof_bytes] is the number of bytes the RLC is allowed to fill.
  *
  * \returns the number of bytes written to the payload buffer.
- * \remark: This functions assumes that the SDU has already been copied to tx_pdu.sdu_buf.
+ * \remark: This functions assumes that the SDU has already been moved to tx_pdu.sdu_buf.
  */
 uint32_t rlc_am_nr_tx::build_continuation_sdu_segment(rlc_amd_tx_pdu_nr& tx_pdu, uint8_t* payload, uint32_t nof_bytes)
 {
@@ -441,7 +437,7 @@ uint32_t rlc_am_nr_tx::build_continuation_sdu_segment(rlc_amd_tx_pdu_nr& tx_pdu,
  * \param [nof_bytes] is the number of bytes the RLC is allowed to fill.
  *
  * \returns the number of bytes written to the payload buffer.
- * \remark: This functions assumes that the SDU has already been copied to tx_pdu.sdu_buf.
+ * \remark: This functions assumes that the SDU has already been moved to tx_pdu.sdu_buf.
  */
 uint32_t rlc_am_nr_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
@@ -589,7 +585,7 @@ rlc_am_nr_tx::build_retx_pdu_without_segmentation(const rlc_amd_retx_nr_t retx,
  * \param [nof_bytes] is the number of bytes the RLC is allowed to fill.
  *
  * \returns the number of bytes written to the payload buffer.
- * \remark: This functions assumes that the SDU has already been copied to tx_pdu.sdu_buf.
+ * \remark: This functions assumes that the SDU has already been moved to tx_pdu.sdu_buf.
  */
 uint32_t rlc_am_nr_tx::build_retx_pdu_with_segmentation(rlc_amd_retx_nr_t& retx, uint8_t* payload, uint32_t nof_bytes)
 {
@@ -31,12 +31,17 @@
 
 namespace srslog {
 
+/// Queue of log entries, with one lock-free queue per producer thread. Entries
+/// of different threads are popped in timestamp order.
+using log_entry_queue =
+    detail::work_queue<detail::log_entry, SRSLOG_THREAD_QUEUE_CAPACITY, detail::log_entry_time_order>;
+
 /// The backend worker runs in a secondary thread a routine that endlessly pops
 /// log entries from a work queue and dispatches them to the selected sinks.
 class backend_worker
 {
 public:
-  backend_worker(detail::work_queue<detail::log_entry>& queue, detail::dyn_arg_store_pool& arg_pool) :
+  backend_worker(log_entry_queue& queue, detail::dyn_arg_store_pool& arg_pool) :
     queue(queue), arg_pool(arg_pool), running_flag(false)
   {}
 
@@ -100,7 +105,7 @@ private:
   {
     if (queue.is_almost_full()) {
       err_handler(fmt::format("The backend queue size is about to reach its maximum "
-                              "capacity of {} elements, new log entries will get "
+                              "capacity of {} elements per thread, new log entries will get "
                               "discarded.\nConsider increasing the queue capacity.",
                               queue.get_capacity()));
       err_handler = [](const std::string&) {};
@@ -111,9 +116,9 @@ private:
   void set_thread_priority(backend_priority priority) const;
 
 private:
-  detail::work_queue<detail::log_entry>& queue;
-  detail::dyn_arg_store_pool&            arg_pool;
-  detail::shared_variable<bool>          running_flag;
+  log_entry_queue&              queue;
+  detail::dyn_arg_store_pool&   arg_pool;
+  detail::shared_variable<bool> running_flag;
   error_handler      err_handler = [](const std::string& error) { fmt::print(stderr, "srsLog error - {}\n", error); };
   std::once_flag     start_once_flag;
   std::thread        worker_thread;
@@ -0,0 +1,287 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_decoder.h"
+#include "binary_formatter.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include <cstring>
+
+using namespace srslog;
+
+namespace {
+
+/// Helper class to read values from a memory block with bounds checking.
+class reader
+{
+public:
+  reader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+  /// Returns the number of bytes that have not been read yet.
+  size_t remaining() const { return size - pos; }
+
+  /// Reads a value, returns false when there are not enough bytes left.
+  template <typename T>
+  bool read(T& value)
+  {
+    if (remaining() < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  /// Reads a block of bytes, returns false when there are not enough bytes left.
+  bool read_bytes(size_t len, const uint8_t*& bytes)
+  {
+    if (remaining() < len) {
+      return false;
+    }
+    bytes = data + pos;
+    pos += len;
+    return true;
+  }
+
+private:
+  const uint8_t* data;
+  size_t         size;
+  size_t         pos = 0;
+};
+
+/// Reads an encoded argument value and pushes it into the store using the C++
+/// type of the original argument.
+template <typename Arg, typename Encoded>
+bool read_arg(reader& r, fmt::dynamic_format_arg_store<fmt::printf_context>& store)
+{
+  Encoded value;
+  if (!r.read(value)) {
+    return false;
+  }
+  store.push_back(static_cast<Arg>(value));
+  return true;
+}
+
+/// Appends the text into the buffer as a JSON string, escaping the characters
+/// JSON does not allow inside a string literal.
+void append_json_string(fmt::string_view text, fmt::memory_buffer& out)
+{
+  out.push_back('"');
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        fmt::format_to(out, "\\\"");
+        break;
+      case '\\':
+        fmt::format_to(out, "\\\\");
+        break;
+      case '\n':
+        fmt::format_to(out, "\\n");
+        break;
+      case '\r':
+        fmt::format_to(out, "\\r");
+        break;
+      case '\t':
+        fmt::format_to(out, "\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          fmt::format_to(out, "\\u{:04x}", static_cast<unsigned>(c));
+        } else {
+          out.push_back(c);
+        }
+    }
+  }
+  out.push_back('"');
+}
+
+} // namespace
+
+const std::string* binary_decoder::find_string(uint32_t id) const
+{
+  if (id == 0 || id > strings.size() || !is_defined[id - 1]) {
+    return nullptr;
+  }
+  return &strings[id - 1];
+}
+
+detail::error_string binary_decoder::decode(const uint8_t* data, size_t size, fmt::memory_buffer& out)
+{
+  if (size < sizeof(binary_log::magic) + sizeof(binary_log::version) ||
+      std::memcmp(data, binary_log::magic, sizeof(binary_log::magic)) != 0) {
+    return "Not a binary log file";
+  }
+
+  uint32_t version;
+  std::memcpy(&version, data + sizeof(binary_log::magic), sizeof(version));
+  if (version != binary_log::version) {
+    return fmt::format("Unsupported binary log version {}", version);
+  }
+
+  reader r(data + sizeof(binary_log::magic) + sizeof(version),
+           size - sizeof(binary_log::magic) - sizeof(version));
+  while (r.remaining()) {
+    uint8_t type;
+    r.read(type);
+    // End of the written data.
+    if (type == 0) {
+      break;
+    }
+
+    uint32_t       len;
+    const uint8_t* payload;
+    if (!r.read(len) || !r.read_bytes(len, payload)) {
+      return "Truncated record";
+    }
+
+    switch (static_cast<binary_log::record_type>(type)) {
+      case binary_log::record_type::string_def: {
+        uint32_t id;
+        if (len < sizeof(id)) {
+          return "Invalid string definition record";
+        }
+        std::memcpy(&id, payload, sizeof(id));
+        if (id == 0) {
+          return "Invalid string id";
+        }
+        if (id > strings.size()) {
+          strings.resize(id);
+          is_defined.resize(id, false);
+        }
+        strings[id - 1].assign(reinterpret_cast<const char*>(payload) + sizeof(id), len - sizeof(id));
+        is_defined[id - 1] = true;
+        break;
+      }
+      case binary_log::record_type::entry:
+        if (auto err_str = decode_entry(payload, len, out)) {
+          return err_str;
+        }
+        break;
+      case binary_log::record_type::text:
+        if (json_text) {
+          fmt::format_to(out, "{{\n  \"text\": ");
+          append_json_string(fmt::string_view(reinterpret_cast<const char*>(payload), len), out);
+          fmt::format_to(out, "\n}}\n");
+        } else {
+          out.append(payload, payload + len);
+        }
+        break;
+      default:
+        return fmt::format("Unknown record type {}", type);
+    }
+  }
+
+  return {};
+}
+
+detail::error_string binary_decoder::decode_entry(const uint8_t* data, size_t size, fmt::memory_buffer& out)
+{
+  reader r(data, size);
+
+  int64_t  ns;
+  uint32_t fmt_id, name_id, ctx_value;
+  char     tag;
+  uint8_t  flags, nof_args;
+  if (!r.read(ns) || !r.read(fmt_id) || !r.read(name_id) || !r.read(tag) || !r.read(flags) || !r.read(ctx_value) ||
+      !r.read(nof_args)) {
+    return "Truncated entry record";
+  }
+
+  const std::string* fmtstring = find_string(fmt_id);
+  const std::string* log_name  = find_string(name_id);
+  if ((fmt_id && !fmtstring) || (name_id && !log_name)) {
+    return "Entry references an undefined string";
+  }
+
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  for (unsigned i = 0; i != nof_args; ++i) {
+    uint8_t type;
+    if (!r.read(type)) {
+      return "Truncated entry argument";
+    }
+
+    bool ok = true;
+    switch (static_cast<binary_log::arg_type>(type)) {
+      case binary_log::arg_type::int32:
+        ok = read_arg<int, int32_t>(r, store);
+        break;
+      case binary_log::arg_type::uint32:
+        ok = read_arg<unsigned, uint32_t>(r, store);
+        break;
+      case binary_log::arg_type::int64:
+        ok = read_arg<long long, int64_t>(r, store);
+        break;
+      case binary_log::arg_type::uint64:
+        ok = read_arg<unsigned long long, uint64_t>(r, store);
+        break;
+      case binary_log::arg_type::boolean:
+        ok = read_arg<bool, uint8_t>(r, store);
+        break;
+      case binary_log::arg_type::character:
+        ok = read_arg<char, char>(r, store);
+        break;
+      case binary_log::arg_type::floating:
+        ok = read_arg<double, double>(r, store);
+        break;
+      case binary_log::arg_type::string: {
+        uint32_t       len;
+        const uint8_t* bytes;
+        ok = r.read(len) && r.read_bytes(len, bytes);
+        if (ok) {
+          store.push_back(std::string(reinterpret_cast<const char*>(bytes), len));
+        }
+        break;
+      }
+      case binary_log::arg_type::pointer: {
+        uint64_t v;
+        ok = r.read(v);
+        if (ok) {
+          store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(v)));
+        }
+        break;
+      }
+      default:
+        return fmt::format("Unknown argument type {}", type);
+    }
+    if (!ok) {
+      return "Truncated entry argument";
+    }
+  }
+
+  uint32_t       hex_len;
+  const uint8_t* hex;
+  if (!r.read(hex_len) || !r.read_bytes(hex_len, hex)) {
+    return "Truncated entry hex dump";
+  }
+
+  detail::log_entry_metadata metadata;
+  metadata.tp        = std::chrono::high_resolution_clock::time_point(
+      std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::nanoseconds(ns)));
+  metadata.context   = {ctx_value, (flags & binary_log::flag_context_enabled) != 0};
+  metadata.fmtstring = fmtstring ? fmtstring->c_str() : nullptr;
+  metadata.store     = (flags & binary_log::flag_has_args) ? &store : nullptr;
+  metadata.log_name  = log_name ? *log_name : std::string();
+  metadata.log_tag   = tag;
+  metadata.hex_dump.assign(hex, hex + hex_len);
+
+  formatter->format(std::move(metadata), out);
+
+  return {};
+}
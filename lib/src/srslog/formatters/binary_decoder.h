@@ -0,0 +1,65 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_DECODER_H
+#define SRSLOG_BINARY_DECODER_H
+
+#include "srsran/srslog/detail/support/error_string.h"
+#include "srsran/srslog/formatter.h"
+
+namespace srslog {
+
+/// Decodes the records written by the binary formatter and renders them with
+/// the provided formatter. Records that were already stored as text are copied
+/// verbatim, or wrapped into a JSON object with an escaped "text" field when
+/// json_text is set.
+class binary_decoder
+{
+public:
+  explicit binary_decoder(std::unique_ptr<log_formatter> f, bool json_text = false) :
+    formatter(std::move(f)), json_text(json_text)
+  {
+    assert(formatter && "Invalid formatter");
+  }
+
+  /// Decodes the contents of a binary log file, appending the rendered entries
+  /// into the output buffer. Decoding stops at the first unused byte, which is
+  /// what remains at the end of a file that was not closed cleanly.
+  detail::error_string decode(const uint8_t* data, size_t size, fmt::memory_buffer& out);
+
+private:
+  /// Decodes a single log entry record.
+  detail::error_string decode_entry(const uint8_t* data, size_t size, fmt::memory_buffer& out);
+
+  /// Returns the string associated to the specified id or nullptr if not found.
+  const std::string* find_string(uint32_t id) const;
+
+private:
+  std::unique_ptr<log_formatter> formatter;
+  const bool                     json_text;
+  /// Known strings, where the id of each string is its index plus one.
+  std::vector<std::string> strings;
+  std::vector<bool>        is_defined;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_DECODER_H
@@ -0,0 +1,260 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_formatter.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include <cstring>
+
+using namespace srslog;
+
+/// Appends the raw bytes of a value into the buffer.
+template <typename T>
+static void append_value(T value, fmt::memory_buffer& buffer)
+{
+  const char* p = reinterpret_cast<const char*>(&value);
+  buffer.append(p, p + sizeof(T));
+}
+
+/// Appends a string prefixed with its length into the buffer.
+static void append_string(fmt::string_view str, fmt::memory_buffer& buffer)
+{
+  append_value(static_cast<uint32_t>(str.size()), buffer);
+  buffer.append(str.data(), str.data() + str.size());
+}
+
+/// Writes the header of a record with a payload that will be filled later.
+/// Returns the position of the header in the buffer.
+static size_t begin_record(binary_log::record_type type, fmt::memory_buffer& buffer)
+{
+  size_t pos = buffer.size();
+  append_value(static_cast<uint8_t>(type), buffer);
+  append_value(uint32_t(0), buffer);
+  return pos;
+}
+
+/// Fills in the payload length of the record that starts at the specified position.
+static void end_record(size_t pos, fmt::memory_buffer& buffer)
+{
+  uint32_t len = buffer.size() - pos - binary_log::record_header_size;
+  std::memcpy(buffer.data() + pos + sizeof(uint8_t), &len, sizeof(len));
+}
+
+void binary_log::format_file_header(fmt::memory_buffer& buffer)
+{
+  buffer.append(std::begin(magic), std::end(magic));
+  append_value(version, buffer);
+}
+
+namespace {
+
+/// Visitor that encodes the value of a format argument. Returns false for the
+/// argument types that can not be encoded.
+class arg_encoder
+{
+public:
+  explicit arg_encoder(fmt::memory_buffer& buffer) : buffer(buffer) {}
+
+  bool operator()(int v) { return encode(binary_log::arg_type::int32, v); }
+  bool operator()(unsigned v) { return encode(binary_log::arg_type::uint32, v); }
+  bool operator()(long long v) { return encode(binary_log::arg_type::int64, static_cast<int64_t>(v)); }
+  bool operator()(unsigned long long v) { return encode(binary_log::arg_type::uint64, static_cast<uint64_t>(v)); }
+  bool operator()(bool v) { return encode(binary_log::arg_type::boolean, static_cast<uint8_t>(v)); }
+  bool operator()(char v) { return encode(binary_log::arg_type::character, v); }
+  bool operator()(float v) { return encode(binary_log::arg_type::floating, static_cast<double>(v)); }
+  bool operator()(double v) { return encode(binary_log::arg_type::floating, v); }
+  bool operator()(long double v) { return encode(binary_log::arg_type::floating, static_cast<double>(v)); }
+  bool operator()(const char* v) { return (v) ? (*this)(fmt::string_view(v)) : false; }
+  bool operator()(fmt::string_view v)
+  {
+    append_value(static_cast<uint8_t>(binary_log::arg_type::string), buffer);
+    append_string(v, buffer);
+    return true;
+  }
+  bool operator()(const void* v)
+  {
+    return encode(binary_log::arg_type::pointer, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(v)));
+  }
+
+  /// Custom types, 128 bit integers and empty arguments.
+  template <typename T>
+  bool operator()(T)
+  {
+    return false;
+  }
+
+private:
+  template <typename T>
+  bool encode(binary_log::arg_type type, T value)
+  {
+    append_value(static_cast<uint8_t>(type), buffer);
+    append_value(value, buffer);
+    return true;
+  }
+
+  fmt::memory_buffer& buffer;
+};
+
+} // namespace
+
+std::unique_ptr<log_formatter> binary_formatter::clone() const
+{
+  return std::unique_ptr<log_formatter>(new binary_formatter(*this));
+}
+
+uint32_t binary_formatter::add_string(fmt::string_view str, fmt::memory_buffer& buffer)
+{
+  strings.emplace_back(str.data(), str.size());
+  uint32_t id = strings.size();
+
+  size_t pos = begin_record(binary_log::record_type::string_def, buffer);
+  append_value(id, buffer);
+  buffer.append(str.data(), str.data() + str.size());
+  end_record(pos, buffer);
+
+  return id;
+}
+
+uint32_t binary_formatter::get_fmtstring_id(const char* str, fmt::memory_buffer& buffer)
+{
+  if (!str) {
+    return 0;
+  }
+
+  // Check the contents too, in case the address belongs to a string that is not a literal.
+  auto it = fmtstring_ids.find(str);
+  if (it != fmtstring_ids.end() && strings[it->second - 1] == str) {
+    return it->second;
+  }
+
+  uint32_t id       = add_string(str, buffer);
+  fmtstring_ids[str] = id;
+  return id;
+}
+
+uint32_t binary_formatter::get_name_id(const std::string& name, fmt::memory_buffer& buffer)
+{
+  if (name.empty()) {
+    return 0;
+  }
+
+  auto it = name_ids.find(name);
+  if (it != name_ids.end()) {
+    return it->second;
+  }
+
+  uint32_t id = add_string(name, buffer);
+  name_ids.emplace(name, id);
+  return id;
+}
+
+void binary_formatter::format_string_table(fmt::memory_buffer& buffer) const
+{
+  for (uint32_t i = 0, e = strings.size(); i != e; ++i) {
+    size_t pos = begin_record(binary_log::record_type::string_def, buffer);
+    append_value(i + 1, buffer);
+    buffer.append(strings[i].data(), strings[i].data() + strings[i].size());
+    end_record(pos, buffer);
+  }
+}
+
+bool binary_formatter::format_entry(const detail::log_entry_metadata& metadata, fmt::memory_buffer& buffer)
+{
+  uint32_t fmt_id  = get_fmtstring_id(metadata.fmtstring, buffer);
+  uint32_t name_id = get_name_id(metadata.log_name, buffer);
+
+  fmt::basic_format_args<fmt::printf_context> args;
+  unsigned                                    nof_args = 0;
+  if (metadata.store) {
+    args = fmt::basic_format_args<fmt::printf_context>(*metadata.store);
+    while (nof_args != UINT8_MAX && args.get(nof_args)) {
+      ++nof_args;
+    }
+    if (nof_args == UINT8_MAX) {
+      return false;
+    }
+  }
+
+  size_t pos = begin_record(binary_log::record_type::entry, buffer);
+  append_value(static_cast<int64_t>(
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(metadata.tp.time_since_epoch()).count()),
+               buffer);
+  append_value(fmt_id, buffer);
+  append_value(name_id, buffer);
+  append_value(metadata.log_tag, buffer);
+  uint8_t flags = (metadata.context.enabled ? binary_log::flag_context_enabled : 0) |
+                  (metadata.store ? binary_log::flag_has_args : 0);
+  append_value(flags, buffer);
+  append_value(metadata.context.value, buffer);
+
+  append_value(static_cast<uint8_t>(nof_args), buffer);
+  arg_encoder encoder(buffer);
+  for (unsigned i = 0; i != nof_args; ++i) {
+    if (!fmt::visit_format_arg(encoder, args.get(i))) {
+      return false;
+    }
+  }
+
+  append_string(fmt::string_view(reinterpret_cast<const char*>(metadata.hex_dump.data()), metadata.hex_dump.size()),
+                buffer);
+  end_record(pos, buffer);
+
+  return true;
+}
+
+void binary_formatter::format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer)
+{
+  size_t start = buffer.size();
+  if (format_entry(metadata, buffer)) {
+    return;
+  }
+
+  // Fall back to text for the entries that can not be encoded. Keep the string
+  // definitions that may have been written.
+  size_t text_start = start;
+  while (text_start < buffer.size() &&
+         static_cast<binary_log::record_type>(buffer[text_start]) == binary_log::record_type::string_def) {
+    uint32_t len;
+    std::memcpy(&len, buffer.data() + text_start + sizeof(uint8_t), sizeof(len));
+    text_start += binary_log::record_header_size + len;
+  }
+  buffer.resize(text_start);
+
+  size_t pos = begin_record(binary_log::record_type::text, buffer);
+  text_formatter::format(std::move(metadata), buffer);
+  end_record(pos, buffer);
+}
+
+void binary_formatter::format_context_begin(const detail::log_entry_metadata& md,
+                                            fmt::string_view                  ctx_name,
+                                            unsigned                          size,
+                                            fmt::memory_buffer&               buffer)
+{
+  ctx_record_start = begin_record(binary_log::record_type::text, buffer);
+  text_formatter::format_context_begin(md, ctx_name, size, buffer);
+}
+
+void binary_formatter::format_context_end(const detail::log_entry_metadata& md,
+                                          fmt::string_view                  ctx_name,
+                                          fmt::memory_buffer&               buffer)
+{
+  text_formatter::format_context_end(md, ctx_name, buffer);
+  end_record(ctx_record_start, buffer);
+}
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_FORMATTER_H
+#define SRSLOG_BINARY_FORMATTER_H
+
+#include "text_formatter.h"
+#include <unordered_map>
+
+namespace srslog {
+
+/// Definitions of the binary log format.
+/// A binary log file starts with the magic string and the format version, and
+/// is followed by a sequence of records. Each record starts with its type
+/// (1 byte) and the length of its payload (4 bytes). All the integers are
+/// stored in the native byte order.
+namespace binary_log {
+
+/// Magic string that identifies a binary log file.
+constexpr char     magic[8] = {'S', 'R', 'S', 'L', 'O', 'G', 'B', 'N'};
+constexpr uint32_t version  = 1;
+
+/// Size of the header of each record.
+constexpr size_t record_header_size = sizeof(uint8_t) + sizeof(uint32_t);
+
+enum class record_type : uint8_t {
+  /// Associates an identifier to a string (format string or log name).
+  /// Payload: id (u32), string bytes.
+  string_def = 1,
+  /// Log entry with its raw arguments.
+  /// Payload: timestamp in ns (i64), format string id (u32), log name id (u32),
+  /// tag (char), flags (u8), context value (u32), number of args (u8), args,
+  /// hex dump length (u32), hex dump bytes.
+  entry = 2,
+  /// Entry that could not be encoded in binary form, stored as formatted text.
+  /// Payload: text bytes.
+  text = 3
+};
+
+/// Type of each argument of a log entry, followed by its value.
+enum class arg_type : uint8_t {
+  int32 = 1,  ///< i32
+  uint32,     ///< u32
+  int64,      ///< i64
+  uint64,     ///< u64
+  boolean,    ///< u8
+  character,  ///< char
+  floating,   ///< double
+  string,     ///< length (u32), bytes
+  pointer     ///< u64
+};
+
+/// Flags of a log entry record.
+constexpr uint8_t flag_context_enabled = 1u << 0;
+constexpr uint8_t flag_has_args        = 1u << 1;
+
+/// Writes the header of a binary log file into the buffer.
+void format_file_header(fmt::memory_buffer& buffer);
+
+} // namespace binary_log
+
+/// Binary formatter implementation class.
+/// Instead of formatting the log message, the formatter stores the format
+/// string id and the raw value of each argument, which is much cheaper and
+/// more compact. The strings are written only the first time they are used.
+/// The resulting records are rendered later with the srslog_decode tool.
+/// Contexts are stored as formatted text.
+class binary_formatter : public text_formatter
+{
+public:
+  std::unique_ptr<log_formatter> clone() const override;
+
+  void format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) override;
+
+  /// Writes the definition of all the strings known by the formatter into the
+  /// buffer, so that a new file can be decoded independently of the previous
+  /// ones.
+  void format_string_table(fmt::memory_buffer& buffer) const;
+
+private:
+  void format_context_begin(const detail::log_entry_metadata& md,
+                            fmt::string_view                  ctx_name,
+                            unsigned                          size,
+                            fmt::memory_buffer&               buffer) override;
+
+  void format_context_end(const detail::log_entry_metadata& md,
+                          fmt::string_view                  ctx_name,
+                          fmt::memory_buffer&               buffer) override;
+
+  /// Encodes the log entry in binary form. Returns false if any of its
+  /// arguments cannot be encoded.
+  bool format_entry(const detail::log_entry_metadata& metadata, fmt::memory_buffer& buffer);
+
+  /// Returns the id of the specified format string, writing its definition
+  /// into the buffer when it is used for the first time.
+  uint32_t get_fmtstring_id(const char* str, fmt::memory_buffer& buffer);
+
+  /// Returns the id of the specified log name, writing its definition into the
+  /// buffer when it is used for the first time.
+  uint32_t get_name_id(const std::string& name, fmt::memory_buffer& buffer);
+
+  /// Registers a new string, writing its definition into the buffer.
+  uint32_t add_string(fmt::string_view str, fmt::memory_buffer& buffer);
+
+private:
+  /// Known strings, where the id of each string is its index plus one.
+  std::vector<std::string> strings;
+  /// Format strings are usually string literals, so they are indexed by address.
+  std::unordered_map<const char*, uint32_t> fmtstring_ids;
+  std::unordered_map<std::string, uint32_t> name_ids;
+  /// Start of the text record of the context being formatted.
+  size_t ctx_record_start = 0;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_FORMATTER_H
@@ -50,7 +50,19 @@ public:
     return true;
   }
 
-  fmt::dynamic_format_arg_store<fmt::printf_context>* alloc_arg_store() override { return arg_pool.alloc(); }
+  fmt::dynamic_format_arg_store<fmt::printf_context>* alloc_arg_store() override
+  {
+    auto* store = arg_pool.alloc();
+    if (!store) {
+      nof_alloc_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    return store;
+  }
+
+  uint64_t get_nof_dropped_entries() const override
+  {
+    return queue.get_nof_dropped() + nof_alloc_failures.load(std::memory_order_relaxed);
+  }
 
   bool is_running() const override { return worker.is_running(); }
 
@@ -61,9 +73,10 @@ public:
   void stop() { worker.stop(); }
 
 private:
-  detail::work_queue<detail::log_entry> queue;
-  detail::dyn_arg_store_pool            arg_pool;
-  backend_worker                        worker{queue, arg_pool};
+  log_entry_queue            queue;
+  detail::dyn_arg_store_pool arg_pool;
+  std::atomic<uint64_t>      nof_alloc_failures{0};
+  backend_worker             worker{queue, arg_pool};
 };
 
 } // namespace srslog
@@ -0,0 +1,256 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_FILE_SINK_H
+#define SRSLOG_BINARY_FILE_SINK_H
+
+#include "../formatters/binary_formatter.h"
+#include "file_utils.h"
+#include "srsran/srslog/sink.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace srslog {
+
+namespace file_utils {
+
+/// This class writes into a file through a memory mapped window that slides
+/// along the file as it grows, avoiding a system call per write. The file is
+/// truncated to the written size when closed. Disables itself when it
+/// encounters an error.
+class mmap_file
+{
+  /// Size of the mapped window, must be a multiple of the page size.
+  static constexpr size_t window_size = 4 * 1024 * 1024;
+
+  std::string path;
+  int         fd          = -1;
+  char*       window      = nullptr;
+  size_t      window_pos  = 0;
+  size_t      window_used = 0;
+
+public:
+  ~mmap_file() { close(); }
+
+  explicit operator bool() const { return fd != -1; }
+
+  /// Returns the path of the file.
+  const std::string& get_path() const { return path; }
+
+  /// Creates a new file in the specified path by previously closing any opened
+  /// file.
+  detail::error_string create(const std::string& new_path)
+  {
+    close();
+
+    fd = ::open(new_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+      return format_error(fmt::format("Unable to create log file \"{}\"", new_path), errno);
+    }
+    path = new_path;
+
+    return map_window(0);
+  }
+
+  /// Writes the provided memory buffer into an open file, otherwise does
+  /// nothing.
+  detail::error_string write(detail::memory_buffer buffer)
+  {
+    const char* data = buffer.data();
+    size_t      size = buffer.size();
+
+    while (fd != -1 && size) {
+      if (window_used == window_size) {
+        if (auto err_str = map_window(window_pos + window_size)) {
+          return err_str;
+        }
+      }
+      size_t n = std::min(size, window_size - window_used);
+      std::memcpy(window + window_used, data, n);
+      window_used += n;
+      data += n;
+      size -= n;
+    }
+
+    return {};
+  }
+
+  /// Schedules the write back of the mapped window, otherwise does nothing.
+  detail::error_string flush()
+  {
+    if (window && ::msync(window, window_used, MS_ASYNC) == -1) {
+      auto err_str = format_error(fmt::format("Error encountered while flushing log file \"{}\"", path), errno);
+      close();
+      return err_str;
+    }
+
+    return {};
+  }
+
+  /// Closes an open file, otherwise does nothing.
+  void close()
+  {
+    if (fd == -1) {
+      return;
+    }
+
+    size_t file_size = window_pos + window_used;
+    unmap_window();
+    // Drop the unused tail of the last window.
+    if (::ftruncate(fd, file_size) == -1) {
+      fmt::print(stderr, "srsLog error - Unable to truncate log file \"{}\"\n", path);
+    }
+    ::close(fd);
+    fd = -1;
+    path.clear();
+  }
+
+private:
+  /// Maps the window that starts at the specified file offset, growing the
+  /// file as needed. The disk blocks of the window are reserved before mapping
+  /// it, so that a full disk is reported here instead of raising SIGBUS when
+  /// writing into the window.
+  detail::error_string map_window(size_t offset)
+  {
+    unmap_window();
+
+    if (int err = ::posix_fallocate(fd, offset, window_size)) {
+      auto err_str = format_error(fmt::format("Unable to grow log file \"{}\"", path), err);
+      close();
+      return err_str;
+    }
+
+    void* p = ::mmap(nullptr, window_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+    if (p == MAP_FAILED) {
+      auto err_str = format_error(fmt::format("Unable to map log file \"{}\"", path), errno);
+      close();
+      return err_str;
+    }
+
+    window      = static_cast<char*>(p);
+    window_pos  = offset;
+    window_used = 0;
+    return {};
+  }
+
+  void unmap_window()
+  {
+    if (window) {
+      ::munmap(window, window_size);
+      window = nullptr;
+    }
+    window_pos += window_used;
+    window_used = 0;
+  }
+};
+
+} // namespace file_utils
+
+/// This sink implementation writes the records generated by a binary formatter
+/// into memory mapped files. Includes the optional feature of file rotation: a
+/// new file is created when file size exceeds an established threshold, and
+/// each new file starts with the table of known strings so that it can be
+/// decoded on its own.
+class binary_file_sink : public sink
+{
+public:
+  binary_file_sink(std::string name, size_t max_size) :
+    sink(std::unique_ptr<log_formatter>(new binary_formatter)),
+    max_size((max_size == 0) ? 0 : std::max<size_t>(max_size, 4 * 1024)),
+    base_filename(std::move(name))
+  {}
+
+  binary_file_sink(const binary_file_sink& other) = delete;
+  binary_file_sink& operator=(const binary_file_sink& other) = delete;
+
+  detail::error_string write(detail::memory_buffer buffer) override
+  {
+    // Create a new file the first time we hit this method.
+    if (is_first_write()) {
+      assert(!handler && "No handler should be created yet");
+      if (auto err_str = create_file()) {
+        return err_str;
+      }
+    }
+
+    // Do not bother doing any work when the file was closed on a previous
+    // error.
+    if (!handler) {
+      return {};
+    }
+
+    if (auto err_str = handle_rotation(buffer.size())) {
+      return err_str;
+    }
+
+    return handler.write(buffer);
+  }
+
+  detail::error_string flush() override { return handler.flush(); }
+
+private:
+  /// Returns true when the sink has never written data to a file, otherwise
+  /// returns false.
+  bool is_first_write() const { return file_index == 0; }
+
+  /// Creates a new file, increments the file index counter and writes the file
+  /// preamble.
+  detail::error_string create_file()
+  {
+    if (auto err_str = handler.create(file_utils::build_filename_with_index(base_filename, file_index++))) {
+      return err_str;
+    }
+
+    fmt::memory_buffer preamble;
+    binary_log::format_file_header(preamble);
+    static_cast<const binary_formatter&>(get_formatter()).format_string_table(preamble);
+    current_size = preamble.size();
+
+    return handler.write(detail::memory_buffer(preamble.data(), preamble.size()));
+  }
+
+  /// Handles the file rotation feature when it is activated.
+  /// NOTE: The file handler must be valid.
+  detail::error_string handle_rotation(size_t size)
+  {
+    assert(handler && "Expected a valid file handle");
+    current_size += size;
+    if (max_size && current_size >= max_size) {
+      auto err_str = create_file();
+      current_size += size;
+      return err_str;
+    }
+    return {};
+  }
+
+private:
+  const size_t          max_size;
+  const std::string     base_filename;
+  file_utils::mmap_file handler;
+  size_t                current_size = 0;
+  uint32_t              file_index   = 0;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_FILE_SINK_H
@@ -21,6 +21,7 @@
 
 #include "srsran/srslog/srslog.h"
 #include "formatters/json_formatter.h"
+#include "sinks/binary_file_sink.h"
 #include "sinks/file_sink.h"
 #include "sinks/syslog_sink.h"
 #include "srslog_instance.h"
@@ -178,6 +179,22 @@ sink& srslog::fetch_file_sink(const std::string&             path,
   return *s;
 }
 
+sink& srslog::fetch_binary_file_sink(const std::string& path, size_t max_size)
+{
+  assert(!path.empty() && "Empty path string");
+
+  if (auto* s = find_sink(path)) {
+    return *s;
+  }
+
+  //: TODO: GCC5 or lower versions emits an error if we use the new() expression
+  // directly, use redundant piecewise_construct instead.
+  auto& s = srslog_instance::get().get_sink_repo().emplace(
+      std::piecewise_construct, std::forward_as_tuple(path), std::forward_as_tuple(new binary_file_sink(path, max_size)));
+
+  return *s;
+}
+
 sink& srslog::fetch_syslog_sink(const std::string&             preamble_,
                                 syslog_local_type              log_local_,
                                 std::unique_ptr<log_formatter> f)
@@ -238,6 +255,8 @@ void srslog::flush()
   }
 
   detail::log_entry cmd;
+  // The timestamp orders the command after the entries already generated by other threads.
+  cmd.metadata.tp    = std::chrono::high_resolution_clock::now();
   cmd.metadata.store = nullptr;
   cmd.flush_cmd =
       std::unique_ptr<detail::flush_backend_cmd>(new detail::flush_backend_cmd{completion_flag, std::move(sinks)});
@@ -253,6 +272,11 @@ void srslog::flush()
   }
 }
 
+uint64_t srslog::get_nof_dropped_entries()
+{
+  return srslog_instance::get().get_backend().get_nof_dropped_entries();
+}
+
 void srslog::set_error_handler(error_handler handler)
 {
   srslog_instance::get().set_error_handler(std::move(handler));
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/// Offline tool that renders the files written by the srslog binary sink as
+/// plain text or JSON.
+
+#include "../formatters/binary_decoder.h"
+#include "../formatters/json_formatter.h"
+#include "../formatters/text_formatter.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace srslog;
+
+static void usage(const char* prog)
+{
+  fmt::print(stderr, "Usage: {} [-j|--json] file...\n", prog);
+  fmt::print(stderr, "\t-j, --json Render the entries as JSON instead of plain text\n");
+}
+
+/// Decodes the specified file and writes the result into stdout.
+static bool decode_file(const char* path, bool json)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    fmt::print(stderr, "Unable to open file \"{}\"\n", path);
+    return false;
+  }
+  std::vector<uint8_t> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+  binary_decoder decoder(json ? std::unique_ptr<log_formatter>(new json_formatter)
+                              : std::unique_ptr<log_formatter>(new text_formatter),
+                         json);
+  fmt::memory_buffer out;
+  auto               err_str = decoder.decode(data.data(), data.size(), out);
+  std::fwrite(out.data(), sizeof(char), out.size(), stdout);
+
+  if (err_str) {
+    fmt::print(stderr, "Error decoding file \"{}\": {}\n", path, err_str.get_error());
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  bool                     json = false;
+  std::vector<const char*> files;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-j") || !std::strcmp(argv[i], "--json")) {
+      json = true;
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+      return -1;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+
+  if (files.empty()) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  bool ok = true;
+  for (const auto* path : files) {
+    ok &= decode_file(path, json);
+  }
+
+  return ok ? 0 : 1;
+}
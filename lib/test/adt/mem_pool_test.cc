@@ -122,6 +122,13 @@ void test_fixedsize_pool()
     TESTASSERT(obj != nullptr);
     obj.reset();
     fixed_pool->print_all_buffers();
+
+    srsran::fixed_memory_pool_metrics_t metrics = fixed_pool->get_metrics();
+    TESTASSERT(metrics.nof_blocks == pool_size);
+    TESTASSERT(metrics.nof_workers == 1);
+    TESTASSERT(metrics.nof_allocs == pool_size + 2);
+    TESTASSERT(metrics.nof_failed_allocs == 1);
+    TESTASSERT(metrics.nof_central_refills > 0 and metrics.nof_central_returns > 0);
   }
   fixed_pool->print_all_buffers();
   TESTASSERT(C::default_ctor_counter == C::dtor_counter);
@@ -147,6 +154,8 @@ void test_fixedsize_pool()
     fixed_pool->print_all_buffers();
     t.join();
   }
+  // blocks cached by the exited thread were returned to the central cache
+  TESTASSERT(fixed_pool->get_metrics().nof_workers == 1);
   fixed_pool->print_all_buffers();
   TESTASSERT(C::default_ctor_counter == C::dtor_counter);
 }
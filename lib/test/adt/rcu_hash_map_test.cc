@@ -0,0 +1,202 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/adt/rcu_hash_map.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+
+namespace srsran {
+
+struct tracked_value {
+  static int count;
+
+  uint32_t key   = 0;
+  uint32_t check = 0;
+
+  tracked_value(uint32_t key_ = 0, uint32_t check_ = 0) : key(key_), check(check_) { count++; }
+  tracked_value(const tracked_value& other) : key(other.key), check(other.check) { count++; }
+  ~tracked_value() { count--; }
+};
+int tracked_value::count = 0;
+
+/// 172.16.0.0/16 addresses in network byte order, which only differ in their upper bits
+static uint32_t ue_ip(uint32_t i)
+{
+  return __builtin_bswap32(0xac100000 + i);
+}
+
+void test_rcu_hash_map_basic()
+{
+  {
+    rcu_domain                            rcu(1);
+    rcu_hash_map<uint32_t, tracked_value> map(rcu, 8);
+    TESTASSERT(map.empty() and map.capacity() == 8);
+    TESTASSERT(map.find(5) == nullptr);
+
+    map.insert_or_assign(5, tracked_value{5, 50});
+    TESTASSERT_EQ(1, map.size());
+    TESTASSERT(map.find(5) != nullptr and map.find(5)->check == 50);
+
+    // Replace value. Without readers online, the old node is reclaimed right away
+    map.insert_or_assign(5, tracked_value{5, 51});
+    TESTASSERT_EQ(1, map.size());
+    TESTASSERT_EQ(51, map.find(5)->check);
+    TESTASSERT_EQ(0, rcu.nof_pending_reclaims());
+
+    TESTASSERT(not map.erase(6));
+    TESTASSERT(map.erase(5));
+    TESTASSERT(map.find(5) == nullptr and map.empty());
+    TESTASSERT(not map.erase(5));
+
+    // Grow well past the initial capacity
+    for (uint32_t i = 0; i < 1000; ++i) {
+      map.insert_or_assign(ue_ip(i), tracked_value{i, i * 3});
+    }
+    TESTASSERT_EQ(1000, map.size());
+    TESTASSERT(map.capacity() >= 2000);
+    for (uint32_t i = 0; i < 1000; ++i) {
+      const tracked_value* v = map.find(ue_ip(i));
+      TESTASSERT(v != nullptr and v->key == i and v->check == i * 3);
+    }
+
+    // Erase and re-insert half of the entries, so that tombstones are reused and dropped on rehash
+    for (uint32_t round = 0; round < 10; ++round) {
+      for (uint32_t i = 0; i < 1000; i += 2) {
+        TESTASSERT(map.erase(ue_ip(i)));
+      }
+      TESTASSERT_EQ(500, map.size());
+      for (uint32_t i = 0; i < 1000; i += 2) {
+        TESTASSERT(map.find(ue_ip(i)) == nullptr);
+        map.insert_or_assign(ue_ip(i), tracked_value{i, i * 3 + round});
+      }
+      TESTASSERT_EQ(1000, map.size());
+    }
+    for (uint32_t i = 0; i < 1000; ++i) {
+      const tracked_value* v = map.find(ue_ip(i));
+      TESTASSERT(v != nullptr and v->check == i * 3 + (i % 2 == 0 ? 9 : 0));
+    }
+    TESTASSERT_EQ(0, rcu.nof_pending_reclaims());
+    TESTASSERT_EQ(1000, tracked_value::count);
+  }
+  TESTASSERT_EQ(0, tracked_value::count);
+}
+
+void test_rcu_grace_period()
+{
+  {
+    rcu_domain                            rcu(2);
+    rcu_hash_map<uint32_t, tracked_value> map(rcu);
+    map.insert_or_assign(1, tracked_value{1, 10});
+
+    // Reader 0 keeps a reference across the writer update
+    rcu.online(0);
+    const tracked_value* v = map.find(1);
+    TESTASSERT(v != nullptr and v->check == 10);
+
+    map.insert_or_assign(1, tracked_value{1, 11});
+    TESTASSERT_EQ(1, rcu.nof_pending_reclaims());
+    TESTASSERT_EQ(10, v->check);
+    TESTASSERT_EQ(11, map.find(1)->check);
+
+    // Reader 1 coming online after the update does not delay the reclamation
+    rcu.online(1);
+    rcu.offline(0);
+    rcu.reclaim();
+    TESTASSERT_EQ(0, rcu.nof_pending_reclaims());
+    TESTASSERT_EQ(1, tracked_value::count);
+
+    TESTASSERT(map.erase(1));
+    TESTASSERT_EQ(1, rcu.nof_pending_reclaims());
+    rcu.offline(1);
+    rcu.reclaim();
+    TESTASSERT_EQ(0, tracked_value::count);
+
+    // Objects still pending are released with the domain
+    rcu.online(0);
+    map.insert_or_assign(2, tracked_value{2, 20});
+    map.insert_or_assign(2, tracked_value{2, 21});
+    TESTASSERT_EQ(1, rcu.nof_pending_reclaims());
+  }
+  TESTASSERT_EQ(0, tracked_value::count);
+}
+
+void test_rcu_concurrent_readers()
+{
+  const uint32_t nof_readers = 3, nof_keys = 512, nof_updates = 200000;
+
+  rcu_domain                            rcu(nof_readers);
+  rcu_hash_map<uint32_t, tracked_value> map(rcu, 16);
+  std::atomic<bool>                     stop{false};
+  std::atomic<uint32_t>                 nof_errors{0};
+
+  std::vector<std::thread> readers;
+  for (uint32_t r = 0; r < nof_readers; ++r) {
+    readers.emplace_back([&, r]() {
+      uint32_t key = r;
+      while (not stop.load(std::memory_order_relaxed)) {
+        rcu.online(r);
+        for (uint32_t i = 0; i < 64; ++i) {
+          key                    = (key * 7 + 1) % nof_keys;
+          const tracked_value* v = map.find(key);
+          if (v != nullptr and (v->key != key or v->check != key * 1000 + v->check % 1000)) {
+            nof_errors++;
+          }
+        }
+        rcu.offline(r);
+      }
+    });
+  }
+
+  for (uint32_t i = 0; i < nof_updates; ++i) {
+    uint32_t key = (i * 13) % nof_keys;
+    if (i % 3 == 2) {
+      map.erase(key);
+    } else {
+      map.insert_or_assign(key, tracked_value{key, key * 1000 + i % 1000});
+    }
+  }
+  stop = true;
+  for (std::thread& t : readers) {
+    t.join();
+  }
+  rcu.reclaim();
+
+  TESTASSERT_EQ(0, nof_errors.load());
+  TESTASSERT_EQ(0, rcu.nof_pending_reclaims());
+  TESTASSERT_EQ((int)map.size(), tracked_value::count);
+}
+
+} // namespace srsran
+
+int main(int argc, char** argv)
+{
+  auto& test_log = srslog::fetch_basic_logger("TEST");
+  test_log.set_level(srslog::basic_levels::info);
+
+  srsran::test_init(argc, argv);
+
+  srsran::test_rcu_hash_map_basic();
+  srsran::test_rcu_grace_period();
+  srsran::test_rcu_concurrent_readers();
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/byte_buffer_chain.h"
+#include "srsran/common/byte_buffer_slice.h"
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/test_common.h"
+#include <numeric>
+
+using namespace srsran;
+
+int test_small_buffer()
+{
+  byte_buffer_t buf;
+  buf.N_bytes = 40;
+  std::iota(buf.msg, buf.msg + buf.N_bytes, 0);
+  buf.md.pdcp_sn = 5;
+
+  byte_buffer_chain chain = make_byte_buffer_chain(buf);
+  TESTASSERT(chain.has_value());
+  TESTASSERT(chain.length() == buf.N_bytes);
+  TESTASSERT(chain.nof_segments() == 1);
+  TESTASSERT(chain.get_headroom() == byte_buffer_chain_headroom);
+  TESTASSERT(chain.md.pdcp_sn == 5);
+
+  // prepend header using the headroom
+  uint8_t hdr[2] = {0xaa, 0xbb};
+  TESTASSERT(chain.prepend(hdr, sizeof(hdr)));
+  TESTASSERT(chain.length() == buf.N_bytes + sizeof(hdr));
+  std::vector<uint8_t> hroom(byte_buffer_chain_headroom);
+  TESTASSERT(not chain.prepend(hroom.data(), hroom.size()));
+
+  unique_byte_buffer_t lin = make_byte_buffer(chain);
+  TESTASSERT(lin != nullptr);
+  TESTASSERT(lin->N_bytes == chain.length());
+  TESTASSERT(lin->msg[0] == 0xaa and lin->msg[1] == 0xbb);
+  TESTASSERT(memcmp(lin->msg + 2, buf.msg, buf.N_bytes) == 0);
+
+  chain.trim_head(sizeof(hdr));
+  TESTASSERT(chain.length() == buf.N_bytes);
+  return SRSRAN_SUCCESS;
+}
+
+int test_chained_buffer()
+{
+  std::vector<uint8_t> payload(9000);
+  std::iota(payload.begin(), payload.end(), 0);
+
+  byte_buffer_chain chain;
+  TESTASSERT(not chain.has_value());
+  TESTASSERT(chain.append(payload.data(), 100));
+  TESTASSERT(chain.append(payload.data() + 100, payload.size() - 100));
+  TESTASSERT(chain.length() == payload.size());
+  TESTASSERT(chain.nof_segments() > 1);
+
+  uint32_t total = 0;
+  chain.for_each_segment([&payload, &total](const_byte_span seg) {
+    TESTASSERT(memcmp(seg.data(), payload.data() + total, seg.size()) == 0);
+    total += seg.size();
+  });
+  TESTASSERT(total == payload.size());
+
+  // remove the first segments
+  chain.trim_head(3000);
+  TESTASSERT(chain.length() == payload.size() - 3000);
+  std::vector<uint8_t> out(chain.length());
+  TESTASSERT(chain.copy_to(out.data(), out.size()) == out.size());
+  TESTASSERT(std::equal(out.begin(), out.end(), payload.begin() + 3000));
+
+  // move ownership
+  byte_buffer_chain chain2 = std::move(chain);
+  TESTASSERT(not chain.has_value());
+  TESTASSERT(chain2.length() == out.size());
+  chain2.clear();
+  TESTASSERT(not chain2.has_value() and chain2.empty());
+  return SRSRAN_SUCCESS;
+}
+
+int test_byte_buffer_slices()
+{
+  shared_byte_buffer_t sdu1 = srsran::make_byte_buffer();
+  shared_byte_buffer_t sdu2 = srsran::make_byte_buffer();
+  TESTASSERT(sdu1 != nullptr and sdu2 != nullptr);
+  sdu1->N_bytes = 100;
+  sdu2->N_bytes = 50;
+  std::iota(sdu1->msg, sdu1->msg + sdu1->N_bytes, 0);
+  std::iota(sdu2->msg, sdu2->msg + sdu2->N_bytes, sdu1->N_bytes);
+
+  // Segment the tail of the first SDU and the head of the second one, as done by the RLC
+  byte_buffer_slice_chain pdu;
+  pdu.push_back(byte_buffer_slice{sdu1}.make_slice(60, 40));
+  pdu.push_back(byte_buffer_slice{sdu2, sdu2->msg, 30});
+  TESTASSERT(pdu.length() == 70);
+  TESTASSERT(pdu.nof_slices() == 2);
+  TESTASSERT(sdu1.use_count() == 2 and sdu2.use_count() == 2);
+
+  // Copies of a slice share the same reference count, stored in the byte buffer
+  {
+    byte_buffer_slice copy = pdu.begin()->make_slice(0, 10);
+    TESTASSERT(sdu1.use_count() == 3);
+  }
+  TESTASSERT(sdu1.use_count() == 2);
+
+  // The slices keep the SDUs alive after they are released by the segmentation
+  sdu1.reset();
+  sdu2->msg += 30;
+  sdu2->N_bytes -= 30;
+  sdu2.reset();
+
+  std::vector<uint8_t> out(pdu.length());
+  TESTASSERT(pdu.copy_to(out.data()) == pdu.length());
+  for (uint32_t i = 0; i < out.size(); ++i) {
+    TESTASSERT(out[i] == 60 + i);
+  }
+
+  // Partial copies, e.g. for retransmission of PDU segments, may span several slices
+  TESTASSERT(pdu.copy_to(out.data(), 35, 10) == 10);
+  for (uint32_t i = 0; i < 10; ++i) {
+    TESTASSERT(out[i] == 95 + i);
+  }
+  TESTASSERT(pdu.copy_to(out.data(), 65, 10) == 5);
+
+  pdu.clear();
+  TESTASSERT(pdu.empty() and pdu.length() == 0);
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(test_small_buffer() == SRSRAN_SUCCESS);
+  TESTASSERT(test_chained_buffer() == SRSRAN_SUCCESS);
+  TESTASSERT(test_byte_buffer_slices() == SRSRAN_SUCCESS);
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
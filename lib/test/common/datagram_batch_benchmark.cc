@@ -0,0 +1,222 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Checks the batched datagram I/O helpers over the loopback interface and measures the throughput of forwarding
+ * GTP-U sized datagrams with one sendto()/recvfrom() per packet versus sendmmsg()/recvmmsg() batches.
+ */
+
+#include "srsran/common/network_utils.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace srsran;
+
+struct bench_params {
+  uint32_t nof_pdus   = 200000;
+  uint32_t pdu_len    = 1400;
+  uint32_t batch_size = 32;
+};
+
+/// Opens a UDP socket bound to an ephemeral loopback port and returns its address in addr
+static int open_loopback_socket(sockaddr_in* addr)
+{
+  int fd = net_utils::open_socket(
+      net_utils::addr_family::ipv4, net_utils::socket_type::datagram, net_utils::protocol_type::UDP);
+  TESTASSERT(fd >= 0);
+  bool bound = net_utils::bind_addr(fd, "127.0.0.1", 0, addr);
+  TESTASSERT(bound);
+
+  // Make room for a few batches of in-flight datagrams
+  int rcvbuf = 4 * 1024 * 1024;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+  socklen_t addrlen = sizeof(*addr);
+  int       ret     = getsockname(fd, (sockaddr*)addr, &addrlen);
+  TESTASSERT_EQ(0, ret);
+  return fd;
+}
+
+static unique_byte_buffer_t make_pdu(uint32_t sn, uint32_t len)
+{
+  unique_byte_buffer_t pdu = make_byte_buffer();
+  TESTASSERT(pdu != nullptr);
+  for (uint32_t i = 0; i < len; i++) {
+    pdu->msg[i] = (sn + i) & 0xff;
+  }
+  pdu->N_bytes = len;
+  return pdu;
+}
+
+/// Sends datagrams of varying length in batches and checks they are received intact, in order and with the right source
+void test_datagram_batch()
+{
+  sockaddr_in tx_addr = {}, rx_addr = {};
+  int         tx_fd = open_loopback_socket(&tx_addr);
+  int         rx_fd = open_loopback_socket(&rx_addr);
+
+  net_utils::datagram_tx_batch tx(8);
+  net_utils::datagram_rx_batch rx(5);
+  TESTASSERT_EQ(8, tx.capacity());
+  TESTASSERT_EQ(5, rx.capacity());
+
+  // Nothing pending yet
+  int n = rx.recv(rx_fd);
+  TESTASSERT_EQ(0, n);
+
+  const uint32_t nof_pdus = 37;
+  uint32_t       sn       = 0;
+  while (sn < nof_pdus) {
+    while (not tx.full() and sn < nof_pdus) {
+      tx.push(make_pdu(sn, 1 + sn * 37), rx_addr);
+      sn++;
+    }
+    uint32_t nof_queued = tx.size();
+    uint32_t nof_sent   = tx.flush(tx_fd);
+    TESTASSERT_EQ(nof_queued, nof_sent);
+    TESTASSERT(tx.empty());
+  }
+
+  uint32_t rx_sn = 0;
+  while (rx_sn < nof_pdus) {
+    n = rx.recv(rx_fd);
+    TESTASSERT(n > 0 and n <= (int)rx.capacity());
+    TESTASSERT_EQ((uint32_t)n, rx.size());
+    for (int i = 0; i < n; ++i, ++rx_sn) {
+      byte_buffer_t* pdu = rx.get(i);
+      TESTASSERT_EQ(1 + rx_sn * 37, pdu->N_bytes);
+      for (uint32_t j = 0; j < pdu->N_bytes; j++) {
+        TESTASSERT_EQ((uint8_t)(rx_sn + j), pdu->msg[j]);
+      }
+      TESTASSERT_EQ(tx_addr.sin_port, rx.get_addr(i).sin_port);
+      TESTASSERT_EQ(tx_addr.sin_addr.s_addr, rx.get_addr(i).sin_addr.s_addr);
+    }
+    // Taking ownership of a received buffer must not affect the next batch
+    unique_byte_buffer_t owned = rx.release(0);
+    TESTASSERT(owned != nullptr);
+  }
+  n = rx.recv(rx_fd);
+  TESTASSERT_EQ(0, n);
+
+  close(tx_fd);
+  close(rx_fd);
+}
+
+template <typename Func>
+static void run_bench(const char* name, const bench_params& params, Func&& func)
+{
+  auto     tp_start = std::chrono::steady_clock::now();
+  uint32_t nof_pdus = func();
+  auto     tp_end   = std::chrono::steady_clock::now();
+
+  double total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_start).count();
+  printf("%-24s %u PDUs of %uB, %.2f Mbps, avg=%.1f nsec/PDU\n",
+         name,
+         nof_pdus,
+         params.pdu_len,
+         nof_pdus * params.pdu_len * 8 * 1000.0 / total_ns,
+         total_ns / nof_pdus);
+}
+
+/// Copies the payload into a new pool buffer, as done by the SPGW for every packet read from the SGi interface
+static unique_byte_buffer_t copy_pdu(const byte_buffer_t& payload)
+{
+  unique_byte_buffer_t pdu = make_byte_buffer();
+  TESTASSERT(pdu != nullptr);
+  memcpy(pdu->msg, payload.msg, payload.N_bytes);
+  pdu->N_bytes = payload.N_bytes;
+  return pdu;
+}
+
+/// Forwards PDUs from one loopback socket to another, one batch at a time so that the socket buffer never overflows
+void bench_loopback(const bench_params& params)
+{
+  sockaddr_in tx_addr = {}, rx_addr = {};
+  int         tx_fd   = open_loopback_socket(&tx_addr);
+  int         rx_fd   = open_loopback_socket(&rx_addr);
+
+  unique_byte_buffer_t payload = make_pdu(0, params.pdu_len);
+  unique_byte_buffer_t rx_pdu  = make_byte_buffer();
+
+  run_bench("sendto/recvfrom:", params, [&]() {
+    uint32_t count = 0;
+    for (; count + params.batch_size <= params.nof_pdus; count += params.batch_size) {
+      for (uint32_t i = 0; i < params.batch_size; i++) {
+        unique_byte_buffer_t pdu = copy_pdu(*payload);
+        ssize_t              n   = sendto(tx_fd, pdu->msg, pdu->N_bytes, 0, (sockaddr*)&rx_addr, sizeof(rx_addr));
+        TESTASSERT_EQ((ssize_t)params.pdu_len, n);
+      }
+      for (uint32_t i = 0; i < params.batch_size; i++) {
+        sockaddr_in src_addr = {};
+        socklen_t   addrlen  = sizeof(src_addr);
+        ssize_t     n = recvfrom(rx_fd, rx_pdu->msg, rx_pdu->get_tailroom(), 0, (sockaddr*)&src_addr, &addrlen);
+        TESTASSERT_EQ((ssize_t)params.pdu_len, n);
+      }
+    }
+    return count;
+  });
+
+  net_utils::datagram_tx_batch tx(params.batch_size);
+  net_utils::datagram_rx_batch rx(params.batch_size);
+  run_bench("sendmmsg/recvmmsg:", params, [&]() {
+    uint32_t count = 0;
+    for (; count + params.batch_size <= params.nof_pdus; count += params.batch_size) {
+      while (not tx.full()) {
+        tx.push(copy_pdu(*payload), rx_addr);
+      }
+      uint32_t nof_sent = tx.flush(tx_fd);
+      TESTASSERT_EQ(params.batch_size, nof_sent);
+      uint32_t nof_rx = 0;
+      while (nof_rx < params.batch_size) {
+        int n = rx.recv(rx_fd);
+        TESTASSERT(n >= 0);
+        nof_rx += n;
+      }
+    }
+    return count;
+  });
+
+  close(tx_fd);
+  close(rx_fd);
+}
+
+int main(int argc, char** argv)
+{
+  bench_params params;
+  if (argc > 1) {
+    params.nof_pdus = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    params.batch_size = std::max(std::strtoul(argv[2], nullptr, 10), 1ul);
+  }
+  if (argc > 3) {
+    params.pdu_len = std::strtoul(argv[3], nullptr, 10);
+  }
+
+  test_datagram_batch();
+  bench_loopback(params);
+
+  printf("Success\n");
+  return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Benchmark of the multiqueue_handler. It measures the throughput of tasks pushed by several producer threads and
+ * popped by a single consumer thread, as it happens with the stack thread, and the latency of waking up a sleeping
+ * consumer.
+ */
+
+#include "srsran/common/multiqueue.h"
+#include "srsran/support/srsran_test.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace srsran;
+
+struct bench_params {
+  uint32_t nof_msgs_per_producer = 1000000;
+  uint32_t nof_latency_samples   = 2000;
+  uint32_t queue_capacity        = 1024;
+};
+
+static uint64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Measures the rate of tasks pushed by several producers, each with its own queue, and run by a single consumer
+void bench_throughput(const bench_params& params, uint32_t nof_producers, uint32_t batch_size)
+{
+  task_multiqueue                multiqueue(params.queue_capacity);
+  std::vector<task_queue_handle> queues;
+  for (uint32_t i = 0; i < nof_producers; ++i) {
+    queues.push_back(multiqueue.add_queue());
+  }
+
+  uint64_t                 count = 0;
+  std::vector<std::thread> producers;
+  auto                     tp_start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_producers; ++i) {
+    producers.emplace_back([&params, &queues, &count, i]() {
+      for (uint32_t j = 0; j < params.nof_msgs_per_producer; ++j) {
+        queues[i].push([&count]() { count++; });
+      }
+    });
+  }
+
+  const uint64_t           nof_msgs = static_cast<uint64_t>(nof_producers) * params.nof_msgs_per_producer;
+  std::vector<move_task_t> tasks(batch_size);
+  while (count < nof_msgs) {
+    uint32_t n = multiqueue.wait_pop_batch(tasks.data(), batch_size);
+    TESTASSERT(n > 0);
+    for (uint32_t k = 0; k < n; ++k) {
+      tasks[k]();
+    }
+  }
+  auto tp_end = std::chrono::steady_clock::now();
+
+  for (std::thread& t : producers) {
+    t.join();
+  }
+  TESTASSERT(count == nof_msgs);
+
+  double total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_start).count();
+  printf("throughput: %u producers, batch=%u, %" PRIu64 " tasks, %.2f Mtasks/sec, avg=%.1f nsec/task\n",
+         nof_producers,
+         batch_size,
+         nof_msgs,
+         nof_msgs * 1000.0 / total_ns,
+         total_ns / nof_msgs);
+}
+
+/// Measures the time between a push and the pop of a consumer that was sleeping in wait_pop()
+void bench_wakeup_latency(const bench_params& params)
+{
+  multiqueue_handler<uint64_t>           multiqueue(params.queue_capacity);
+  multiqueue_handler<uint64_t>::queue_handle q = multiqueue.add_queue();
+
+  std::thread producer([&params, &q]() {
+    for (uint32_t i = 0; i < params.nof_latency_samples; ++i) {
+      // give time for the consumer to go to sleep
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+      q.push(now_ns());
+    }
+  });
+
+  std::vector<uint64_t> latencies;
+  latencies.reserve(params.nof_latency_samples);
+  uint64_t tstamp;
+  for (uint32_t i = 0; i < params.nof_latency_samples; ++i) {
+    TESTASSERT(multiqueue.wait_pop(&tstamp));
+    latencies.push_back(now_ns() - tstamp);
+  }
+  producer.join();
+
+  std::sort(latencies.begin(), latencies.end());
+  uint64_t sum = 0;
+  for (uint64_t l : latencies) {
+    sum += l;
+  }
+  printf("wake-up latency: %u samples, avg=%.1f usec, median=%.1f usec, p99=%.1f usec\n",
+         params.nof_latency_samples,
+         sum / 1000.0 / latencies.size(),
+         latencies[latencies.size() / 2] / 1000.0,
+         latencies[latencies.size() * 99 / 100] / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+  bench_params params;
+  if (argc > 1) {
+    params.nof_msgs_per_producer = std::strtoul(argv[1], nullptr, 10);
+  }
+
+  bench_throughput(params, 1, 1);
+  bench_throughput(params, 4, 1);
+  bench_throughput(params, 4, 32);
+  bench_wakeup_latency(params);
+
+  printf("Success\n");
+  return 0;
+}
@@ -410,6 +410,66 @@ int test_task_thread_pool3()
   return 0;
 }
 
+int test_task_thread_pool_priorities()
+{
+  std::cout << "\n====== TEST task thread pool priorities: start ======\n";
+  // Description: high priority tasks pushed before the pool starts run before the normal priority ones, and tasks
+  // pushed to the queue of a busy worker are stolen by the idle workers
+
+  task_thread_pool thread_pool(1, true);
+
+  std::mutex       mutex;
+  std::vector<int> order;
+  for (int i = 0; i < 5; ++i) {
+    thread_pool.push_task([&mutex, &order, i]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(i);
+    });
+  }
+  for (int i = 5; i < 10; ++i) {
+    thread_pool.push_task(
+        [&mutex, &order, i]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(i);
+        },
+        task_priority::high);
+  }
+  TESTASSERT(thread_pool.nof_pending_tasks() == 10);
+  thread_pool.start();
+  while (thread_pool.nof_pending_tasks() > 0) {
+    usleep(10);
+  }
+  thread_pool.stop();
+  TESTASSERT(order.size() == 10);
+  for (int i = 0; i < 5; ++i) {
+    TESTASSERT(order[i] == 5 + i);
+    TESTASSERT(order[5 + i] == i);
+  }
+
+  // A worker blocked in a task pushes more tasks to its own queue. The other worker must steal and run them.
+  task_thread_pool  thread_pool2(2);
+  std::atomic<int>  nof_runs{0};
+  std::atomic<bool> unblock{false};
+  thread_pool2.push_task([&thread_pool2, &nof_runs, &unblock]() {
+    for (int i = 0; i < 10; ++i) {
+      thread_pool2.push_task([&nof_runs]() { nof_runs++; });
+    }
+    while (nof_runs < 10) {
+      usleep(10);
+    }
+    unblock = true;
+  });
+  while (not unblock) {
+    usleep(10);
+  }
+  TESTASSERT(nof_runs == 10);
+  thread_pool2.stop();
+
+  std::cout << "outcome: Success\n";
+  std::cout << "===================================================\n";
+  return 0;
+}
+
 struct C {
   std::unique_ptr<int> val{new int{5}};
 };
@@ -503,6 +563,7 @@ int main()
   TESTASSERT(test_task_thread_pool() == 0);
   TESTASSERT(test_task_thread_pool2() == 0);
   TESTASSERT(test_task_thread_pool3() == 0);
+  TESTASSERT(test_task_thread_pool_priorities() == 0);
 
   TESTASSERT(test_inplace_task() == 0);
 }
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/common/network_utils.h"
+#include "srsran/common/int_helpers.h"
 #include "srsran/common/task_scheduler.h"
 #include "srsran/common/test_common.h"
 #include <atomic>
@@ -130,6 +131,75 @@ int test_socket_handler()
   return 0;
 }
 
+int test_udp_batch_handler()
+{
+  auto& logger = srslog::fetch_basic_logger("GTPU", false);
+
+  std::atomic<int> counter = {0}, nof_bursts = {0}, out_of_order = {0};
+
+  srsran::unique_socket  server_socket, client_socket;
+  srsran::socket_manager sockhandler;
+  using namespace srsran::net_utils;
+
+  TESTASSERT(server_socket.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  TESTASSERT(server_socket.bind_addr("127.0.0.1", 0));
+  TESTASSERT(client_socket.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  sockaddr_in server_addrin = {};
+  socklen_t   socklen       = sizeof(server_addrin);
+  TESTASSERT(getsockname(server_socket.fd(), (struct sockaddr*)&server_addrin, &socklen) == 0);
+
+  // Queue more datagrams than the batch size before the socket is registered
+  int32_t nof_counts = 100, batch_size = 16;
+  for (int32_t i = 0; i < nof_counts; ++i) {
+    uint8_t buf[4];
+    srsran::uint32_to_uint8(i, buf);
+    ssize_t n_sent = sendto(client_socket.fd(), buf, sizeof(buf), 0, (struct sockaddr*)&server_addrin, socklen);
+    TESTASSERT(n_sent == sizeof(buf));
+  }
+
+  // register server Rx handler. Each burst is handled by a single task that calls the handler once per datagram
+  rx_thread_tester rx_tester;
+  auto             pdu_handler = [&counter, &out_of_order](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
+    uint32_t sn = 0;
+    srsran::uint8_to_uint32(pdu->msg, &sn);
+    if (pdu->N_bytes != sizeof(sn) or sn != (uint32_t)counter) {
+      out_of_order++;
+    }
+    counter++;
+  };
+  srsran::socket_manager_itf::recv_callback_t handler =
+      srsran::make_sdu_batch_handler(logger, rx_tester.task_queue, pdu_handler, batch_size);
+  sockhandler.add_socket_handler(server_socket.fd(),
+                                 [&nof_bursts, &handler](int fd) {
+                                   nof_bursts++;
+                                   return handler(fd);
+                                 });
+
+  uint32_t time_elapsed = 0;
+  while (counter != nof_counts) {
+    usleep(100);
+    time_elapsed += 100;
+    if (time_elapsed > 3000000) {
+      // too much time has passed
+      return -1;
+    }
+  }
+  TESTASSERT(out_of_order == 0);
+  TESTASSERT(nof_bursts == (nof_counts + batch_size - 1) / batch_size);
+  logger.info("Received %d datagrams in %d bursts", counter.load(), nof_bursts.load());
+
+  // Once removed, the socket is not polled anymore
+  TESTASSERT(sockhandler.remove_socket(server_socket.fd()));
+  int     bursts_after_rm = nof_bursts;
+  uint8_t buf[4]          = {};
+  TESTASSERT(sendto(client_socket.fd(), buf, sizeof(buf), 0, (struct sockaddr*)&server_addrin, socklen) == 4);
+  usleep(10000);
+  TESTASSERT(nof_bursts == bursts_after_rm);
+  TESTASSERT(counter == nof_counts);
+
+  return 0;
+}
+
 int test_sctp_bind_error()
 {
   srsran::unique_socket sock;
@@ -157,6 +227,7 @@ int main()
   srslog::init();
 
   TESTASSERT(test_socket_handler() == 0);
+  TESTASSERT(test_udp_batch_handler() == 0);
   TESTASSERT(test_sctp_bind_error() == 0);
 
   return 0;
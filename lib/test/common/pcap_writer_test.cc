@@ -0,0 +1,275 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/mac_pcap.h"
+#include "srsran/common/pcap_writer.h"
+#include "srsran/common/test_common.h"
+#include <fstream>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+
+/// Reads a pcap file and returns the number of records, or -1 if the file is malformed.
+int count_pcap_records(const std::string& filename, uint32_t dlt, uint32_t record_len = 0)
+{
+  std::ifstream f(filename, std::ios::binary);
+  if (not f.is_open()) {
+    return -1;
+  }
+  pcap_hdr_t file_header = {};
+  if (not f.read((char*)&file_header, sizeof(file_header)) or file_header.magic_number != 0xa1b2c3d4 or
+      file_header.network != dlt) {
+    return -1;
+  }
+  int           nof_records = 0;
+  pcaprec_hdr_t rec         = {};
+  while (f.read((char*)&rec, sizeof(rec))) {
+    if (rec.incl_len != rec.orig_len or (record_len > 0 and rec.incl_len != record_len)) {
+      return -1;
+    }
+    f.seekg(rec.incl_len, std::ios::cur);
+    nof_records++;
+  }
+  return nof_records;
+}
+
+/// Reads a pcapng file with a single interface and returns the number of Enhanced Packet Blocks, or -1 if the file is
+/// malformed. All the packets must have been captured with cap_len bytes out of orig_len.
+int count_pcapng_blocks(const std::string& filename, uint32_t dlt, uint32_t cap_len, uint32_t orig_len)
+{
+  std::ifstream f(filename, std::ios::binary);
+  if (not f.is_open()) {
+    return -1;
+  }
+  int nof_blocks = 0;
+  while (true) {
+    uint32_t block_hdr[2];
+    if (not f.read((char*)block_hdr, sizeof(block_hdr))) {
+      break;
+    }
+    std::vector<uint8_t> body(block_hdr[1] - sizeof(block_hdr));
+    if (body.size() < sizeof(uint32_t) or not f.read((char*)body.data(), body.size())) {
+      return -1;
+    }
+    uint32_t trailing_len;
+    memcpy(&trailing_len, &body[body.size() - sizeof(uint32_t)], sizeof(uint32_t));
+    if (trailing_len != block_hdr[1] or block_hdr[1] % 4 != 0) {
+      return -1;
+    }
+    switch (block_hdr[0]) {
+      case PCAPNG_SHB_TYPE:
+        if (nof_blocks != 0) {
+          return -1;
+        }
+        break;
+      case PCAPNG_IDB_TYPE:
+        if ((body[0] | (body[1] << 8U)) != (int)dlt) {
+          return -1;
+        }
+        break;
+      case PCAPNG_EPB_TYPE: {
+        pcapng_epb_hdr_t epb;
+        memcpy(&epb.interface_id, body.data(), sizeof(epb) - sizeof(block_hdr));
+        if (epb.interface_id != 0 or epb.captured_len != cap_len or epb.orig_len != orig_len) {
+          return -1;
+        }
+        nof_blocks++;
+        break;
+      }
+      default:
+        return -1;
+    }
+  }
+  return nof_blocks;
+}
+
+int mac_pcap_writer_test()
+{
+  std::array<uint8_t, 150> tv = {};
+  for (uint32_t i = 0; i < tv.size(); ++i) {
+    tv[i] = i;
+  }
+  const char* filename            = "/tmp/pcap_writer_test_mac.pcap";
+  uint32_t    num_threads         = 8;
+  uint32_t    num_pdus_per_thread = 5000;
+
+  // Small write buffer to exercise the flushes while the writers are running
+  srsran::pcap_writer::args_t args;
+  args.buffer_size = 64 * 1024;
+
+  srsran::mac_pcap pcap;
+  TESTASSERT(pcap.open(filename, 0, args) == SRSRAN_SUCCESS);
+  TESTASSERT(pcap.open(filename) != SRSRAN_SUCCESS); // open again will fail
+
+  std::vector<std::thread> writer_threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    writer_threads.emplace_back([&pcap, &tv, num_pdus_per_thread]() {
+      for (uint32_t j = 0; j < num_pdus_per_thread; j++) {
+        pcap.write_ul_crnti(tv.data(), tv.size(), 0x1001, 0, j % 10240, 0);
+      }
+    });
+  }
+  for (std::thread& t : writer_threads) {
+    t.join();
+  }
+  uint64_t nof_dropped = pcap.nof_dropped();
+  TESTASSERT(pcap.close() == SRSRAN_SUCCESS);
+  TESTASSERT(pcap.close() != SRSRAN_SUCCESS); // closing twice will fail
+
+  // Every PDU is either written or accounted as dropped. The record has the UDP header and MAC context before the PDU.
+  int nof_records = count_pcap_records(filename, UDP_DLT);
+  TESTASSERT(nof_records > 0);
+  TESTASSERT((uint64_t)nof_records + nof_dropped == num_threads * num_pdus_per_thread);
+  unlink(filename);
+  return SRSRAN_SUCCESS;
+}
+
+int pcap_writer_rotation_test()
+{
+  const std::string        filename = "/tmp/pcap_writer_test_rot.pcap";
+  std::array<uint8_t, 100> pdu      = {};
+
+  // Each file holds the file header and 9 records of 116 bytes
+  srsran::pcap_writer::args_t args;
+  args.max_file_size = sizeof(pcap_hdr_t) + 9 * (sizeof(pcaprec_hdr_t) + pdu.size()) + 50;
+  args.max_files     = 3;
+
+  srsran::pcap_writer writer;
+  TESTASSERT(writer.open(filename, NAS_LTE_DLT, args));
+  for (uint32_t i = 0; i < 50; ++i) {
+    TESTASSERT(writer.write(nullptr, 0, pdu.data(), pdu.size()));
+  }
+  writer.close();
+  TESTASSERT(writer.nof_dropped() == 0);
+  TESTASSERT(not writer.write(nullptr, 0, pdu.data(), pdu.size())); // writing to a closed file fails
+
+  // 50 records in files of 9 records: indexes 0 to 5, of which only the last three are kept
+  TESTASSERT(access(filename.c_str(), F_OK) != 0);
+  TESTASSERT(access((filename + ".1").c_str(), F_OK) != 0);
+  TESTASSERT(access((filename + ".2").c_str(), F_OK) != 0);
+  TESTASSERT(count_pcap_records(filename + ".3", NAS_LTE_DLT, pdu.size()) == 9);
+  TESTASSERT(count_pcap_records(filename + ".4", NAS_LTE_DLT, pdu.size()) == 9);
+  TESTASSERT(count_pcap_records(filename + ".5", NAS_LTE_DLT, pdu.size()) == 5);
+  for (uint32_t idx = 3; idx < 6; ++idx) {
+    unlink((filename + "." + std::to_string(idx)).c_str());
+  }
+
+  // The file can be reopened, and records are flushed after the flush period even if the buffer is not full
+  args                 = {};
+  args.flush_period_ms = 10;
+  TESTASSERT(writer.open(filename, NAS_LTE_DLT, args));
+  TESTASSERT(writer.write(nullptr, 0, pdu.data(), pdu.size()));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  TESTASSERT(count_pcap_records(filename, NAS_LTE_DLT, pdu.size()) == 1);
+  writer.close();
+  unlink(filename.c_str());
+  return SRSRAN_SUCCESS;
+}
+
+int pcap_writer_pcapng_test()
+{
+  const std::string        filename = "/tmp/pcap_writer_test.pcapng";
+  std::array<uint8_t, 100> pdu      = {};
+  std::array<uint8_t, 10>  context  = {};
+
+  // Only the context and the first bytes of the PDU are captured
+  srsran::pcap_writer::args_t args;
+  args.format   = srsran::pcap_format_t::pcapng;
+  args.if_name  = "mac";
+  args.snap_len = 33;
+
+  srsran::pcap_writer writer;
+  TESTASSERT(writer.open(filename, UDP_DLT, args));
+  for (uint32_t i = 0; i < 20; ++i) {
+    TESTASSERT(writer.write(context.data(), context.size(), pdu.data(), pdu.size()));
+  }
+  writer.close();
+  TESTASSERT(count_pcapng_blocks(filename, UDP_DLT, args.snap_len, context.size() + pdu.size()) == 20);
+  unlink(filename.c_str());
+  return SRSRAN_SUCCESS;
+}
+
+int mac_pcap_filter_test()
+{
+  const char*              filename = "/tmp/pcap_writer_test_filter.pcap";
+  std::array<uint8_t, 100> pdu      = {};
+
+  srsran::pcap_filter filter;
+  TESTASSERT(not filter.parse("0x46,abc"));
+  TESTASSERT(not filter.parse("65536"));
+  TESTASSERT(filter.parse("0x46, 71"));
+  TESTASSERT(filter.rnti_allowed(0x46) and filter.rnti_allowed(71) and not filter.rnti_allowed(0x48));
+
+  srsran::mac_pcap pcap;
+  pcap.set_filter(filter);
+  TESTASSERT(pcap.open(filename) == SRSRAN_SUCCESS);
+  for (uint16_t rnti = 0x40; rnti < 0x50; ++rnti) {
+    pcap.write_dl_crnti(pdu.data(), pdu.size(), rnti, true, 0, 0);
+  }
+  TESTASSERT(pcap.close() == SRSRAN_SUCCESS);
+  TESTASSERT(count_pcap_records(filename, UDP_DLT) == 2);
+  unlink(filename);
+  return SRSRAN_SUCCESS;
+}
+
+int pcap_writer_trigger_test()
+{
+  const std::string        filename = "/tmp/pcap_writer_test_trigger.pcap";
+  std::array<uint8_t, 100> pdu      = {};
+
+  // The history holds the last buffer, which is flushed every 10ms
+  srsran::pcap_writer::args_t args;
+  args.flush_period_ms      = 10;
+  args.trigger_history_size = 1;
+  args.trigger_post_ms      = 100;
+
+  srsran::pcap_writer writer;
+  TESTASSERT(writer.open(filename, NAS_LTE_DLT, args));
+  for (uint32_t i = 0; i < 5; ++i) {
+    TESTASSERT(writer.write(nullptr, 0, pdu.data(), pdu.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  TESTASSERT(count_pcap_records(filename, NAS_LTE_DLT) == 0);
+
+  // The trigger writes the history, and the records of the following trigger_post_ms
+  srsran::pcap_writer::trigger_all();
+  TESTASSERT(writer.write(nullptr, 0, pdu.data(), pdu.size()));
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  TESTASSERT(writer.write(nullptr, 0, pdu.data(), pdu.size()));
+  writer.close();
+  TESTASSERT(count_pcap_records(filename, NAS_LTE_DLT, pdu.size()) == 2);
+  unlink(filename.c_str());
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+  srslog::fetch_basic_logger("MAC").set_level(srslog::basic_levels::warning);
+
+  TESTASSERT(mac_pcap_writer_test() == SRSRAN_SUCCESS);
+  TESTASSERT(pcap_writer_rotation_test() == SRSRAN_SUCCESS);
+  TESTASSERT(pcap_writer_pcapng_test() == SRSRAN_SUCCESS);
+  TESTASSERT(mac_pcap_filter_test() == SRSRAN_SUCCESS);
+  TESTASSERT(pcap_writer_trigger_test() == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,259 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Checks the cached-key EEA2/EIA2 implementation against the liblte reference and measures the throughput of ciphering
+ * and integrity protection of PDCP PDUs, computing the key schedule on every call, using a cached key context and
+ * processing the PDUs in batches.
+ */
+
+#include "srsran/common/liblte_security.h"
+#include "srsran/common/security.h"
+#include "srsran/config.h"
+#include "srsran/support/srsran_test.h"
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace srsran;
+
+static std::mt19937 rand_gen(0);
+
+struct bench_params {
+  uint32_t nof_pdus   = 20000;
+  uint32_t pdu_len    = 1500;
+  uint32_t batch_size = 32;
+};
+
+static void random_bytes(uint8_t* data, uint32_t len)
+{
+  std::uniform_int_distribution<uint32_t> dist(0, 255);
+  for (uint32_t i = 0; i < len; i++) {
+    data[i] = dist(rand_gen);
+  }
+}
+
+/// Compares single and batched ciphering against the reference, for random keys, lengths and COUNTs
+void test_eea2_reference()
+{
+  const uint32_t                          nof_pdus = 64;
+  std::uniform_int_distribution<uint32_t> len_dist(1, 1600);
+
+  for (uint32_t iter = 0; iter < 20; iter++) {
+    uint8_t key[16];
+    random_bytes(key, sizeof(key));
+    uint8_t        bearer    = rand_gen() % 32;
+    uint8_t        direction = rand_gen() % 2;
+    aes128_key_ctx ctx(key);
+
+    std::vector<std::vector<uint8_t> > msgs(nof_pdus), ref(nof_pdus), out(nof_pdus), batch(nof_pdus);
+    std::vector<security_batch_pdu_t>  pdus(nof_pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      uint32_t len = len_dist(rand_gen);
+      msgs[i].resize(len);
+      random_bytes(msgs[i].data(), len);
+      ref[i].resize(len);
+      out[i].resize(len);
+      batch[i] = msgs[i];
+      pdus[i]  = {batch[i].data(), len, (uint32_t)rand_gen(), batch[i].data()};
+
+      liblte_security_encryption_eea2(key, pdus[i].count, bearer, direction, msgs[i].data(), len * 8, ref[i].data());
+      TESTASSERT_EQ(SRSRAN_SUCCESS,
+                    security_128_eea2(ctx, pdus[i].count, bearer, direction, msgs[i].data(), len, out[i].data()));
+      TESTASSERT(ref[i] == out[i]);
+    }
+
+    // Batch ciphering is done in place
+    security_128_eea2_batch(ctx, bearer, direction, pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      TESTASSERT(ref[i] == batch[i]);
+    }
+  }
+}
+
+/// Compares single and batched integrity protection against the reference, for random keys, lengths and COUNTs
+void test_eia2_reference()
+{
+  const uint32_t                          nof_pdus = 64;
+  std::uniform_int_distribution<uint32_t> len_dist(1, 1600);
+
+  for (uint32_t iter = 0; iter < 20; iter++) {
+    uint8_t key[16];
+    random_bytes(key, sizeof(key));
+    uint8_t        bearer    = rand_gen() % 32;
+    uint8_t        direction = rand_gen() % 2;
+    aes128_key_ctx ctx(key);
+
+    std::vector<std::vector<uint8_t> > msgs(nof_pdus);
+    std::vector<std::array<uint8_t, 4> > macs(nof_pdus);
+    std::vector<security_batch_pdu_t>    pdus(nof_pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      // Make sure all the padding cases are covered
+      uint32_t len = (i < 32) ? i + 1 : len_dist(rand_gen);
+      msgs[i].resize(len);
+      random_bytes(msgs[i].data(), len);
+      pdus[i] = {msgs[i].data(), len, (uint32_t)rand_gen(), macs[i].data()};
+
+      uint8_t ref[4], mac[4];
+      liblte_security_128_eia2(key, pdus[i].count, bearer, direction, msgs[i].data(), len, ref);
+      TESTASSERT_EQ(SRSRAN_SUCCESS,
+                    security_128_eia2(ctx, pdus[i].count, bearer, direction, msgs[i].data(), len, mac));
+      TESTASSERT(memcmp(ref, mac, sizeof(mac)) == 0);
+    }
+
+    security_128_eia2_batch(ctx, bearer, direction, pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      uint8_t ref[4];
+      liblte_security_128_eia2(key, pdus[i].count, bearer, direction, msgs[i].data(), msgs[i].size(), ref);
+      TESTASSERT(memcmp(ref, macs[i].data(), sizeof(ref)) == 0);
+    }
+  }
+}
+
+template <typename Func>
+static void run_bench(const char* name, const bench_params& params, Func&& func)
+{
+  auto     tp_start = std::chrono::steady_clock::now();
+  uint32_t nof_pdus = func();
+  auto     tp_end   = std::chrono::steady_clock::now();
+
+  double total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_start).count();
+  printf("%-28s %u PDUs of %uB, %.2f Mbps, avg=%.1f nsec/PDU\n",
+         name,
+         nof_pdus,
+         params.pdu_len,
+         nof_pdus * params.pdu_len * 8 * 1000.0 / total_ns,
+         total_ns / nof_pdus);
+}
+
+void bench_eea2(const bench_params& params)
+{
+  uint8_t key[16];
+  random_bytes(key, sizeof(key));
+  aes128_key_ctx ctx(key);
+
+  std::vector<std::vector<uint8_t> > msgs(params.batch_size, std::vector<uint8_t>(params.pdu_len));
+  for (std::vector<uint8_t>& msg : msgs) {
+    random_bytes(msg.data(), msg.size());
+  }
+  std::vector<security_batch_pdu_t> pdus(params.batch_size);
+
+  run_bench("EEA2 liblte reference:", params, [&]() {
+    for (uint32_t i = 0; i < params.nof_pdus; i++) {
+      uint8_t* msg = msgs[i % params.batch_size].data();
+      liblte_security_encryption_eea2(key, i, 1, 1, msg, params.pdu_len * 8, msg);
+    }
+    return params.nof_pdus;
+  });
+  run_bench("EEA2 key per call:", params, [&]() {
+    for (uint32_t i = 0; i < params.nof_pdus; i++) {
+      uint8_t* msg = msgs[i % params.batch_size].data();
+      security_128_eea2(key, i, 1, 1, msg, params.pdu_len, msg);
+    }
+    return params.nof_pdus;
+  });
+  run_bench("EEA2 cached key context:", params, [&]() {
+    for (uint32_t i = 0; i < params.nof_pdus; i++) {
+      uint8_t* msg = msgs[i % params.batch_size].data();
+      security_128_eea2(ctx, i, 1, 1, msg, params.pdu_len, msg);
+    }
+    return params.nof_pdus;
+  });
+  run_bench("EEA2 batch:", params, [&]() {
+    uint32_t count = 0;
+    for (; count + params.batch_size <= params.nof_pdus; count += params.batch_size) {
+      for (uint32_t i = 0; i < params.batch_size; i++) {
+        pdus[i] = {msgs[i].data(), params.pdu_len, count + i, msgs[i].data()};
+      }
+      security_128_eea2_batch(ctx, 1, 1, pdus);
+    }
+    return count;
+  });
+}
+
+void bench_eia2(const bench_params& params)
+{
+  uint8_t key[16];
+  random_bytes(key, sizeof(key));
+  aes128_key_ctx ctx(key);
+
+  std::vector<std::vector<uint8_t> > msgs(params.batch_size, std::vector<uint8_t>(params.pdu_len));
+  for (std::vector<uint8_t>& msg : msgs) {
+    random_bytes(msg.data(), msg.size());
+  }
+  std::vector<std::array<uint8_t, 4> > macs(params.batch_size);
+  std::vector<security_batch_pdu_t>    pdus(params.batch_size);
+
+  run_bench("EIA2 liblte reference:", params, [&]() {
+    for (uint32_t i = 0; i < params.nof_pdus; i++) {
+      uint32_t idx = i % params.batch_size;
+      liblte_security_128_eia2(key, i, 1, 1, msgs[idx].data(), params.pdu_len, macs[idx].data());
+    }
+    return params.nof_pdus;
+  });
+  run_bench("EIA2 key per call:", params, [&]() {
+    for (uint32_t i = 0; i < params.nof_pdus; i++) {
+      uint32_t idx = i % params.batch_size;
+      security_128_eia2(key, i, 1, 1, msgs[idx].data(), params.pdu_len, macs[idx].data());
+    }
+    return params.nof_pdus;
+  });
+  run_bench("EIA2 cached key context:", params, [&]() {
+    for (uint32_t i = 0; i < params.nof_pdus; i++) {
+      uint32_t idx = i % params.batch_size;
+      security_128_eia2(ctx, i, 1, 1, msgs[idx].data(), params.pdu_len, macs[idx].data());
+    }
+    return params.nof_pdus;
+  });
+  run_bench("EIA2 batch:", params, [&]() {
+    uint32_t count = 0;
+    for (; count + params.batch_size <= params.nof_pdus; count += params.batch_size) {
+      for (uint32_t i = 0; i < params.batch_size; i++) {
+        pdus[i] = {msgs[i].data(), params.pdu_len, count + i, macs[i].data()};
+      }
+      security_128_eia2_batch(ctx, 1, 1, pdus);
+    }
+    return count;
+  });
+}
+
+int main(int argc, char** argv)
+{
+  bench_params params;
+  if (argc > 1) {
+    params.nof_pdus = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    params.pdu_len = std::strtoul(argv[2], nullptr, 10);
+  }
+
+  test_eea2_reference();
+  test_eia2_reference();
+
+  bench_eea2(params);
+  bench_eia2(params);
+
+  printf("Success\n");
+  return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Checks the multi-buffer EEA1 (SNOW 3G) and EEA3 (ZUC) batch ciphering against the per-PDU liblte implementation and
+ * compares the throughput of both.
+ */
+
+#include "srsran/common/liblte_security.h"
+#include "srsran/common/security.h"
+#include "srsran/support/srsran_test.h"
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace srsran;
+
+static std::mt19937 rand_gen(0);
+
+struct bench_params {
+  uint32_t nof_pdus   = 20000;
+  uint32_t pdu_len    = 1500;
+  uint32_t batch_size = 32;
+};
+
+using eea_func_t       = LIBLTE_ERROR_ENUM (*)(uint8*, uint32, uint8, uint8, uint8*, uint32, uint8*);
+using eea_batch_func_t = void (*)(const uint8_t*, uint8_t, uint8_t, span<const security_batch_pdu_t>);
+
+static void random_bytes(uint8_t* data, uint32_t len)
+{
+  std::uniform_int_distribution<uint32_t> dist(0, 255);
+  for (uint32_t i = 0; i < len; i++) {
+    data[i] = dist(rand_gen);
+  }
+}
+
+/// Compares batched ciphering against the reference, for random keys, lengths and COUNTs, with batches that do not
+/// fill all the lanes
+void test_reference(eea_func_t ref_func, eea_batch_func_t batch_func)
+{
+  std::uniform_int_distribution<uint32_t> len_dist(1, 1600);
+
+  for (uint32_t nof_pdus : {1, 3, 16, 17, 40}) {
+    uint8_t key[16];
+    random_bytes(key, sizeof(key));
+    uint8_t bearer    = rand_gen() % 32;
+    uint8_t direction = rand_gen() % 2;
+
+    std::vector<std::vector<uint8_t> > msgs(nof_pdus), ref(nof_pdus), out(nof_pdus);
+    std::vector<security_batch_pdu_t>  pdus(nof_pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      // Make sure that short PDUs and all the tail lengths are covered
+      uint32_t len = (i < 8) ? i + 1 : len_dist(rand_gen);
+      msgs[i].resize(len);
+      random_bytes(msgs[i].data(), len);
+      ref[i].resize(len);
+      out[i].resize(len);
+      pdus[i] = {msgs[i].data(), len, (uint32_t)rand_gen(), out[i].data()};
+
+      ref_func(key, pdus[i].count, bearer, direction, msgs[i].data(), len * 8, ref[i].data());
+    }
+
+    batch_func(key, bearer, direction, pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      TESTASSERT(ref[i] == out[i]);
+    }
+
+    // Deciphering in place gives back the original PDUs
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      pdus[i].msg = ref[i].data();
+      pdus[i].out = ref[i].data();
+    }
+    batch_func(key, bearer, direction, pdus);
+    for (uint32_t i = 0; i < nof_pdus; i++) {
+      TESTASSERT(ref[i] == msgs[i]);
+    }
+  }
+}
+
+template <typename Func>
+static void run_bench(const char* name, const bench_params& params, Func&& func)
+{
+  auto     tp_start = std::chrono::steady_clock::now();
+  uint32_t nof_pdus = func();
+  auto     tp_end   = std::chrono::steady_clock::now();
+
+  double total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_start).count();
+  printf("%-16s %u PDUs of %uB, %.2f Mbps, avg=%.1f nsec/PDU\n",
+         name,
+         nof_pdus,
+         params.pdu_len,
+         nof_pdus * params.pdu_len * 8 * 1000.0 / total_ns,
+         total_ns / nof_pdus);
+}
+
+void bench(const char* name, const bench_params& params, eea_func_t ref_func, eea_batch_func_t batch_func)
+{
+  uint8_t key[16];
+  random_bytes(key, sizeof(key));
+
+  std::vector<std::vector<uint8_t> > msgs(params.batch_size, std::vector<uint8_t>(params.pdu_len));
+  for (std::vector<uint8_t>& msg : msgs) {
+    random_bytes(msg.data(), msg.size());
+  }
+  std::vector<security_batch_pdu_t> pdus(params.batch_size);
+
+  std::string label = std::string(name) + " per PDU:";
+  run_bench(label.c_str(), params, [&]() {
+    for (uint32_t i = 0; i < params.nof_pdus; i++) {
+      uint8_t* msg = msgs[i % params.batch_size].data();
+      ref_func(key, i, 1, 1, msg, params.pdu_len * 8, msg);
+    }
+    return params.nof_pdus;
+  });
+
+  label = std::string(name) + " batch:";
+  run_bench(label.c_str(), params, [&]() {
+    uint32_t count = 0;
+    for (; count + params.batch_size <= params.nof_pdus; count += params.batch_size) {
+      for (uint32_t i = 0; i < params.batch_size; i++) {
+        pdus[i] = {msgs[i].data(), params.pdu_len, count + i, msgs[i].data()};
+      }
+      batch_func(key, 1, 1, pdus);
+    }
+    return count;
+  });
+}
+
+int main(int argc, char** argv)
+{
+  bench_params params;
+  if (argc > 1) {
+    params.nof_pdus = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    params.pdu_len = std::strtoul(argv[2], nullptr, 10);
+  }
+
+  test_reference(liblte_security_encryption_eea1, security_128_eea1_batch);
+  test_reference(liblte_security_encryption_eea3, security_128_eea3_batch);
+
+  bench("EEA1", params, liblte_security_encryption_eea1, security_128_eea1_batch);
+  bench("EEA3", params, liblte_security_encryption_eea3, security_128_eea3_batch);
+
+  printf("Success\n");
+  return 0;
+}
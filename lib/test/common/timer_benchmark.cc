@@ -0,0 +1,194 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Benchmark of the timer_handler. It measures the cost of step_all() with a large number of active timers, whose
+ * durations mimic the ones of RLC/PDCP timers (t-Reordering, t-PollRetransmit, PDCP discard timers), and the cost of
+ * restarting timers from a thread other than the one stepping the timers.
+ */
+
+#include "srsran/common/timers.h"
+#include "srsran/support/srsran_test.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+using namespace srsran;
+
+struct bench_params {
+  uint32_t nof_timers   = 100000;
+  uint32_t nof_steps    = 5000;
+  uint32_t max_duration = 1500;
+};
+
+static uint32_t random_duration(std::mt19937& rgen, uint32_t max_duration)
+{
+  static const uint32_t short_durations[] = {5, 10, 35, 45, 50, 100};
+  std::uniform_int_distribution<uint32_t> dist(0, 9);
+  uint32_t                                idx = dist(rgen);
+  if (idx < 6) {
+    return short_durations[idx];
+  }
+  return std::uniform_int_distribution<uint32_t>(1, max_duration)(rgen);
+}
+
+/// Measures the step_all() cost with all the timers restarted on expiry, so the number of active timers stays constant
+void bench_step(const bench_params& params)
+{
+  timer_handler             timers(params.nof_timers);
+  std::vector<unique_timer> timer_list;
+  std::mt19937              rgen(0);
+  uint64_t                  nof_expiries = 0;
+
+  // The callbacks keep pointers to the timers, so the vector must not reallocate
+  timer_list.reserve(params.nof_timers);
+  for (uint32_t i = 0; i < params.nof_timers; ++i) {
+    timer_list.push_back(timers.get_unique_timer());
+    unique_timer* t = &timer_list.back();
+    timer_list.back().set(random_duration(rgen, params.max_duration), [t, &nof_expiries](uint32_t tid) {
+      nof_expiries++;
+      t->run();
+    });
+  }
+  for (unique_timer& t : timer_list) {
+    t.run();
+  }
+  TESTASSERT(timers.nof_running_timers() == params.nof_timers);
+
+  auto tp_start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < params.nof_steps; ++i) {
+    timers.step_all();
+  }
+  auto tp_end = std::chrono::steady_clock::now();
+
+  TESTASSERT(timers.nof_running_timers() == params.nof_timers);
+  TESTASSERT(nof_expiries > 0);
+  double step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_start).count() /
+                   static_cast<double>(params.nof_steps);
+  printf("step_all(): %u active timers, %u steps, %" PRIu64 " expiries, avg=%.2f usec/step\n",
+         params.nof_timers,
+         params.nof_steps,
+         nof_expiries,
+         step_ns / 1000.0);
+}
+
+/// Measures the step_all() cost when most timers are restarted/stopped before they expire, as it happens with RLC/PDCP
+/// timers during normal operation
+void bench_restart(const bench_params& params)
+{
+  timer_handler             timers(params.nof_timers);
+  std::vector<unique_timer> timer_list;
+  std::mt19937              rgen(0);
+
+  for (uint32_t i = 0; i < params.nof_timers; ++i) {
+    timer_list.push_back(timers.get_unique_timer());
+    timer_list.back().set(random_duration(rgen, params.max_duration));
+    timer_list.back().run();
+  }
+
+  const uint32_t nof_restarts_per_step = std::max(params.nof_timers / 50, 1U);
+  uint32_t       next_timer            = 0;
+  auto           tp_start              = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < params.nof_steps; ++i) {
+    for (uint32_t j = 0; j < nof_restarts_per_step; ++j) {
+      unique_timer& t = timer_list[next_timer];
+      next_timer      = (next_timer + 1) % params.nof_timers;
+      if (j % 8 == 0) {
+        t.stop();
+      } else {
+        t.run();
+      }
+    }
+    timers.step_all();
+  }
+  auto tp_end = std::chrono::steady_clock::now();
+
+  double step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_start).count() /
+                   static_cast<double>(params.nof_steps);
+  printf("run()/stop() + step_all(): %u timers, %u restarts/step, avg=%.2f usec/step\n",
+         params.nof_timers,
+         nof_restarts_per_step,
+         step_ns / 1000.0);
+}
+
+/// Measures the cost of run()/stop() from a separate thread, while another thread keeps stepping the timers
+void bench_concurrent_run_stop(const bench_params& params)
+{
+  timer_handler             timers(params.nof_timers);
+  std::vector<unique_timer> timer_list;
+  std::mt19937              rgen(0);
+
+  for (uint32_t i = 0; i < params.nof_timers; ++i) {
+    timer_list.push_back(timers.get_unique_timer());
+    timer_list.back().set(random_duration(rgen, params.max_duration));
+    timer_list.back().run();
+  }
+
+  std::atomic<bool> stop_stepping{false};
+  std::thread       stepper([&timers, &stop_stepping]() {
+    while (not stop_stepping.load(std::memory_order_relaxed)) {
+      timers.step_all();
+    }
+  });
+
+  const uint32_t nof_ops  = 10 * params.nof_timers;
+  auto           tp_start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_ops; ++i) {
+    unique_timer& t = timer_list[i % params.nof_timers];
+    if ((i / params.nof_timers) % 2 == 0) {
+      t.run();
+    } else {
+      t.stop();
+    }
+  }
+  auto tp_end = std::chrono::steady_clock::now();
+
+  stop_stepping = true;
+  stepper.join();
+  TESTASSERT(timers.nof_running_timers() == 0);
+
+  double op_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(tp_end - tp_start).count() / static_cast<double>(nof_ops);
+  printf("run()/stop() with concurrent step_all(): %u ops, avg=%.1f nsec/op\n", nof_ops, op_ns);
+}
+
+int main(int argc, char** argv)
+{
+  bench_params params;
+  if (argc > 1) {
+    params.nof_timers = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    params.nof_steps = std::strtoul(argv[2], nullptr, 10);
+  }
+
+  // Run the multi-threaded benchmark first. The libc mutex/atomic fast paths of a single-threaded process would not be
+  // representative of the stack, which always runs multiple threads
+  bench_concurrent_run_stop(params);
+  bench_step(params);
+  bench_restart(params);
+
+  printf("Success\n");
+  return 0;
+}
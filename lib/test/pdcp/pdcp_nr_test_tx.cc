@@ -53,16 +53,26 @@ public:
   int test_tx(uint32_t                     n_packets,
               const pdcp_initial_state&    init_state,
               uint64_t                     n_pdus_exp,
-              srsran::unique_byte_buffer_t pdu_exp)
+              srsran::unique_byte_buffer_t pdu_exp,
+              uint32_t                     batch_size = 1)
   {
     pdcp_hlp_tx.set_pdcp_initial_state(init_state);
 
     // Run test
+    std::vector<srsran::unique_byte_buffer_t> batch;
     for (uint32_t i = 0; i < n_packets; ++i) {
       // Test SDU
       srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
       sdu->append_bytes(sdu1, sizeof(sdu1));
-      pdcp_hlp_tx.pdcp.write_sdu(std::move(sdu));
+      if (batch_size == 1) {
+        pdcp_hlp_tx.pdcp.write_sdu(std::move(sdu));
+        continue;
+      }
+      batch.push_back(std::move(sdu));
+      if (batch.size() == batch_size or i == n_packets - 1) {
+        pdcp_hlp_tx.pdcp.write_sdus(std::move(batch));
+        batch.clear();
+      }
     }
 
     srsran::unique_byte_buffer_t pdu_act = srsran::make_byte_buffer();
@@ -221,6 +231,36 @@ int test_tx_all(srslog::basic_logger& logger)
     tx_helper.pdcp_tx.notify_delivery({0});
     TESTASSERT(tx_helper.pdcp_tx.nof_discard_timers() == 0);
   }
+
+  /*
+   * TX Test 10: PDCP Entity with SN LEN = 12
+   * TX_NEXT = 2048, SDUs written in batches of 13, so that the last batch is incomplete.
+   * Input: {0x18, 0xE2}
+   * Output: {0x88, 0x00, 0x8d, 0x2c, 0xe5, 0x38, 0xc0, 0x42}
+   */
+  {
+    srsran::test_delimit_logger delimiter("TX COUNT 2048, 12 bit SN, batched");
+    test_tx_helper              tx_helper(srsran::PDCP_SN_LEN_12, logger);
+    n_packets                                            = 2049;
+    srsran::unique_byte_buffer_t pdu_exp_count2048_len12 = srsran::make_byte_buffer();
+    pdu_exp_count2048_len12->append_bytes(pdu1_count2048_snlen12, sizeof(pdu1_count2048_snlen12));
+    TESTASSERT(tx_helper.test_tx(n_packets, normal_init_state, n_packets, std::move(pdu_exp_count2048_len12), 13) == 0);
+  }
+
+  /*
+   * TX Test 11: PDCP Entity with SN LEN = 18
+   * Test batched TX at COUNT wraparound.
+   * Packets after wraparound are dropped without affecting the rest of the batch.
+   */
+  {
+    srsran::test_delimit_logger delimiter("TX COUNT wrap around, 18 bit SN, batched");
+    test_tx_helper              tx_helper(srsran::PDCP_SN_LEN_18, logger);
+    n_packets                                                  = 5;
+    srsran::unique_byte_buffer_t pdu_exp_count4294967295_len18 = srsran::make_byte_buffer();
+    pdu_exp_count4294967295_len18->append_bytes(pdu1_count4294967295_snlen18, sizeof(pdu1_count4294967295_snlen18));
+    TESTASSERT(tx_helper.test_tx(
+                   n_packets, near_wraparound_init_state, 1, std::move(pdu_exp_count4294967295_len18), n_packets) == 0);
+  }
   return SRSRAN_SUCCESS;
 }
 
@@ -0,0 +1,255 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "file_test_utils.h"
+#include "src/srslog/formatters/binary_decoder.h"
+#include "src/srslog/formatters/binary_formatter.h"
+#include "src/srslog/sinks/binary_file_sink.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include "testing_helpers.h"
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+using namespace srslog;
+
+using arg_store = fmt::dynamic_format_arg_store<fmt::printf_context>;
+
+/// Helper to build a log entry.
+static detail::log_entry_metadata build_log_entry_metadata(const char* fmtstring, arg_store* store)
+{
+  // Create a time point 50000us from epoch.
+  using tp_ty = std::chrono::time_point<std::chrono::high_resolution_clock>;
+  tp_ty tp(std::chrono::microseconds(50000));
+
+  return {tp, {10, true}, fmtstring, store, "ABC", 'Z'};
+}
+
+/// Renders the log entry directly with the text formatter.
+static std::string format_as_text(detail::log_entry_metadata metadata)
+{
+  fmt::memory_buffer buffer;
+  text_formatter{}.format(std::move(metadata), buffer);
+  return fmt::to_string(buffer);
+}
+
+/// Decodes the binary data in the buffer with the text formatter.
+static std::string decode_as_text(const fmt::memory_buffer& buffer)
+{
+  fmt::memory_buffer out;
+  binary_decoder     decoder(std::unique_ptr<log_formatter>(new text_formatter));
+  if (auto err_str = decoder.decode(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size(), out)) {
+    return err_str.get_error();
+  }
+  return fmt::to_string(out);
+}
+
+/// Reads the binary file in the specified path and decodes it with the text
+/// formatter.
+static std::string decode_file_as_text(const std::string& path)
+{
+  std::ifstream      file(path, std::ios::binary);
+  fmt::memory_buffer buffer;
+  std::copy(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), std::back_inserter(buffer));
+  return decode_as_text(buffer);
+}
+
+static bool when_entry_with_args_is_encoded_then_decoded_text_is_identical()
+{
+  arg_store store;
+  store.push_back(-5);
+  store.push_back(7u);
+  store.push_back(-123456789012LL);
+  store.push_back(123456789012ULL);
+  store.push_back('c');
+  store.push_back(3.25);
+  store.push_back("string");
+  store.push_back(std::string("dynamic"));
+  const char* fmtstring = "Text %d %u %lld %llu %c %.2f %s %s";
+
+  fmt::memory_buffer buffer;
+  binary_log::format_file_header(buffer);
+  binary_formatter formatter;
+  formatter.format(build_log_entry_metadata(fmtstring, &store), buffer);
+  formatter.format(build_log_entry_metadata(fmtstring, &store), buffer);
+
+  std::string expected = format_as_text(build_log_entry_metadata(fmtstring, &store));
+  ASSERT_EQ(decode_as_text(buffer), expected + expected);
+
+  return true;
+}
+
+static bool when_entry_without_args_is_encoded_then_decoded_text_is_identical()
+{
+  auto entry = build_log_entry_metadata("Text %d", nullptr);
+  entry.hex_dump.resize(20);
+  std::iota(entry.hex_dump.begin(), entry.hex_dump.end(), 0);
+  entry.context.enabled = false;
+
+  fmt::memory_buffer buffer;
+  binary_log::format_file_header(buffer);
+  binary_formatter{}.format(detail::log_entry_metadata(entry), buffer);
+
+  ASSERT_EQ(decode_as_text(buffer), format_as_text(entry));
+
+  return true;
+}
+
+static bool when_entry_with_unsupported_arg_is_encoded_then_text_is_stored()
+{
+  arg_store store;
+  store.push_back(static_cast<__int128>(4));
+  store.push_back(2);
+
+  fmt::memory_buffer buffer;
+  binary_log::format_file_header(buffer);
+  binary_formatter formatter;
+  formatter.format(build_log_entry_metadata("Wide %d %d", &store), buffer);
+  // The format string and name definitions of the rejected entry are kept.
+  formatter.format(build_log_entry_metadata("Wide %d %d", nullptr), buffer);
+
+  std::string expected = format_as_text(build_log_entry_metadata("Wide %d %d", &store)) +
+                         format_as_text(build_log_entry_metadata("Wide %d %d", nullptr));
+  ASSERT_EQ(decode_as_text(buffer), expected);
+
+  return true;
+}
+
+static bool when_text_record_is_decoded_as_json_then_text_is_escaped()
+{
+  arg_store store;
+  store.push_back(static_cast<__int128>(4));
+  store.push_back(2);
+
+  fmt::memory_buffer buffer;
+  binary_log::format_file_header(buffer);
+  binary_formatter{}.format(build_log_entry_metadata("Quote \" \\ %d\t%d", &store), buffer);
+
+  std::string text = format_as_text(build_log_entry_metadata("Quote \" \\ %d\t%d", &store));
+  std::string expected;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      expected += '\\';
+      expected += c;
+    } else if (c == '\t') {
+      expected += "\\t";
+    } else if (c == '\n') {
+      expected += "\\n";
+    } else {
+      expected += c;
+    }
+  }
+  expected = "{\n  \"text\": \"" + expected + "\"\n}\n";
+
+  fmt::memory_buffer out;
+  binary_decoder     decoder(std::unique_ptr<log_formatter>(new text_formatter), true);
+  auto               err_str = decoder.decode(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size(), out);
+  ASSERT_EQ(static_cast<bool>(err_str), false);
+  ASSERT_EQ(fmt::to_string(out), expected);
+
+  return true;
+}
+
+static bool when_format_string_address_is_reused_then_new_string_is_defined()
+{
+  char fmtstring[16] = "First %d";
+
+  arg_store store;
+  store.push_back(1);
+
+  fmt::memory_buffer buffer;
+  binary_log::format_file_header(buffer);
+  binary_formatter formatter;
+  formatter.format(build_log_entry_metadata(fmtstring, &store), buffer);
+  std::string expected = format_as_text(build_log_entry_metadata(fmtstring, &store));
+
+  std::strcpy(fmtstring, "Second %d");
+  formatter.format(build_log_entry_metadata(fmtstring, &store), buffer);
+  expected += format_as_text(build_log_entry_metadata(fmtstring, &store));
+
+  ASSERT_EQ(decode_as_text(buffer), expected);
+
+  return true;
+}
+
+static bool when_file_is_truncated_then_decoding_fails()
+{
+  arg_store store;
+  store.push_back(1);
+
+  fmt::memory_buffer buffer;
+  binary_log::format_file_header(buffer);
+  binary_formatter{}.format(build_log_entry_metadata("Text %d", &store), buffer);
+  buffer.resize(buffer.size() - 1);
+
+  ASSERT_EQ(decode_as_text(buffer), std::string("Truncated record"));
+
+  return true;
+}
+
+static constexpr char log_filename[] = "binary_file_sink_test.log";
+
+static bool when_sink_rotates_files_then_each_file_is_decoded_independently()
+{
+  std::string                          filename0 = file_utils::build_filename_with_index(log_filename, 0);
+  std::string                          filename1 = file_utils::build_filename_with_index(log_filename, 1);
+  file_test_utils::scoped_file_deleter deleter   = {filename0, filename1};
+
+  std::string expected;
+  {
+    binary_file_sink sink(log_filename, 4096);
+
+    arg_store store;
+    store.push_back(std::string(100, 'x'));
+
+    for (unsigned i = 0; i != 40; ++i) {
+      fmt::memory_buffer buffer;
+      sink.get_formatter().format(build_log_entry_metadata("Entry %s", &store), buffer);
+      sink.write(detail::memory_buffer(buffer.data(), buffer.size()));
+
+      expected += format_as_text(build_log_entry_metadata("Entry %s", &store));
+    }
+    sink.flush();
+  }
+
+  // The second file does not repeat the entries of the first one, so it can
+  // only be decoded if it contains the string table.
+  ASSERT_EQ(file_test_utils::file_exists(filename1), true);
+  std::string text0 = decode_file_as_text(filename0);
+  std::string text1 = decode_file_as_text(filename1);
+  ASSERT_EQ(text1.empty(), false);
+  ASSERT_EQ(text0 + text1, expected);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_entry_with_args_is_encoded_then_decoded_text_is_identical);
+  TEST_FUNCTION(when_entry_without_args_is_encoded_then_decoded_text_is_identical);
+  TEST_FUNCTION(when_entry_with_unsupported_arg_is_encoded_then_text_is_stored);
+  TEST_FUNCTION(when_text_record_is_decoded_as_json_then_text_is_escaped);
+  TEST_FUNCTION(when_format_string_address_is_reused_then_new_string_is_defined);
+  TEST_FUNCTION(when_file_is_truncated_then_decoding_fails);
+  TEST_FUNCTION(when_sink_rotates_files_then_each_file_is_decoded_independently);
+
+  return 0;
+}
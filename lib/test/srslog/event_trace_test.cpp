@@ -46,6 +46,8 @@ public:
 
   bool is_running() const override { return true; }
 
+  uint64_t get_nof_dropped_entries() const override { return 0; }
+
   void reset() { count = 0; }
 
   unsigned push_invocation_count() const { return count; }
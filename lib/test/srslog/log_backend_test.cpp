@@ -22,6 +22,7 @@
 #include "src/srslog/log_backend_impl.h"
 #include "test_dummies.h"
 #include "testing_helpers.h"
+#include <thread>
 
 using namespace srslog;
 
@@ -233,6 +234,60 @@ static bool when_empty_handler_is_used_then_backend_does_not_crash()
   return true;
 }
 
+static bool when_thread_queue_is_full_then_log_entries_are_dropped_and_counted()
+{
+  test_dummies::sink_dummy s;
+
+  log_backend_impl backend;
+
+  // The backend is not started, so entries accumulate in the queue of this thread.
+  const unsigned nof_extra_entries = 5;
+  for (unsigned i = 0; i != SRSLOG_THREAD_QUEUE_CAPACITY + nof_extra_entries; ++i) {
+    backend.push(build_log_entry(&s, backend.alloc_arg_store()));
+  }
+
+  ASSERT_EQ(backend.get_nof_dropped_entries(), nof_extra_entries);
+
+  return true;
+}
+
+static bool when_log_entries_are_pushed_from_several_threads_then_they_are_processed_in_timestamp_order()
+{
+  using tp_ty = std::chrono::time_point<std::chrono::high_resolution_clock>;
+
+  test_dummies::sink_dummy s;
+  std::vector<int64_t>     order;
+
+  log_backend_impl backend;
+
+  // Each thread pushes entries with interleaved timestamps and exits before the backend starts.
+  auto producer = [&](int first) {
+    for (int i = first; i < 10; i += 2) {
+      auto entry        = build_log_entry(&s, backend.alloc_arg_store());
+      entry.metadata.tp = tp_ty(std::chrono::microseconds(i));
+      entry.format_func = [&order](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
+        order.push_back(std::chrono::duration_cast<std::chrono::microseconds>(metadata.tp.time_since_epoch()).count());
+      };
+      backend.push(std::move(entry));
+    }
+  };
+  std::thread t1(producer, 0);
+  t1.join();
+  std::thread t2(producer, 1);
+  t2.join();
+
+  backend.start();
+  // Stop the backend to ensure the entries have been processed.
+  backend.stop();
+
+  ASSERT_EQ(order.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(order[i], i);
+  }
+
+  return true;
+}
+
 int main()
 {
   TEST_FUNCTION(when_backend_is_started_then_is_started_returns_true);
@@ -243,6 +298,8 @@ int main()
   TEST_FUNCTION(when_sink_write_fails_then_error_handler_is_invoked);
   TEST_FUNCTION(when_handler_is_set_after_start_then_handler_is_not_used);
   TEST_FUNCTION(when_empty_handler_is_used_then_backend_does_not_crash);
+  TEST_FUNCTION(when_thread_queue_is_full_then_log_entries_are_dropped_and_counted);
+  TEST_FUNCTION(when_log_entries_are_pushed_from_several_threads_then_they_are_processed_in_timestamp_order);
 
   return 0;
 }
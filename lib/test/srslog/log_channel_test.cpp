@@ -80,6 +80,8 @@ public:
 
   bool is_running() const override { return true; }
 
+  uint64_t get_nof_dropped_entries() const override { return 0; }
+
   fmt::dynamic_format_arg_store<fmt::printf_context>* alloc_arg_store() override { return &store; }
 
   unsigned push_invocation_count() const { return count; }
@@ -108,7 +108,7 @@ private:
 
     void     metrics_read(phy_metrics_t* metrics);
     void     metrics_dl(uint32_t mcs);
-    void     metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters);
+    void     metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters, float turbo_time_us);
     void     metrics_ul_pucch(float rssi, float ni, float sinr);
     uint32_t get_rnti() const { return rnti; }
 
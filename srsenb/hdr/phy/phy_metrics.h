@@ -37,6 +37,7 @@ struct ul_metrics_t {
   float   pucch_rssi;
   float   pucch_ni;
   float   turbo_iters;
+  float   turbo_time_us;
   float   mcs;
   int     n_samples;
   int     n_samples_pucch;
@@ -43,6 +43,14 @@ typedef struct {
   uint16_t    bind_port;
 } pcap_net_args_t;
 
+typedef struct {
+  std::string format;               // pcap or pcapng
+  uint32_t    snap_len;             // Maximum captured bytes per PDU, 0 captures the whole PDU
+  std::string rnti_filter;          // Comma-separated RNTIs captured by the MAC pcap, empty captures all of them
+  uint32_t    trigger_history_size; // Bytes kept in memory until an RLF triggers the capture, 0 writes everything
+  uint32_t    trigger_post_ms;      // Time during which PDUs are written after a trigger
+} pcap_capture_args_t;
+
 typedef struct {
   bool        enable;
   std::string m1u_multiaddr;
@@ -69,15 +77,16 @@ typedef struct {
 } stack_log_args_t;
 
 typedef struct {
-  uint32_t         sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
-  uint32_t         gtpu_indirect_tunnel_timeout_msec;
-  mac_args_t       mac;
-  s1ap_args_t      s1ap;
-  pcap_args_t      mac_pcap;
-  pcap_net_args_t  mac_pcap_net;
-  pcap_args_t      s1ap_pcap;
-  stack_log_args_t log;
-  embms_args_t     embms;
+  uint32_t            sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
+  uint32_t            gtpu_indirect_tunnel_timeout_msec;
+  mac_args_t          mac;
+  s1ap_args_t         s1ap;
+  pcap_args_t         mac_pcap;
+  pcap_net_args_t     mac_pcap_net;
+  pcap_args_t         s1ap_pcap;
+  pcap_capture_args_t pcap_capture;
+  stack_log_args_t    log;
+  embms_args_t        embms;
 } stack_args_t;
 
 struct stack_metrics_t;
@@ -66,12 +66,28 @@ struct mac_cc_info_t {
   uint32_t cc_rach_counter;
 };
 
+/// HARQ softbuffer pool occupancy.
+struct mac_softbuffer_pool_metrics_t {
+  /// Number of Tx softbuffers held by DL HARQ processes.
+  uint32_t tx_in_use;
+  /// Number of Tx softbuffers allocated by the pool.
+  uint32_t tx_allocated;
+  /// Number of Rx softbuffers held by UL HARQ processes.
+  uint32_t rx_in_use;
+  /// Number of Rx softbuffers allocated by the pool.
+  uint32_t rx_allocated;
+  /// Memory allocated by the pool in bytes.
+  uint64_t nof_bytes;
+};
+
 /// Main MAC metrics.
 struct mac_metrics_t {
   /// Per CC info.
   std::vector<mac_cc_info_t> cc_info;
   /// Per UE MAC metrics.
   std::vector<mac_ue_metrics_t> ues;
+  /// HARQ softbuffer pool occupancy.
+  mac_softbuffer_pool_metrics_t softbuffer_pool;
 };
 
 } // namespace srsenb
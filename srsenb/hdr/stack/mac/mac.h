@@ -204,7 +204,7 @@ private:
   std::vector<sched_interface::dl_sched_po_info_t> pending_po_prachs = {};
 
   // Softbuffer pool
-  std::unique_ptr<srsran::obj_pool_itf<ue_cc_softbuffers> > softbuffer_pool;
+  std::unique_ptr<softbuffer_pool> harq_softbuffers;
 };
 
 } // namespace srsenb
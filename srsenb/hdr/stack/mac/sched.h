@@ -66,6 +66,14 @@ public:
   int dl_mac_buffer_state(uint16_t rnti, uint32_t ce_code, uint32_t nof_cmds = 1) final;
 
   int dl_ack_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack) final;
+  /// Same as dl_ack_info(), also returning the HARQ process and the DL TTI that the ACK was matched to
+  int dl_ack_info(uint32_t           tti,
+                  uint16_t           rnti,
+                  uint32_t           enb_cc_idx,
+                  uint32_t           tb_idx,
+                  bool               ack,
+                  uint32_t&          pid,
+                  srsran::tti_point& tti_tx_dl);
   int dl_rach_info(uint32_t enb_cc_idx, dl_sched_rar_info_t rar_info) final;
   int dl_ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_value) final;
   int dl_pmi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t pmi_value) final;
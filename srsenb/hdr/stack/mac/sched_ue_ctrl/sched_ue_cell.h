@@ -61,7 +61,12 @@ struct sched_ue_cell {
 
   uint32_t get_aggr_level(uint32_t nof_bits) const;
 
-  int set_ack_info(tti_point tti_rx, uint32_t tb_idx, bool ack);
+  /// Sets the ACK of a DL TB. If the ACK matches a HARQ process, its id and DL TTI are written to pid and tti_tx_dl
+  int set_ack_info(tti_point  tti_rx,
+                   uint32_t   tb_idx,
+                   bool       ack,
+                   uint32_t*  pid       = nullptr,
+                   tti_point* tti_tx_dl = nullptr);
   int set_ul_crc(tti_point tti_rx, bool crc_res);
   int set_ul_snr(tti_point tti_rx, float ul_snr, uint32_t ul_ch_code);
 
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_SOFTBUFFER_POOL_H
+#define SRSENB_SOFTBUFFER_POOL_H
+
+#include "common/mac_metrics.h"
+#include "srsran/adt/pool/pool_interface.h"
+#include "srsran/common/common.h"
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/fec/softbuffer.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace srsenb {
+
+/// Tx softbuffer with room for a fixed number of code blocks
+class tx_softbuffer
+{
+public:
+  explicit tx_softbuffer(uint32_t max_cb) { srsran_softbuffer_tx_init_guru(&buffer, max_cb, SOFTBUFFER_SIZE); }
+  tx_softbuffer(const tx_softbuffer&) = delete;
+  tx_softbuffer(tx_softbuffer&&)      = delete;
+  tx_softbuffer& operator=(const tx_softbuffer&) = delete;
+  tx_softbuffer& operator=(tx_softbuffer&&) = delete;
+  ~tx_softbuffer() { srsran_softbuffer_tx_free(&buffer); }
+
+  srsran_softbuffer_tx_t* get() { return &buffer; }
+
+private:
+  srsran_softbuffer_tx_t buffer = {};
+};
+
+/// Rx softbuffer with room for a fixed number of code blocks
+class rx_softbuffer
+{
+public:
+  rx_softbuffer(uint32_t max_cb, srsran_softbuffer_llr_t llr_format)
+  {
+    srsran_softbuffer_rx_init_llr(&buffer, max_cb, SOFTBUFFER_SIZE, llr_format);
+  }
+  rx_softbuffer(const rx_softbuffer&) = delete;
+  rx_softbuffer(rx_softbuffer&&)      = delete;
+  rx_softbuffer& operator=(const rx_softbuffer&) = delete;
+  rx_softbuffer& operator=(rx_softbuffer&&) = delete;
+  ~rx_softbuffer() { srsran_softbuffer_rx_free(&buffer); }
+
+  srsran_softbuffer_rx_t* get() { return &buffer; }
+
+private:
+  srsran_softbuffer_rx_t buffer = {};
+};
+
+/**
+ * Pool of HARQ softbuffers shared by all the UEs and carriers of the eNB.
+ *
+ * Softbuffers are grouped in size classes of 1, 2, 4, ... code blocks, the last class fitting the largest TB of the
+ * cell bandwidth. A HARQ process takes a softbuffer of the smallest class that fits its TB when it starts a new
+ * transmission, and the softbuffer goes back to the pool when the returned pointer is reset. Rx softbuffers store the
+ * soft bits with the given LLR format.
+ */
+class softbuffer_pool
+{
+public:
+  explicit softbuffer_pool(uint32_t                nof_prb,
+                           srsran_softbuffer_llr_t llr_format = SRSRAN_SOFTBUFFER_LLR_16BIT,
+                           uint32_t                batch_size = SRSRAN_FDD_NOF_HARQ);
+  softbuffer_pool(const softbuffer_pool&) = delete;
+  softbuffer_pool(softbuffer_pool&&)      = delete;
+  softbuffer_pool& operator=(const softbuffer_pool&) = delete;
+  softbuffer_pool& operator=(softbuffer_pool&&) = delete;
+  ~softbuffer_pool();
+
+  /// Get a Tx softbuffer that fits a TB of tbs_bits
+  srsran::unique_pool_ptr<tx_softbuffer> get_tx(uint32_t tbs_bits);
+
+  /// Get an Rx softbuffer that fits a TB of tbs_bits. The code blocks of the TB are reset
+  srsran::unique_pool_ptr<rx_softbuffer> get_rx(uint32_t tbs_bits);
+
+  void get_metrics(mac_softbuffer_pool_metrics_t& metrics) const;
+
+private:
+  /// Up to 32 code blocks, more than the 17 of a 100 PRB TB
+  const static uint32_t MAX_NOF_SIZE_CLASSES = 6;
+
+  template <typename T>
+  struct size_class_pool {
+    std::unique_ptr<srsran::obj_pool_itf<T> > pool;
+    uint32_t                                  max_cb = 0;
+    std::atomic<uint32_t>                     nof_allocated{0};
+    std::atomic<uint32_t>                     nof_in_use{0};
+  };
+
+  uint32_t get_size_class(uint32_t tbs_bits) const;
+
+  srsran_softbuffer_llr_t                                           llr_format;
+  uint32_t                                                          nof_size_classes = 0;
+  std::array<size_class_pool<tx_softbuffer>, MAX_NOF_SIZE_CLASSES> tx_pools;
+  std::array<size_class_pool<rx_softbuffer>, MAX_NOF_SIZE_CLASSES> rx_pools;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_SOFTBUFFER_POOL_H
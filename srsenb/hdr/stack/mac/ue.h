@@ -24,6 +24,7 @@
 
 #include "common/mac_metrics.h"
 #include "sched_interface.h"
+#include "softbuffer_pool.h"
 #include "srsran/adt/circular_array.h"
 #include "srsran/adt/circular_map.h"
 #include "srsran/adt/pool/pool_interface.h"
@@ -36,6 +37,8 @@
 #include "srsran/srslog/srslog.h"
 
 #include "ta.h"
+#include <limits>
+#include <mutex>
 #include <pthread.h>
 #include <vector>
 
@@ -45,28 +48,40 @@ class rrc_interface_mac;
 class rlc_interface_mac;
 class phy_interface_stack_lte;
 
-/// Class to manage the allocation, deallocation & access to UE carrier DL + UL softbuffers
-struct ue_cc_softbuffers {
-  // List of Tx softbuffers for all HARQ processes of one carrier
-  using cc_softbuffer_tx_list_t = std::vector<srsran_softbuffer_tx_t>;
-  // List of Rx softbuffers for all HARQ processes of one carrier
-  using cc_softbuffer_rx_list_t = std::vector<srsran_softbuffer_rx_t>;
-
-  const uint32_t          nof_tx_harq_proc;
-  const uint32_t          nof_rx_harq_proc;
-  cc_softbuffer_tx_list_t softbuffer_tx_list;
-  cc_softbuffer_rx_list_t softbuffer_rx_list;
-
-  ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_);
-  ue_cc_softbuffers(ue_cc_softbuffers&&) noexcept = default;
-  ~ue_cc_softbuffers();
+/// Class to manage the access to UE carrier DL + UL softbuffers. Each HARQ process takes a softbuffer sized to its TB
+/// from the shared softbuffer_pool when it starts a new transmission, and returns it once the TB is acknowledged or
+/// the maximum number of transmissions is reached.
+class ue_cc_softbuffers
+{
+public:
+  void set_pool(softbuffer_pool* pool_);
+  bool has_pool() const { return pool != nullptr; }
   void clear();
 
-  srsran_softbuffer_tx_t& get_tx(uint32_t pid, uint32_t tb_idx)
-  {
-    return softbuffer_tx_list.at(pid * SRSRAN_MAX_TB + tb_idx);
-  }
-  srsran_softbuffer_rx_t& get_rx(uint32_t tti) { return softbuffer_rx_list.at(tti % nof_rx_harq_proc); }
+  srsran_softbuffer_tx_t* get_tx(uint32_t tti_tx_dl, uint32_t pid, uint32_t tb_idx, uint32_t tbs_bits, bool ndi);
+  void                    set_ack(uint32_t tti_tx_dl, uint32_t pid, uint32_t tb_idx, bool ack, uint32_t max_nof_tx);
+
+  srsran_softbuffer_rx_t* get_rx(uint32_t tti_tx_ul, uint32_t tbs_bits, uint32_t current_tx_nb, uint32_t max_nof_tx);
+  void                    set_crc(uint32_t tti_rx, bool crc);
+
+private:
+  struct dl_harq_softbuffer_t {
+    srsran::unique_pool_ptr<tx_softbuffer> softbuffer;
+    bool                                   ndi    = false;
+    uint32_t                               nof_tx = 0;
+    uint32_t                               tti_tx = std::numeric_limits<uint32_t>::max();
+  };
+  struct ul_harq_softbuffer_t {
+    srsran::unique_pool_ptr<rx_softbuffer> softbuffer;
+    bool                                   last_tx = false;
+  };
+
+  softbuffer_pool* pool = nullptr;
+  std::mutex       mutex;
+
+  std::array<std::array<dl_harq_softbuffer_t, SRSRAN_MAX_TB>, SRSRAN_FDD_NOF_HARQ> dl_harqs;
+  // UL HARQ processes are indexed by TTI
+  std::array<ul_harq_softbuffer_t, SRSRAN_FDD_NOF_HARQ> ul_harqs;
 };
 
 /// Class to manage the allocation, deallocation & access to pending UL HARQ buffers
@@ -102,16 +117,12 @@ public:
   ~cc_buffer_handler();
 
   void reset();
-  void allocate_cc(srsran::unique_pool_ptr<ue_cc_softbuffers> cc_softbuffers_);
+  void allocate_cc(softbuffer_pool* softbuffers_);
   void deallocate_cc();
 
-  bool                    empty() const { return cc_softbuffers == nullptr; }
-  srsran_softbuffer_tx_t& get_tx_softbuffer(uint32_t pid, uint32_t tb_idx)
-  {
-    return cc_softbuffers->get_tx(pid, tb_idx);
-  }
-  srsran_softbuffer_rx_t& get_rx_softbuffer(uint32_t tti) { return cc_softbuffers->get_rx(tti); }
-  srsran::byte_buffer_t*  get_tx_payload_buffer(size_t harq_pid, size_t tb)
+  bool                   empty() const { return not cc_softbuffers.has_pool(); }
+  ue_cc_softbuffers&     get_softbuffers() { return cc_softbuffers; }
+  srsran::byte_buffer_t* get_tx_payload_buffer(size_t harq_pid, size_t tb)
   {
     return tx_payload_buffer[harq_pid][tb].get();
   }
@@ -119,7 +130,7 @@ public:
 
 private:
   // CC softbuffers
-  srsran::unique_pool_ptr<ue_cc_softbuffers> cc_softbuffers;
+  ue_cc_softbuffers cc_softbuffers;
 
   // buffers
   cc_used_buffers_map rx_used_buffers;
@@ -131,15 +142,15 @@ private:
 class ue : public srsran::read_pdu_interface, public mac_ta_ue_interface
 {
 public:
-  ue(uint16_t                                 rnti,
-     uint32_t                                 enb_cc_idx,
-     sched_interface*                         sched,
-     rrc_interface_mac*                       rrc_,
-     rlc_interface_mac*                       rlc,
-     phy_interface_stack_lte*                 phy_,
-     srslog::basic_logger&                    logger,
-     uint32_t                                 nof_cells_,
-     srsran::obj_pool_itf<ue_cc_softbuffers>* softbuffer_pool);
+  ue(uint16_t                 rnti,
+     uint32_t                 enb_cc_idx,
+     sched_interface*         sched,
+     rrc_interface_mac*       rrc_,
+     rlc_interface_mac*       rlc,
+     phy_interface_stack_lte* phy_,
+     srslog::basic_logger&    logger,
+     uint32_t                 nof_cells_,
+     softbuffer_pool*         softbuffers_);
 
   virtual ~ue();
   void reset();
@@ -168,8 +179,16 @@ public:
                             uint32_t                             nof_pdu_elems,
                             uint32_t                             grant_size);
 
-  srsran_softbuffer_tx_t* get_tx_softbuffer(uint32_t enb_cc_idx, uint32_t harq_process, uint32_t tb_idx);
-  srsran_softbuffer_rx_t* get_rx_softbuffer(uint32_t enb_cc_idx, uint32_t tti);
+  srsran_softbuffer_tx_t* get_tx_softbuffer(uint32_t enb_cc_idx,
+                                            uint32_t tti_tx_dl,
+                                            uint32_t harq_process,
+                                            uint32_t tb_idx,
+                                            uint32_t tbs_bytes,
+                                            bool     ndi);
+  srsran_softbuffer_rx_t*
+       get_rx_softbuffer(uint32_t enb_cc_idx, uint32_t tti_tx_ul, uint32_t tbs_bytes, uint32_t current_tx_nb);
+  void dl_ack_info(uint32_t enb_cc_idx, uint32_t tti_tx_dl, uint32_t pid, uint32_t tb_idx, bool ack);
+  void ul_crc_info(uint32_t enb_cc_idx, uint32_t tti_rx, bool crc);
 
   uint8_t* request_buffer(uint32_t tti, uint32_t enb_cc_idx, uint32_t len);
   void     process_pdu(srsran::unique_byte_buffer_t pdu, uint32_t ue_cc_idx, uint32_t grant_nof_prbs);
@@ -214,7 +233,8 @@ private:
   uint32_t         dl_pmi_counter = 0;
   mac_ue_metrics_t ue_metrics     = {};
 
-  srsran::obj_pool_itf<ue_cc_softbuffers>* softbuffer_pool = nullptr;
+  softbuffer_pool*      softbuffers = nullptr;
+  std::atomic<uint32_t> max_nof_harq_tx{sched_interface::ue_cfg_t{}.maxharq_tx};
 
   srsran::block_queue<uint32_t> pending_ta_commands;
   ta                            ta_fsm;
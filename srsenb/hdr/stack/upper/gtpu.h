@@ -25,7 +25,8 @@
 
 #include "srsenb/hdr/common/common_enb.h"
 #include "srsran/adt/bounded_vector.h"
-#include "srsran/adt/circular_map.h"
+#include "srsran/adt/circular_buffer.h"
+#include "srsran/adt/optional.h"
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/network_utils.h"
 #include "srsran/common/task_scheduler.h"
@@ -104,8 +105,8 @@ public:
   explicit gtpu_tunnel_manager(srsran::task_sched_handle task_sched_, srslog::basic_logger& logger);
   void init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_);
 
-  bool                           has_teid(uint32_t teid) const { return tunnels.contains(teid); }
-  const tunnel*                  find_tunnel(uint32_t teid);
+  bool                           has_teid(uint32_t teid) const { return tunnels.find(teid) != nullptr; }
+  const tunnel*                  find_tunnel(uint32_t teid) { return tunnels.find(teid); }
   ue_bearer_tunnel_list*         find_rnti_tunnels(uint16_t rnti);
   srsran::span<bearer_teid_pair> find_rnti_bearer_tunnels(uint16_t rnti, uint32_t eps_bearer_id);
 
@@ -124,8 +125,50 @@ public:
   bool remove_rnti(uint16_t rnti);
 
 private:
-  using tunnel_list_t  = srsran::static_id_obj_pool<uint32_t, tunnel, SRSENB_MAX_UES * MAX_TUNNELS_PER_UE>;
-  using tunnel_ctxt_it = typename tunnel_list_t::iterator;
+  /// Flat table of tunnels indexed by TEID. The lower bits of a TEID are the index of its slot, and the upper bits are
+  /// the generation of the slot, which is incremented whenever the slot is released. A lookup is thus a mask and a
+  /// compare, and a stale TEID never resolves to the tunnel that reused its slot. Released slots are reused in FIFO
+  /// order, to delay the reuse of their index as much as possible.
+  class tunnel_table
+  {
+  public:
+    tunnel_table() = default;
+    ~tunnel_table();
+    tunnel_table(const tunnel_table&) = delete;
+    tunnel_table& operator=(const tunnel_table&) = delete;
+
+    /// Allocates the slots. Must not be called while there are tunnels in the table.
+    void resize(uint32_t max_tunnels);
+
+    tunnel* find(uint32_t teid)
+    {
+      slot_t& slot = slots[teid & index_mask];
+      return (slot.tun.has_value() and slot.tun->teid_in == teid) ? &slot.tun.value() : nullptr;
+    }
+    const tunnel* find(uint32_t teid) const { return const_cast<tunnel_table*>(this)->find(teid); }
+    tunnel&       operator[](uint32_t teid)
+    {
+      tunnel* tun = find(teid);
+      srsran_assert(tun != nullptr, "Accessing non-existent TEID=0x%x", teid);
+      return *tun;
+    }
+
+    /// Creates a tunnel with a new TEID In.
+    /// @return nullptr if the table is full
+    tunnel* insert();
+    void    erase(uint32_t teid);
+
+  private:
+    struct slot_t {
+      uint32_t                 generation = 1;
+      srsran::optional<tunnel> tun;
+    };
+
+    uint32_t                              index_bits = 0;
+    uint32_t                              index_mask = 0;
+    std::vector<slot_t>                   slots;
+    srsran::dyn_circular_buffer<uint32_t> free_slots;
+  };
 
   srsran::task_sched_handle task_sched;
   const gtpu_args_t*        gtpu_args = nullptr;
@@ -133,7 +176,7 @@ private:
   srslog::basic_logger&     logger;
 
   std::unordered_map<uint16_t, ue_bearer_tunnel_list> ue_teidin_db;
-  tunnel_list_t                     tunnels;
+  tunnel_table                                        tunnels;
 };
 
 using gtpu_tunnel_state = gtpu_tunnel_manager::tunnel_state;
@@ -218,8 +218,9 @@ bool enb::get_metrics(enb_metrics_t* m)
   if (nr_stack) {
     nr_stack->get_metrics(&m->nr_stack);
   }
-  m->running = true;
-  m->sys     = sys_proc.get_metrics();
+  m->running          = true;
+  m->sys              = sys_proc.get_metrics();
+  m->byte_buffer_pool = srsran::byte_buffer_pool::get_instance()->get_metrics();
   return true;
 }
 
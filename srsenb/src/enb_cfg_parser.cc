@@ -1867,6 +1867,10 @@ int set_derived_args(all_args_t* args_, rrc_cfg_t* rrc_cfg_, phy_cfg_t* phy_cfg_
                    "mac.nof_prealloc_ues=%d must be within [0, %d]",
                    args_->stack.mac.nof_prealloc_ues,
                    SRSENB_MAX_UES);
+  ASSERT_VALID_CFG(args_->stack.mac.pusch_softbuffer_bits == 16 or args_->stack.mac.pusch_softbuffer_bits == 8 or
+                       args_->stack.mac.pusch_softbuffer_bits == 4,
+                   "expert.pusch_softbuffer_bits=%d must be 16, 8 or 4",
+                   args_->stack.mac.pusch_softbuffer_bits);
 
   // Check for a forced  DL EARFCN or frequency (only valid for a single cell config
   if (rrc_cfg_->cell_list.size() > 0) {
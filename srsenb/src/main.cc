@@ -154,6 +154,11 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("pcap.bind_port", bpo::value<uint16_t>(&args->stack.mac_pcap_net.bind_port)->default_value(5687),        "Bind port for MAC network trace")
     ("pcap.client_ip", bpo::value<string>(&args->stack.mac_pcap_net.client_ip)->default_value("127.0.0.1"),     "Client IP address for MAC network trace")
     ("pcap.client_port", bpo::value<uint16_t>(&args->stack.mac_pcap_net.client_port)->default_value(5847),    "Enable MAC network captures")
+    ("pcap.format", bpo::value<string>(&args->stack.pcap_capture.format)->default_value("pcap"), "Format of the MAC and S1AP captures (pcap or pcapng)")
+    ("pcap.snap_len", bpo::value<uint32_t>(&args->stack.pcap_capture.snap_len)->default_value(0), "Maximum captured bytes per PDU, context included. 0 captures the whole PDU")
+    ("pcap.rnti_filter", bpo::value<string>(&args->stack.pcap_capture.rnti_filter)->default_value(""), "Comma-separated list of RNTIs captured by the MAC pcap. Empty captures all of them")
+    ("pcap.trigger_history_size", bpo::value<uint32_t>(&args->stack.pcap_capture.trigger_history_size)->default_value(0), "Bytes of PDUs kept in memory until a radio link failure triggers the capture. 0 writes all PDUs")
+    ("pcap.trigger_post_ms", bpo::value<uint32_t>(&args->stack.pcap_capture.trigger_post_ms)->default_value(5000), "Time during which PDUs are written after a trigger")
 
     /* Scheduling section */
     ("scheduler.policy", bpo::value<string>(&args->stack.mac.sched.sched_policy)->default_value("time_pf"), "DL and UL data scheduling policy (E.g. time_rr, time_pf)")
@@ -235,6 +240,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.metrics_csv_enable",  bpo::value<bool>(&args->general.metrics_csv_enable)->default_value(false), "Write metrics to CSV file.")
     ("expert.metrics_csv_filename", bpo::value<string>(&args->general.metrics_csv_filename)->default_value("/tmp/enb_metrics.csv"), "Metrics CSV filename.")
     ("expert.pusch_max_its", bpo::value<uint32_t>(&args->phy.pusch_max_its)->default_value(8), "Maximum number of turbo decoder iterations for LTE.")
+    ("expert.pusch_nof_turbo_threads", bpo::value<uint32_t>(&args->phy.pusch_nof_turbo_threads)->default_value(1), "Number of threads decoding the turbo code blocks of a PUSCH transmission, per PHY worker.")
+    ("expert.pusch_softbuffer_bits", bpo::value<uint32_t>(&args->stack.mac.pusch_softbuffer_bits)->default_value(16), "Number of bits per soft bit stored in the PUSCH HARQ softbuffers: 16, 8 or 4 (Experimental).")
     ("expert.pusch_8bit_decoder", bpo::value<bool>(&args->phy.pusch_8bit_decoder)->default_value(false), "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental).")
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure.")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor.")
@@ -287,6 +294,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.nr_pdsch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_dl_mcs)->default_value(28), "Fixed NR DL MCS (-1 for dynamic).")
     ("scheduler.nr_pusch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_ul_mcs)->default_value(28), "Fixed NR UL MCS (-1 for dynamic).")
     ("expert.nr_pusch_max_its", bpo::value<uint32_t>(&args->phy.nr_pusch_max_its)->default_value(10),     "Maximum number of LDPC iterations for NR.")
+    ("expert.nr_pusch_nof_ldpc_threads", bpo::value<uint32_t>(&args->phy.nr_pusch_nof_ldpc_threads)->default_value(1), "Number of threads decoding the LDPC code blocks of an NR PUSCH transmission, per PHY worker.")
   ;
 
   // Positional options - config file location
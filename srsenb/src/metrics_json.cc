@@ -95,13 +95,30 @@ DECLARE_METRIC("nof_rach", metric_nof_rach, uint32_t, "");
 DECLARE_METRIC_LIST("ue_list", mlist_ues, std::vector<mset_ue_container>);
 DECLARE_METRIC_SET("cell_container", mset_cell_container, metric_carrier_id, metric_pci, metric_nof_rach, mlist_ues);
 
+/// Byte buffer pool metrics.
+DECLARE_METRIC("nof_blocks", metric_pool_nof_blocks, uint64_t, "");
+DECLARE_METRIC("nof_central_blocks", metric_pool_nof_central_blocks, uint64_t, "");
+DECLARE_METRIC("max_local_cache_size", metric_pool_max_local_cache_size, uint64_t, "");
+DECLARE_METRIC("nof_allocs", metric_pool_nof_allocs, uint64_t, "");
+DECLARE_METRIC("nof_central_refills", metric_pool_nof_central_refills, uint64_t, "");
+DECLARE_METRIC("nof_failed_allocs", metric_pool_nof_failed_allocs, uint64_t, "");
+DECLARE_METRIC_SET("byte_buffer_pool",
+                   mset_byte_buffer_pool,
+                   metric_pool_nof_blocks,
+                   metric_pool_nof_central_blocks,
+                   metric_pool_max_local_cache_size,
+                   metric_pool_nof_allocs,
+                   metric_pool_nof_central_refills,
+                   metric_pool_nof_failed_allocs);
+
 /// Metrics root object.
 DECLARE_METRIC("type", metric_type_tag, std::string, "");
 DECLARE_METRIC("timestamp", metric_timestamp_tag, double, "");
 DECLARE_METRIC_LIST("cell_list", mlist_cell, std::vector<mset_cell_container>);
 
 /// Metrics context.
-using metric_context_t = srslog::build_context_type<metric_type_tag, metric_timestamp_tag, mlist_cell>;
+using metric_context_t =
+    srslog::build_context_type<metric_type_tag, metric_timestamp_tag, mlist_cell, mset_byte_buffer_pool>;
 
 } // namespace
 
@@ -238,6 +255,15 @@ void metrics_json::set_metrics(const enb_metrics_t& m, const uint32_t period_use
     }
   }
 
+  // Fill the byte buffer pool metrics.
+  auto& pool = ctx.get<mset_byte_buffer_pool>();
+  pool.write<metric_pool_nof_blocks>(m.byte_buffer_pool.nof_blocks);
+  pool.write<metric_pool_nof_central_blocks>(m.byte_buffer_pool.nof_central_blocks);
+  pool.write<metric_pool_max_local_cache_size>(m.byte_buffer_pool.max_local_cache_size);
+  pool.write<metric_pool_nof_allocs>(m.byte_buffer_pool.nof_allocs);
+  pool.write<metric_pool_nof_central_refills>(m.byte_buffer_pool.nof_central_refills);
+  pool.write<metric_pool_nof_failed_allocs>(m.byte_buffer_pool.nof_failed_allocs);
+
   // Log the context.
   ctx.write<metric_timestamp_tag>(get_time_stamp());
   log_c(ctx);
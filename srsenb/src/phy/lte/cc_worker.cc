@@ -156,6 +156,11 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
   }
+
+  if (srsran_sch_set_decoder_threads(&enb_ul.pusch.ul_sch, phy->params.pusch_nof_turbo_threads) < SRSRAN_SUCCESS) {
+    ERROR("Error creating PUSCH turbo decoder threads");
+    exit(-1);
+  }
   initiated = true;
 
 #ifdef DEBUG_WRITE_FILE
@@ -375,7 +380,8 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     ue_db[rnti]->metrics_ul(ul_grant.dci.tb.mcs_idx,
                             enb_ul.chest_res.epre_dBfs - phy->params.rx_gain_offset,
                             enb_ul.chest_res.snr_db,
-                            pusch_res.avg_iterations_block);
+                            pusch_res.avg_iterations_block,
+                            (float)pusch_res.decode_time_us);
   }
   return true;
 }
@@ -680,15 +686,16 @@ void cc_worker::ue::metrics_dl(uint32_t mcs)
   metrics.dl.n_samples++;
 }
 
-void cc_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters)
+void cc_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters, float turbo_time_us)
 {
   if (isnan(rssi)) {
     rssi = 0;
   }
-  metrics.ul.mcs         = SRSRAN_VEC_CMA((float)mcs, metrics.ul.mcs, metrics.ul.n_samples);
-  metrics.ul.pusch_sinr  = SRSRAN_VEC_CMA((float)sinr, metrics.ul.pusch_sinr, metrics.ul.n_samples);
-  metrics.ul.pusch_rssi  = SRSRAN_VEC_CMA((float)rssi, metrics.ul.pusch_rssi, metrics.ul.n_samples);
-  metrics.ul.turbo_iters = SRSRAN_VEC_CMA((float)turbo_iters, metrics.ul.turbo_iters, metrics.ul.n_samples);
+  metrics.ul.mcs           = SRSRAN_VEC_CMA((float)mcs, metrics.ul.mcs, metrics.ul.n_samples);
+  metrics.ul.pusch_sinr    = SRSRAN_VEC_CMA((float)sinr, metrics.ul.pusch_sinr, metrics.ul.n_samples);
+  metrics.ul.pusch_rssi    = SRSRAN_VEC_CMA((float)rssi, metrics.ul.pusch_rssi, metrics.ul.n_samples);
+  metrics.ul.turbo_iters   = SRSRAN_VEC_CMA((float)turbo_iters, metrics.ul.turbo_iters, metrics.ul.n_samples);
+  metrics.ul.turbo_time_us = SRSRAN_VEC_CMA(turbo_time_us, metrics.ul.turbo_time_us, metrics.ul.n_samples);
   metrics.ul.n_samples++;
 }
 
@@ -267,6 +267,7 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
       metrics[j].ul.pucch_ni += metrics_tmp[j].ul.n_samples_pucch * metrics_tmp[j].ul.pucch_ni;
       metrics[j].ul.pucch_sinr += metrics_tmp[j].ul.n_samples_pucch * metrics_tmp[j].ul.pucch_sinr;
       metrics[j].ul.turbo_iters += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.turbo_iters;
+      metrics[j].ul.turbo_time_us += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.turbo_time_us;
     }
   }
   for (uint32_t j = 0; j < metrics.size(); j++) {
@@ -282,6 +283,7 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
       metrics[j].ul.pucch_ni /= metrics[j].ul.n_samples_pucch;
       metrics[j].ul.pucch_sinr /= metrics[j].ul.n_samples_pucch;
       metrics[j].ul.turbo_iters /= metrics[j].ul.n_samples;
+      metrics[j].ul.turbo_time_us /= metrics[j].ul.n_samples;
     }
   }
 }
@@ -376,6 +378,7 @@ int phy::init_nr(const phy_args_t& args, const phy_cfg_t& cfg, stack_interface_p
   worker_args.log.phy_level           = args.log.phy_level;
   worker_args.log.phy_hex_limit       = args.log.phy_hex_limit;
   worker_args.pusch_max_its           = args.nr_pusch_max_its;
+  worker_args.pusch_nof_ldpc_threads  = args.nr_pusch_nof_ldpc_threads;
 
   if (not nr_workers->init(worker_args, cfg.phy_cell_cfg_nr)) {
     return SRSRAN_ERROR;
@@ -32,6 +32,23 @@ using namespace srsran;
 
 namespace srsenb {
 
+static bool make_pcap_writer_args(const pcap_capture_args_t&   args,
+                                  const std::string&           if_name,
+                                  srsran::pcap_writer::args_t& writer_args)
+{
+  if (args.format == "pcapng") {
+    writer_args.format = srsran::pcap_format_t::pcapng;
+  } else if (args.format != "pcap") {
+    srsran::console("Error: invalid pcap format %s. Valid values are pcap and pcapng\n", args.format.c_str());
+    return false;
+  }
+  writer_args.if_name              = if_name;
+  writer_args.snap_len             = args.snap_len;
+  writer_args.trigger_history_size = args.trigger_history_size;
+  writer_args.trigger_post_ms      = args.trigger_post_ms;
+  return true;
+}
+
 enb_stack_lte::enb_stack_lte(srslog::sink& log_sink) :
   thread("STACK"),
   mac_logger(srslog::fetch_basic_logger("MAC", log_sink)),
@@ -100,7 +117,15 @@ int enb_stack_lte::init(const stack_args_t&      args_,
 
   // Set up pcap and trace
   if (args.mac_pcap.enable) {
-    mac_pcap.open(args.mac_pcap.filename);
+    srsran::pcap_writer::args_t writer_args;
+    srsran::pcap_filter         filter;
+    if (not make_pcap_writer_args(args.pcap_capture, "mac", writer_args) or
+        not filter.parse(args.pcap_capture.rnti_filter)) {
+      stack_logger.error("Invalid MAC pcap configuration");
+      return SRSRAN_ERROR;
+    }
+    mac_pcap.set_filter(filter);
+    mac_pcap.open(args.mac_pcap.filename, 0, writer_args);
     mac.start_pcap(&mac_pcap);
   }
 
@@ -113,7 +138,12 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   }
 
   if (args.s1ap_pcap.enable) {
-    s1ap_pcap.open(args.s1ap_pcap.filename.c_str());
+    srsran::pcap_writer::args_t writer_args;
+    if (not make_pcap_writer_args(args.pcap_capture, "s1ap", writer_args)) {
+      stack_logger.error("Invalid S1AP pcap configuration");
+      return SRSRAN_ERROR;
+    }
+    s1ap_pcap.open(args.s1ap_pcap.filename.c_str(), writer_args);
     s1ap.start_pcap(&s1ap_pcap);
   }
 
@@ -23,7 +23,6 @@
 #include <string.h>
 
 #include "srsenb/hdr/stack/mac/mac.h"
-#include "srsran/adt/pool/obj_pool.h"
 #include "srsran/common/rwlock_guard.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/time_prof.h"
@@ -80,13 +79,13 @@ bool mac::init(const mac_args_t&        args_,
   }
 
   // Initiate common pool of softbuffers
-  uint32_t nof_prb          = args.nof_prb;
-  auto     init_softbuffers = [nof_prb](void* ptr) {
-    new (ptr) ue_cc_softbuffers(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ);
-  };
-  auto recycle_softbuffers = [](ue_cc_softbuffers& softbuffers) { softbuffers.clear(); };
-  softbuffer_pool.reset(new srsran::background_obj_pool<ue_cc_softbuffers>(
-      8, 8, args.nof_prealloc_ues, init_softbuffers, recycle_softbuffers));
+  srsran_softbuffer_llr_t llr_format = SRSRAN_SOFTBUFFER_LLR_16BIT;
+  if (args.pusch_softbuffer_bits == 8) {
+    llr_format = SRSRAN_SOFTBUFFER_LLR_8BIT;
+  } else if (args.pusch_softbuffer_bits == 4) {
+    llr_format = SRSRAN_SOFTBUFFER_LLR_4BIT;
+  }
+  harq_softbuffers.reset(new softbuffer_pool(args.nof_prb, llr_format));
 
   detected_rachs.resize(cells.size());
 
@@ -256,6 +255,9 @@ void mac::get_metrics(mac_metrics_t& metrics)
     scheduler.metrics_read(u.first, ue_metrics);
     ue_metrics.pci = (ue_metrics.cc_idx < cell_config.size()) ? cell_config[ue_metrics.cc_idx].cell.id : 0;
   }
+  if (harq_softbuffers != nullptr) {
+    harq_softbuffers->get_metrics(metrics.softbuffer_pool);
+  }
   metrics.cc_info.resize(detected_rachs.size());
   for (unsigned cc = 0, e = detected_rachs.size(); cc != e; ++cc) {
     metrics.cc_info[cc].cc_rach_counter = detected_rachs[cc];
@@ -294,7 +296,13 @@ int mac::ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
     return SRSRAN_ERROR;
   }
 
-  int nof_bytes = scheduler.dl_ack_info(tti_rx, rnti, enb_cc_idx, tb_idx, ack);
+  // The scheduler matches the ACK to a HARQ process with the cell HARQ timing, its softbuffer is released by pid
+  uint32_t          pid = 0;
+  srsran::tti_point tti_tx_dl;
+  int               nof_bytes = scheduler.dl_ack_info(tti_rx, rnti, enb_cc_idx, tb_idx, ack, pid, tti_tx_dl);
+  if (nof_bytes > 0) {
+    ue_db[rnti]->dl_ack_info(enb_cc_idx, tti_tx_dl.to_uint(), pid, tb_idx, ack);
+  }
   ue_db[rnti]->metrics_tx(ack, nof_bytes);
 
   rrc_h->set_radiolink_dl_state(rnti, ack);
@@ -316,6 +324,9 @@ int mac::crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
 
   rrc_h->set_radiolink_ul_state(rnti, crc);
 
+  // Release the softbuffer before the scheduler can reuse the HARQ process
+  ue_db[rnti]->ul_crc_info(enb_cc_idx, tti_rx, crc);
+
   // Scheduler uses eNB's CC mapping
   return scheduler.ul_crc_info(tti_rx, rnti, enb_cc_idx, crc);
 }
@@ -498,7 +509,7 @@ uint16_t mac::allocate_ue(uint32_t enb_cc_idx)
 
     // Allocate and initialize UE object
     unique_rnti_ptr<ue> ue_ptr = make_rnti_obj<ue>(
-        rnti, rnti, enb_cc_idx, &scheduler, rrc_h, rlc_h, phy_h, logger, cells.size(), softbuffer_pool.get());
+        rnti, rnti, enb_cc_idx, &scheduler, rrc_h, rlc_h, phy_h, logger, cells.size(), harq_softbuffers.get());
 
     // Add UE to rnti map
     srsran::rwlock_write_guard rw_lock(rwlock);
@@ -667,11 +678,29 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
         dl_sched_res->pdsch[n].dci = sched_result.data[i].dci;
 
         for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; tb++) {
-          dl_sched_res->pdsch[n].softbuffer_tx[tb] =
-              ue_db[rnti]->get_tx_softbuffer(enb_cc_idx, sched_result.data[i].dci.pid, tb);
+          // Disabled TBs do not need a softbuffer
+          if (sched_result.data[i].tbs[tb] == 0) {
+            dl_sched_res->pdsch[n].softbuffer_tx[tb] = nullptr;
+            dl_sched_res->pdsch[n].data[tb]          = nullptr;
+            continue;
+          }
 
-          // If the Rx soft-buffer is not given, abort transmission
+          // New transmissions (toggled NDI) take a new softbuffer, retransmissions use the one of the HARQ process
+          dl_sched_res->pdsch[n].softbuffer_tx[tb] =
+              ue_db[rnti]->get_tx_softbuffer(enb_cc_idx,
+                                             tti_tx_dl,
+                                             sched_result.data[i].dci.pid,
+                                             tb,
+                                             sched_result.data[i].tbs[tb],
+                                             sched_result.data[i].dci.tb[tb].ndi);
+
+          // If the Tx soft-buffer is not given, abort transmission
           if (dl_sched_res->pdsch[n].softbuffer_tx[tb] == nullptr) {
+            logger.warning("Failed to retrieve DL softbuffer for rnti=0x%x, pid=%d, tb=%d",
+                           rnti,
+                           sched_result.data[i].dci.pid,
+                           tb);
+            dl_sched_res->pdsch[n].data[tb] = nullptr;
             continue;
           }
 
@@ -997,17 +1026,15 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
           phy_ul_sched_res->pusch[n].pid           = TTI_RX(tti_tx_ul) % SRSRAN_FDD_NOF_HARQ;
           phy_ul_sched_res->pusch[n].needs_pdcch   = sched_result.pusch[i].needs_pdcch;
           phy_ul_sched_res->pusch[n].dci           = sched_result.pusch[i].dci;
-          phy_ul_sched_res->pusch[n].softbuffer_rx = ue_db[rnti]->get_rx_softbuffer(enb_cc_idx, tti_tx_ul);
+          // New transmissions take a new (reset) softbuffer, retransmissions use the one of the HARQ process
+          phy_ul_sched_res->pusch[n].softbuffer_rx = ue_db[rnti]->get_rx_softbuffer(
+              enb_cc_idx, tti_tx_ul, sched_result.pusch[i].tbs, sched_result.pusch[i].current_tx_nb);
 
           // If the Rx soft-buffer is not given, abort reception
           if (phy_ul_sched_res->pusch[n].softbuffer_rx == nullptr) {
             logger.warning("Failed to retrieve UL softbuffer for tti=%d, cc=%d", tti_tx_ul, enb_cc_idx);
             continue;
           }
-
-          if (sched_result.pusch[n].current_tx_nb == 0) {
-            srsran_softbuffer_rx_reset_tbs(phy_ul_sched_res->pusch[n].softbuffer_rx, sched_result.pusch[i].tbs * 8);
-          }
           phy_ul_sched_res->pusch[n].data =
               ue_db[rnti]->request_buffer(tti_tx_ul, enb_cc_idx, sched_result.pusch[i].tbs);
           if (phy_ul_sched_res->pusch[n].data) {
@@ -1056,7 +1083,7 @@ void mac::write_mcch(const srsran::sib2_mbms_t* sib2_,
   current_mcch_length = mcch_payload_length;
 
   unique_rnti_ptr<ue> ue_ptr = make_rnti_obj<ue>(
-      SRSRAN_MRNTI, SRSRAN_MRNTI, 0, &scheduler, rrc_h, rlc_h, phy_h, logger, cells.size(), softbuffer_pool.get());
+      SRSRAN_MRNTI, SRSRAN_MRNTI, 0, &scheduler, rrc_h, rlc_h, phy_h, logger, cells.size(), harq_softbuffers.get());
 
   auto ret = ue_db.insert(SRSRAN_MRNTI, std::move(ue_ptr));
   if (!ret) {
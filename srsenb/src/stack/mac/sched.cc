@@ -185,11 +185,24 @@ int sched::dl_mac_buffer_state(uint16_t rnti, uint32_t ce_code, uint32_t nof_cmd
 }
 
 int sched::dl_ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
+{
+  uint32_t  pid = 0;
+  tti_point tti_tx_dl;
+  return dl_ack_info(tti_rx, rnti, enb_cc_idx, tb_idx, ack, pid, tti_tx_dl);
+}
+
+int sched::dl_ack_info(uint32_t   tti_rx,
+                       uint16_t   rnti,
+                       uint32_t   enb_cc_idx,
+                       uint32_t   tb_idx,
+                       bool       ack,
+                       uint32_t&  pid,
+                       tti_point& tti_tx_dl)
 {
   int ret = -1;
   ue_db_access_locked(
       rnti,
-      [&](sched_ue& ue) { ret = ue.set_ack_info(tti_point{tti_rx}, enb_cc_idx, tb_idx, ack); },
+      [&](sched_ue& ue) { ret = ue.set_ack_info(tti_point{tti_rx}, enb_cc_idx, tb_idx, ack, &pid, &tti_tx_dl); },
       __PRETTY_FUNCTION__);
   return ret;
 }
@@ -259,9 +259,14 @@ bool sched_ue::phich_enabled(tti_point tti_rx, uint32_t enb_cc_idx) const
   return true;
 }
 
-int sched_ue::set_ack_info(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
+int sched_ue::set_ack_info(tti_point  tti_rx,
+                           uint32_t   enb_cc_idx,
+                           uint32_t   tb_idx,
+                           bool       ack,
+                           uint32_t*  pid,
+                           tti_point* tti_tx_dl)
 {
-  return cells[enb_cc_idx].set_ack_info(tti_rx, tb_idx, ack);
+  return cells[enb_cc_idx].set_ack_info(tti_rx, tb_idx, ack, pid, tti_tx_dl);
 }
 
 void sched_ue::set_ul_crc(tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res)
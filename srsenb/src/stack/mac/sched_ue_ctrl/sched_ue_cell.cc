@@ -240,7 +240,7 @@ int sched_ue_cell::set_ul_crc(tti_point tti_rx, bool crc_res)
   return pid;
 }
 
-int sched_ue_cell::set_ack_info(tti_point tti_rx, uint32_t tb_idx, bool ack)
+int sched_ue_cell::set_ack_info(tti_point tti_rx, uint32_t tb_idx, bool ack, uint32_t* pid, tti_point* tti_tx_dl)
 {
   CHECK_VALID_CC("DL ACK Info");
 
@@ -250,6 +250,12 @@ int sched_ue_cell::set_ack_info(tti_point tti_rx, uint32_t tb_idx, bool ack)
     logger.warning("SCHED: Received ACK info for unknown TTI=%d", tti_rx.to_uint());
     return tbs_acked;
   }
+  if (pid != nullptr) {
+    *pid = std::get<0>(p2);
+  }
+  if (tti_tx_dl != nullptr) {
+    *tti_tx_dl = harq_ent.dl_harq_procs()[std::get<0>(p2)].get_tti();
+  }
 
   // Adapt DL MCS based on BLER
   if (cell_cfg->sched_cfg->target_bler > 0 and fixed_mcs_dl < 0) {
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/softbuffer_pool.h"
+#include "srsran/adt/pool/obj_pool.h"
+#include "srsran/srsran.h"
+#include "srsran/support/srsran_assert.h"
+#include <algorithm>
+
+namespace srsenb {
+
+/// Number of code blocks of a TB, as computed by srsran_softbuffer_rx_reset_tbs()
+static uint32_t tbs_to_nof_cb(uint32_t tbs_bits)
+{
+  return (tbs_bits + 24) / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1;
+}
+
+softbuffer_pool::softbuffer_pool(uint32_t nof_prb, srsran_softbuffer_llr_t llr_format_, uint32_t batch_size) :
+  llr_format(llr_format_)
+{
+  int max_tbs = srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, nof_prb);
+  srsran_assert(max_tbs > 0, "Invalid nof_prb=%d", nof_prb);
+  uint32_t max_cb = tbs_to_nof_cb(max_tbs);
+
+  srsran_assert(max_cb <= (1U << (MAX_NOF_SIZE_CLASSES - 1)), "Invalid max_cb=%d", max_cb);
+
+  // Classes of 1, 2, 4, ... code blocks, the last one saturated to the largest TB
+  uint32_t nof_cb = 0;
+  while (nof_cb < max_cb) {
+    nof_cb                            = std::min(1U << nof_size_classes, max_cb);
+    tx_pools[nof_size_classes].max_cb = nof_cb;
+    rx_pools[nof_size_classes].max_cb = nof_cb;
+    nof_size_classes++;
+  }
+
+  for (uint32_t i = 0; i < nof_size_classes; ++i) {
+    auto& tx                  = tx_pools[i];
+    auto  init_tx_softbuffers = [&tx](void* ptr) {
+      new (ptr) tx_softbuffer(tx.max_cb);
+      tx.nof_allocated++;
+    };
+    auto recycle_tx_softbuffers = [&tx](tx_softbuffer&) { tx.nof_in_use--; };
+    tx.pool.reset(new srsran::background_obj_pool<tx_softbuffer>(
+        batch_size, batch_size, batch_size, init_tx_softbuffers, recycle_tx_softbuffers));
+
+    auto& rx                  = rx_pools[i];
+    auto  init_rx_softbuffers = [this, &rx](void* ptr) {
+      new (ptr) rx_softbuffer(rx.max_cb, llr_format);
+      rx.nof_allocated++;
+    };
+    auto recycle_rx_softbuffers = [&rx](rx_softbuffer&) { rx.nof_in_use--; };
+    rx.pool.reset(new srsran::background_obj_pool<rx_softbuffer>(
+        batch_size, batch_size, batch_size, init_rx_softbuffers, recycle_rx_softbuffers));
+  }
+}
+
+softbuffer_pool::~softbuffer_pool() = default;
+
+uint32_t softbuffer_pool::get_size_class(uint32_t tbs_bits) const
+{
+  uint32_t nof_cb     = tbs_to_nof_cb(tbs_bits);
+  uint32_t size_class = 0;
+  while ((1U << size_class) < nof_cb and size_class + 1 < nof_size_classes) {
+    size_class++;
+  }
+  return size_class;
+}
+
+srsran::unique_pool_ptr<tx_softbuffer> softbuffer_pool::get_tx(uint32_t tbs_bits)
+{
+  auto& tx = tx_pools[get_size_class(tbs_bits)];
+  tx.nof_in_use++;
+  return tx.pool->make();
+}
+
+srsran::unique_pool_ptr<rx_softbuffer> softbuffer_pool::get_rx(uint32_t tbs_bits)
+{
+  auto& rx = rx_pools[get_size_class(tbs_bits)];
+  rx.nof_in_use++;
+  srsran::unique_pool_ptr<rx_softbuffer> softbuffer = rx.pool->make();
+  srsran_softbuffer_rx_reset_tbs(softbuffer->get(), tbs_bits);
+  return softbuffer;
+}
+
+void softbuffer_pool::get_metrics(mac_softbuffer_pool_metrics_t& metrics) const
+{
+  metrics                 = {};
+  uint32_t rx_cb_nof_bytes = srsran_softbuffer_llr_nof_bytes(llr_format, SOFTBUFFER_SIZE) + SOFTBUFFER_SIZE / 8;
+  for (uint32_t i = 0; i < nof_size_classes; ++i) {
+    const auto& tx = tx_pools[i];
+    const auto& rx = rx_pools[i];
+    metrics.tx_in_use += tx.nof_in_use;
+    metrics.tx_allocated += tx.nof_allocated;
+    metrics.rx_in_use += rx.nof_in_use;
+    metrics.rx_allocated += rx.nof_allocated;
+    metrics.nof_bytes += (uint64_t)tx.nof_allocated * tx.max_cb * SOFTBUFFER_SIZE;
+    metrics.nof_bytes += (uint64_t)rx.nof_allocated * rx.max_cb * rx_cb_nof_bytes;
+  }
+}
+
+} // namespace srsenb
@@ -32,42 +32,94 @@
 
 namespace srsenb {
 
-ue_cc_softbuffers::ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_) :
-  nof_tx_harq_proc(nof_tx_harq_proc_), nof_rx_harq_proc(nof_rx_harq_proc_)
+void ue_cc_softbuffers::set_pool(softbuffer_pool* pool_)
 {
-  // Create and init Rx buffers
-  softbuffer_rx_list.resize(nof_rx_harq_proc);
-  for (srsran_softbuffer_rx_t& buffer : softbuffer_rx_list) {
-    srsran_softbuffer_rx_init(&buffer, nof_prb);
+  clear();
+  std::lock_guard<std::mutex> lock(mutex);
+  pool = pool_;
+}
+
+void ue_cc_softbuffers::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto& harq : dl_harqs) {
+    for (auto& tb : harq) {
+      tb.softbuffer.reset();
+      tb.nof_tx = 0;
+      tb.tti_tx = std::numeric_limits<uint32_t>::max();
+    }
+  }
+  for (auto& harq : ul_harqs) {
+    harq.softbuffer.reset();
+    harq.last_tx = false;
   }
+}
 
-  // Create and init Tx buffers
-  softbuffer_tx_list.resize(nof_tx_harq_proc * SRSRAN_MAX_TB);
-  for (auto& buffer : softbuffer_tx_list) {
-    srsran_softbuffer_tx_init(&buffer, nof_prb);
+srsran_softbuffer_tx_t*
+ue_cc_softbuffers::get_tx(uint32_t tti_tx_dl, uint32_t pid, uint32_t tb_idx, uint32_t tbs_bits, bool ndi)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (pool == nullptr or pid >= dl_harqs.size() or tb_idx >= SRSRAN_MAX_TB) {
+    return nullptr;
+  }
+
+  dl_harq_softbuffer_t& harq = dl_harqs[pid][tb_idx];
+  if (harq.softbuffer == nullptr or harq.ndi != ndi) {
+    // New transmission, the previous TB of the HARQ process, if any, is over
+    harq.softbuffer = pool->get_tx(tbs_bits);
+    harq.ndi        = ndi;
+    harq.nof_tx     = 0;
+  }
+  if (harq.softbuffer == nullptr) {
+    return nullptr;
   }
+  harq.nof_tx++;
+  harq.tti_tx = tti_tx_dl;
+
+  return harq.softbuffer->get();
 }
 
-ue_cc_softbuffers::~ue_cc_softbuffers()
+void ue_cc_softbuffers::set_ack(uint32_t tti_tx_dl, uint32_t pid, uint32_t tb_idx, bool ack, uint32_t max_nof_tx)
 {
-  for (auto& buffer : softbuffer_rx_list) {
-    srsran_softbuffer_rx_free(&buffer);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (pid >= dl_harqs.size() or tb_idx >= SRSRAN_MAX_TB) {
+    return;
   }
-  softbuffer_rx_list.clear();
 
-  for (auto& buffer : softbuffer_tx_list) {
-    srsran_softbuffer_tx_free(&buffer);
+  // The HARQ process may already carry a newer TB, whose softbuffer must be kept
+  dl_harq_softbuffer_t& harq = dl_harqs[pid][tb_idx];
+  if (harq.tti_tx == tti_tx_dl and (ack or harq.nof_tx >= max_nof_tx)) {
+    harq.softbuffer.reset();
   }
-  softbuffer_tx_list.clear();
 }
 
-void ue_cc_softbuffers::clear()
+srsran_softbuffer_rx_t*
+ue_cc_softbuffers::get_rx(uint32_t tti_tx_ul, uint32_t tbs_bits, uint32_t current_tx_nb, uint32_t max_nof_tx)
 {
-  for (auto& buffer : softbuffer_rx_list) {
-    srsran_softbuffer_rx_reset(&buffer);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (pool == nullptr) {
+    return nullptr;
+  }
+
+  ul_harq_softbuffer_t& harq = ul_harqs[tti_tx_ul % ul_harqs.size()];
+  if (current_tx_nb == 0) {
+    // The previous TB of the HARQ process, if any, is over
+    harq.softbuffer = pool->get_rx(tbs_bits);
+  }
+  if (harq.softbuffer == nullptr) {
+    return nullptr;
   }
-  for (auto& buffer : softbuffer_tx_list) {
-    srsran_softbuffer_tx_reset(&buffer);
+  harq.last_tx = current_tx_nb + 1 >= max_nof_tx;
+
+  return harq.softbuffer->get();
+}
+
+void ue_cc_softbuffers::set_crc(uint32_t tti_rx, bool crc)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  ul_harq_softbuffer_t&       harq = ul_harqs[tti_rx % ul_harqs.size()];
+  if (crc or harq.last_tx) {
+    harq.softbuffer.reset();
   }
 }
 
@@ -160,39 +212,36 @@ cc_buffer_handler::~cc_buffer_handler()
 }
 
 /**
- * Allocate and initialize softbuffers for Tx and Rx. It uses the configured
- * number of HARQ processes and cell width.
+ * Enable the Tx and Rx softbuffers of the carrier. The softbuffers are taken from the
+ * given pool as the HARQ processes start new transmissions.
  *
- * @param num_cc Number of carriers to add buffers for (default 1)
- * @return number of carriers
+ * @param softbuffers_ eNB softbuffer pool
  */
-void cc_buffer_handler::allocate_cc(srsran::unique_pool_ptr<ue_cc_softbuffers> cc_softbuffers_)
+void cc_buffer_handler::allocate_cc(softbuffer_pool* softbuffers_)
 {
   srsran_assert(empty(), "Cannot allocate softbuffers in CC that is already initialized");
-  cc_softbuffers = std::move(cc_softbuffers_);
+  cc_softbuffers.set_pool(softbuffers_);
 }
 
 void cc_buffer_handler::deallocate_cc()
 {
-  cc_softbuffers.reset();
+  cc_softbuffers.set_pool(nullptr);
 }
 
 void cc_buffer_handler::reset()
 {
-  if (not empty()) {
-    cc_softbuffers->clear();
-  }
+  cc_softbuffers.clear();
 }
 
-ue::ue(uint16_t                                 rnti_,
-       uint32_t                                 enb_cc_idx,
-       sched_interface*                         sched_,
-       rrc_interface_mac*                       rrc_,
-       rlc_interface_mac*                       rlc_,
-       phy_interface_stack_lte*                 phy_,
-       srslog::basic_logger&                    logger_,
-       uint32_t                                 nof_cells_,
-       srsran::obj_pool_itf<ue_cc_softbuffers>* softbuffer_pool_) :
+ue::ue(uint16_t                 rnti_,
+       uint32_t                 enb_cc_idx,
+       sched_interface*         sched_,
+       rrc_interface_mac*       rrc_,
+       rlc_interface_mac*       rlc_,
+       phy_interface_stack_lte* phy_,
+       srslog::basic_logger&    logger_,
+       uint32_t                 nof_cells_,
+       softbuffer_pool*         softbuffers_) :
   rnti(rnti_),
   sched(sched_),
   rrc(rrc_),
@@ -203,11 +252,11 @@ ue::ue(uint16_t                                 rnti_,
   mch_mac_msg_dl(10, logger_),
   mac_msg_ul(20, logger_),
   ta_fsm(this),
-  softbuffer_pool(softbuffer_pool_),
+  softbuffers(softbuffers_),
   cc_buffers(nof_cells_)
 {
   // Allocate buffer for PCell
-  cc_buffers[enb_cc_idx].allocate_cc(softbuffer_pool->make());
+  cc_buffers[enb_cc_idx].allocate_cc(softbuffers);
 }
 
 ue::~ue() {}
@@ -237,32 +286,54 @@ void ue::start_pcap(srsran::mac_pcap* pcap_)
 
 void ue::ue_cfg(const sched_interface::ue_cfg_t& ue_cfg)
 {
+  max_nof_harq_tx = ue_cfg.maxharq_tx;
+
   for (const auto& ue_cc : ue_cfg.supported_cc_list) {
     // Allocate and initialize Rx/Tx softbuffers for new carriers (exclude PCell)
     if (ue_cc.active and cc_buffers[ue_cc.enb_cc_idx].empty()) {
-      cc_buffers[ue_cc.enb_cc_idx].allocate_cc(softbuffer_pool->make());
+      cc_buffers[ue_cc.enb_cc_idx].allocate_cc(softbuffers);
     }
   }
 }
 
-srsran_softbuffer_rx_t* ue::get_rx_softbuffer(uint32_t enb_cc_idx, uint32_t tti)
+srsran_softbuffer_rx_t*
+ue::get_rx_softbuffer(uint32_t enb_cc_idx, uint32_t tti_tx_ul, uint32_t tbs_bytes, uint32_t current_tx_nb)
 {
   if ((size_t)enb_cc_idx >= cc_buffers.size() or cc_buffers[enb_cc_idx].empty()) {
     ERROR("eNB CC Index (%d/%zd) out-of-range", enb_cc_idx, cc_buffers.size());
     return nullptr;
   }
 
-  return &cc_buffers[enb_cc_idx].get_rx_softbuffer(tti);
+  return cc_buffers[enb_cc_idx].get_softbuffers().get_rx(tti_tx_ul, tbs_bytes * 8, current_tx_nb, max_nof_harq_tx);
 }
 
-srsran_softbuffer_tx_t* ue::get_tx_softbuffer(uint32_t enb_cc_idx, uint32_t harq_process, uint32_t tb_idx)
+srsran_softbuffer_tx_t* ue::get_tx_softbuffer(uint32_t enb_cc_idx,
+                                              uint32_t tti_tx_dl,
+                                              uint32_t harq_process,
+                                              uint32_t tb_idx,
+                                              uint32_t tbs_bytes,
+                                              bool     ndi)
 {
   if ((size_t)enb_cc_idx >= cc_buffers.size() or cc_buffers[enb_cc_idx].empty()) {
     ERROR("eNB CC Index (%d/%zd) out-of-range", enb_cc_idx, cc_buffers.size());
     return nullptr;
   }
 
-  return &cc_buffers[enb_cc_idx].get_tx_softbuffer(harq_process, tb_idx);
+  return cc_buffers[enb_cc_idx].get_softbuffers().get_tx(tti_tx_dl, harq_process, tb_idx, tbs_bytes * 8, ndi);
+}
+
+void ue::dl_ack_info(uint32_t enb_cc_idx, uint32_t tti_tx_dl, uint32_t pid, uint32_t tb_idx, bool ack)
+{
+  if ((size_t)enb_cc_idx < cc_buffers.size()) {
+    cc_buffers[enb_cc_idx].get_softbuffers().set_ack(tti_tx_dl, pid, tb_idx, ack, max_nof_harq_tx);
+  }
+}
+
+void ue::ul_crc_info(uint32_t enb_cc_idx, uint32_t tti_rx, bool crc)
+{
+  if ((size_t)enb_cc_idx < cc_buffers.size()) {
+    cc_buffers[enb_cc_idx].get_softbuffers().set_crc(tti_rx, crc);
+  }
 }
 
 uint8_t* ue::request_buffer(uint32_t tti, uint32_t enb_cc_idx, uint32_t len)
@@ -27,6 +27,7 @@
 #include "srsenb/hdr/stack/rrc/ue_rr_cfg.h"
 #include "srsran/asn1/rrc_utils.h"
 #include "srsran/common/enb_events.h"
+#include "srsran/common/pcap_writer.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/interfaces/enb_pdcp_interfaces.h"
 #include "srsran/interfaces/enb_rlc_interfaces.h"
@@ -268,6 +269,9 @@ void rrc::ue::rlf_timer_expired(uint32_t timeout_id)
   // Log event.
   event_logger::get().log_rlf_detected(
       ue_cell_list.get_ue_cc_idx(UE_PCELL_CC_IDX)->cell_common->enb_cc_idx, event_type, rnti);
+
+  // Keep the captured history that led to the RLF
+  srsran::pcap_writer::trigger_all();
 }
 
 void rrc::ue::max_rlc_retx_reached()
@@ -41,20 +41,81 @@ namespace srsenb {
 #define TEID_IN_FMT "TEID In=0x%x"
 #define TEID_OUT_FMT "TEID Out=0x%x"
 
+gtpu_tunnel_manager::tunnel_table::~tunnel_table()
+{
+  // Tunnels are removed one by one, as the removal callback of a tunnel may access other tunnels
+  for (slot_t& slot : slots) {
+    if (slot.tun.has_value()) {
+      erase(slot.tun->teid_in);
+    }
+  }
+}
+
+void gtpu_tunnel_manager::tunnel_table::resize(uint32_t max_tunnels)
+{
+  srsran_assert(slots.empty() or free_slots.size() == slots.size() - 1,
+                "The TEID table cannot be resized while tunnels exist");
+
+  // Slot 0 is never used, so that TEID 0 is never assigned
+  index_bits = 1;
+  while ((1U << index_bits) < max_tunnels + 1) {
+    index_bits++;
+  }
+  index_mask = (1U << index_bits) - 1;
+
+  slots.clear();
+  slots.resize(index_mask + 1);
+  free_slots = srsran::dyn_circular_buffer<uint32_t>(slots.size());
+  for (uint32_t idx = 1; idx < slots.size(); ++idx) {
+    free_slots.push(idx);
+  }
+}
+
+gtpu_tunnel_manager::tunnel* gtpu_tunnel_manager::tunnel_table::insert()
+{
+  if (free_slots.empty()) {
+    return nullptr;
+  }
+  uint32_t idx = free_slots.top();
+  free_slots.pop();
+
+  slot_t& slot = slots[idx];
+  slot.tun.emplace();
+  slot.tun->teid_in = (slot.generation << index_bits) | idx;
+  return &slot.tun.value();
+}
+
+void gtpu_tunnel_manager::tunnel_table::erase(uint32_t teid)
+{
+  uint32_t idx  = teid & index_mask;
+  slot_t&  slot = slots[idx];
+  srsran_assert(slot.tun.has_value() and slot.tun->teid_in == teid, "Removing non-existent TEID=0x%x", teid);
+
+  // The tunnel is only destroyed once its slot is released, as its removal callback may modify the table
+  tunnel tun = std::move(slot.tun.value());
+  slot.tun.reset();
+
+  // The generation wraps around without ever being 0, so that the TEID is never 0
+  slot.generation = (slot.generation + 1) & (UINT32_MAX >> index_bits);
+  if (slot.generation == 0) {
+    slot.generation = 1;
+  }
+  free_slots.push(idx);
+}
+
 gtpu_tunnel_manager::gtpu_tunnel_manager(srsran::task_sched_handle task_sched_, srslog::basic_logger& logger) :
-  logger(logger), task_sched(task_sched_), tunnels(1)
-{}
+  logger(logger), task_sched(task_sched_)
+{
+  tunnels.resize(SRSENB_MAX_UES * MAX_TUNNELS_PER_UE);
+}
 
 void gtpu_tunnel_manager::init(const gtpu_args_t& args, pdcp_interface_gtpu* pdcp_)
 {
   gtpu_args = &args;
   pdcp      = pdcp_;
-}
-
-const gtpu_tunnel_manager::tunnel* gtpu_tunnel_manager::find_tunnel(uint32_t teid)
-{
-  auto it = tunnels.find(teid);
-  return it != tunnels.end() ? &it->second : nullptr;
+  if (args.max_tunnels > 0) {
+    tunnels.resize(args.max_tunnels);
+  }
 }
 
 gtpu_tunnel_manager::ue_bearer_tunnel_list* gtpu_tunnel_manager::find_rnti_tunnels(uint16_t rnti)
@@ -87,13 +148,11 @@ gtpu_tunnel_manager::add_tunnel(uint16_t rnti, uint32_t eps_bearer_id, uint32_t
     logger.warning("Adding TEID with invalid eps-BearerID=%d", eps_bearer_id);
     return nullptr;
   }
-  auto ret_pair = tunnels.insert(tunnel());
-  if (not ret_pair) {
+  tunnel* tun = tunnels.insert();
+  if (tun == nullptr) {
     logger.warning("Unable to create new GTPU TEID In");
     return nullptr;
   }
-  tunnel* tun        = &tunnels[ret_pair.value()];
-  tun->teid_in       = ret_pair.value();
   tun->rnti          = rnti;
   tun->eps_bearer_id = eps_bearer_id;
   tun->teid_out      = teidout;
@@ -275,7 +334,7 @@ void gtpu_tunnel_manager::set_tunnel_priority(uint32_t before_teid, uint32_t aft
   suspend_tunnel(after_teid);
 
   before_tun.on_removal = [this, after_teid]() {
-    if (tunnels.contains(after_teid)) {
+    if (tunnels.find(after_teid) != nullptr) {
       // In Handover, TeNB switches paths, and flushes PDUs that have been buffered
       activate_tunnel(after_teid);
     }
@@ -338,7 +397,7 @@ void gtpu_tunnel_manager::setup_forwarding(uint32_t rx_teid, uint32_t tx_teid)
 
   // Auto-removes indirect tunnel when the main tunnel is removed
   rx_tun.on_removal = [this, tx_teid]() {
-    if (tunnels.contains(tx_teid)) {
+    if (tunnels.find(tx_teid) != nullptr) {
       remove_tunnel(tx_teid);
     }
   };
@@ -415,7 +474,7 @@ int gtpu::init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_)
   auto rx_callback = [this](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
     handle_gtpu_s1u_rx_packet(std::move(pdu), from);
   };
-  rx_socket_handler->add_socket_handler(fd, srsran::make_sdu_handler(logger, gtpu_queue, rx_callback));
+  rx_socket_handler->add_socket_handler(fd, srsran::make_sdu_batch_handler(logger, gtpu_queue, rx_callback));
 
   // Start MCH socket if enabled
   if (args.embms_enable) {
@@ -0,0 +1,137 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/softbuffer_pool.h"
+#include "srsran/common/test_common.h"
+#include "srsran/phy/fec/turbo/turbodecoder.h"
+#include <vector>
+
+namespace srsenb {
+
+const uint32_t nof_prb     = 100;
+const uint32_t max_tbs     = 97896;
+const uint32_t nof_max_cb  = 17;
+const uint32_t nof_ues     = 500;
+const size_t   tx_cb_bytes = SOFTBUFFER_SIZE;
+const size_t   rx_cb_bytes = SOFTBUFFER_SIZE * sizeof(int16_t) + SOFTBUFFER_SIZE / 8;
+
+int test_size_classes()
+{
+  softbuffer_pool pool(nof_prb);
+
+  // Each TB gets the smallest class that fits its code blocks
+  srsran::unique_pool_ptr<tx_softbuffer> tx = pool.get_tx(1000);
+  TESTASSERT(tx->get()->max_cb == 1);
+  tx = pool.get_tx(3 * (SRSRAN_TCOD_MAX_LEN_CB - 24));
+  TESTASSERT(tx->get()->max_cb == 4);
+  tx = pool.get_tx(max_tbs);
+  TESTASSERT(tx->get()->max_cb == nof_max_cb);
+
+  srsran::unique_pool_ptr<rx_softbuffer> rx = pool.get_rx(1000);
+  TESTASSERT(rx->get()->max_cb == 1);
+  rx = pool.get_rx(max_tbs);
+  TESTASSERT(rx->get()->max_cb == nof_max_cb);
+
+  // Rx softbuffers are handed out reset
+  rx->get()->cb_crc[0]      = true;
+  rx->get()->buffer_f[0][0] = 1;
+  rx.reset();
+  rx = pool.get_rx(max_tbs);
+  TESTASSERT(not rx->get()->cb_crc[0]);
+  TESTASSERT(rx->get()->buffer_f[0][0] == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_occupancy()
+{
+  softbuffer_pool               pool(nof_prb);
+  mac_softbuffer_pool_metrics_t metrics = {};
+
+  pool.get_metrics(metrics);
+  TESTASSERT(metrics.tx_in_use == 0 and metrics.rx_in_use == 0);
+  TESTASSERT(metrics.tx_allocated > 0 and metrics.rx_allocated > 0);
+
+  // All UEs keep a small DL and UL TB in flight
+  std::vector<srsran::unique_pool_ptr<tx_softbuffer> > tx_list;
+  std::vector<srsran::unique_pool_ptr<rx_softbuffer> > rx_list;
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    tx_list.push_back(pool.get_tx(1000));
+    rx_list.push_back(pool.get_rx(1000));
+  }
+  pool.get_metrics(metrics);
+  TESTASSERT(metrics.tx_in_use == nof_ues and metrics.rx_in_use == nof_ues);
+  TESTASSERT(metrics.tx_allocated >= nof_ues and metrics.rx_allocated >= nof_ues);
+
+  // Per UE softbuffers sized for the cell bandwidth, for all HARQ processes
+  uint64_t nof_bytes_per_ue = SRSRAN_FDD_NOF_HARQ * nof_max_cb * (SRSRAN_MAX_TB * tx_cb_bytes + rx_cb_bytes);
+  printf("Softbuffer memory for %u UEs: pool=%.1f MB, per UE=%.1f MB\n",
+         nof_ues,
+         metrics.nof_bytes / 1e6,
+         nof_ues * nof_bytes_per_ue / 1e6);
+  TESTASSERT(10 * metrics.nof_bytes < nof_ues * nof_bytes_per_ue);
+
+  // Acknowledged TBs return their softbuffers
+  tx_list.clear();
+  rx_list.resize(nof_ues / 2);
+  pool.get_metrics(metrics);
+  TESTASSERT(metrics.tx_in_use == 0 and metrics.rx_in_use == nof_ues / 2);
+  rx_list.clear();
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_llr_format_metrics()
+{
+  softbuffer_pool               pool16(nof_prb, SRSRAN_SOFTBUFFER_LLR_16BIT);
+  softbuffer_pool               pool8(nof_prb, SRSRAN_SOFTBUFFER_LLR_8BIT);
+  softbuffer_pool               pool4(nof_prb, SRSRAN_SOFTBUFFER_LLR_4BIT);
+  mac_softbuffer_pool_metrics_t metrics16 = {}, metrics8 = {}, metrics4 = {};
+
+  pool16.get_metrics(metrics16);
+  pool8.get_metrics(metrics8);
+  pool4.get_metrics(metrics4);
+  TESTASSERT(metrics16.rx_allocated == metrics8.rx_allocated and metrics8.rx_allocated == metrics4.rx_allocated);
+
+  // The soft bits take 2, 1 and 1/2 bytes, the rest of the pool is the same
+  TESTASSERT(metrics4.nof_bytes < metrics8.nof_bytes);
+  TESTASSERT(metrics16.nof_bytes - metrics8.nof_bytes == 2 * (metrics8.nof_bytes - metrics4.nof_bytes));
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main()
+{
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::info);
+
+  srslog::init();
+
+  TESTASSERT(srsenb::test_size_classes() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_occupancy() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_llr_format_metrics() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/upper/gtpu.h"
+#include "srsenb/test/common/dummy_classes_common.h"
+#include "srsran/common/test_common.h"
+#include "srsran/upper/gtpu.h"
+#include <chrono>
+#include <linux/ip.h>
+#include <random>
+
+/**
+ * Measures the rate at which the eNB GTPU handles S1-U data PDUs, from the reception of the datagram to the delivery
+ * of the SDU to PDCP, when many UEs and bearers are active. Each PDU is copied into a fresh byte buffer before it is
+ * handled, as the socket handler does.
+ */
+
+namespace srsenb {
+
+struct bench_params {
+  uint32_t nof_ues         = 1000;
+  uint32_t nof_bearers     = 4;
+  uint32_t nof_pdus        = 1000000;
+  uint32_t sdu_len         = 100;
+  uint32_t first_bearer_id = 5;
+};
+
+class pdcp_sink : public pdcp_dummy
+{
+public:
+  void write_sdu(uint16_t rnti, uint32_t eps_bearer_id, srsran::unique_byte_buffer_t sdu, int pdcp_sn) override
+  {
+    nof_sdus++;
+    nof_bytes += sdu->N_bytes;
+  }
+
+  uint64_t nof_sdus  = 0;
+  uint64_t nof_bytes = 0;
+};
+
+struct dummy_socket_manager : public srsran::socket_manager_itf {
+  dummy_socket_manager() : srsran::socket_manager_itf(srslog::fetch_basic_logger("TEST")) {}
+  bool add_socket_handler(int fd, recv_callback_t handler) final { return true; }
+  bool remove_socket(int fd) final { return true; }
+};
+
+/// Encodes a G-PDU with an IPv4 SDU of the given length
+std::vector<uint8_t> encode_gtpu_pdu(uint32_t teid, uint32_t sdu_len)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+
+  struct iphdr ip_pkt = {};
+  ip_pkt.version      = 4;
+  ip_pkt.ihl          = 5;
+  ip_pkt.tot_len      = htons(sdu_len);
+  ip_pkt.saddr        = htonl(0x0a000001);
+  ip_pkt.daddr        = htonl(0xac100002);
+  pdu->append_bytes((uint8_t*)&ip_pkt, sizeof(struct iphdr));
+  pdu->N_bytes = std::max(sdu_len, (uint32_t)sizeof(struct iphdr));
+
+  srsran::gtpu_header_t header = {};
+  header.flags                 = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+  header.message_type          = GTPU_MSG_DATA_PDU;
+  header.length                = pdu->N_bytes;
+  header.teid                  = teid;
+  gtpu_write_header(&header, pdu.get(), srslog::fetch_basic_logger("GTPU"));
+
+  return std::vector<uint8_t>(pdu->msg, pdu->msg + pdu->N_bytes);
+}
+
+int run_benchmark(const bench_params& params)
+{
+  srsran::task_scheduler task_sched;
+  dummy_socket_manager   rx_sockets;
+  pdcp_sink              pdcp;
+  gtpu                   enb_gtpu(&task_sched, srslog::fetch_basic_logger("GTPU"), &rx_sockets);
+
+  gtpu_args_t gtpu_args;
+  gtpu_args.gtp_bind_addr = "127.0.0.1";
+  gtpu_args.mme_addr      = "127.0.0.2";
+  gtpu_args.max_tunnels   = params.nof_ues * params.nof_bearers;
+  TESTASSERT(enb_gtpu.init(gtpu_args, &pdcp) == SRSRAN_SUCCESS);
+
+  // Create the tunnels and encode one G-PDU per tunnel
+  std::vector<std::vector<uint8_t> > pdus;
+  for (uint32_t ue = 0; ue < params.nof_ues; ++ue) {
+    uint16_t rnti = 0x46 + ue;
+    for (uint32_t bearer = 0; bearer < params.nof_bearers; ++bearer) {
+      uint32_t                   addr_in;
+      srsran::expected<uint32_t> teid_in = enb_gtpu.add_bearer(
+          rnti, params.first_bearer_id + bearer, 0x7f000002, ue * params.nof_bearers + bearer + 1, addr_in);
+      TESTASSERT(teid_in.has_value());
+      pdus.push_back(encode_gtpu_pdu(teid_in.value(), params.sdu_len));
+    }
+  }
+
+  // PDUs arrive for random tunnels
+  std::mt19937                            rng(0);
+  std::uniform_int_distribution<uint32_t> tunnel_dist(0, pdus.size() - 1);
+  std::vector<uint32_t>                   order(params.nof_pdus);
+  for (uint32_t& idx : order) {
+    idx = tunnel_dist(rng);
+  }
+
+  sockaddr_in from = {};
+  auto        t0   = std::chrono::steady_clock::now();
+  for (uint32_t idx : order) {
+    srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+    memcpy(pdu->msg, pdus[idx].data(), pdus[idx].size());
+    pdu->N_bytes = pdus[idx].size();
+    enb_gtpu.handle_gtpu_s1u_rx_packet(std::move(pdu), from);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  TESTASSERT(pdcp.nof_sdus == params.nof_pdus);
+  double elapsed_s = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() * 1e-9;
+  printf("GTPU S1-U Rx: %d UEs x %d bearers, %d PDUs of %d bytes in %.3f s: %.3f Mpps, %.1f ns/PDU\n",
+         params.nof_ues,
+         params.nof_bearers,
+         params.nof_pdus,
+         params.sdu_len,
+         elapsed_s,
+         params.nof_pdus / elapsed_s * 1e-6,
+         elapsed_s * 1e9 / params.nof_pdus);
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char** argv)
+{
+  srsenb::bench_params params;
+  if (argc > 1) {
+    params.nof_pdus = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    params.nof_ues = std::strtoul(argv[2], nullptr, 10);
+  }
+  if (argc > 3) {
+    params.nof_bearers = std::min(std::strtoul(argv[3], nullptr, 10), 4ul);
+  }
+
+  srslog::fetch_basic_logger("GTPU").set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  TESTASSERT(srsenb::run_benchmark(params) == SRSRAN_SUCCESS);
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -28,11 +28,17 @@
 #ifndef SRSEPC_HSS_H
 #define SRSEPC_HSS_H
 
+#include "srsepc/hdr/hss/hss_db.h"
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/standard_streams.h"
+#include "srsran/common/thread_pool.h"
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <map>
 
@@ -45,31 +51,11 @@ namespace srsepc {
 
 struct hss_args_t {
   std::string db_file;
+  std::string db_store;
   uint16_t    mcc;
   uint16_t    mnc;
-};
-
-enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
-
-struct hss_ue_ctx_t {
-  // Members
-  std::string        name;
-  uint64_t           imsi;
-  enum hss_auth_algo algo;
-  uint8_t            key[16];
-  bool               op_configured;
-  uint8_t            op[16];
-  uint8_t            opc[16];
-  uint8_t            amf[2];
-  uint8_t            sqn[6];
-  uint16_t           qci;
-  uint8_t            last_rand[16];
-  std::string        static_ip_addr;
-
-  // Helper getters/setters
-  void set_sqn(const uint8_t* sqn_);
-  void set_last_rand(const uint8_t* rand_);
-  void get_last_rand(uint8_t* rand_);
+  uint32_t    auth_vector_cache = 0;
+  uint32_t    auth_workers      = 2;
 };
 
 class hss : public hss_interface_nas
@@ -92,10 +78,10 @@ private:
   virtual ~hss();
   static hss* m_instance;
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
-
   void gen_rand(uint8_t rand_[16]);
 
+  void gen_auth_vector(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+
   void
        gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
   void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
@@ -110,36 +96,50 @@ private:
   void increment_sqn(uint8_t* sqn, uint8_t* next_sqn);
 
   bool          set_auth_algo(std::string auth_algo);
-  bool          read_db_file(std::string db_file);
+  bool          read_db_file(std::string db_file, std::vector<hss_ue_ctx_t>& ues);
   bool          write_db_file(std::string db_file);
   hss_ue_ctx_t* get_ue_ctx(uint64_t imsi);
 
   std::string hex_string(uint8_t* hex, int size);
 
+  // Authentication vector cache. Vectors are precomputed by the worker pool, each one reserving the next SQN of its
+  // UE, and are handed out in SQN order. A resync invalidates the vectors of the UE, including those in flight.
+  struct auth_vector_t {
+    uint8_t k_asme[32];
+    uint8_t autn[16];
+    uint8_t rand[16];
+    uint8_t xres[16];
+  };
+  struct auth_vector_cache_t {
+    std::deque<auth_vector_t> vectors;
+    uint32_t                  generation     = 0;
+    bool                      refill_pending = false;
+  };
+
+  bool pop_auth_vector(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+  void schedule_auth_vector_refill(uint64_t imsi);
+  void refill_auth_vectors(uint64_t imsi);
+
+  // Protects the subscriber store and the vector cache, which are accessed by the NAS and by the auth workers
+  std::mutex m_mutex;
+
+  uint32_t                                          m_nof_cached_vectors = 0;
+  std::unordered_map<uint64_t, auth_vector_cache_t> m_auth_vectors;
+  std::unique_ptr<srsran::task_thread_pool>         m_auth_workers;
+
   std::string db_file;
 
   /*Logs*/
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("HSS");
 
+  // Subscriber store, UE contexts are updated in place
+  hss_db m_db{m_logger};
+
   uint16_t mcc;
   uint16_t mnc;
 
   std::map<std::string, uint64_t> m_ip_to_imsi;
 };
 
-inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
-{
-  memcpy(sqn, sqn_, 6);
-}
-
-inline void hss_ue_ctx_t::set_last_rand(const uint8_t* last_rand_)
-{
-  memcpy(last_rand, last_rand_, 16);
-}
-
-inline void hss_ue_ctx_t::get_last_rand(uint8_t* last_rand_)
-{
-  memcpy(last_rand_, last_rand, 16);
-}
 } // namespace srsepc
 #endif // SRSEPC_HSS_H
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        hss_db.h
+ * Description: Binary, memory-mapped subscriber store of the HSS. Records
+ *              are fixed-size and looked up through an open-addressing
+ *              hash index on the IMSI, which is stored in the same file.
+ *              The CSV user database is only used to import/export it.
+ *****************************************************************************/
+
+#ifndef SRSEPC_HSS_DB_H
+#define SRSEPC_HSS_DB_H
+
+#include "srsran/srslog/srslog.h"
+#include <netinet/in.h>
+#include <string.h>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace srsepc {
+
+#define HSS_UE_NAME_MAX_LEN 64
+
+enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
+
+// Trivially copyable, as it is stored as-is in the subscriber store
+struct hss_ue_ctx_t {
+  // Members
+  char               name[HSS_UE_NAME_MAX_LEN];
+  uint64_t           imsi;
+  enum hss_auth_algo algo;
+  uint8_t            key[16];
+  bool               op_configured;
+  uint8_t            op[16];
+  uint8_t            opc[16];
+  uint8_t            amf[2];
+  uint8_t            sqn[6];
+  uint16_t           qci;
+  uint8_t            last_rand[16];
+  char               static_ip_addr[INET_ADDRSTRLEN]; // "0.0.0.0" for dynamic allocation
+
+  // Helper getters/setters
+  void set_sqn(const uint8_t* sqn_);
+  void set_last_rand(const uint8_t* rand_);
+  void get_last_rand(uint8_t* rand_);
+};
+
+/// Identifies the version of the CSV user database a store was imported from
+struct hss_db_csv_stamp_t {
+  int64_t  mtime_ns;
+  uint64_t size;
+};
+
+struct hss_db_header_t;
+
+class hss_db
+{
+public:
+  explicit hss_db(srslog::basic_logger& logger_) : logger(logger_) {}
+  ~hss_db();
+  hss_db(const hss_db&) = delete;
+  hss_db& operator=(const hss_db&) = delete;
+
+  /// Maps an existing store file. Fails if the file is missing, was written with a different record layout or its
+  /// index points outside the records
+  bool open(const std::string& path);
+
+  /// Builds a new store from the given UE contexts. If path is empty, the store is kept in anonymous memory only
+  bool create(const std::string& path, const std::vector<hss_ue_ctx_t>& ues, const hss_db_csv_stamp_t& stamp);
+
+  /// Flushes and unmaps the store
+  void close();
+
+  hss_ue_ctx_t*       find(uint64_t imsi);
+  uint32_t            size() const;
+  hss_ue_ctx_t&       operator[](uint32_t idx) { return records[idx]; }
+  const hss_ue_ctx_t& operator[](uint32_t idx) const { return records[idx]; }
+
+  hss_db_csv_stamp_t get_csv_stamp() const;
+  void               set_csv_stamp(const hss_db_csv_stamp_t& stamp);
+
+  /// Returns the stamp of the file at path, or a zeroed stamp if it does not exist
+  static hss_db_csv_stamp_t stat_csv(const std::string& path);
+
+private:
+  bool map(int fd, size_t len);
+  void set_layout();
+  bool check_index() const;
+
+  srslog::basic_logger& logger;
+
+  void*            base    = nullptr;
+  size_t           map_len = 0;
+  hss_db_header_t* hdr     = nullptr;
+  uint32_t*        slots   = nullptr; // record index + 1, 0 if empty
+  hss_ue_ctx_t*    records = nullptr;
+};
+
+inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
+{
+  memcpy(sqn, sqn_, 6);
+}
+
+inline void hss_ue_ctx_t::set_last_rand(const uint8_t* last_rand_)
+{
+  memcpy(last_rand, last_rand_, 16);
+}
+
+inline void hss_ue_ctx_t::get_last_rand(uint8_t* last_rand_)
+{
+  memcpy(last_rand_, last_rand, 16);
+}
+
+} // namespace srsepc
+
+#endif // SRSEPC_HSS_DB_H
@@ -33,6 +33,7 @@
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/threads.h"
 #include <cstddef>
+#include <unordered_map>
 
 namespace srsepc {
 
@@ -71,11 +72,16 @@ private:
   s1ap*       m_s1ap;
   mme_gtpc*   m_mme_gtpc;
 
-  bool   m_running;
-  fd_set m_set;
+  bool m_running;
+  int  m_epoll_fd = -1;
 
-  // Timer map
-  std::vector<mme_timer_t> timers;
+  static constexpr std::size_t max_events = 64;
+
+  // Timers, indexed by timer fd and by (timer type, IMSI)
+  std::unordered_map<int, mme_timer_t> timers;
+  std::unordered_map<uint64_t, int>    timer_fds;
+
+  static uint64_t timer_key(enum nas_timer_type type, uint64_t imsi) { return (imsi << 4U) | (uint64_t)type; }
 
   // Timer Methods
   void handle_timer_expire(int timer_fd);
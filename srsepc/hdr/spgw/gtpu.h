@@ -23,59 +23,126 @@
 #define SRSEPC_GTPU_H
 
 #include "srsepc/hdr/spgw/spgw.h"
+#include "srsran/adt/rcu_hash_map.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/network_utils.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <vector>
 
 namespace srsepc {
 
 class spgw::gtpu : public gtpu_interface_gtpc
 {
 public:
+  class worker;
+
   gtpu();
   virtual ~gtpu();
   int  init(spgw_args_t* args, spgw* spgw, gtpc_interface_gtpu* gtpc);
+  int  start_workers();
   void stop();
 
   int init_sgi(spgw_args_t* args);
   int init_s1u(spgw_args_t* args);
   int get_sgi();
   int get_s1u();
+  int get_paging_fd();
+
+  /// Per-thread S1-U transmission context. Downlink PDUs are queued and sent in batches with sendmmsg()
+  struct s1u_tx_ctx {
+    s1u_tx_ctx(int fd_, uint32_t batch_size) : fd(fd_), batch(batch_size) {}
+    int                                  fd;
+    srsran::net_utils::datagram_tx_batch batch;
+  };
+
+  // User plane, called from the worker threads
+  void handle_sgi_pdu(srsran::unique_byte_buffer_t msg, s1u_tx_ctx& tx);
+  void handle_s1u_pdu(srsran::byte_buffer_t* msg, int sgi);
+  void send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::unique_byte_buffer_t msg, s1u_tx_ctx& tx);
+  void flush_s1u_pdus(s1u_tx_ctx& tx);
 
-  void handle_sgi_pdu(srsran::unique_byte_buffer_t msg);
-  void handle_s1u_pdu(srsran::byte_buffer_t* msg);
-  void send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg);
+  // Called from the SPGW thread
+  void handle_paging_pdus();
+  void flush_s1u_pdus();
 
   virtual in_addr_t get_s1u_addr();
 
   virtual bool modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtp_fteid_t dw_user_fteid, uint32_t up_ctr_fteid);
   virtual bool delete_gtpu_tunnel(in_addr_t ue_ipv4);
   virtual bool delete_gtpc_tunnel(in_addr_t ue_ipv4);
+  virtual bool add_uplink_tunnel(uint32_t up_user_teid, in_addr_t ue_ipv4);
+  virtual bool delete_uplink_tunnel(uint32_t up_user_teid);
   virtual void send_all_queued_packets(srsran::gtp_fteid_t                       dw_user_fteid,
                                        std::queue<srsran::unique_byte_buffer_t>& pkt_queue);
 
   spgw*                m_spgw;
   gtpc_interface_gtpu* m_gtpc;
 
-  bool m_sgi_up;
-  int  m_sgi;
-
-  bool        m_s1u_up;
-  int         m_s1u;
-  sockaddr_in m_s1u_addr;
-
-  std::map<in_addr_t, srsran::gtp_fteid_t> m_ip_to_usr_teid; // Map IP to User-plane TEID for downlink traffic
-  std::map<in_addr_t, uint32_t>            m_ip_to_ctr_teid; // IP to control TEID map. Important to check if
-                                                             // UE is attached without an active user-plane
-                                                             // for downlink notifications.
+  bool             m_sgi_up;
+  int              m_sgi;
+  std::vector<int> m_sgi_queues; // One TUN queue per worker, m_sgi being the first
+
+  bool             m_s1u_up;
+  int              m_s1u;
+  std::vector<int> m_s1u_socks;      // One SO_REUSEPORT socket per worker, m_s1u being the first
+  int              m_s1u_ctrl = -1; // Send-only socket of the SPGW thread, not shared with the workers
+  sockaddr_in      m_s1u_addr;
+
+  uint32_t                             m_nof_workers = 1;
+  uint32_t                             m_batch_size  = 1;
+  int                                  m_stop_fd     = -1; // Wakes up the workers on stop
+  std::vector<std::unique_ptr<worker>> m_workers;
+  std::unique_ptr<s1u_tx_ctx>          m_ctrl_tx; // Used by the SPGW thread to send queued packets after paging
+
+  /// Downlink tunnel state of a UE. Published to the workers through m_ip_to_tunnel
+  struct ue_tunnel_t {
+    srsran::gtp_fteid_t dw_user_fteid;
+    uint32_t            up_ctrl_teid;
+    bool                usr_found;
+    bool                ctr_found;
+  };
+
+  // Tunnel tables. Only modified by the SPGW thread and looked up lock-free by the workers, which are the readers of
+  // m_rcu. The user-plane TEID (usr_found) is needed to forward downlink traffic. The control TEID (ctr_found)
+  // identifies attached UEs without an active user-plane, for downlink data notifications.
+  std::unique_ptr<srsran::rcu_domain>                            m_rcu;
+  std::unique_ptr<srsran::rcu_hash_map<in_addr_t, ue_tunnel_t> > m_ip_to_tunnel;
+  std::unique_ptr<srsran::rcu_hash_map<uint32_t, in_addr_t> >    m_teid_to_ue_ip; // Uplink user TEID to UE IP
+
+  // Downlink PDUs of UEs in ECM-IDLE, handed over by the workers to the SPGW thread for paging
+  struct paging_pdu_t {
+    in_addr_t                    ue_ipv4;
+    srsran::unique_byte_buffer_t pdu;
+  };
+  std::mutex                m_paging_mutex;
+  std::vector<paging_pdu_t> m_paging_pdus;
+  int                       m_paging_fd = -1;
 
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("GTPU");
 };
 
+/// User plane worker. Forwards the traffic of one TUN queue and one S1-U socket
+class spgw::gtpu::worker : public srsran::thread
+{
+public:
+  worker(gtpu* parent_, uint32_t id_, int sgi_, int s1u_);
+  void run_thread() override;
+
+private:
+  gtpu*                                parent;
+  uint32_t                             id;
+  int                                  sgi;
+  s1u_tx_ctx                           tx;
+  srsran::net_utils::datagram_rx_batch s1u_rx;
+};
+
 inline int spgw::gtpu::get_sgi()
 {
   return m_sgi;
@@ -86,6 +153,11 @@ inline int spgw::gtpu::get_s1u()
   return m_s1u;
 }
 
+inline int spgw::gtpu::get_paging_fd()
+{
+  return m_paging_fd;
+}
+
 inline in_addr_t spgw::gtpu::get_s1u_addr()
 {
   return m_s1u_addr.sin_addr.s_addr;
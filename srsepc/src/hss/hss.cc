@@ -21,6 +21,7 @@
 #include "srsepc/hdr/hss/hss.h"
 #include "srsran/common/security.h"
 #include "srsran/common/string_helpers.h"
+#include <algorithm>
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
 #include <iomanip>
@@ -68,10 +69,28 @@ int hss::init(hss_args_t* hss_args)
 {
   srand(time(NULL));
 
-  /*Read user information from DB*/
-  if (read_db_file(hss_args->db_file) == false) {
-    srsran::console("Error reading user database file %s\n", hss_args->db_file.c_str());
-    return -1;
+  /*Read user information from DB. The CSV is only parsed if the subscriber store is missing or out of date*/
+  hss_db_csv_stamp_t csv_stamp   = hss_db::stat_csv(hss_args->db_file);
+  bool               store_valid = false;
+  if (not hss_args->db_store.empty() && m_db.open(hss_args->db_store)) {
+    hss_db_csv_stamp_t store_stamp = m_db.get_csv_stamp();
+    store_valid                    = store_stamp.mtime_ns == csv_stamp.mtime_ns && store_stamp.size == csv_stamp.size;
+    if (not store_valid) {
+      m_logger.info("User database file %s changed, re-importing it", hss_args->db_file.c_str());
+    }
+  }
+  if (store_valid) {
+    for (uint32_t i = 0; i < m_db.size(); i++) {
+      if (strcmp(m_db[i].static_ip_addr, "0.0.0.0") != 0) {
+        m_ip_to_imsi.insert(std::make_pair(std::string(m_db[i].static_ip_addr), m_db[i].imsi));
+      }
+    }
+  } else {
+    std::vector<hss_ue_ctx_t> ues;
+    if (read_db_file(hss_args->db_file, ues) == false || m_db.create(hss_args->db_store, ues, csv_stamp) == false) {
+      srsran::console("Error reading user database file %s\n", hss_args->db_file.c_str());
+      return -1;
+    }
   }
 
   mcc = hss_args->mcc;
@@ -79,18 +98,40 @@ int hss::init(hss_args_t* hss_args)
 
   db_file = hss_args->db_file;
 
-  m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d", hss_args->db_file.c_str(), mcc, mnc);
+  // Start precomputing authentication vectors for all subscribers
+  m_nof_cached_vectors = hss_args->auth_vector_cache;
+  if (m_nof_cached_vectors > 0) {
+    m_auth_workers.reset(new srsran::task_thread_pool(std::max(hss_args->auth_workers, 1u)));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_auth_vectors.reserve(m_db.size());
+    for (uint32_t i = 0; i < m_db.size(); i++) {
+      schedule_auth_vector_refill(m_db[i].imsi);
+    }
+  }
+
+  m_logger.info("HSS Initialized. DB file %s, %d users, MCC: %d, MNC: %d",
+                hss_args->db_file.c_str(),
+                m_db.size(),
+                mcc,
+                mnc);
   srsran::console("HSS Initialized.\n");
   return 0;
 }
 
 void hss::stop()
 {
-  write_db_file(db_file);
+  if (m_auth_workers != nullptr) {
+    m_auth_workers->stop();
+  }
+  // Export the current SQNs. The store remains valid, as it is stamped with the exported file
+  if (write_db_file(db_file)) {
+    m_db.set_csv_stamp(hss_db::stat_csv(db_file));
+  }
+  m_db.close();
   return;
 }
 
-bool hss::read_db_file(std::string db_filename)
+bool hss::read_db_file(std::string db_filename, std::vector<hss_ue_ctx_t>& ues)
 {
   std::ifstream m_db_file;
 
@@ -114,8 +155,12 @@ bool hss::read_db_file(std::string db_filename)
         srsran::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
         return false;
       }
-      std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
-      ue_ctx->name                         = split[0];
+      ues.emplace_back();
+      hss_ue_ctx_t* ue_ctx = &ues.back();
+      if (split[0].size() >= HSS_UE_NAME_MAX_LEN) {
+        m_logger.warning("UE name %s truncated to %d characters", split[0].c_str(), HSS_UE_NAME_MAX_LEN - 1);
+      }
+      strncpy(ue_ctx->name, split[0].c_str(), HSS_UE_NAME_MAX_LEN - 1);
       if (split[1] == std::string("xor")) {
         ue_ctx->algo = HSS_ALGO_XOR;
       } else if (split[1] == std::string("mil")) {
@@ -152,13 +197,13 @@ bool hss::read_db_file(std::string db_filename)
       m_logger.debug("Default Bearer QCI: %d", ue_ctx->qci);
 
       if (split[9] == std::string("dynamic")) {
-        ue_ctx->static_ip_addr = "0.0.0.0";
+        strcpy(ue_ctx->static_ip_addr, "0.0.0.0");
       } else {
         char buf[128] = {0};
-        if (inet_pton(AF_INET, split[9].c_str(), buf)) {
+        if (inet_pton(AF_INET, split[9].c_str(), buf) && split[9].size() < INET_ADDRSTRLEN) {
           if (m_ip_to_imsi.insert(std::make_pair(split[9], ue_ctx->imsi)).second) {
-            ue_ctx->static_ip_addr = split[9];
-            m_logger.info("static ip addr %s", ue_ctx->static_ip_addr.c_str());
+            strcpy(ue_ctx->static_ip_addr, split[9].c_str());
+            m_logger.info("static ip addr %s", ue_ctx->static_ip_addr);
           } else {
             m_logger.info("duplicate static ip addr %s", split[9].c_str());
             return false;
@@ -168,7 +213,6 @@ bool hss::read_db_file(std::string db_filename)
           return false;
         }
       }
-      m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
     }
   }
 
@@ -176,6 +220,14 @@ bool hss::read_db_file(std::string db_filename)
     m_db_file.close();
   }
 
+  // Sort users by IMSI, so that exporting gives a stable order. Only the first entry of a repeated IMSI is kept.
+  std::stable_sort(
+      ues.begin(), ues.end(), [](const hss_ue_ctx_t& a, const hss_ue_ctx_t& b) { return a.imsi < b.imsi; });
+  ues.erase(std::unique(ues.begin(),
+                        ues.end(),
+                        [](const hss_ue_ctx_t& a, const hss_ue_ctx_t& b) { return a.imsi == b.imsi; }),
+            ues.end());
+
   return true;
 }
 
@@ -216,37 +268,36 @@ bool hss::write_db_file(std::string db_filename)
             << "#                                                                                           \n"
             << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
-  while (it != m_imsi_to_ue_ctx.end()) {
-    m_db_file << it->second->name;
+  for (uint32_t i = 0; i < m_db.size(); i++) {
+    hss_ue_ctx_t& ue_ctx = m_db[i];
+    m_db_file << ue_ctx.name;
     m_db_file << ",";
-    m_db_file << (it->second->algo == HSS_ALGO_XOR ? "xor" : "mil");
+    m_db_file << (ue_ctx.algo == HSS_ALGO_XOR ? "xor" : "mil");
     m_db_file << ",";
-    m_db_file << std::setfill('0') << std::setw(15) << it->second->imsi;
+    m_db_file << std::setfill('0') << std::setw(15) << ue_ctx.imsi;
     m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->key, 16);
+    m_db_file << srsran::hex_string(ue_ctx.key, 16);
     m_db_file << ",";
-    if (it->second->op_configured) {
+    if (ue_ctx.op_configured) {
       m_db_file << "op,";
-      m_db_file << srsran::hex_string(it->second->op, 16);
+      m_db_file << srsran::hex_string(ue_ctx.op, 16);
     } else {
       m_db_file << "opc,";
-      m_db_file << srsran::hex_string(it->second->opc, 16);
+      m_db_file << srsran::hex_string(ue_ctx.opc, 16);
     }
     m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->amf, 2);
+    m_db_file << srsran::hex_string(ue_ctx.amf, 2);
     m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->sqn, 6);
+    m_db_file << srsran::hex_string(ue_ctx.sqn, 6);
     m_db_file << ",";
-    m_db_file << it->second->qci;
-    if (it->second->static_ip_addr != "0.0.0.0") {
+    m_db_file << ue_ctx.qci;
+    if (strcmp(ue_ctx.static_ip_addr, "0.0.0.0") != 0) {
       m_db_file << ",";
-      m_db_file << it->second->static_ip_addr;
+      m_db_file << ue_ctx.static_ip_addr;
     } else {
       m_db_file << ",dynamic";
     }
     m_db_file << std::endl;
-    it++;
   }
   if (m_db_file.is_open()) {
     m_db_file.close();
@@ -258,13 +309,30 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
 {
 
   m_logger.debug("Generating AUTH info answer");
-  hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  hss_ue_ctx_t*               ue_ctx = get_ue_ctx(imsi);
   if (ue_ctx == nullptr) {
     srsran::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     m_logger.error("User not found at HSS. IMSI: %015" PRIu64 "", imsi);
     return false;
   }
 
+  if (not pop_auth_vector(ue_ctx, k_asme, autn, rand, xres)) {
+    // The vector computed here takes a higher SQN than the ones being computed by a pending refill, which must then be
+    // discarded. Otherwise, they would be handed out later with an SQN the UE has already seen
+    auto it = m_auth_vectors.find(imsi);
+    if (it != m_auth_vectors.end()) {
+      it->second.generation++;
+    }
+    gen_auth_vector(ue_ctx, k_asme, autn, rand, xres);
+    increment_ue_sqn(ue_ctx);
+  }
+  schedule_auth_vector_refill(imsi);
+  return true;
+}
+
+void hss::gen_auth_vector(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
+{
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
       gen_auth_info_answer_xor(ue_ctx, k_asme, autn, rand, xres);
@@ -273,10 +341,67 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
       gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
       break;
   }
-  increment_ue_sqn(ue_ctx);
+}
+
+bool hss::pop_auth_vector(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
+{
+  auto it = m_auth_vectors.find(ue_ctx->imsi);
+  if (it == m_auth_vectors.end() or it->second.vectors.empty()) {
+    return false;
+  }
+  const auth_vector_t& av = it->second.vectors.front();
+  memcpy(k_asme, av.k_asme, sizeof(av.k_asme));
+  memcpy(autn, av.autn, sizeof(av.autn));
+  memcpy(rand, av.rand, sizeof(av.rand));
+  memcpy(xres, av.xres, sizeof(av.xres));
+  it->second.vectors.pop_front();
+
+  // The RAND of the vector in use is the one a resync refers to
+  ue_ctx->set_last_rand(rand);
+  m_logger.debug("Using precomputed authentication vector -- IMSI: %015" PRIu64 "", ue_ctx->imsi);
   return true;
 }
 
+void hss::schedule_auth_vector_refill(uint64_t imsi)
+{
+  if (m_auth_workers == nullptr) {
+    return;
+  }
+  auth_vector_cache_t& cache = m_auth_vectors[imsi];
+  if (cache.refill_pending or cache.vectors.size() >= m_nof_cached_vectors) {
+    return;
+  }
+  cache.refill_pending = true;
+  m_auth_workers->push_task([this, imsi]() { refill_auth_vectors(imsi); });
+}
+
+void hss::refill_auth_vectors(uint64_t imsi)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auth_vector_cache_t&         cache = m_auth_vectors[imsi];
+  while (cache.vectors.size() < m_nof_cached_vectors) {
+    hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
+    if (ue_ctx == nullptr) {
+      break;
+    }
+
+    // Reserve the SQN and compute the vector on a copy of the context, without holding the lock
+    hss_ue_ctx_t ue_copy    = *ue_ctx;
+    uint32_t     generation = cache.generation;
+    increment_ue_sqn(ue_ctx);
+    lock.unlock();
+
+    auth_vector_t av;
+    gen_auth_vector(&ue_copy, av.k_asme, av.autn, av.rand, av.xres);
+
+    lock.lock();
+    if (generation == cache.generation) {
+      cache.vectors.push_back(av);
+    }
+  }
+  cache.refill_pending = false;
+}
+
 void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
                                         uint8_t*      k_asme,
                                         uint8_t*      autn,
@@ -440,13 +565,12 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
 
 bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
+  const hss_ue_ctx_t* ue_ctx = m_db.find(imsi);
+  if (ue_ctx == nullptr) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
     srsran::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     return false;
   }
-  const std::unique_ptr<hss_ue_ctx_t>& ue_ctx = ue_ctx_it->second;
   m_logger.info("Found User %015" PRIu64 "", imsi);
   *qci = ue_ctx->qci;
   return true;
@@ -455,7 +579,8 @@ bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
 {
   m_logger.debug("Re-syncing SQN");
-  hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  hss_ue_ctx_t*               ue_ctx = get_ue_ctx(imsi);
   if (ue_ctx == nullptr) {
     srsran::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     m_logger.error("User not found at HSS. IMSI: %015" PRIu64 "", imsi);
@@ -472,6 +597,13 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
   }
 
   increment_seq_after_resync(ue_ctx);
+
+  // Vectors computed with the old SQN would be rejected by the UE
+  auto it = m_auth_vectors.find(imsi);
+  if (it != m_auth_vectors.end()) {
+    it->second.vectors.clear();
+    it->second.generation++;
+  }
   return true;
 }
 
@@ -612,13 +744,11 @@ void hss::gen_rand(uint8_t rand_[16])
 
 hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
+  hss_ue_ctx_t* ue_ctx = m_db.find(imsi);
+  if (ue_ctx == nullptr) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
-    return nullptr;
   }
-
-  return ue_ctx_it->second.get();
+  return ue_ctx;
 }
 
 std::map<std::string, uint64_t> hss::get_ip_to_imsi(void) const
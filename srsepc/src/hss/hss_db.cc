@@ -0,0 +1,287 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/hss/hss_db.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace srsepc {
+
+static_assert(std::is_trivially_copyable<hss_ue_ctx_t>::value, "UE contexts are stored as raw bytes");
+
+struct hss_db_header_t {
+  char               magic[8];
+  uint32_t           version;
+  uint32_t           record_size; // guards against reading a store written with a different hss_ue_ctx_t layout
+  uint32_t           nof_records;
+  uint32_t           nof_slots; // power of two
+  hss_db_csv_stamp_t csv_stamp;
+};
+
+static_assert(sizeof(hss_db_header_t) == 40, "The header size is part of the store format");
+
+static const char     HSS_DB_MAGIC[8] = {'S', 'R', 'S', 'H', 'S', 'S', 'D', 'B'};
+static const uint32_t HSS_DB_VERSION  = 1;
+
+static size_t align8(size_t len)
+{
+  return (len + 7) & ~(size_t)7;
+}
+
+static size_t slots_offset()
+{
+  return align8(sizeof(hss_db_header_t));
+}
+
+static size_t records_offset(uint32_t nof_slots)
+{
+  return align8(slots_offset() + nof_slots * sizeof(uint32_t));
+}
+
+static size_t store_len(uint32_t nof_records, uint32_t nof_slots)
+{
+  return records_offset(nof_slots) + nof_records * sizeof(hss_ue_ctx_t);
+}
+
+// Fibonacci hashing, so that consecutive IMSIs spread over the whole index
+static uint32_t slot_of(uint64_t imsi, uint32_t nof_slots)
+{
+  return (uint32_t)((imsi * 0x9E3779B97F4A7C15ULL) >> 32) & (nof_slots - 1);
+}
+
+hss_db::~hss_db()
+{
+  close();
+}
+
+bool hss_db::map(int fd, size_t len)
+{
+  int   flags = (fd < 0) ? (MAP_PRIVATE | MAP_ANONYMOUS) : MAP_SHARED;
+  void* ptr   = mmap(nullptr, len, PROT_READ | PROT_WRITE, flags, fd, 0);
+  if (ptr == MAP_FAILED) {
+    logger.error("Failed to map subscriber store: %s", strerror(errno));
+    return false;
+  }
+  base    = ptr;
+  map_len = len;
+  hdr     = (hss_db_header_t*)base;
+  return true;
+}
+
+void hss_db::set_layout()
+{
+  slots   = (uint32_t*)((uint8_t*)base + slots_offset());
+  records = (hss_ue_ctx_t*)((uint8_t*)base + records_offset(hdr->nof_slots));
+}
+
+bool hss_db::check_index() const
+{
+  // Every used slot must point to a record inside the mapping, and exactly nof_records slots may be used so that
+  // lookups always reach an empty slot
+  uint32_t nof_used = 0;
+  for (uint32_t s = 0; s < hdr->nof_slots; ++s) {
+    if (slots[s] == 0) {
+      continue;
+    }
+    if (slots[s] > hdr->nof_records || records_offset(hdr->nof_slots) + slots[s] * sizeof(hss_ue_ctx_t) > map_len) {
+      return false;
+    }
+    ++nof_used;
+  }
+  return nof_used == hdr->nof_records;
+}
+
+bool hss_db::open(const std::string& path)
+{
+  close();
+
+  int fd = ::open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    logger.info("Could not open subscriber store %s: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(hss_db_header_t)) {
+    logger.warning("Subscriber store %s is not valid", path.c_str());
+    ::close(fd);
+    return false;
+  }
+  bool mapped = map(fd, st.st_size);
+  ::close(fd);
+  if (not mapped) {
+    return false;
+  }
+
+  if (memcmp(hdr->magic, HSS_DB_MAGIC, sizeof(HSS_DB_MAGIC)) != 0 || hdr->version != HSS_DB_VERSION ||
+      hdr->record_size != sizeof(hss_ue_ctx_t) || hdr->nof_slots == 0 || (hdr->nof_slots & (hdr->nof_slots - 1)) ||
+      hdr->nof_slots <= hdr->nof_records || map_len != store_len(hdr->nof_records, hdr->nof_slots)) {
+    logger.warning("Subscriber store %s is not valid or has an incompatible format", path.c_str());
+    close();
+    return false;
+  }
+  set_layout();
+
+  if (not check_index()) {
+    logger.warning("Subscriber store %s has a corrupted index", path.c_str());
+    close();
+    return false;
+  }
+
+  logger.info("Mapped subscriber store %s with %d users", path.c_str(), hdr->nof_records);
+  return true;
+}
+
+bool hss_db::create(const std::string& path, const std::vector<hss_ue_ctx_t>& ues, const hss_db_csv_stamp_t& stamp)
+{
+  close();
+
+  // Keep the index at most half full
+  uint32_t nof_slots = 16;
+  while (nof_slots < 2 * ues.size()) {
+    nof_slots <<= 1;
+  }
+  size_t len = store_len(ues.size(), nof_slots);
+
+  // Build the new store next to the old one and replace it once complete
+  int         fd = -1;
+  std::string tmp_path;
+  if (not path.empty()) {
+    tmp_path = path + ".tmp";
+    fd       = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+      logger.error("Could not create subscriber store %s: %s", tmp_path.c_str(), strerror(errno));
+      return false;
+    }
+    if (ftruncate(fd, len) != 0) {
+      logger.error("Could not resize subscriber store %s: %s", tmp_path.c_str(), strerror(errno));
+      ::close(fd);
+      unlink(tmp_path.c_str());
+      return false;
+    }
+  }
+  bool mapped = map(fd, len);
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (not mapped) {
+    if (not tmp_path.empty()) {
+      unlink(tmp_path.c_str());
+    }
+    return false;
+  }
+
+  // Fresh mappings are zeroed, i.e. all index slots are empty
+  memcpy(hdr->magic, HSS_DB_MAGIC, sizeof(HSS_DB_MAGIC));
+  hdr->version     = HSS_DB_VERSION;
+  hdr->record_size = sizeof(hss_ue_ctx_t);
+  hdr->nof_records = ues.size();
+  hdr->nof_slots   = nof_slots;
+  hdr->csv_stamp   = stamp;
+  set_layout();
+
+  for (uint32_t i = 0; i < ues.size(); ++i) {
+    records[i] = ues[i];
+    uint32_t s = slot_of(ues[i].imsi, nof_slots);
+    for (; slots[s] != 0; s = (s + 1) & (nof_slots - 1)) {
+      if (records[slots[s] - 1].imsi == ues[i].imsi) {
+        logger.error("Duplicate IMSI %015" PRIu64 " in subscriber store", ues[i].imsi);
+        close();
+        if (not tmp_path.empty()) {
+          unlink(tmp_path.c_str());
+        }
+        return false;
+      }
+    }
+    slots[s] = i + 1;
+  }
+
+  if (not tmp_path.empty()) {
+    if (msync(base, map_len, MS_SYNC) != 0 || rename(tmp_path.c_str(), path.c_str()) != 0) {
+      logger.error("Could not write subscriber store %s: %s", path.c_str(), strerror(errno));
+      close();
+      unlink(tmp_path.c_str());
+      return false;
+    }
+    logger.info("Created subscriber store %s with %zd users", path.c_str(), ues.size());
+  }
+  return true;
+}
+
+void hss_db::close()
+{
+  if (base != nullptr) {
+    munmap(base, map_len);
+  }
+  base    = nullptr;
+  map_len = 0;
+  hdr     = nullptr;
+  slots   = nullptr;
+  records = nullptr;
+}
+
+hss_ue_ctx_t* hss_db::find(uint64_t imsi)
+{
+  if (hdr == nullptr) {
+    return nullptr;
+  }
+  for (uint32_t s = slot_of(imsi, hdr->nof_slots); slots[s] != 0; s = (s + 1) & (hdr->nof_slots - 1)) {
+    hss_ue_ctx_t* ue_ctx = &records[slots[s] - 1];
+    if (ue_ctx->imsi == imsi) {
+      return ue_ctx;
+    }
+  }
+  return nullptr;
+}
+
+uint32_t hss_db::size() const
+{
+  return (hdr != nullptr) ? hdr->nof_records : 0;
+}
+
+hss_db_csv_stamp_t hss_db::get_csv_stamp() const
+{
+  return (hdr != nullptr) ? hdr->csv_stamp : hss_db_csv_stamp_t{};
+}
+
+void hss_db::set_csv_stamp(const hss_db_csv_stamp_t& stamp)
+{
+  if (hdr != nullptr) {
+    hdr->csv_stamp = stamp;
+  }
+}
+
+hss_db_csv_stamp_t hss_db::stat_csv(const std::string& path)
+{
+  struct stat        st    = {};
+  hss_db_csv_stamp_t stamp = {};
+  if (stat(path.c_str(), &st) == 0) {
+    stamp.mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    stamp.size     = st.st_size;
+  }
+  return stamp;
+}
+
+} // namespace srsepc
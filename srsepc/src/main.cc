@@ -87,6 +87,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   string   integrity_algo;
   uint16_t paging_timer     = 0;
   uint32_t max_paging_queue = 0;
+  uint32_t spgw_batch_size  = 0;
+  uint32_t spgw_nof_workers = 0;
   string   spgw_bind_addr;
   string   sgi_if_addr;
   string   sgi_if_name;
@@ -95,6 +97,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   string   short_net_name;
   bool     request_imeisv;
   string   hss_db_file;
+  string   hss_db_store;
+  uint32_t hss_auth_vector_cache = 0;
+  uint32_t hss_auth_workers      = 0;
   string   hss_auth_algo;
   string   log_filename;
   string   lac;
@@ -127,10 +132,15 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("mme.request_imeisv",  bpo::value<bool>(&request_imeisv)->default_value(false),         "Enable IMEISV request in Security mode command")
     ("mme.lac",             bpo::value<string>(&lac)->default_value("0x01"),                 "Location Area Code")
     ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file that stores UE's keys")
+    ("hss.db_store",        bpo::value<string>(&hss_db_store)->default_value(""),            "Binary subscriber store imported from db_file (empty to keep users in memory only)")
+    ("hss.auth_vector_cache", bpo::value<uint32_t>(&hss_auth_vector_cache)->default_value(0),  "Number of authentication vectors precomputed per UE (0 to disable)")
+    ("hss.auth_workers",    bpo::value<uint32_t>(&hss_auth_workers)->default_value(2),        "Number of threads precomputing authentication vectors")
     ("spgw.gtpu_bind_addr", bpo::value<string>(&spgw_bind_addr)->default_value("127.0.0.1"), "IP address of SP-GW for the S1-U connection")
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
     ("spgw.sgi_if_name",    bpo::value<string>(&sgi_if_name)->default_value("srs_spgw_sgi"), "Name of TUN interface for the SGi connection")
     ("spgw.max_paging_queue", bpo::value<uint32_t>(&max_paging_queue)->default_value(100), "Max number of packets in paging queue")
+    ("spgw.batch_size",     bpo::value<uint32_t>(&spgw_batch_size)->default_value(32),        "Max number of user plane packets read or sent per system call")
+    ("spgw.nof_workers",    bpo::value<uint32_t>(&spgw_nof_workers)->default_value(1),        "Number of user plane worker threads")
 
     ("pcap.enable",   bpo::value<bool>(&args->mme_args.s1ap_args.pcap_enable)->default_value(false),         "Enable S1AP PCAP")
     ("pcap.filename", bpo::value<string>(&args->mme_args.s1ap_args.pcap_filename)->default_value("/tmp/epc.pcap"), "PCAP filename")
@@ -295,7 +305,12 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   args->spgw_args.sgi_if_addr             = sgi_if_addr;
   args->spgw_args.sgi_if_name             = sgi_if_name;
   args->spgw_args.max_paging_queue        = max_paging_queue;
+  args->spgw_args.batch_size              = spgw_batch_size;
+  args->spgw_args.nof_workers             = spgw_nof_workers;
   args->hss_args.db_file                  = hss_db_file;
+  args->hss_args.db_store                 = hss_db_store;
+  args->hss_args.auth_vector_cache        = hss_auth_vector_cache;
+  args->hss_args.auth_workers             = hss_auth_workers;
 
   // Apply all_level to any unset layers
   if (vm.count("log.all_level")) {
@@ -0,0 +1,806 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        main.cc
+ * Description: Attach load generator for the MME. Emulates one eNB serving
+ *              many UEs over S1-MME. Each UE runs an IMSI attach (attach
+ *              request, authentication, NAS security mode, initial context
+ *              setup and attach complete) and the attach rate and latency
+ *              are reported. Subscriber keys are derived from the IMSI, the
+ *              matching HSS user database is written with --gen_db.
+ *****************************************************************************/
+
+#include "srsran/asn1/liblte_mme.h"
+#include "srsran/asn1/s1ap.h"
+#include "srsran/common/bcd_helpers.h"
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/network_utils.h"
+#include "srsran/common/security.h"
+#include "srsran/common/standard_streams.h"
+#include "srsran/config.h"
+#include "srsran/srslog/srslog.h"
+#include <algorithm>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fstream>
+#include <inttypes.h>
+#include <iomanip>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <vector>
+
+using namespace asn1::s1ap;
+namespace bpo = boost::program_options;
+
+namespace {
+
+const uint16_t S1MME_PORT     = 36412;
+const uint32_t S1AP_PPID      = 18;
+const uint16_t NONUE_STREAM   = 0;
+const uint16_t UE_STREAM      = 1;
+const uint8_t  PDN_TRANS_ID   = 1;
+const uint8_t  LOADGEN_OPC[]  = {0x63, 0xbf, 0xa5, 0x0e, 0xe6, 0x52, 0x33, 0x65,
+                                 0xff, 0x14, 0xc1, 0xf4, 0x5f, 0x88, 0x73, 0x7d};
+const uint8_t  LOADGEN_AMF[2] = {0x90, 0x01};
+
+using clock_t_ = std::chrono::steady_clock;
+
+bool running = true;
+
+void sig_int_handler(int signo)
+{
+  running = false;
+}
+
+struct loadgen_args_t {
+  std::string mme_addr;
+  std::string enb_addr;
+  std::string mcc;
+  std::string mnc;
+  std::string algo;
+  std::string gen_db;
+  uint16_t    tac;
+  uint32_t    enb_id;
+  uint64_t    first_imsi;
+  uint32_t    nof_ues;
+  uint32_t    rate;
+  uint32_t    max_inflight;
+  uint32_t    timeout_ms;
+};
+
+enum class ue_state_t { idle, wait_auth, wait_smc, wait_ctxt_setup, wait_emm_info, attached, failed };
+
+struct sim_ue_t {
+  uint64_t                            imsi           = 0;
+  uint32_t                            mme_ue_s1ap_id = 0;
+  ue_state_t                          state          = ue_state_t::idle;
+  clock_t_::time_point                start;
+  uint32_t                            ul_count = 0;
+  srsran::CIPHERING_ALGORITHM_ID_ENUM cipher_algo;
+  srsran::INTEGRITY_ALGORITHM_ID_ENUM integ_algo;
+  uint8_t                             k_asme[32];
+  uint8_t                             k_nas_enc[32];
+  uint8_t                             k_nas_int[32];
+};
+
+/// Derives the subscriber key from the IMSI, so that the UEs and the generated HSS database agree.
+void ue_key(uint64_t imsi, uint8_t key[16])
+{
+  for (uint32_t i = 0; i < 16; i++) {
+    key[i] = (uint8_t)((imsi >> (8 * (i % 8))) ^ (0x5a + 17 * i));
+  }
+}
+
+std::string hex_string(const uint8_t* data, uint32_t len)
+{
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (uint32_t i = 0; i < len; i++) {
+    ss << std::setw(2) << (int)data[i];
+  }
+  return ss.str();
+}
+
+bool write_db(const loadgen_args_t& args)
+{
+  std::ofstream f(args.gen_db.c_str(), std::ofstream::out);
+  if (not f.is_open()) {
+    srsran::console("Could not open %s\n", args.gen_db.c_str());
+    return false;
+  }
+  f << "# Generated by srsepc_loadgen: " << args.nof_ues << " subscribers from IMSI " << args.first_imsi << "\n";
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    uint64_t imsi = args.first_imsi + i;
+    uint8_t  key[16];
+    ue_key(imsi, key);
+    f << "ue" << i << "," << args.algo << "," << std::setfill('0') << std::setw(15) << imsi << ","
+      << hex_string(key, 16) << ",opc," << hex_string(LOADGEN_OPC, 16) << "," << hex_string(LOADGEN_AMF, 2)
+      << ",000000001234,7,dynamic\n";
+  }
+  srsran::console("Wrote %d subscribers to %s\n", args.nof_ues, args.gen_db.c_str());
+  return true;
+}
+
+class enb_sim
+{
+public:
+  explicit enb_sim(const loadgen_args_t& args_) : args(args_), ues(args_.nof_ues) {}
+
+  bool connect();
+  int  run();
+
+private:
+  // S1AP
+  bool send_s1ap(const s1ap_pdu_c& pdu, uint16_t stream);
+  bool send_s1_setup_request();
+  bool send_initial_ue_message(uint32_t ue_idx);
+  bool send_ul_nas(uint32_t ue_idx, srsran::byte_buffer_t* nas);
+  bool send_initial_context_setup_response(uint32_t ue_idx, const init_context_setup_request_s& msg);
+  void handle_s1ap_rx(srsran::byte_buffer_t* pdu);
+  void handle_dl_nas(uint32_t ue_idx, srsran::byte_buffer_t* nas);
+
+  // NAS
+  void handle_authentication_request(uint32_t ue_idx, srsran::byte_buffer_t* nas);
+  void handle_security_mode_command(uint32_t ue_idx, srsran::byte_buffer_t* nas);
+  void protect_ul_nas(sim_ue_t& ue, srsran::byte_buffer_t* nas);
+  void unprotect_dl_nas(sim_ue_t& ue, srsran::byte_buffer_t* nas);
+
+  void attach_done(uint32_t ue_idx, bool success);
+  void check_timeouts(clock_t_::time_point now);
+  void report();
+
+  sim_ue_t* find_ue(uint32_t enb_ue_s1ap_id)
+  {
+    return (enb_ue_s1ap_id == 0 or enb_ue_s1ap_id > ues.size()) ? nullptr : &ues[enb_ue_s1ap_id - 1];
+  }
+
+  const loadgen_args_t&     args;
+  srslog::basic_logger&     logger = srslog::fetch_basic_logger("LOADGEN");
+  srsran::unique_socket     socket;
+  sockaddr_in               mme_addr = {};
+  uint16_t                  mcc      = 0;
+  uint16_t                  mnc      = 0;
+  tai_s                     tai;
+  eutran_cgi_s              eutran_cgi;
+  bool                      s1_setup_done = false;
+  std::vector<sim_ue_t>     ues;
+  std::vector<double>       latencies_ms;
+  uint32_t                  nof_started  = 0;
+  uint32_t                  nof_inflight = 0;
+  uint32_t                  nof_attached = 0;
+  uint32_t                  nof_failed   = 0;
+  clock_t_::time_point      t_start;
+  clock_t_::time_point      t_last_report;
+  uint32_t                  last_report_attached = 0;
+};
+
+bool enb_sim::connect()
+{
+  if (not srsran::string_to_mcc(args.mcc, &mcc) or not srsran::string_to_mnc(args.mnc, &mnc)) {
+    srsran::console("Invalid MCC/MNC %s/%s\n", args.mcc.c_str(), args.mnc.c_str());
+    return false;
+  }
+  uint32_t plmn;
+  srsran::s1ap_mccmnc_to_plmn(mcc, mnc, &plmn);
+  tai.plm_nid.from_number(plmn);
+  tai.tac.from_number(args.tac);
+  eutran_cgi.plm_nid.from_number(plmn);
+  eutran_cgi.cell_id.from_number((args.enb_id << 8U) | 1U);
+
+  using namespace srsran::net_utils;
+  if (not socket.open_socket(addr_family::ipv4, socket_type::seqpacket, protocol_type::SCTP)) {
+    return false;
+  }
+  if (not socket.bind_addr(args.enb_addr.c_str(), 0)) {
+    socket.close();
+    return false;
+  }
+  if (not socket.connect_to(args.mme_addr.c_str(), S1MME_PORT, &mme_addr)) {
+    return false;
+  }
+  return send_s1_setup_request();
+}
+
+bool enb_sim::send_s1ap(const s1ap_pdu_c& pdu, uint16_t stream)
+{
+  srsran::unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  if (buf == nullptr) {
+    logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return false;
+  }
+  asn1::bit_ref bref(buf->msg, buf->get_tailroom());
+  if (pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+    logger.error("Failed to pack S1AP PDU");
+    return false;
+  }
+  buf->N_bytes = bref.distance_bytes();
+
+  ssize_t n_sent = sctp_sendmsg(socket.fd(),
+                                buf->msg,
+                                buf->N_bytes,
+                                (struct sockaddr*)&mme_addr,
+                                sizeof(struct sockaddr_in),
+                                htonl(S1AP_PPID),
+                                0,
+                                stream,
+                                0,
+                                0);
+  if (n_sent == -1) {
+    logger.error("Failure sending S1AP PDU: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool enb_sim::send_s1_setup_request()
+{
+  uint32_t plmn;
+  srsran::s1ap_mccmnc_to_plmn(mcc, mnc, &plmn);
+  plmn = htonl(plmn);
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+  s1_setup_request_s& container             = pdu.init_msg().value.s1_setup_request();
+  container->global_enb_id.value.plm_nid[0] = ((uint8_t*)&plmn)[1];
+  container->global_enb_id.value.plm_nid[1] = ((uint8_t*)&plmn)[2];
+  container->global_enb_id.value.plm_nid[2] = ((uint8_t*)&plmn)[3];
+  container->global_enb_id.value.enb_id.set_macro_enb_id().from_number(args.enb_id);
+
+  container->enbname_present = true;
+  container->enbname.value.from_string("srsepc_loadgen");
+
+  uint16_t tmp16 = htons(args.tac);
+  container->supported_tas.value.resize(1);
+  memcpy(container->supported_tas.value[0].tac.data(), (uint8_t*)&tmp16, 2);
+  container->supported_tas.value[0].broadcast_plmns.resize(1);
+  container->supported_tas.value[0].broadcast_plmns[0][0] = ((uint8_t*)&plmn)[1];
+  container->supported_tas.value[0].broadcast_plmns[0][1] = ((uint8_t*)&plmn)[2];
+  container->supported_tas.value[0].broadcast_plmns[0][2] = ((uint8_t*)&plmn)[3];
+
+  container->default_paging_drx.value.value = paging_drx_opts::v128;
+  return send_s1ap(pdu, NONUE_STREAM);
+}
+
+bool enb_sim::send_initial_ue_message(uint32_t ue_idx)
+{
+  sim_ue_t& ue = ues[ue_idx];
+  ue.imsi      = args.first_imsi + ue_idx;
+
+  // PDN connectivity request, without ESM information transfer
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT           attach_req  = {};
+  LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+  pdn_con_req.eps_bearer_id                                  = 0;
+  pdn_con_req.proc_transaction_id                            = PDN_TRANS_ID;
+  pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+  pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+  liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+  // IMSI attach, advertising all EEA/EIA algorithms
+  attach_req.eps_attach_type = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+  for (uint32_t i = 0; i < 4; i++) {
+    attach_req.ue_network_cap.eea[i] = true;
+    attach_req.ue_network_cap.eia[i] = true;
+  }
+  attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+  attach_req.nas_ksi.tsc_flag         = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  attach_req.nas_ksi.nas_ksi          = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+  uint64_t imsi                       = ue.imsi;
+  for (int i = 14; i >= 0; i--) {
+    attach_req.eps_mobile_id.imsi[i] = imsi % 10;
+    imsi /= 10;
+  }
+
+  srsran::unique_byte_buffer_t nas = srsran::make_byte_buffer();
+  if (nas == nullptr) {
+    logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return false;
+  }
+  liblte_mme_pack_attach_request_msg(&attach_req, (LIBLTE_BYTE_MSG_STRUCT*)nas.get());
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+  init_ue_msg_s& container        = pdu.init_msg().value.init_ue_msg();
+  container->enb_ue_s1ap_id.value = ue_idx + 1;
+  container->nas_pdu.value.resize(nas->N_bytes);
+  memcpy(container->nas_pdu.value.data(), nas->msg, nas->N_bytes);
+  container->tai.value                     = tai;
+  container->eutran_cgi.value              = eutran_cgi;
+  container->rrc_establishment_cause.value = rrc_establishment_cause_opts::mo_sig;
+
+  ue.state    = ue_state_t::wait_auth;
+  ue.start    = clock_t_::now();
+  ue.ul_count = 0;
+  return send_s1ap(pdu, UE_STREAM);
+}
+
+bool enb_sim::send_ul_nas(uint32_t ue_idx, srsran::byte_buffer_t* nas)
+{
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+  ul_nas_transport_s& container   = pdu.init_msg().value.ul_nas_transport();
+  container->mme_ue_s1ap_id.value = ues[ue_idx].mme_ue_s1ap_id;
+  container->enb_ue_s1ap_id.value = ue_idx + 1;
+  container->nas_pdu.value.resize(nas->N_bytes);
+  memcpy(container->nas_pdu.value.data(), nas->msg, nas->N_bytes);
+  container->eutran_cgi.value = eutran_cgi;
+  container->tai.value        = tai;
+  return send_s1ap(pdu, UE_STREAM);
+}
+
+bool enb_sim::send_initial_context_setup_response(uint32_t ue_idx, const init_context_setup_request_s& msg)
+{
+  s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_INIT_CONTEXT_SETUP);
+  auto& container                 = pdu.successful_outcome().value.init_context_setup_resp();
+  container->mme_ue_s1ap_id.value = ues[ue_idx].mme_ue_s1ap_id;
+  container->enb_ue_s1ap_id.value = ue_idx + 1;
+
+  in_addr_t addr = inet_addr(args.enb_addr.c_str());
+  container->erab_setup_list_ctxt_su_res.value.resize(msg->erab_to_be_setup_list_ctxt_su_req.value.size());
+  for (uint32_t i = 0; i < msg->erab_to_be_setup_list_ctxt_su_req.value.size(); i++) {
+    const erab_to_be_setup_item_ctxt_su_req_s& req =
+        msg->erab_to_be_setup_list_ctxt_su_req.value[i]->erab_to_be_setup_item_ctxt_su_req();
+    container->erab_setup_list_ctxt_su_res.value[i].load_info_obj(ASN1_S1AP_ID_ERAB_SETUP_ITEM_CTXT_SU_RES);
+    auto& item   = container->erab_setup_list_ctxt_su_res.value[i]->erab_setup_item_ctxt_su_res();
+    item.erab_id = req.erab_id;
+    item.transport_layer_address.resize(32);
+    for (uint32_t j = 0; j < 4; ++j) {
+      item.transport_layer_address.data()[j] = ((uint8_t*)&addr)[3 - j];
+    }
+    item.gtp_teid.from_number(((ue_idx + 1) << 4U) | req.erab_id);
+  }
+  return send_s1ap(pdu, UE_STREAM);
+}
+
+void enb_sim::handle_s1ap_rx(srsran::byte_buffer_t* pdu)
+{
+  s1ap_pdu_c     rx_pdu;
+  asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
+  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+    logger.error("Failed to unpack received S1AP PDU");
+    return;
+  }
+
+  switch (rx_pdu.type().value) {
+    case s1ap_pdu_c::types_opts::init_msg: {
+      const init_msg_s& msg = rx_pdu.init_msg();
+      if (msg.value.type().value == s1ap_elem_procs_o::init_msg_c::types_opts::dl_nas_transport) {
+        const dl_nas_transport_s& dl = msg.value.dl_nas_transport();
+        sim_ue_t*                 ue = find_ue(dl->enb_ue_s1ap_id.value.value);
+        if (ue == nullptr) {
+          logger.warning("DL NAS transport for unknown eNB UE S1AP Id %" PRIu64, dl->enb_ue_s1ap_id.value.value);
+          return;
+        }
+        ue->mme_ue_s1ap_id               = dl->mme_ue_s1ap_id.value.value;
+        srsran::unique_byte_buffer_t nas = srsran::make_byte_buffer();
+        if (nas == nullptr) {
+          logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+          return;
+        }
+        memcpy(nas->msg, dl->nas_pdu.value.data(), dl->nas_pdu.value.size());
+        nas->N_bytes = dl->nas_pdu.value.size();
+        handle_dl_nas(ue - ues.data(), nas.get());
+      } else if (msg.value.type().value == s1ap_elem_procs_o::init_msg_c::types_opts::init_context_setup_request) {
+        const init_context_setup_request_s& req    = msg.value.init_context_setup_request();
+        uint32_t                            ue_idx = req->enb_ue_s1ap_id.value.value - 1;
+        if (find_ue(req->enb_ue_s1ap_id.value.value) == nullptr or ues[ue_idx].state != ue_state_t::wait_ctxt_setup) {
+          logger.warning("Unexpected Initial Context Setup Request");
+          return;
+        }
+        send_initial_context_setup_response(ue_idx, req);
+
+        // Attach complete, carrying the activate default EPS bearer context accept of the first E-RAB
+        sim_ue_t&                             ue                = ues[ue_idx];
+        LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT attach_complete   = {};
+        LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT act_bearer = {};
+        act_bearer.eps_bearer_id =
+            req->erab_to_be_setup_list_ctxt_su_req.value[0]->erab_to_be_setup_item_ctxt_su_req().erab_id;
+        act_bearer.proc_transaction_id = PDN_TRANS_ID;
+        liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_bearer, &attach_complete.esm_msg);
+
+        srsran::unique_byte_buffer_t nas = srsran::make_byte_buffer();
+        if (nas == nullptr) {
+          logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+          return;
+        }
+        liblte_mme_pack_attach_complete_msg(&attach_complete,
+                                            LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED,
+                                            ue.ul_count,
+                                            (LIBLTE_BYTE_MSG_STRUCT*)nas.get());
+        protect_ul_nas(ue, nas.get());
+        send_ul_nas(ue_idx, nas.get());
+        ue.state = ue_state_t::wait_emm_info;
+      }
+      break;
+    }
+    case s1ap_pdu_c::types_opts::successful_outcome:
+      if (rx_pdu.successful_outcome().value.type().value ==
+          s1ap_elem_procs_o::successful_outcome_c::types_opts::s1_setup_resp) {
+        srsran::console("S1 Setup complete\n");
+        s1_setup_done = true;
+      }
+      break;
+    case s1ap_pdu_c::types_opts::unsuccessful_outcome:
+      if (rx_pdu.unsuccessful_outcome().value.type().value ==
+          s1ap_elem_procs_o::unsuccessful_outcome_c::types_opts::s1_setup_fail) {
+        srsran::console("S1 Setup failed\n");
+        running = false;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void enb_sim::handle_dl_nas(uint32_t ue_idx, srsran::byte_buffer_t* nas)
+{
+  sim_ue_t& ue = ues[ue_idx];
+  uint8_t   pd, sec_hdr_type, msg_type;
+  liblte_mme_parse_msg_sec_header((LIBLTE_BYTE_MSG_STRUCT*)nas, &pd, &sec_hdr_type);
+  if (sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED) {
+    unprotect_dl_nas(ue, nas);
+  }
+  liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*)nas, &pd, &msg_type);
+
+  switch (msg_type) {
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+      handle_authentication_request(ue_idx, nas);
+      break;
+    case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+      handle_security_mode_command(ue_idx, nas);
+      break;
+    case LIBLTE_MME_MSG_TYPE_EMM_INFORMATION:
+      if (ue.state == ue_state_t::wait_emm_info) {
+        attach_done(ue_idx, true);
+      }
+      break;
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REJECT:
+    case LIBLTE_MME_MSG_TYPE_ATTACH_REJECT:
+      logger.warning("Attach rejected. IMSI %015" PRIu64, ue.imsi);
+      attach_done(ue_idx, false);
+      break;
+    default:
+      logger.debug("Ignoring DL NAS message %s", liblte_nas_msg_type_to_string(msg_type));
+      break;
+  }
+}
+
+void enb_sim::handle_authentication_request(uint32_t ue_idx, srsran::byte_buffer_t* nas)
+{
+  sim_ue_t&                                    ue       = ues[ue_idx];
+  LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+  liblte_mme_unpack_authentication_request_msg((LIBLTE_BYTE_MSG_STRUCT*)nas, &auth_req);
+
+  // The network is trusted, so neither the AUTN MAC nor the SQN are verified
+  uint8_t key[16], ck[16], ik[16], ak[6];
+  ue_key(ue.imsi, key);
+  LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_resp = {};
+  auth_resp.res_len                                       = 8;
+  if (args.algo == "xor") {
+    srsran::security_xor_f2345(key, auth_req.rand, auth_resp.res, ck, ik, ak);
+  } else {
+    srsran::security_milenage_f2345(key, (uint8_t*)LOADGEN_OPC, auth_req.rand, auth_resp.res, ck, ik, ak);
+  }
+  // AUTN starts with SQN xor AK
+  srsran::security_generate_k_asme(ck, ik, auth_req.autn, mcc, mnc, ue.k_asme);
+
+  srsran::unique_byte_buffer_t tx = srsran::make_byte_buffer();
+  if (tx == nullptr) {
+    logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return;
+  }
+  liblte_mme_pack_authentication_response_msg(
+      &auth_resp, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS, 0, (LIBLTE_BYTE_MSG_STRUCT*)tx.get());
+  send_ul_nas(ue_idx, tx.get());
+  ue.state = ue_state_t::wait_smc;
+}
+
+void enb_sim::handle_security_mode_command(uint32_t ue_idx, srsran::byte_buffer_t* nas)
+{
+  sim_ue_t&                                   ue     = ues[ue_idx];
+  LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT sm_cmd = {};
+  liblte_mme_unpack_security_mode_command_msg((LIBLTE_BYTE_MSG_STRUCT*)nas, &sm_cmd);
+
+  ue.cipher_algo = (srsran::CIPHERING_ALGORITHM_ID_ENUM)sm_cmd.selected_nas_sec_algs.type_of_eea;
+  ue.integ_algo  = (srsran::INTEGRITY_ALGORITHM_ID_ENUM)sm_cmd.selected_nas_sec_algs.type_of_eia;
+  srsran::security_generate_k_nas(ue.k_asme, ue.cipher_algo, ue.integ_algo, ue.k_nas_enc, ue.k_nas_int);
+
+  LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT sm_comp = {};
+  srsran::unique_byte_buffer_t                 tx      = srsran::make_byte_buffer();
+  if (tx == nullptr) {
+    logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return;
+  }
+  ue.ul_count = 0;
+  uint8_t sec_hdr_type = LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT;
+  liblte_mme_pack_security_mode_complete_msg(&sm_comp, sec_hdr_type, ue.ul_count, (LIBLTE_BYTE_MSG_STRUCT*)tx.get());
+  protect_ul_nas(ue, tx.get());
+  send_ul_nas(ue_idx, tx.get());
+  ue.state = ue_state_t::wait_ctxt_setup;
+}
+
+void enb_sim::protect_ul_nas(sim_ue_t& ue, srsran::byte_buffer_t* nas)
+{
+  // Cipher the plain NAS message, then compute the MAC over the sequence number and the ciphered message
+  uint8_t       ciphered[SRSRAN_MAX_BUFFER_SIZE_BYTES];
+  uint8_t*      k_enc = &ue.k_nas_enc[16];
+  uint8_t*      k_int = &ue.k_nas_int[16];
+  uint32_t      len   = nas->N_bytes;
+  const uint8_t dir   = srsran::SECURITY_DIRECTION_UPLINK;
+  switch (ue.cipher_algo) {
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA1:
+      srsran::security_128_eea1(k_enc, ue.ul_count, 0, dir, &nas->msg[6], len - 6, ciphered);
+      memcpy(&nas->msg[6], ciphered, len - 6);
+      break;
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA2:
+      srsran::security_128_eea2(k_enc, ue.ul_count, 0, dir, &nas->msg[6], len - 6, ciphered);
+      memcpy(&nas->msg[6], ciphered, len - 6);
+      break;
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA3:
+      srsran::security_128_eea3(k_enc, ue.ul_count, 0, dir, &nas->msg[6], len - 6, ciphered);
+      memcpy(&nas->msg[6], ciphered, len - 6);
+      break;
+    default:
+      break;
+  }
+
+  switch (ue.integ_algo) {
+    case srsran::INTEGRITY_ALGORITHM_ID_128_EIA1:
+      srsran::security_128_eia1(k_int, ue.ul_count, 0, dir, &nas->msg[5], len - 5, &nas->msg[1]);
+      break;
+    case srsran::INTEGRITY_ALGORITHM_ID_128_EIA2:
+      srsran::security_128_eia2(k_int, ue.ul_count, 0, dir, &nas->msg[5], len - 5, &nas->msg[1]);
+      break;
+    case srsran::INTEGRITY_ALGORITHM_ID_128_EIA3:
+      srsran::security_128_eia3(k_int, ue.ul_count, 0, dir, &nas->msg[5], len - 5, &nas->msg[1]);
+      break;
+    default:
+      break;
+  }
+  ue.ul_count++;
+}
+
+void enb_sim::unprotect_dl_nas(sim_ue_t& ue, srsran::byte_buffer_t* nas)
+{
+  // The MAC of DL messages is not verified, only the deciphering is needed to parse them
+  uint8_t       plain[SRSRAN_MAX_BUFFER_SIZE_BYTES];
+  uint8_t*      k_enc = &ue.k_nas_enc[16];
+  uint32_t      count = nas->msg[5];
+  uint32_t      len   = nas->N_bytes;
+  const uint8_t dir   = srsran::SECURITY_DIRECTION_DOWNLINK;
+  switch (ue.cipher_algo) {
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA1:
+      srsran::security_128_eea1(k_enc, count, 0, dir, &nas->msg[6], len - 6, plain);
+      memcpy(&nas->msg[6], plain, len - 6);
+      break;
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA2:
+      srsran::security_128_eea2(k_enc, count, 0, dir, &nas->msg[6], len - 6, plain);
+      memcpy(&nas->msg[6], plain, len - 6);
+      break;
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA3:
+      srsran::security_128_eea3(k_enc, count, 0, dir, &nas->msg[6], len - 6, plain);
+      memcpy(&nas->msg[6], plain, len - 6);
+      break;
+    default:
+      break;
+  }
+}
+
+void enb_sim::attach_done(uint32_t ue_idx, bool success)
+{
+  sim_ue_t& ue = ues[ue_idx];
+  if (ue.state == ue_state_t::attached or ue.state == ue_state_t::failed or ue.state == ue_state_t::idle) {
+    return;
+  }
+  nof_inflight--;
+  if (success) {
+    nof_attached++;
+    ue.state = ue_state_t::attached;
+    latencies_ms.push_back(std::chrono::duration<double, std::milli>(clock_t_::now() - ue.start).count());
+  } else {
+    nof_failed++;
+    ue.state = ue_state_t::failed;
+  }
+}
+
+void enb_sim::check_timeouts(clock_t_::time_point now)
+{
+  for (uint32_t i = 0; i < nof_started; i++) {
+    sim_ue_t& ue = ues[i];
+    if (ue.state != ue_state_t::attached and ue.state != ue_state_t::failed and
+        now - ue.start > std::chrono::milliseconds(args.timeout_ms)) {
+      logger.warning("Attach timed out. IMSI %015" PRIu64, ue.imsi);
+      attach_done(i, false);
+    }
+  }
+}
+
+void enb_sim::report()
+{
+  double elapsed = std::chrono::duration<double>(clock_t_::now() - t_start).count();
+  srsran::console("Attached %d/%d UEs, %d failed, in %.2f s: %.1f attaches/s\n",
+                  nof_attached,
+                  args.nof_ues,
+                  nof_failed,
+                  elapsed,
+                  elapsed > 0 ? nof_attached / elapsed : 0.0);
+  if (latencies_ms.empty()) {
+    return;
+  }
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  auto pct = [this](double p) {
+    return latencies_ms[std::min<size_t>(latencies_ms.size() * p, latencies_ms.size() - 1)];
+  };
+  srsran::console("Attach latency (ms): p50 %.2f, p90 %.2f, p99 %.2f, max %.2f\n",
+                  pct(0.5),
+                  pct(0.9),
+                  pct(0.99),
+                  latencies_ms.back());
+}
+
+int enb_sim::run()
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  if (pdu == nullptr) {
+    logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return SRSRAN_ERROR;
+  }
+  latencies_ms.reserve(args.nof_ues);
+
+  struct pollfd pfd = {};
+  pfd.fd            = socket.fd();
+  pfd.events        = POLLIN;
+
+  clock_t_::time_point t_timeout_check;
+  while (running and nof_attached + nof_failed < args.nof_ues) {
+    clock_t_::time_point now = clock_t_::now();
+
+    // Start new attaches at the configured rate, with a bounded number of procedures in flight
+    if (s1_setup_done) {
+      if (nof_started == 0) {
+        t_start = t_last_report = t_timeout_check = now;
+      }
+      double   elapsed = std::chrono::duration<double>(now - t_start).count();
+      uint64_t due     = args.rate > 0 ? (uint64_t)(elapsed * args.rate) + 1 : args.nof_ues;
+      while (nof_started < args.nof_ues and nof_started < due and nof_inflight < args.max_inflight) {
+        if (send_initial_ue_message(nof_started)) {
+          nof_inflight++;
+        } else {
+          nof_failed++;
+          ues[nof_started].state = ue_state_t::failed;
+        }
+        nof_started++;
+      }
+    }
+
+    // Drain all received PDUs
+    if (poll(&pfd, 1, 1) > 0) {
+      while (true) {
+        sockaddr_in     from    = {};
+        socklen_t       fromlen = sizeof(from);
+        sctp_sndrcvinfo sri     = {};
+        int             flags   = MSG_DONTWAIT;
+        int rd_sz = sctp_recvmsg(socket.fd(), pdu->msg, pdu->get_tailroom(), (sockaddr*)&from, &fromlen, &sri, &flags);
+        if (rd_sz <= 0) {
+          break;
+        }
+        if (flags & MSG_NOTIFICATION) {
+          continue;
+        }
+        pdu->N_bytes = rd_sz;
+        handle_s1ap_rx(pdu.get());
+        pdu->clear();
+      }
+    }
+
+    if (s1_setup_done and now - t_timeout_check > std::chrono::milliseconds(100)) {
+      check_timeouts(now);
+      t_timeout_check = now;
+    }
+    if (s1_setup_done and now - t_last_report > std::chrono::seconds(1)) {
+      double dt = std::chrono::duration<double>(now - t_last_report).count();
+      srsran::console("%d attached, %d in flight, %d failed, %.1f attaches/s\n",
+                      nof_attached,
+                      nof_inflight,
+                      nof_failed,
+                      (nof_attached - last_report_attached) / dt);
+      last_report_attached = nof_attached;
+      t_last_report        = now;
+    }
+  }
+  report();
+  return nof_failed == 0 and nof_attached == args.nof_ues ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+}
+
+bool parse_args(loadgen_args_t* args, int argc, char* argv[])
+{
+  bpo::options_description options("Options");
+  // clang-format off
+  options.add_options()
+    ("help,h",        "Produce help message")
+    ("mme_addr",      bpo::value<std::string>(&args->mme_addr)->default_value("127.0.1.100"), "IP address of the MME S1-MME interface")
+    ("enb_addr",      bpo::value<std::string>(&args->enb_addr)->default_value("127.0.1.1"),   "Local IP address of the emulated eNB")
+    ("mcc",           bpo::value<std::string>(&args->mcc)->default_value("001"),              "Mobile Country Code")
+    ("mnc",           bpo::value<std::string>(&args->mnc)->default_value("01"),               "Mobile Network Code")
+    ("tac",           bpo::value<uint16_t>(&args->tac)->default_value(7),                     "Tracking Area Code")
+    ("enb_id",        bpo::value<uint32_t>(&args->enb_id)->default_value(0x19B),              "eNB ID")
+    ("algo",          bpo::value<std::string>(&args->algo)->default_value("mil"),             "Authentication algorithm of the subscribers (mil or xor)")
+    ("first_imsi",    bpo::value<uint64_t>(&args->first_imsi)->default_value(1010000100000ULL), "IMSI of the first UE")
+    ("nof_ues",       bpo::value<uint32_t>(&args->nof_ues)->default_value(1000),              "Number of UEs to attach")
+    ("rate",          bpo::value<uint32_t>(&args->rate)->default_value(1000),                 "Attach requests started per second (0 for as fast as possible)")
+    ("max_inflight",  bpo::value<uint32_t>(&args->max_inflight)->default_value(500),          "Maximum number of attach procedures in flight")
+    ("timeout_ms",    bpo::value<uint32_t>(&args->timeout_ms)->default_value(5000),           "Attach procedure timeout in milliseconds")
+    ("gen_db",        bpo::value<std::string>(&args->gen_db)->default_value(""),              "Write the HSS user database for the UEs to this file and exit")
+    ;
+  // clang-format on
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::parse_command_line(argc, argv, options), vm);
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  if (vm.count("help")) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << std::endl << options << std::endl;
+    exit(0);
+  }
+  if (args->algo != "mil" and args->algo != "xor") {
+    std::cerr << "Unknown authentication algorithm " << args->algo << std::endl;
+    return false;
+  }
+  if (args->nof_ues == 0 or args->nof_ues >= (1U << 24U) or args->max_inflight == 0) {
+    std::cerr << "Invalid number of UEs" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  signal(SIGINT, sig_int_handler);
+  signal(SIGTERM, sig_int_handler);
+
+  loadgen_args_t args;
+  if (not parse_args(&args, argc, argv)) {
+    return SRSRAN_ERROR;
+  }
+  if (not args.gen_db.empty()) {
+    return write_db(args) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+  }
+
+  srslog::fetch_basic_logger("LOADGEN").set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  enb_sim enb(args);
+  if (not enb.connect()) {
+    srsran::console("Could not connect to the MME at %s\n", args.mme_addr.c_str());
+    return SRSRAN_ERROR;
+  }
+  int ret = enb.run();
+  srslog::flush();
+  return ret;
+}
@@ -23,6 +23,7 @@
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
 #include <netinet/sctp.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -38,7 +39,9 @@ mme::mme() : m_running(false), thread("MME")
 
 mme::~mme()
 {
-  return;
+  if (m_epoll_fd >= 0) {
+    close(m_epoll_fd);
+  }
 }
 
 mme* mme::get_instance(void)
@@ -70,6 +73,14 @@ int mme::init(mme_args_t* args)
     exit(-1);
   }
 
+  /*Init event loop. Timers are added and removed as NAS procedures run, so they are kept in an epoll set rather than
+   * re-scanned on every iteration*/
+  m_epoll_fd = epoll_create1(0);
+  if (m_epoll_fd < 0) {
+    m_s1ap_logger.error("Error creating epoll instance: %s", strerror(errno));
+    exit(-1);
+  }
+
   /*Init GTP-C*/
   m_mme_gtpc = mme_gtpc::get_instance();
   if (!m_mme_gtpc->init()) {
@@ -118,28 +129,28 @@ void mme::run_thread()
   int s1mme = m_s1ap->get_s1_mme();
   int s11   = m_mme_gtpc->get_s11();
 
-  while (m_running) {
-    pdu->clear();
-    int max_fd = std::max(s1mme, s11);
-
-    FD_ZERO(&m_set);
-    FD_SET(s1mme, &m_set);
-    FD_SET(s11, &m_set);
-
-    // Add timers to select
-    for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
-      FD_SET(it->fd, &m_set);
-      max_fd = std::max(max_fd, it->fd);
-      m_s1ap_logger.debug("Adding Timer fd %d to fd_set", it->fd);
-    }
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.fd            = s1mme;
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, s1mme, &ev);
+  ev.data.fd = s11;
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, s11, &ev);
 
+  struct epoll_event events[max_events];
+  while (m_running) {
     m_s1ap_logger.debug("Waiting for S1-MME or S11 Message");
-    int n = select(max_fd + 1, &m_set, NULL, NULL, NULL);
+    int n = epoll_wait(m_epoll_fd, events, max_events, -1);
     if (n == -1) {
-      m_s1ap_logger.error("Error from select");
-    } else if (n) {
-      // Handle S1-MME
-      if (FD_ISSET(s1mme, &m_set)) {
+      if (errno != EINTR) {
+        m_s1ap_logger.error("Error from epoll_wait: %s", strerror(errno));
+      }
+      continue;
+    }
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      pdu->clear();
+      if (fd == s1mme) {
+        // Handle S1-MME
         rd_sz = sctp_recvmsg(s1mme, pdu->msg, sz, (struct sockaddr*)&enb_addr, &fromlen, &sri, &msg_flags);
         if (rd_sz == -1 && errno != EAGAIN) {
           m_s1ap_logger.error("Error reading from SCTP socket: %s", strerror(errno));
@@ -162,27 +173,14 @@ void mme::run_thread()
             m_s1ap->handle_s1ap_rx_pdu(pdu.get(), &sri);
           }
         }
-      }
-      // Handle S11
-      if (FD_ISSET(s11, &m_set)) {
+      } else if (fd == s11) {
+        // Handle S11
         pdu->N_bytes = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
         m_mme_gtpc->handle_s11_pdu(pdu.get());
+      } else {
+        // Handle NAS Timers
+        handle_timer_expire(fd);
       }
-      // Handle NAS Timers
-      for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
-        if (FD_ISSET(it->fd, &m_set)) {
-          m_s1ap_logger.info("Timer expired");
-          uint64_t exp;
-          rd_sz = read(it->fd, &exp, sizeof(uint64_t));
-          m_s1ap->expire_nas_timer(it->type, it->imsi);
-          close(it->fd);
-          timers.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    } else {
-      m_s1ap_logger.debug("No data from select.");
     }
   }
   return;
@@ -200,40 +198,62 @@ bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
   timer.type = type;
   timer.imsi = imsi;
 
-  timers.push_back(timer);
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.fd            = timer_fd;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) < 0) {
+    m_s1ap_logger.error("Error adding timer fd %d to epoll set: %s", timer_fd, strerror(errno));
+    return false;
+  }
+  timers.insert(std::make_pair(timer_fd, timer));
+  timer_fds.insert(std::make_pair(timer_key(type, imsi), timer_fd));
   return true;
 }
 
 bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 {
-  std::vector<mme_timer_t>::iterator it;
-  for (it = timers.begin(); it != timers.end(); ++it) {
-    if (it->type == type && it->imsi == imsi) {
-      return true; // found timer
-    }
-  }
-  return false;
+  return timer_fds.count(timer_key(type, imsi)) > 0;
 }
 
 bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 {
-  std::vector<mme_timer_t>::iterator it;
-  for (it = timers.begin(); it != timers.end(); ++it) {
-    if (it->type == type && it->imsi == imsi) {
-      break; // found timer to remove
-    }
-  }
-  if (it == timers.end()) {
+  auto it = timer_fds.find(timer_key(type, imsi));
+  if (it == timer_fds.end()) {
     m_s1ap_logger.warning("Could not find timer to remove. IMSI %" PRIu64 ", Type %d", imsi, type);
     return false;
   }
 
   // removing timer
-  m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, it->fd);
-  FD_CLR(it->fd, &m_set);
-  close(it->fd);
-  timers.erase(it);
+  int fd = it->second;
+  m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, fd);
+  timer_fds.erase(it);
+  timers.erase(fd);
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
   return true;
 }
 
+void mme::handle_timer_expire(int timer_fd)
+{
+  auto it = timers.find(timer_fd);
+  if (it == timers.end()) {
+    m_s1ap_logger.warning("Event on unknown timer fd %d", timer_fd);
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, timer_fd, nullptr);
+    return;
+  }
+  m_s1ap_logger.info("Timer expired");
+  uint64_t    exp;
+  mme_timer_t timer = it->second;
+  if (read(timer_fd, &exp, sizeof(uint64_t)) < 0) {
+    m_s1ap_logger.warning("Error reading timer fd %d: %s", timer_fd, strerror(errno));
+  }
+
+  // The timer is one-shot. Remove it before notifying S1AP, which may start a new one for the same UE
+  timer_fds.erase(timer_key(timer.type, timer.imsi));
+  timers.erase(it);
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, timer_fd, nullptr);
+  close(timer_fd);
+  m_s1ap->expire_nas_timer(timer.type, timer.imsi);
+}
+
 } // namespace srsepc
@@ -464,6 +464,8 @@ spgw_tunnel_ctx_t* spgw::gtpc::create_gtpc_ctx(const struct srsran::gtpc_create_
   tunnel_ctx->dw_ctrl_fteid.ipv4 = cs_req.sender_f_teid.ipv4;
   std::memset(&tunnel_ctx->dw_user_fteid, 0, sizeof(srsran::gtp_fteid_t));
 
+  m_gtpu->add_uplink_tunnel(spgw_uplink_user_teid, ue_ip);
+
   m_teid_to_tunnel_ctx.insert(std::pair<uint32_t, spgw_tunnel_ctx_t*>(spgw_uplink_ctrl_teid, tunnel_ctx));
   m_imsi_to_ctr_teid.insert(std::pair<uint64_t, uint32_t>(cs_req.imsi, spgw_uplink_ctrl_teid));
   return tunnel_ctx;
@@ -481,6 +483,9 @@ bool spgw::gtpc::delete_gtpc_ctx(uint32_t ctrl_teid)
   // Remove Ctrl TEID from GTP-U Mapping
   m_gtpu->delete_gtpc_tunnel(tunnel_ctx->ue_ipv4);
 
+  // Remove uplink User TEID from GTP-U Mapping
+  m_gtpu->delete_uplink_tunnel(tunnel_ctx->up_user_fteid.teid);
+
   // Remove Ctrl TEID from IMSI to control TEID map
   m_imsi_to_ctr_teid.erase(tunnel_ctx->imsi);
 
@@ -33,6 +33,8 @@
 #include <linux/ip.h>
 #include <netinet/in.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 
 namespace srsepc {
@@ -62,6 +64,19 @@ int spgw::gtpu::init(spgw_args_t* args, spgw* spgw, gtpc_interface_gtpu* gtpc)
   m_spgw = spgw;
   m_gtpc = gtpc;
 
+  // User plane threads and tunnel tables
+  m_nof_workers = std::max(args->nof_workers, 1u);
+  m_batch_size  = std::max(args->batch_size, 1u);
+  m_rcu.reset(new srsran::rcu_domain(m_nof_workers));
+  m_ip_to_tunnel.reset(new srsran::rcu_hash_map<in_addr_t, ue_tunnel_t>(*m_rcu));
+  m_teid_to_ue_ip.reset(new srsran::rcu_hash_map<uint32_t, in_addr_t>(*m_rcu));
+  m_stop_fd   = eventfd(0, EFD_NONBLOCK);
+  m_paging_fd = eventfd(0, EFD_NONBLOCK);
+  if (m_stop_fd < 0 or m_paging_fd < 0) {
+    m_logger.error("Failed to create eventfd: %s", strerror(errno));
+    return SRSRAN_ERROR_CANT_START;
+  }
+
   // Init SGi interface
   err = init_sgi(args);
   if (err != SRSRAN_SUCCESS) {
@@ -75,21 +90,67 @@ int spgw::gtpu::init(spgw_args_t* args, spgw* spgw, gtpc_interface_gtpu* gtpc)
     srsran::console("Could not initialize the S1-U interface.\n");
     return err;
   }
+  m_ctrl_tx.reset(new s1u_tx_ctx(m_s1u_ctrl, m_batch_size));
 
   m_logger.info("SPGW GTP-U Initialized.");
   srsran::console("SPGW GTP-U Initialized.\n");
   return SRSRAN_SUCCESS;
 }
 
+int spgw::gtpu::start_workers()
+{
+  for (uint32_t i = 0; i < m_nof_workers; ++i) {
+    m_workers.emplace_back(new worker(this, i, m_sgi_queues[i], m_s1u_socks[i]));
+    if (not m_workers.back()->start()) {
+      m_logger.error("Failed to start user plane worker %d", i);
+      return SRSRAN_ERROR_CANT_START;
+    }
+  }
+  m_logger.info("Started %d user plane workers", m_nof_workers);
+  return SRSRAN_SUCCESS;
+}
+
 void spgw::gtpu::stop()
 {
+  // Wake up and join the workers
+  if (not m_workers.empty()) {
+    uint64_t one = 1;
+    if (write(m_stop_fd, &one, sizeof(one)) != sizeof(one)) {
+      m_logger.error("Failed to signal the user plane workers: %s", strerror(errno));
+    }
+    for (std::unique_ptr<worker>& w : m_workers) {
+      w->wait_thread_finish();
+    }
+    m_workers.clear();
+  }
+  if (m_stop_fd >= 0) {
+    close(m_stop_fd);
+    m_stop_fd = -1;
+  }
+  if (m_paging_fd >= 0) {
+    close(m_paging_fd);
+    m_paging_fd = -1;
+  }
+
   // Clean up SGi interface
   if (m_sgi_up) {
-    close(m_sgi);
+    for (int fd : m_sgi_queues) {
+      close(fd);
+    }
+    m_sgi_queues.clear();
+    m_sgi_up = false;
   }
-  // Clean up S1-U socket
+  // Clean up S1-U sockets
   if (m_s1u_up) {
-    close(m_s1u);
+    for (int fd : m_s1u_socks) {
+      close(fd);
+    }
+    m_s1u_socks.clear();
+    m_s1u_up = false;
+  }
+  if (m_s1u_ctrl >= 0) {
+    close(m_s1u_ctrl);
+    m_s1u_ctrl = -1;
   }
 }
 
@@ -102,25 +163,44 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
     return SRSRAN_ERROR_ALREADY_STARTED;
   }
 
-  // Construct the TUN device
-  m_sgi = open("/dev/net/tun", O_RDWR);
-  m_logger.info("TUN file descriptor = %d", m_sgi);
-  if (m_sgi < 0) {
-    m_logger.error("Failed to open TUN device: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
-  }
-
-  memset(&ifr, 0, sizeof(ifr));
-  ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
-  strncpy(
-      ifr.ifr_ifrn.ifrn_name, args->sgi_if_name.c_str(), std::min(args->sgi_if_name.length(), (size_t)(IFNAMSIZ - 1)));
-  ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = '\0';
-
-  if (ioctl(m_sgi, TUNSETIFF, &ifr) < 0) {
-    m_logger.error("Failed to set TUN device name: %s", strerror(errno));
-    close(m_sgi);
-    return SRSRAN_ERROR_CANT_START;
+  // Construct the TUN device. With several workers, each one reads from its own queue of a multi-queue device, to which
+  // the kernel steers downlink packets by flow hash
+  for (uint32_t i = 0; i < m_nof_workers; ++i) {
+    int fd = open("/dev/net/tun", O_RDWR);
+    m_logger.info("TUN file descriptor = %d", fd);
+    if (fd < 0) {
+      m_logger.error("Failed to open TUN device: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_sgi_queues.push_back(fd);
+
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TUN | IFF_NO_PI | (m_nof_workers > 1 ? IFF_MULTI_QUEUE : 0);
+    strncpy(ifr.ifr_ifrn.ifrn_name,
+            args->sgi_if_name.c_str(),
+            std::min(args->sgi_if_name.length(), (size_t)(IFNAMSIZ - 1)));
+    ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = '\0';
+
+    if (ioctl(fd, TUNSETIFF, &ifr) < 0) {
+      m_logger.error("Failed to set TUN device name: %s", strerror(errno));
+      for (int q : m_sgi_queues) {
+        close(q);
+      }
+      m_sgi_queues.clear();
+      return SRSRAN_ERROR_CANT_START;
+    }
+
+    // The workers drain their TUN queue until it would block
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+      m_logger.error("Failed to set TUN device non-blocking: %s", strerror(errno));
+      for (int q : m_sgi_queues) {
+        close(q);
+      }
+      m_sgi_queues.clear();
+      return SRSRAN_ERROR_CANT_START;
+    }
   }
+  m_sgi = m_sgi_queues[0];
 
   // Bring up the interface
   sgi_sock = socket(AF_INET, SOCK_DGRAM, 0);
@@ -175,44 +255,61 @@ int spgw::gtpu::init_sgi(spgw_args_t* args)
 
 int spgw::gtpu::init_s1u(spgw_args_t* args)
 {
-  // Open S1-U socket
-  m_s1u = socket(AF_INET, SOCK_DGRAM, 0);
-  if (m_s1u == -1) {
-    m_logger.error("Failed to open socket: %s", strerror(errno));
-    return SRSRAN_ERROR_CANT_START;
-  }
-  m_s1u_up = true;
-
-  // Bind the socket
-  m_s1u_addr.sin_family      = AF_INET;
+  m_s1u_addr.sin_family = AF_INET;
   if (inet_pton(m_s1u_addr.sin_family, args->gtpu_bind_addr.c_str(), &m_s1u_addr.sin_addr.s_addr) != 1) {
     m_logger.error("Invalid gtpu_bind_addr: %s", args->gtpu_bind_addr.c_str());
     srsran::console("Invalid gtpu_bind_addr: %s\n", args->gtpu_bind_addr.c_str());
     return SRSRAN_ERROR_CANT_START;
   }
-  m_s1u_addr.sin_port        = htons(GTPU_RX_PORT);
+  m_s1u_addr.sin_port = htons(GTPU_RX_PORT);
+
+  // Open one S1-U socket per worker. With SO_REUSEPORT the kernel spreads the uplink flows of the eNBs among them
+  for (uint32_t i = 0; i < m_nof_workers; ++i) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd == -1) {
+      m_logger.error("Failed to open socket: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_s1u_socks.push_back(fd);
+    m_s1u_up = true;
+
+    int enable = 1;
+    if (m_nof_workers > 1 and setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+      m_logger.error("Failed to set SO_REUSEPORT: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+
+    // Bind the socket
+    if (bind(fd, (struct sockaddr*)&m_s1u_addr, sizeof(struct sockaddr_in))) {
+      m_logger.error("Failed to bind socket: %s", strerror(errno));
+      return SRSRAN_ERROR_CANT_START;
+    }
+    m_logger.info("S1-U socket = %d", fd);
+  }
+  m_s1u = m_s1u_socks[0];
+  m_logger.info("S1-U IP = %s, Port = %d ", inet_ntoa(m_s1u_addr.sin_addr), ntohs(m_s1u_addr.sin_port));
 
-  if (bind(m_s1u, (struct sockaddr*)&m_s1u_addr, sizeof(struct sockaddr_in))) {
+  // The SPGW thread sends the packets queued during paging through its own socket, so that its sends do not interleave
+  // with the batches of a worker. It is bound to an ephemeral port, so it does not take part of the uplink traffic.
+  m_s1u_ctrl = socket(AF_INET, SOCK_DGRAM, 0);
+  if (m_s1u_ctrl == -1) {
+    m_logger.error("Failed to open socket: %s", strerror(errno));
+    return SRSRAN_ERROR_CANT_START;
+  }
+  sockaddr_in ctrl_addr = m_s1u_addr;
+  ctrl_addr.sin_port    = 0;
+  if (bind(m_s1u_ctrl, (struct sockaddr*)&ctrl_addr, sizeof(struct sockaddr_in))) {
     m_logger.error("Failed to bind socket: %s", strerror(errno));
     return SRSRAN_ERROR_CANT_START;
   }
-  m_logger.info("S1-U socket = %d", m_s1u);
-  m_logger.info("S1-U IP = %s, Port = %d ", inet_ntoa(m_s1u_addr.sin_addr), ntohs(m_s1u_addr.sin_port));
 
   m_logger.info("Initialized S1-U interface");
   return SRSRAN_SUCCESS;
 }
 
-void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg)
+void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg, s1u_tx_ctx& tx)
 {
-  bool usr_found = false;
-  bool ctr_found = false;
-
-  std::map<uint32_t, srsran::gtpc_f_teid_ie>::iterator gtpu_fteid_it;
-  std::map<in_addr_t, uint32_t>::iterator              gtpc_teid_it;
-  srsran::gtpc_f_teid_ie                               enb_fteid;
-  uint32_t                                             spgw_teid;
-  struct iphdr*                                        iph = (struct iphdr*)msg->msg;
+  struct iphdr* iph = (struct iphdr*)msg->msg;
   m_logger.debug("Received SGi PDU. Bytes %d", msg->N_bytes);
 
   if (iph->version != 4) {
@@ -225,25 +322,20 @@ void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg)
   }
 
   // Logging PDU info
-  m_logger.debug("SGi PDU -- IP version %d, Total length %d", int(iph->version), ntohs(iph->tot_len));
-  fmt::memory_buffer buffer;
-  srsran::gtpu_ntoa(buffer, iph->saddr);
-  m_logger.debug("SGi PDU -- IP src addr %s", srsran::to_c_str(buffer));
-  buffer.clear();
-  srsran::gtpu_ntoa(buffer, iph->daddr);
-  m_logger.debug("SGi PDU -- IP dst addr %s", srsran::to_c_str(buffer));
+  if (m_logger.debug.enabled()) {
+    m_logger.debug("SGi PDU -- IP version %d, Total length %d", int(iph->version), ntohs(iph->tot_len));
+    fmt::memory_buffer buffer;
+    srsran::gtpu_ntoa(buffer, iph->saddr);
+    m_logger.debug("SGi PDU -- IP src addr %s", srsran::to_c_str(buffer));
+    buffer.clear();
+    srsran::gtpu_ntoa(buffer, iph->daddr);
+    m_logger.debug("SGi PDU -- IP dst addr %s", srsran::to_c_str(buffer));
+  }
 
   // Find user and control tunnel
-  gtpu_fteid_it = m_ip_to_usr_teid.find(iph->daddr);
-  if (gtpu_fteid_it != m_ip_to_usr_teid.end()) {
-    usr_found = true;
-    enb_fteid = gtpu_fteid_it->second;
-  }
-  gtpc_teid_it = m_ip_to_ctr_teid.find(iph->daddr);
-  if (gtpc_teid_it != m_ip_to_ctr_teid.end()) {
-    ctr_found = true;
-    spgw_teid = gtpc_teid_it->second;
-  }
+  const ue_tunnel_t* tunnel    = m_ip_to_tunnel->find(iph->daddr);
+  bool               usr_found = tunnel != nullptr and tunnel->usr_found;
+  bool               ctr_found = tunnel != nullptr and tunnel->ctr_found;
 
   // Handle SGi packet
   if (usr_found == false && ctr_found == false) {
@@ -251,24 +343,43 @@ void spgw::gtpu::handle_sgi_pdu(srsran::unique_byte_buffer_t msg)
   } else if (usr_found == false && ctr_found == true) {
     m_logger.debug("Packet for attached UE that is not ECM connected.");
     m_logger.debug("Triggering Donwlink Notification Requset.");
-    m_gtpc->send_downlink_data_notification(spgw_teid);
-    m_gtpc->queue_downlink_packet(spgw_teid, std::move(msg));
+    // GTP-C runs in the SPGW thread. Hand the packet over for queueing until the UE is paged.
+    bool was_empty;
+    {
+      std::lock_guard<std::mutex> lock(m_paging_mutex);
+      was_empty = m_paging_pdus.empty();
+      m_paging_pdus.push_back({iph->daddr, std::move(msg)});
+    }
+    uint64_t one = 1;
+    if (was_empty and write(m_paging_fd, &one, sizeof(one)) != sizeof(one)) {
+      m_logger.error("Failed to signal downlink packet for paging: %s", strerror(errno));
+    }
     return;
   } else if (usr_found == true && ctr_found == false) {
     m_logger.error("User plane tunnel found without a control plane tunnel present.");
   } else {
-    send_s1u_pdu(enb_fteid, msg.get());
+    send_s1u_pdu(tunnel->dw_user_fteid, std::move(msg), tx);
   }
 }
 
-void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg)
+void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg, int sgi)
 {
   srsran::gtpu_header_t header;
-  srsran::gtpu_read_header(msg, &header, m_logger);
+  if (not srsran::gtpu_read_header(msg, &header, m_logger)) {
+    return;
+  }
 
   m_logger.debug("Received PDU from S1-U. Bytes=%d", msg->N_bytes);
   m_logger.debug("TEID 0x%x. Bytes=%d", header.teid, msg->N_bytes);
-  int n = write(m_sgi, msg->msg, msg->N_bytes);
+  if (header.message_type != GTPU_MSG_DATA_PDU) {
+    m_logger.debug("Dropping GTP-U message type 0x%x from S1-U", header.message_type);
+    return;
+  }
+  if (m_teid_to_ue_ip->find(header.teid) == nullptr) {
+    m_logger.debug("Dropping PDU with unknown TEID 0x%x", header.teid);
+    return;
+  }
+  int n = write(sgi, msg->msg, msg->N_bytes);
   if (n < 0) {
     m_logger.error("Could not write to TUN interface.");
   } else {
@@ -277,7 +388,7 @@ void spgw::gtpu::handle_s1u_pdu(srsran::byte_buffer_t* msg)
   return;
 }
 
-void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer_t* msg)
+void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::unique_byte_buffer_t msg, s1u_tx_ctx& tx)
 {
   // Set eNB destination address
   struct sockaddr_in enb_addr;
@@ -296,23 +407,30 @@ void spgw::gtpu::send_s1u_pdu(srsran::gtp_fteid_t enb_fteid, srsran::byte_buffer
   m_logger.debug("eNB F-TEID -- eNB IP %s, eNB TEID 0x%x.", inet_ntoa(enb_addr.sin_addr), enb_fteid.teid);
 
   // Write header into packet
-  int n;
-  if (!srsran::gtpu_write_header(&header, msg, m_logger)) {
+  if (!srsran::gtpu_write_header(&header, msg.get(), m_logger)) {
     m_logger.error("Error writing GTP-U header on PDU");
-    goto out;
+    return;
   }
 
-  // Send packet to destination
-  n = sendto(m_s1u, msg->msg, msg->N_bytes, 0, (struct sockaddr*)&enb_addr, sizeof(enb_addr));
-  if (n < 0) {
-    m_logger.error("Error sending packet to eNB");
-  } else if ((unsigned int)n != msg->N_bytes) {
-    m_logger.error("Mis-match between packet bytes and sent bytes: Sent: %d/%d", n, msg->N_bytes);
+  // Queue packet for transmission. The batch is sent with flush_s1u_pdus(), or here when it is full.
+  if (tx.batch.full()) {
+    flush_s1u_pdus(tx);
   }
+  tx.batch.push(std::move(msg), enb_addr);
+}
 
-out:
-  m_logger.debug("Deallocating packet after sending S1-U message");
-  return;
+void spgw::gtpu::flush_s1u_pdus(s1u_tx_ctx& tx)
+{
+  if (tx.batch.empty()) {
+    return;
+  }
+  uint32_t nof_pdus = tx.batch.size();
+  uint32_t nof_sent = tx.batch.flush(tx.fd);
+  if (nof_sent != nof_pdus) {
+    m_logger.error("Error sending packets to eNB. Sent: %d/%d", nof_sent, nof_pdus);
+  } else {
+    m_logger.debug("Sent %d S1-U PDUs", nof_sent);
+  }
 }
 
 void spgw::gtpu::send_all_queued_packets(srsran::gtp_fteid_t                       dw_user_fteid,
@@ -320,11 +438,44 @@ void spgw::gtpu::send_all_queued_packets(srsran::gtp_fteid_t
 {
   m_logger.debug("Sending all queued packets");
   while (!pkt_queue.empty()) {
-    srsran::unique_byte_buffer_t msg = std::move(pkt_queue.front());
-    send_s1u_pdu(dw_user_fteid, msg.get());
+    send_s1u_pdu(dw_user_fteid, std::move(pkt_queue.front()), *m_ctrl_tx);
     pkt_queue.pop();
   }
-  return;
+  // The tunnel is already published to the workers, so send the queued packets right away instead of at the end of the
+  // SPGW loop iteration, to keep them ahead of the new downlink traffic of the UE
+  flush_s1u_pdus(*m_ctrl_tx);
+}
+
+void spgw::gtpu::flush_s1u_pdus()
+{
+  flush_s1u_pdus(*m_ctrl_tx);
+}
+
+void spgw::gtpu::handle_paging_pdus()
+{
+  uint64_t cnt;
+  if (read(m_paging_fd, &cnt, sizeof(cnt)) < 0 and errno != EAGAIN) {
+    m_logger.error("Failed to read paging eventfd: %s", strerror(errno));
+  }
+
+  std::vector<paging_pdu_t> pdus;
+  {
+    std::lock_guard<std::mutex> lock(m_paging_mutex);
+    pdus.swap(m_paging_pdus);
+  }
+  for (paging_pdu_t& pdu : pdus) {
+    // The tunnel may have changed since the worker queued the PDU, e.g. a Modify Bearer may have set up the S1-U tunnel
+    const ue_tunnel_t* tunnel = m_ip_to_tunnel->find(pdu.ue_ipv4);
+    if (tunnel == nullptr or not tunnel->ctr_found) {
+      m_logger.debug("Dropping downlink PDU for paging of a detached UE.");
+    } else if (tunnel->usr_found) {
+      send_s1u_pdu(tunnel->dw_user_fteid, std::move(pdu.pdu), *m_ctrl_tx);
+    } else {
+      m_gtpc->send_downlink_data_notification(tunnel->up_ctrl_teid);
+      m_gtpc->queue_downlink_packet(tunnel->up_ctrl_teid, std::move(pdu.pdu));
+    }
+  }
+  flush_s1u_pdus(*m_ctrl_tx);
 }
 
 /*
@@ -340,33 +491,150 @@ bool spgw::gtpu::modify_gtpu_tunnel(in_addr_t ue_ipv4, srsran::gtpc_f_teid_ie dw
   srsran::gtpu_ntoa(buffer, dw_user_fteid.ipv4);
   m_logger.info("Downlink eNB addr %s, U-TEID 0x%x", srsran::to_c_str(buffer), dw_user_fteid.teid);
   m_logger.info("Uplink C-TEID: 0x%x", up_ctrl_teid);
-  m_ip_to_usr_teid[ue_ipv4] = dw_user_fteid;
-  m_ip_to_ctr_teid[ue_ipv4] = up_ctrl_teid;
+  m_ip_to_tunnel->insert_or_assign(ue_ipv4, ue_tunnel_t{dw_user_fteid, up_ctrl_teid, true, true});
   return true;
 }
 
 bool spgw::gtpu::delete_gtpu_tunnel(in_addr_t ue_ipv4)
 {
   // Remove GTP-U connections, if any.
-  if (m_ip_to_usr_teid.count(ue_ipv4)) {
-    m_ip_to_usr_teid.erase(ue_ipv4);
-  } else {
+  const ue_tunnel_t* tunnel = m_ip_to_tunnel->find(ue_ipv4);
+  if (tunnel == nullptr or not tunnel->usr_found) {
     m_logger.error("Could not find GTP-U Tunnel to delete.");
     return false;
   }
+  if (tunnel->ctr_found) {
+    ue_tunnel_t ctr_tunnel = *tunnel;
+    ctr_tunnel.usr_found   = false;
+    m_ip_to_tunnel->insert_or_assign(ue_ipv4, ctr_tunnel);
+  } else {
+    m_ip_to_tunnel->erase(ue_ipv4);
+  }
   return true;
 }
 
 bool spgw::gtpu::delete_gtpc_tunnel(in_addr_t ue_ipv4)
 {
   // Remove Ctrl TEID from IP mapping.
-  if (m_ip_to_ctr_teid.count(ue_ipv4)) {
-    m_ip_to_ctr_teid.erase(ue_ipv4);
-  } else {
+  const ue_tunnel_t* tunnel = m_ip_to_tunnel->find(ue_ipv4);
+  if (tunnel == nullptr or not tunnel->ctr_found) {
     m_logger.error("Could not find GTP-C Tunnel info to delete.");
     return false;
   }
+  if (tunnel->usr_found) {
+    ue_tunnel_t usr_tunnel = *tunnel;
+    usr_tunnel.ctr_found   = false;
+    m_ip_to_tunnel->insert_or_assign(ue_ipv4, usr_tunnel);
+  } else {
+    m_ip_to_tunnel->erase(ue_ipv4);
+  }
   return true;
 }
 
+bool spgw::gtpu::add_uplink_tunnel(uint32_t up_user_teid, in_addr_t ue_ipv4)
+{
+  m_teid_to_ue_ip->insert_or_assign(up_user_teid, ue_ipv4);
+  return true;
+}
+
+bool spgw::gtpu::delete_uplink_tunnel(uint32_t up_user_teid)
+{
+  if (not m_teid_to_ue_ip->erase(up_user_teid)) {
+    m_logger.error("Could not find uplink User TEID 0x%x to delete.", up_user_teid);
+    return false;
+  }
+  return true;
+}
+
+/**************************************
+ *
+ * User plane worker
+ *
+ **************************************/
+
+spgw::gtpu::worker::worker(gtpu* parent_, uint32_t id_, int sgi_, int s1u_) :
+  thread("SPGW_UP" + std::to_string(id_)),
+  parent(parent_),
+  id(id_),
+  sgi(sgi_),
+  tx(s1u_, parent_->m_batch_size),
+  s1u_rx(parent_->m_batch_size)
+{}
+
+void spgw::gtpu::worker::run_thread()
+{
+  srslog::basic_logger& logger   = parent->m_logger;
+  int                   stop_fd  = parent->m_stop_fd;
+  uint32_t              buf_len  = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
+  int                   epoll_fd = epoll_create1(0);
+  if (epoll_fd < 0) {
+    logger.error("Error creating epoll: %s", strerror(errno));
+    return;
+  }
+  for (int fd : {sgi, tx.fd, stop_fd}) {
+    struct epoll_event ev = {};
+    ev.events             = EPOLLIN;
+    ev.data.fd            = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      logger.error("Error adding fd=%d to epoll: %s", fd, strerror(errno));
+      close(epoll_fd);
+      return;
+    }
+  }
+
+  bool               running = true;
+  struct epoll_event events[3];
+  while (running) {
+    int n = epoll_wait(epoll_fd, events, 3, -1);
+    if (n == -1) {
+      if (errno != EINTR) {
+        logger.error("Error from epoll_wait: %s", strerror(errno));
+      }
+      continue;
+    }
+
+    // Tunnel lookups are only valid while the worker is online
+    parent->m_rcu->online(id);
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == sgi) {
+        /*
+         * SGi messages may need to be queued when waiting for UE Paging procedure.
+         * For this reason, buffers for SGi pdus are allocated here and deallocated
+         * at the gtpu::flush_s1u_pdus() when the PDU is sent, at handle_sgi_pdu() when the PDU is dropped or at
+         * gtpc::free_all_queued_packets, which is called when the Downlink Data Notification
+         * procedure fails (see handle_downlink_data_notification_acknowledgment and
+         * handle_downlink_data_notification_failure)
+         */
+        for (uint32_t j = 0; j < parent->m_batch_size; ++j) {
+          srsran::unique_byte_buffer_t sgi_msg = srsran::make_byte_buffer("spgw::gtpu::worker::sgi_msg");
+          if (sgi_msg == nullptr) {
+            logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+            break;
+          }
+          int nof_bytes = read(sgi, sgi_msg->msg, buf_len);
+          if (nof_bytes <= 0) {
+            if (nof_bytes < 0 and errno != EAGAIN and errno != EWOULDBLOCK) {
+              logger.error("Error reading from TUN interface: %s", strerror(errno));
+            }
+            break;
+          }
+          sgi_msg->N_bytes = nof_bytes;
+          parent->handle_sgi_pdu(std::move(sgi_msg), tx);
+        }
+      } else if (fd == tx.fd) {
+        int nof_msgs = s1u_rx.recv(tx.fd);
+        for (int j = 0; j < nof_msgs; ++j) {
+          parent->handle_s1u_pdu(s1u_rx.get(j), sgi);
+        }
+      } else if (fd == stop_fd) {
+        running = false;
+      }
+    }
+    parent->flush_s1u_pdus(tx);
+    parent->m_rcu->offline(id);
+  }
+  close(epoll_fd);
+}
+
 } // namespace srsepc
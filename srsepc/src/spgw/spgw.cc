@@ -25,6 +25,7 @@
 #include "srsepc/hdr/spgw/gtpu.h"
 #include "srsran/upper/gtpu.h"
 #include <inttypes.h> // for printing uint64_t
+#include <sys/epoll.h>
 
 namespace srsepc {
 
@@ -103,66 +104,64 @@ void spgw::run_thread()
 {
   // Mark the thread as running
   m_running = true;
-  srsran::unique_byte_buffer_t sgi_msg, s1u_msg, s11_msg;
-  s1u_msg = srsran::make_byte_buffer("spgw::run_thread::s1u");
-  s11_msg = srsran::make_byte_buffer("spgw::run_thread::s11");
+  srsran::unique_byte_buffer_t s11_msg = srsran::make_byte_buffer("spgw::run_thread::s11");
 
-  struct sockaddr_in src_addr_in;
   struct sockaddr_un src_addr_un;
-  struct iphdr*      ip_pkt;
 
-  int sgi = m_gtpu->get_sgi();
-  int s1u = m_gtpu->get_s1u();
-  int s11 = m_gtpc->get_s11();
+  // The user plane is forwarded by the GTP-U workers. This thread handles GTP-C and paging.
+  if (m_gtpu->start_workers() != SRSRAN_SUCCESS) {
+    srsran::console("Could not start the SPGW user plane workers.\n");
+    return;
+  }
 
-  size_t buf_len = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
+  int paging_fd = m_gtpu->get_paging_fd();
+  int s11       = m_gtpc->get_s11();
 
-  fd_set set;
-  int    max_fd = std::max(s1u, sgi);
-  max_fd        = std::max(max_fd, s11);
-  while (m_running) {
-    s1u_msg->clear();
-    s11_msg->clear();
+  size_t buf_len = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
 
-    FD_ZERO(&set);
-    FD_SET(s1u, &set);
-    FD_SET(sgi, &set);
-    FD_SET(s11, &set);
+  int epoll_fd = epoll_create1(0);
+  if (epoll_fd < 0) {
+    m_logger.error("Error creating epoll: %s", strerror(errno));
+    return;
+  }
+  for (int fd : {s11, paging_fd}) {
+    struct epoll_event ev = {};
+    ev.events             = EPOLLIN;
+    ev.data.fd            = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      m_logger.error("Error adding fd=%d to epoll: %s", fd, strerror(errno));
+      close(epoll_fd);
+      return;
+    }
+  }
 
-    int n = select(max_fd + 1, &set, NULL, NULL, NULL);
+  struct epoll_event events[2];
+  while (m_running) {
+    int n = epoll_wait(epoll_fd, events, 2, -1);
     if (n == -1) {
-      m_logger.error("Error from select");
-    } else if (n) {
-      if (FD_ISSET(sgi, &set)) {
-        /*
-         * SGi messages may need to be queued when waiting for UE Paging procedure.
-         * For this reason, buffers for SGi pdus are allocated here and deallocated
-         * at the gtpu::send_s1u_pdu() when the PDU is sent, at handle_sgi_pdu() when the PDU is dropped or at
-         * gtpc::free_all_queued_packets, which is called when the Downlink Data Notification
-         * procedure fails (see handle_downlink_data_notification_acknowledgment and
-         * handle_downlink_data_notification_failure)
-         */
-        m_logger.debug("Message received at SPGW: SGi Message");
-        sgi_msg          = srsran::make_byte_buffer("spgw::run_thread::sgi_msg");
-        sgi_msg->N_bytes = read(sgi, sgi_msg->msg, buf_len);
-        m_gtpu->handle_sgi_pdu(std::move(sgi_msg));
-      }
-      if (FD_ISSET(s1u, &set)) {
-        m_logger.debug("Message received at SPGW: S1-U Message");
-        socklen_t addrlen = sizeof(src_addr_in);
-        s1u_msg->N_bytes  = recvfrom(s1u, s1u_msg->msg, buf_len, 0, (struct sockaddr*)&src_addr_in, &addrlen);
-        m_gtpu->handle_s1u_pdu(s1u_msg.get());
+      if (errno != EINTR) {
+        m_logger.error("Error from epoll_wait: %s", strerror(errno));
       }
-      if (FD_ISSET(s11, &set)) {
+      continue;
+    }
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == s11) {
         m_logger.debug("Message received at SPGW: S11 Message");
+        s11_msg->clear();
         socklen_t addrlen = sizeof(src_addr_un);
         s11_msg->N_bytes  = recvfrom(s11, s11_msg->msg, buf_len, 0, (struct sockaddr*)&src_addr_un, &addrlen);
         m_gtpc->handle_s11_pdu(s11_msg.get());
+      } else if (fd == paging_fd) {
+        m_logger.debug("Downlink packets received at SPGW for UEs in ECM-IDLE");
+        m_gtpu->handle_paging_pdus();
       }
-    } else {
-      m_logger.debug("No data from select.");
     }
+
+    // Send the packets that were queued during paging
+    m_gtpu->flush_s1u_pdus();
   }
+  close(epoll_fd);
   return;
 }
 
@@ -0,0 +1,208 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/hss/hss_db.h"
+#include "srsran/common/test_common.h"
+#include <stdio.h>
+#include <unistd.h>
+
+namespace srsepc {
+
+const uint32_t nof_ues   = 1000;
+const uint64_t base_imsi = 1010123456780ULL;
+
+static hss_ue_ctx_t make_ue(uint64_t imsi)
+{
+  hss_ue_ctx_t ue = {};
+  snprintf(ue.name, sizeof(ue.name), "ue%u", (uint32_t)(imsi - base_imsi));
+  ue.imsi = imsi;
+  ue.algo = HSS_ALGO_MILENAGE;
+  for (uint32_t i = 0; i < sizeof(ue.key); ++i) {
+    ue.key[i] = (uint8_t)(imsi + i);
+  }
+  ue.qci = 7;
+  strncpy(ue.static_ip_addr, "0.0.0.0", sizeof(ue.static_ip_addr));
+  return ue;
+}
+
+static std::vector<hss_ue_ctx_t> make_ues(uint32_t n)
+{
+  std::vector<hss_ue_ctx_t> ues;
+  for (uint32_t i = 0; i < n; ++i) {
+    ues.push_back(make_ue(base_imsi + i));
+  }
+  return ues;
+}
+
+int test_lookup(const std::string& path)
+{
+  hss_db db(srslog::fetch_basic_logger("HSS"));
+
+  TESTASSERT(db.find(base_imsi) == nullptr);
+  TESTASSERT(db.create(path, make_ues(nof_ues), hss_db_csv_stamp_t{1, 2}));
+  TESTASSERT(db.size() == nof_ues);
+
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    hss_ue_ctx_t* ue = db.find(base_imsi + i);
+    TESTASSERT(ue != nullptr);
+    TESTASSERT(ue->imsi == base_imsi + i);
+    TESTASSERT(ue->key[0] == (uint8_t)(base_imsi + i));
+  }
+  TESTASSERT(db.find(base_imsi - 1) == nullptr);
+  TESTASSERT(db.find(base_imsi + nof_ues) == nullptr);
+
+  // Duplicate IMSIs are rejected
+  std::vector<hss_ue_ctx_t> ues = make_ues(2);
+  ues.push_back(ues[0]);
+  TESTASSERT(not db.create("", ues, {}));
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_insert_update(const std::string& path)
+{
+  hss_db db(srslog::fetch_basic_logger("HSS"));
+  TESTASSERT(db.open(path));
+  TESTASSERT(db.size() == nof_ues);
+
+  // Records are updated in place
+  hss_ue_ctx_t* ue = db.find(base_imsi + 10);
+  TESTASSERT(ue != nullptr);
+  ue->qci = 9;
+  TESTASSERT(db.find(base_imsi + 10)->qci == 9);
+
+  // New subscribers are inserted by rebuilding the store, e.g. after the CSV user database changed
+  std::vector<hss_ue_ctx_t> ues;
+  for (uint32_t i = 0; i < db.size(); ++i) {
+    ues.push_back(db[i]);
+  }
+  ues.push_back(make_ue(base_imsi + nof_ues));
+  TESTASSERT(db.create(path, ues, hss_db_csv_stamp_t{3, 4}));
+  TESTASSERT(db.size() == nof_ues + 1);
+  TESTASSERT(db.find(base_imsi + nof_ues) != nullptr);
+  TESTASSERT(db.find(base_imsi + 10)->qci == 9);
+  TESTASSERT(db.get_csv_stamp().mtime_ns == 3 and db.get_csv_stamp().size == 4);
+
+  // A store kept in memory only does not replace the file
+  TESTASSERT(db.create("", make_ues(1), {}));
+  TESTASSERT(db.size() == 1);
+  TESTASSERT(db.open(path));
+  TESTASSERT(db.size() == nof_ues + 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_sqn_persistence(const std::string& path)
+{
+  const uint8_t sqn[6]        = {0x00, 0x00, 0x00, 0x01, 0x23, 0x45};
+  const uint8_t last_rand[16] = {0xde, 0xad, 0xbe, 0xef};
+
+  {
+    hss_db db(srslog::fetch_basic_logger("HSS"));
+    TESTASSERT(db.open(path));
+    hss_ue_ctx_t* ue = db.find(base_imsi + 42);
+    TESTASSERT(ue != nullptr);
+    ue->set_sqn(sqn);
+    ue->set_last_rand(last_rand);
+    db.set_csv_stamp(hss_db_csv_stamp_t{5, 6});
+    db.close();
+  }
+
+  // The SQN and RAND of the last authentication survive a restart of the HSS
+  hss_db db(srslog::fetch_basic_logger("HSS"));
+  TESTASSERT(db.open(path));
+  hss_ue_ctx_t* ue = db.find(base_imsi + 42);
+  TESTASSERT(ue != nullptr);
+  TESTASSERT(memcmp(ue->sqn, sqn, sizeof(sqn)) == 0);
+  uint8_t rand[16];
+  ue->get_last_rand(rand);
+  TESTASSERT(memcmp(rand, last_rand, sizeof(rand)) == 0);
+  TESTASSERT(db.get_csv_stamp().mtime_ns == 5 and db.get_csv_stamp().size == 6);
+
+  // Other records are untouched
+  TESTASSERT(memcmp(db.find(base_imsi + 41)->sqn, sqn, sizeof(sqn)) != 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_corrupted_index(const std::string& path)
+{
+  hss_db db(srslog::fetch_basic_logger("HSS"));
+  TESTASSERT(db.create(path, make_ues(nof_ues), {}));
+  db.close();
+
+  // Point the first used index slot past the last record. The index follows the 40 byte header
+  FILE* f = fopen(path.c_str(), "r+b");
+  TESTASSERT(f != nullptr);
+  TESTASSERT(fseek(f, 40, SEEK_SET) == 0);
+  uint32_t slot = 0;
+  long     pos  = 40;
+  while (slot == 0) {
+    pos = ftell(f);
+    TESTASSERT(fread(&slot, sizeof(slot), 1, f) == 1);
+  }
+  TESTASSERT(slot <= nof_ues);
+  slot = nof_ues + 1;
+  TESTASSERT(fseek(f, pos, SEEK_SET) == 0);
+  TESTASSERT(fwrite(&slot, sizeof(slot), 1, f) == 1);
+  fclose(f);
+
+  TESTASSERT(not db.open(path));
+  TESTASSERT(db.find(base_imsi) == nullptr);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_invalid_store(const std::string& path)
+{
+  hss_db db(srslog::fetch_basic_logger("HSS"));
+
+  // Truncated stores are rejected
+  TESTASSERT(truncate(path.c_str(), 16) == 0);
+  TESTASSERT(not db.open(path));
+  TESTASSERT(db.find(base_imsi) == nullptr);
+
+  TESTASSERT(not db.open(path + ".missing"));
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsepc
+
+int main(int argc, char** argv)
+{
+  std::string path = argc > 1 ? argv[1] : "hss_db_test.db";
+
+  auto& hss_log = srslog::fetch_basic_logger("HSS");
+  hss_log.set_level(srslog::basic_levels::info);
+
+  srslog::init();
+
+  TESTASSERT(srsepc::test_lookup(path) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_insert_update(path) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_sqn_persistence(path) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_corrupted_index(path) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_invalid_store(path) == SRSRAN_SUCCESS);
+  unlink(path.c_str());
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -81,8 +81,9 @@ public:
   rx_harq_softbuffer() { bzero(&buffer, sizeof(buffer)); }
   explicit rx_harq_softbuffer(uint32_t nof_prb_)
   {
-    // Note: for now we use same size regardless of nof_prb_
-    srsran_softbuffer_rx_init_guru(&buffer, SRSRAN_SCH_NR_MAX_NOF_CB_LDPC, SRSRAN_LDPC_MAX_LEN_ENCODED_CB);
+    // Note: for now we use same size regardless of nof_prb_. The LDPC decoder soft bits are 8-bit
+    srsran_softbuffer_rx_init_llr(
+        &buffer, SRSRAN_SCH_NR_MAX_NOF_CB_LDPC, SRSRAN_LDPC_MAX_LEN_ENCODED_CB, SRSRAN_SOFTBUFFER_LLR_8BIT);
   }
   rx_harq_softbuffer(const rx_harq_softbuffer&) = delete;
   rx_harq_softbuffer(rx_harq_softbuffer&& other) noexcept
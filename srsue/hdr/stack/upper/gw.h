@@ -34,6 +34,7 @@
 #include <mutex>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <vector>
 
 namespace srsue {
 
@@ -47,6 +48,7 @@ struct gw_args_t {
   std::string netns;
   std::string tun_dev_name;
   std::string tun_dev_netmask;
+  bool        tun_dev_offload = false;
 };
 
 class gw : public gw_interface_stack, public srsran::thread
@@ -88,6 +90,10 @@ private:
   int32_t           sock       = 0;
   std::atomic<bool> if_up      = {false};
 
+  // TUN offload (IFF_VNET_HDR), one read may return a TCP super-packet of up to TUN_GSO_MAX_SIZE bytes
+  bool                 tun_offload = false;
+  std::vector<uint8_t> tun_rx_buf;
+
   static const int NOT_ASSIGNED          = -1;
   int32_t          default_eps_bearer_id = NOT_ASSIGNED;
   std::mutex       gw_mutex;
@@ -102,6 +108,8 @@ private:
   std::chrono::high_resolution_clock::time_point metrics_tp; // stores time when last metrics have been taken
 
   void run_thread();
+  int  read_tun_offload(std::vector<srsran::unique_byte_buffer_t>& pdus);
+  int  write_tun(const uint8_t* data, uint32_t len);
   int  init_if(char* err_str);
   int  setup_if_addr4(uint32_t ip_addr, char* err_str);
   int  setup_if_addr6(uint8_t* ipv6_if_id, char* err_str);
@@ -0,0 +1,85 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSUE_TUN_OFFLOAD_H
+#define SRSUE_TUN_OFFLOAD_H
+
+#include "srsran/common/buffer_pool.h"
+#include <stdint.h>
+#include <vector>
+
+namespace srsue {
+
+/**
+ * Helpers for TUN devices opened with IFF_VNET_HDR and TSO/checksum offload enabled.
+ *
+ * With offload enabled the kernel hands over TCP super-packets of up to 64 KB with a single read() and leaves the
+ * transport checksum of every packet to be completed by the reader. These helpers turn such reads back into
+ * MTU-sized IP packets that can be delivered to PDCP.
+ */
+
+/// Header prepended by the kernel to every packet read from/written to the TUN device, in host byte order.
+/// Layout of struct virtio_net_hdr, which can't be included from C++ (linux/virtio_net.h uses "class" as field name).
+struct tun_vnet_hdr_t {
+  uint8_t  flags;
+  uint8_t  gso_type;
+  uint16_t hdr_len;
+  uint16_t gso_size;
+  uint16_t csum_start;
+  uint16_t csum_offset;
+};
+
+const uint8_t TUN_VNET_HDR_F_NEEDS_CSUM = 1;
+const uint8_t TUN_VNET_HDR_GSO_NONE     = 0;
+const uint8_t TUN_VNET_HDR_GSO_TCPV4    = 1;
+const uint8_t TUN_VNET_HDR_GSO_UDP      = 3;
+const uint8_t TUN_VNET_HDR_GSO_TCPV6    = 4;
+const uint8_t TUN_VNET_HDR_GSO_ECN      = 0x80;
+
+const uint32_t TUN_VNET_HDR_LEN = sizeof(tun_vnet_hdr_t);
+
+/// Maximum size of a single read from a TUN device with GSO offload enabled
+const uint32_t TUN_GSO_MAX_SIZE = 65535;
+
+/// Computes the Internet checksum (RFC 1071) over len bytes, starting from the partial sum "sum"
+uint16_t tun_csum(const uint8_t* data, uint32_t len, uint64_t sum = 0);
+
+/**
+ * Completes the transport checksum of a packet flagged with TUN_VNET_HDR_F_NEEDS_CSUM. The kernel stores the
+ * pseudo-header checksum at csum_start + csum_offset and expects the sum over [csum_start, len) to be folded in.
+ * @return true if the checksum was written, false if the offsets do not fit the packet
+ */
+bool tun_complete_csum(uint8_t* pkt, uint32_t len, uint16_t csum_start, uint16_t csum_offset);
+
+/**
+ * Splits an IPv4/IPv6 TCP packet read from the TUN device into one IP packet per vnet_hdr.gso_size bytes of payload.
+ * IP length/ID/checksum and TCP sequence number/flags/checksum of every segment are rewritten. Packets not marked
+ * for GSO are copied as-is, after completing their checksum if requested by the kernel.
+ * @return number of packets appended to "pdus", or -1 on malformed input or buffer pool exhaustion
+ */
+int tun_segment_pdu(const tun_vnet_hdr_t&                      vnet_hdr,
+                    const uint8_t*                             pkt,
+                    uint32_t                                   len,
+                    std::vector<srsran::unique_byte_buffer_t>& pdus);
+
+} // namespace srsue
+
+#endif // SRSUE_TUN_OFFLOAD_H
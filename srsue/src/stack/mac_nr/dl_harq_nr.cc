@@ -166,9 +166,11 @@ dl_harq_entity_nr::dl_harq_process_nr::~dl_harq_process_nr()
 
 bool dl_harq_entity_nr::dl_harq_process_nr::init(int pid_)
 {
-  if (softbuffer_rx == nullptr || srsran_softbuffer_rx_init_guru(softbuffer_rx.get(),
-                                                                 SRSRAN_SCH_NR_MAX_NOF_CB_LDPC,
-                                                                 SRSRAN_LDPC_MAX_LEN_ENCODED_CB) != SRSRAN_SUCCESS) {
+  // The LDPC decoder soft bits are 8-bit
+  if (softbuffer_rx == nullptr || srsran_softbuffer_rx_init_llr(softbuffer_rx.get(),
+                                                                SRSRAN_SCH_NR_MAX_NOF_CB_LDPC,
+                                                                SRSRAN_LDPC_MAX_LEN_ENCODED_CB,
+                                                                SRSRAN_SOFTBUFFER_LLR_8BIT) != SRSRAN_SUCCESS) {
     logger.error("Couldn't allocate and/or initialize softbuffer");
     return false;
   }
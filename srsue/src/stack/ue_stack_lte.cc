@@ -445,6 +445,43 @@ void ue_stack_lte::write_sdu(uint32_t eps_bearer_id, srsran::unique_byte_buffer_
   }
 }
 
+/**
+ * GW calls write_sdus() to push a batch of SDUs for the same EPS bearer to the stack.
+ * The whole batch is delivered with a single stack task, so that e.g. the segments
+ * of a TCP super-packet are processed by PDCP in one go.
+ *
+ * @param eps_bearer_id
+ * @param sdus
+ */
+void ue_stack_lte::write_sdus(uint32_t eps_bearer_id, std::vector<srsran::unique_byte_buffer_t> sdus)
+{
+  auto bearer = bearers.get_radio_bearer(eps_bearer_id);
+
+  auto task = [this, eps_bearer_id, bearer](std::vector<srsran::unique_byte_buffer_t>& sdus) {
+    // route SDUs to PDCP entity
+    if (bearer.rat == srsran_rat_t::lte) {
+      pdcp.write_sdus(bearer.lcid, std::move(sdus));
+    } else if (bearer.rat == srsran_rat_t::nr) {
+      for (srsran::unique_byte_buffer_t& sdu : sdus) {
+        if (args.sa_mode) {
+          sdap.write_sdu(bearer.lcid, std::move(sdu));
+        } else {
+          pdcp_nr.write_sdu(bearer.lcid, std::move(sdu));
+        }
+      }
+    } else {
+      stack_logger.warning("Can't deliver %zd SDUs for EPS bearer %d. Dropping them.", sdus.size(), eps_bearer_id);
+    }
+  };
+
+  uint32_t nof_sdus = sdus.size();
+  bool     ret      = gw_queue_id.try_push(std::bind(task, std::move(sdus))).has_value();
+  if (not ret) {
+    pdcp_logger.info("%d GW SDUs with lcid=%d were discarded.", nof_sdus, bearer.lcid);
+    ul_dropped_sdus += nof_sdus;
+  }
+}
+
 bool ue_stack_lte::has_active_radio_bearer(uint32_t eps_bearer_id)
 {
   return bearers.has_active_radio_bearer(eps_bearer_id);
@@ -20,6 +20,7 @@
  */
 
 #include "srsue/hdr/stack/upper/gw.h"
+#include "srsue/hdr/stack/upper/tun_offload.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/interfaces/ue_pdcp_interfaces.h"
 #include "srsran/upper/ipv6.h"
@@ -34,6 +35,7 @@
 #include <netinet/in.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace srsue {
@@ -151,7 +153,7 @@ void gw::write_pdu(uint32_t lcid, srsran::unique_byte_buffer_t pdu)
     // Only handle IPv4 and IPv6 packets
     struct iphdr* ip_pkt = (struct iphdr*)pdu->msg;
     if (ip_pkt->version == 4 || ip_pkt->version == 6) {
-      int n = write(tun_fd, pdu->msg, pdu->N_bytes);
+      int n = write_tun(pdu->msg, pdu->N_bytes);
       if (n > 0 && (pdu->N_bytes != (uint32_t)n)) {
         logger.warning("DL TUN/TAP write failure. Wanted to write %d B but only wrote %d B.", pdu->N_bytes, n);
       }
@@ -185,7 +187,7 @@ void gw::write_pdu_mch(uint32_t lcid, srsran::unique_byte_buffer_t pdu)
         logger.warning("TUN/TAP not up - dropping gw RX message");
       }
     } else {
-      int n = write(tun_fd, pdu->msg, pdu->N_bytes);
+      int n = write_tun(pdu->msg, pdu->N_bytes);
       if (n > 0 && (pdu->N_bytes != (uint32_t)n)) {
         logger.warning("DL TUN/TAP write failure");
       }
@@ -283,6 +285,10 @@ void gw::run_thread()
     return;
   }
 
+  // IP packets obtained from a single TUN read. Without offload this is at most one packet, with offload a TCP
+  // super-packet is segmented here and the whole batch is handed to the stack at once.
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+
   const static uint32_t REGISTER_WAIT_TOUT = 40, SERVICE_WAIT_TOUT = 40; // 4 sec
   uint32_t              register_wait = 0, service_wait = 0;
 
@@ -290,24 +296,33 @@ void gw::run_thread()
 
   running = true;
   while (run_enable) {
-    // Read packet from TUN
-    if (SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET > idx) {
-      N_bytes = read(tun_fd, &pdu->msg[idx], SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET - idx);
+    if (tun_offload) {
+      // Read packet(s) from TUN
+      if (read_tun_offload(pdus) < 0) {
+        logger.error("Failed to read from TUN interface - gw receive thread exiting.");
+        srsran::console("Failed to read from TUN interface - gw receive thread exiting.\n");
+        break;
+      }
+      if (pdus.empty()) {
+        continue;
+      }
     } else {
-      logger.error("GW pdu buffer full - gw receive thread exiting.");
-      srsran::console("GW pdu buffer full - gw receive thread exiting.\n");
-      break;
-    }
-    logger.debug("Read %d bytes from TUN fd=%d, idx=%d", N_bytes, tun_fd, idx);
+      // Read packet from TUN
+      if (SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET > idx) {
+        N_bytes = read(tun_fd, &pdu->msg[idx], SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET - idx);
+      } else {
+        logger.error("GW pdu buffer full - gw receive thread exiting.");
+        srsran::console("GW pdu buffer full - gw receive thread exiting.\n");
+        break;
+      }
+      logger.debug("Read %d bytes from TUN fd=%d, idx=%d", N_bytes, tun_fd, idx);
 
-    if (N_bytes <= 0) {
-      logger.error("Failed to read from TUN interface - gw receive thread exiting.");
-      srsran::console("Failed to read from TUN interface - gw receive thread exiting.\n");
-      break;
-    }
+      if (N_bytes <= 0) {
+        logger.error("Failed to read from TUN interface - gw receive thread exiting.");
+        srsran::console("Failed to read from TUN interface - gw receive thread exiting.\n");
+        break;
+      }
 
-    {
-      std::unique_lock<std::mutex> lock(gw_mutex);
       // Check if IP version makes sense and get packtet length
       struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
       struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
@@ -324,75 +339,149 @@ void gw::run_thread()
       logger.debug("IPv%d packet total length: %d Bytes", int(ip_pkt->version), pkt_len);
 
       // Check if entire packet was received
-      if (pkt_len == pdu->N_bytes) {
-        logger.info(pdu->msg, pdu->N_bytes, "TX PDU");
-
-        // Make sure UE is attached and has default EPS bearer activated
-        while (run_enable && default_eps_bearer_id == NOT_ASSIGNED && register_wait < REGISTER_WAIT_TOUT) {
-          if (!register_wait) {
-            logger.info("UE is not attached, waiting for NAS attach (%d/%d)", register_wait, REGISTER_WAIT_TOUT);
-          }
-          lock.unlock();
-          std::this_thread::sleep_for(std::chrono::microseconds(100));
-          lock.lock();
-          register_wait++;
+      if (pkt_len != pdu->N_bytes) {
+        idx += N_bytes;
+        logger.debug("Entire packet not read from socket. Total Length %d, N_Bytes %d.", ip_pkt->tot_len, pdu->N_bytes);
+        continue;
+      }
+      pdus.push_back(std::move(pdu));
+      do {
+        pdu = srsran::make_byte_buffer();
+        if (!pdu) {
+          logger.error("Fatal Error: Couldn't allocate PDU in run_thread().");
+          usleep(100000);
         }
-        register_wait = 0;
+      } while (!pdu);
+      idx = 0;
+    }
 
-        // If we are still not attached by this stage, drop packet
-        if (run_enable && default_eps_bearer_id == NOT_ASSIGNED) {
-          continue;
-        }
+    {
+      std::unique_lock<std::mutex> lock(gw_mutex);
+      for (const srsran::unique_byte_buffer_t& tx_pdu : pdus) {
+        logger.info(tx_pdu->msg, tx_pdu->N_bytes, "TX PDU");
+      }
 
-        if (!run_enable) {
-          break;
+      // Make sure UE is attached and has default EPS bearer activated
+      while (run_enable && default_eps_bearer_id == NOT_ASSIGNED && register_wait < REGISTER_WAIT_TOUT) {
+        if (!register_wait) {
+          logger.info("UE is not attached, waiting for NAS attach (%d/%d)", register_wait, REGISTER_WAIT_TOUT);
         }
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        lock.lock();
+        register_wait++;
+      }
+      register_wait = 0;
 
-        // Beyond this point we should have a activated default EPS bearer
-        srsran_assert(default_eps_bearer_id != NOT_ASSIGNED, "Default EPS bearer not activated");
+      // If we are still not attached by this stage, drop packet
+      if (run_enable && default_eps_bearer_id == NOT_ASSIGNED) {
+        pdus.clear();
+        continue;
+      }
 
-        uint8_t eps_bearer_id = default_eps_bearer_id;
-        tft_matcher.check_tft_filter_match(pdu, eps_bearer_id);
+      if (!run_enable) {
+        break;
+      }
 
-        // Wait for service request if necessary
-        while (run_enable && !stack->has_active_radio_bearer(eps_bearer_id) && service_wait < SERVICE_WAIT_TOUT) {
-          if (!service_wait) {
-            logger.info(
-                "UE does not have service, waiting for NAS service request (%d/%d)", service_wait, SERVICE_WAIT_TOUT);
-            stack->start_service_request();
-          }
-          usleep(100000);
-          service_wait++;
-        }
-        service_wait = 0;
+      // Beyond this point we should have a activated default EPS bearer
+      srsran_assert(default_eps_bearer_id != NOT_ASSIGNED, "Default EPS bearer not activated");
 
-        // Quit before writing packet if necessary
-        if (!run_enable) {
-          break;
+      // All packets of a batch are segments of the same TCP flow, so the TFT lookup of the first one applies to all
+      uint8_t eps_bearer_id = default_eps_bearer_id;
+      tft_matcher.check_tft_filter_match(pdus.front(), eps_bearer_id);
+
+      // Wait for service request if necessary
+      while (run_enable && !stack->has_active_radio_bearer(eps_bearer_id) && service_wait < SERVICE_WAIT_TOUT) {
+        if (!service_wait) {
+          logger.info(
+              "UE does not have service, waiting for NAS service request (%d/%d)", service_wait, SERVICE_WAIT_TOUT);
+          stack->start_service_request();
         }
+        usleep(100000);
+        service_wait++;
+      }
+      service_wait = 0;
 
-        // Send PDU directly to PDCP
-        pdu->set_timestamp();
-        ul_tput_bytes += pdu->N_bytes;
-        stack->write_sdu(eps_bearer_id, std::move(pdu));
-        do {
-          pdu = srsran::make_byte_buffer();
-          if (!pdu) {
-            logger.error("Fatal Error: Couldn't allocate PDU in run_thread().");
-            usleep(100000);
-          }
-        } while (!pdu);
-        idx = 0;
+      // Quit before writing packet if necessary
+      if (!run_enable) {
+        break;
+      }
+
+      // Send PDU(s) directly to PDCP
+      for (srsran::unique_byte_buffer_t& tx_pdu : pdus) {
+        tx_pdu->set_timestamp();
+        ul_tput_bytes += tx_pdu->N_bytes;
+      }
+      if (pdus.size() == 1) {
+        stack->write_sdu(eps_bearer_id, std::move(pdus.front()));
       } else {
-        idx += N_bytes;
-        logger.debug("Entire packet not read from socket. Total Length %d, N_Bytes %d.", ip_pkt->tot_len, pdu->N_bytes);
+        stack->write_sdus(eps_bearer_id, std::move(pdus));
       }
+      pdus.clear();
     } // end of holdering gw_mutex
   }
   running = false;
   logger.info("GW IP receiver thread exiting.");
 }
 
+/**
+ * Reads one packet from a TUN device opened with IFF_VNET_HDR and splits it into IP packets.
+ * @return number of packets appended to pdus (0 if the packet was dropped), SRSRAN_ERROR if the read failed
+ */
+int gw::read_tun_offload(std::vector<srsran::unique_byte_buffer_t>& pdus)
+{
+  int N_bytes = read(tun_fd, tun_rx_buf.data(), tun_rx_buf.size());
+  if (N_bytes <= 0) {
+    return SRSRAN_ERROR;
+  }
+  logger.debug("Read %d bytes from TUN fd=%d", N_bytes, tun_fd);
+  if ((uint32_t)N_bytes <= TUN_VNET_HDR_LEN) {
+    logger.error("Packet too small to hold virtio-net header. Dropping packet with %d B", N_bytes);
+    return 0;
+  }
+
+  tun_vnet_hdr_t vnet_hdr;
+  memcpy(&vnet_hdr, tun_rx_buf.data(), TUN_VNET_HDR_LEN);
+  uint8_t* pkt     = &tun_rx_buf[TUN_VNET_HDR_LEN];
+  uint32_t pkt_len = N_bytes - TUN_VNET_HDR_LEN;
+
+  struct iphdr* ip_pkt = (struct iphdr*)pkt;
+  if (ip_pkt->version != 4 && ip_pkt->version != 6) {
+    logger.error(pkt, pkt_len, "Unsupported IP version. Dropping packet.");
+    return 0;
+  }
+
+  int nof_pdus = tun_segment_pdu(vnet_hdr, pkt, pkt_len, pdus);
+  if (nof_pdus < 0) {
+    logger.error(pkt,
+                 pkt_len,
+                 "Couldn't segment packet (gso_type=%d, gso_size=%d). Dropping packet.",
+                 vnet_hdr.gso_type,
+                 vnet_hdr.gso_size);
+    pdus.clear();
+    return 0;
+  }
+  if (nof_pdus > 1) {
+    logger.debug("Segmented %d B GSO packet into %d packets (gso_size=%d)", pkt_len, nof_pdus, vnet_hdr.gso_size);
+  }
+  return nof_pdus;
+}
+
+/**
+ * Writes one IP packet to the TUN device, prepending an empty virtio-net header if offload is enabled.
+ * @return number of bytes of the IP packet written, or negative on error
+ */
+int gw::write_tun(const uint8_t* data, uint32_t len)
+{
+  if (!tun_offload) {
+    return write(tun_fd, data, len);
+  }
+  tun_vnet_hdr_t vnet_hdr = {};
+  struct iovec          iov[2]   = {{&vnet_hdr, TUN_VNET_HDR_LEN}, {(void*)data, len}};
+  int                   n        = writev(tun_fd, iov, 2);
+  return (n < (int)TUN_VNET_HDR_LEN) ? n : n - (int)TUN_VNET_HDR_LEN;
+}
+
 /**************************/
 /* TUN Interface Helpers  */
 /**************************/
@@ -430,6 +519,9 @@ int gw::init_if(char* err_str)
 
   memset(&ifr, 0, sizeof(ifr));
   ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+  if (args.tun_dev_offload) {
+    ifr.ifr_flags |= IFF_VNET_HDR;
+  }
   strncpy(
       ifr.ifr_ifrn.ifrn_name, args.tun_dev_name.c_str(), std::min(args.tun_dev_name.length(), (size_t)(IFNAMSIZ - 1)));
   ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = 0;
@@ -440,6 +532,15 @@ int gw::init_if(char* err_str)
     return SRSRAN_ERROR_CANT_START;
   }
 
+  // Let the kernel pass TCP super-packets with partial checksums, they are segmented in run_thread()
+  tun_offload = args.tun_dev_offload;
+  if (tun_offload) {
+    if (0 > ioctl(tun_fd, TUNSETOFFLOAD, TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6)) {
+      logger.warning("Failed to enable TUN offload: %s", strerror(errno));
+    }
+    tun_rx_buf.resize(TUN_VNET_HDR_LEN + TUN_GSO_MAX_SIZE);
+  }
+
   // Bring up the interface
   sock = socket(AF_INET, SOCK_DGRAM, 0);
   if (0 > ioctl(sock, SIOCGIFFLAGS, &ifr)) {
@@ -0,0 +1,228 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/upper/ipv6.h"
+#include "srsue/hdr/stack/upper/tun_offload.h"
+
+#include <arpa/inet.h>
+#include <linux/ip.h>
+#include <linux/tcp.h>
+#include <netinet/in.h>
+
+using namespace srsue;
+
+// IPv4/UDP packet, source 127.0.0.1:2222, destination 127.0.0.2:2001, IP checksum 0x86fb
+uint8_t ipv4_udp_pkt[] = {
+    0x45, 0x04, 0x00, 0x5c, 0xb5, 0x8e, 0x40, 0x00, 0x40, 0x11, 0x86, 0xfb, 0x7f, 0x00, 0x00, 0x01, 0x7f, 0x00, 0x00,
+    0x02, 0x08, 0xae, 0x07, 0xd1, 0x00, 0x48, 0xfe, 0x5c, 0xaf, 0xed, 0x69, 0x5a, 0x77, 0x80, 0x6e, 0x2f, 0x5e, 0xf3,
+    0x76, 0x17, 0x05, 0xe4, 0x2b, 0xca, 0xb2, 0xd2, 0xcb, 0xa5, 0x58, 0x06, 0xc5, 0x02, 0x8d, 0xf1, 0x7a, 0x3d, 0x4f,
+    0x14, 0x34, 0x58, 0x92, 0x37, 0x7c, 0x95, 0x53, 0x18, 0xa3, 0xff, 0x08, 0x1b, 0x07, 0x99, 0x94, 0xe2, 0x10, 0x0d,
+    0x3d, 0x25, 0x20, 0x13, 0x95, 0x84, 0x53, 0x4b, 0x6a, 0x92, 0x64, 0x5a, 0xce, 0xbb, 0x6c, 0x3a,
+};
+
+// Checksum of the TCP segment including the pseudo-header, must be zero for a valid segment
+uint16_t tcp_csum(const uint8_t* pkt, uint32_t len, bool ipv6)
+{
+  std::vector<uint8_t> buf;
+  uint32_t             ip_hdr_len = ipv6 ? sizeof(struct ipv6hdr) : sizeof(struct iphdr);
+  uint16_t             l4_len     = htons(len - ip_hdr_len);
+  uint8_t              proto[2]   = {0, IPPROTO_TCP};
+  if (ipv6) {
+    buf.insert(buf.end(), &pkt[8], &pkt[40]);
+  } else {
+    buf.insert(buf.end(), &pkt[12], &pkt[20]);
+  }
+  buf.insert(buf.end(), proto, proto + 2);
+  buf.insert(buf.end(), (uint8_t*)&l4_len, (uint8_t*)&l4_len + 2);
+  buf.insert(buf.end(), &pkt[ip_hdr_len], &pkt[len]);
+  return tun_csum(buf.data(), buf.size());
+}
+
+// Builds a TCP GSO super-packet with 12 B of TCP options and FIN/PSH/CWR set
+std::vector<uint8_t> make_tcp_pkt(bool ipv6, uint32_t payload_len)
+{
+  uint32_t             ip_hdr_len = ipv6 ? sizeof(struct ipv6hdr) : sizeof(struct iphdr);
+  uint32_t             tcp_len    = sizeof(struct tcphdr) + 12 + payload_len;
+  std::vector<uint8_t> pkt(ip_hdr_len + tcp_len);
+
+  if (ipv6) {
+    struct ipv6hdr* ip6 = (struct ipv6hdr*)pkt.data();
+    ip6->version        = 6;
+    ip6->payload_len    = htons(tcp_len);
+    ip6->nexthdr        = IPPROTO_TCP;
+    ip6->hop_limit      = 64;
+    inet_pton(AF_INET6, "2001:db8::1", &ip6->saddr);
+    inet_pton(AF_INET6, "2001:db8::2", &ip6->daddr);
+  } else {
+    struct iphdr* ip = (struct iphdr*)pkt.data();
+    ip->version      = 4;
+    ip->ihl          = 5;
+    ip->tot_len      = htons(pkt.size());
+    ip->id           = htons(0xfffe);
+    ip->ttl          = 64;
+    ip->protocol     = IPPROTO_TCP;
+    ip->saddr        = htonl(0xac100003);
+    ip->daddr        = htonl(0x08080808);
+  }
+  struct tcphdr* tcp = (struct tcphdr*)&pkt[ip_hdr_len];
+  tcp->source        = htons(5001);
+  tcp->dest          = htons(40000);
+  tcp->seq           = htonl(0xfffff000);
+  tcp->doff          = (sizeof(struct tcphdr) + 12) / 4;
+  tcp->ack           = 1;
+  tcp->fin           = 1;
+  tcp->psh           = 1;
+  tcp->cwr           = 1;
+  for (uint32_t i = 0; i < payload_len; i++) {
+    pkt[ip_hdr_len + sizeof(struct tcphdr) + 12 + i] = i * 7;
+  }
+  return pkt;
+}
+
+int test_csum()
+{
+  std::vector<uint8_t> hdr(ipv4_udp_pkt, ipv4_udp_pkt + sizeof(struct iphdr));
+  TESTASSERT(tun_csum(hdr.data(), hdr.size()) == 0);
+  hdr[10] = hdr[11] = 0;
+  TESTASSERT(ntohs(tun_csum(hdr.data(), hdr.size())) == 0x86fb);
+
+  // Kernel leaves the folded pseudo-header sum in the UDP checksum field
+  std::vector<uint8_t> pkt(ipv4_udp_pkt, ipv4_udp_pkt + sizeof(ipv4_udp_pkt));
+  uint8_t              pseudo[12] = {};
+  memcpy(pseudo, &pkt[12], 8);
+  pseudo[9]        = IPPROTO_UDP;
+  uint16_t udp_len = htons(pkt.size() - sizeof(struct iphdr));
+  memcpy(&pseudo[10], &udp_len, 2);
+  uint16_t partial = ~tun_csum(pseudo, sizeof(pseudo));
+  memcpy(&pkt[26], &partial, 2);
+
+  tun_vnet_hdr_t vnet_hdr = {};
+  vnet_hdr.flags          = TUN_VNET_HDR_F_NEEDS_CSUM;
+  vnet_hdr.csum_start     = sizeof(struct iphdr);
+  vnet_hdr.csum_offset    = 6;
+
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+  TESTASSERT(tun_segment_pdu(vnet_hdr, pkt.data(), pkt.size(), pdus) == 1);
+  TESTASSERT(pdus.size() == 1);
+  TESTASSERT(pdus[0]->N_bytes == sizeof(ipv4_udp_pkt));
+  TESTASSERT(memcmp(pdus[0]->msg, ipv4_udp_pkt, 26) == 0);
+  TESTASSERT(memcmp(&pdus[0]->msg[28], &ipv4_udp_pkt[28], sizeof(ipv4_udp_pkt) - 28) == 0);
+
+  // Sum over pseudo-header and UDP datagram including the completed checksum must be zero
+  std::vector<uint8_t> udp(pseudo, pseudo + sizeof(pseudo));
+  udp.insert(udp.end(), &pdus[0]->msg[sizeof(struct iphdr)], &pdus[0]->msg[pdus[0]->N_bytes]);
+  TESTASSERT(tun_csum(udp.data(), udp.size()) == 0);
+
+  // Checksum field out of bounds
+  vnet_hdr.csum_start = pkt.size() - 1;
+  pdus.clear();
+  TESTASSERT(tun_segment_pdu(vnet_hdr, pkt.data(), pkt.size(), pdus) == -1);
+  return SRSRAN_SUCCESS;
+}
+
+int test_tcp_gso(bool ipv6)
+{
+  const uint32_t       payload_len = 4000, gso_size = 1448, nof_segments = 3;
+  std::vector<uint8_t> pkt         = make_tcp_pkt(ipv6, payload_len);
+  uint32_t             ip_hdr_len  = ipv6 ? sizeof(struct ipv6hdr) : sizeof(struct iphdr);
+  uint32_t             hdr_len     = ip_hdr_len + sizeof(struct tcphdr) + 12;
+
+  tun_vnet_hdr_t vnet_hdr = {};
+  vnet_hdr.flags          = TUN_VNET_HDR_F_NEEDS_CSUM;
+  vnet_hdr.gso_type       = ipv6 ? TUN_VNET_HDR_GSO_TCPV6 : TUN_VNET_HDR_GSO_TCPV4;
+  vnet_hdr.gso_size       = gso_size;
+  vnet_hdr.hdr_len        = hdr_len;
+  vnet_hdr.csum_start     = ip_hdr_len;
+  vnet_hdr.csum_offset    = 16;
+
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+  int                                       nof_pdus = tun_segment_pdu(vnet_hdr, pkt.data(), pkt.size(), pdus);
+  TESTASSERT(nof_pdus == nof_segments);
+  TESTASSERT(pdus.size() == nof_segments);
+
+  std::vector<uint8_t> payload;
+  for (uint32_t i = 0; i < nof_segments; i++) {
+    const uint8_t* seg     = pdus[i]->msg;
+    uint32_t       seg_len = std::min(gso_size, payload_len - i * gso_size);
+    TESTASSERT(pdus[i]->N_bytes == hdr_len + seg_len);
+
+    if (ipv6) {
+      const struct ipv6hdr* ip6 = (const struct ipv6hdr*)seg;
+      TESTASSERT(ntohs(ip6->payload_len) == pdus[i]->N_bytes - ip_hdr_len);
+    } else {
+      const struct iphdr* ip = (const struct iphdr*)seg;
+      TESTASSERT(ntohs(ip->tot_len) == pdus[i]->N_bytes);
+      TESTASSERT(ntohs(ip->id) == (uint16_t)(0xfffe + i));
+      TESTASSERT(tun_csum(seg, ip_hdr_len) == 0);
+    }
+
+    const struct tcphdr* tcp  = (const struct tcphdr*)&seg[ip_hdr_len];
+    bool                 last = (i == nof_segments - 1);
+    TESTASSERT(ntohl(tcp->seq) == (uint32_t)(0xfffff000 + i * gso_size));
+    TESTASSERT(tcp->fin == last);
+    TESTASSERT(tcp->psh == last);
+    TESTASSERT(tcp->cwr == (i == 0));
+    TESTASSERT(tcp->ack == 1);
+    TESTASSERT(memcmp(&seg[ip_hdr_len + sizeof(struct tcphdr)], &pkt[ip_hdr_len + sizeof(struct tcphdr)], 12) == 0);
+    TESTASSERT(tcp_csum(seg, pdus[i]->N_bytes, ipv6) == 0);
+
+    payload.insert(payload.end(), &seg[hdr_len], &seg[pdus[i]->N_bytes]);
+  }
+  TESTASSERT(payload.size() == payload_len);
+  TESTASSERT(memcmp(payload.data(), &pkt[hdr_len], payload_len) == 0);
+  return SRSRAN_SUCCESS;
+}
+
+int test_malformed()
+{
+  tun_vnet_hdr_t                            vnet_hdr = {};
+  std::vector<srsran::unique_byte_buffer_t> pdus;
+
+  // UDP packet flagged as TCP GSO
+  vnet_hdr.gso_type = TUN_VNET_HDR_GSO_TCPV4;
+  vnet_hdr.gso_size = 1400;
+  TESTASSERT(tun_segment_pdu(vnet_hdr, ipv4_udp_pkt, sizeof(ipv4_udp_pkt), pdus) == -1);
+
+  // Truncated TCP header
+  std::vector<uint8_t> pkt = make_tcp_pkt(false, 100);
+  TESTASSERT(tun_segment_pdu(vnet_hdr, pkt.data(), sizeof(struct iphdr) + 10, pdus) == -1);
+
+  // Unsupported GSO type
+  vnet_hdr.gso_type = TUN_VNET_HDR_GSO_UDP;
+  TESTASSERT(tun_segment_pdu(vnet_hdr, pkt.data(), pkt.size(), pdus) == -1);
+  TESTASSERT(pdus.empty());
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(test_csum() == SRSRAN_SUCCESS);
+  TESTASSERT(test_tcp_gso(false) == SRSRAN_SUCCESS);
+  TESTASSERT(test_tcp_gso(true) == SRSRAN_SUCCESS);
+  TESTASSERT(test_malformed() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
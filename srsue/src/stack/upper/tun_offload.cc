@@ -0,0 +1,183 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsue/hdr/stack/upper/tun_offload.h"
+#include "srsran/upper/ipv6.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <linux/ip.h>
+#include <linux/tcp.h>
+#include <linux/udp.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace srsue {
+
+// Ones' complement sum of 32-bit words. The carries are kept in the upper half of the accumulator and folded later.
+static uint64_t csum_partial(const uint8_t* data, uint32_t len, uint64_t sum)
+{
+  uint32_t w32;
+  uint16_t w16;
+  for (; len >= 4; data += 4, len -= 4) {
+    memcpy(&w32, data, sizeof(w32));
+    sum += w32;
+  }
+  if (len >= 2) {
+    memcpy(&w16, data, sizeof(w16));
+    sum += w16;
+    data += 2;
+    len -= 2;
+  }
+  if (len > 0) {
+    uint8_t tail[2] = {data[0], 0};
+    memcpy(&w16, tail, sizeof(w16));
+    sum += w16;
+  }
+  return sum;
+}
+
+static uint16_t csum_fold(uint64_t sum)
+{
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return (uint16_t)~sum;
+}
+
+uint16_t tun_csum(const uint8_t* data, uint32_t len, uint64_t sum)
+{
+  return csum_fold(csum_partial(data, len, sum));
+}
+
+bool tun_complete_csum(uint8_t* pkt, uint32_t len, uint16_t csum_start, uint16_t csum_offset)
+{
+  if ((uint32_t)csum_start + csum_offset + sizeof(uint16_t) > len) {
+    return false;
+  }
+  uint16_t csum = tun_csum(&pkt[csum_start], len - csum_start);
+  // A zero UDP checksum means "no checksum", hence it is transmitted as all ones
+  if (csum == 0 && csum_offset == offsetof(struct udphdr, check)) {
+    csum = 0xffff;
+  }
+  memcpy(&pkt[csum_start + csum_offset], &csum, sizeof(csum));
+  return true;
+}
+
+int tun_segment_pdu(const tun_vnet_hdr_t&                      vnet_hdr,
+                    const uint8_t*                             pkt,
+                    uint32_t                                   len,
+                    std::vector<srsran::unique_byte_buffer_t>& pdus)
+{
+  uint8_t gso_type = vnet_hdr.gso_type & ~TUN_VNET_HDR_GSO_ECN;
+
+  if (gso_type == TUN_VNET_HDR_GSO_NONE) {
+    srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+    if (pdu == nullptr || len > pdu->get_tailroom()) {
+      return -1;
+    }
+    memcpy(pdu->msg, pkt, len);
+    pdu->N_bytes = len;
+    if ((vnet_hdr.flags & TUN_VNET_HDR_F_NEEDS_CSUM) &&
+        not tun_complete_csum(pdu->msg, pdu->N_bytes, vnet_hdr.csum_start, vnet_hdr.csum_offset)) {
+      return -1;
+    }
+    pdus.push_back(std::move(pdu));
+    return 1;
+  }
+
+  if ((gso_type != TUN_VNET_HDR_GSO_TCPV4 && gso_type != TUN_VNET_HDR_GSO_TCPV6) || vnet_hdr.gso_size == 0) {
+    return -1;
+  }
+
+  // Locate the IP and TCP headers. The kernel does not generate TCP GSO packets with IPv6 extension headers.
+  uint32_t ip_hdr_len = 0;
+  if (gso_type == TUN_VNET_HDR_GSO_TCPV4) {
+    const struct iphdr* ip = (const struct iphdr*)pkt;
+    if (len < sizeof(struct iphdr) || ip->version != 4 || ip->protocol != IPPROTO_TCP) {
+      return -1;
+    }
+    ip_hdr_len = ip->ihl * 4;
+  } else {
+    const struct ipv6hdr* ip6 = (const struct ipv6hdr*)pkt;
+    if (len < sizeof(struct ipv6hdr) || ip6->version != 6 || ip6->nexthdr != IPPROTO_TCP) {
+      return -1;
+    }
+    ip_hdr_len = sizeof(struct ipv6hdr);
+  }
+  if (len < ip_hdr_len + sizeof(struct tcphdr)) {
+    return -1;
+  }
+  uint32_t tcp_hdr_len = ((const struct tcphdr*)&pkt[ip_hdr_len])->doff * 4;
+  uint32_t hdr_len     = ip_hdr_len + tcp_hdr_len;
+  if (tcp_hdr_len < sizeof(struct tcphdr) || len < hdr_len) {
+    return -1;
+  }
+
+  uint32_t payload_len = len - hdr_len;
+  int      nof_pdus    = 0;
+  for (uint32_t offset = 0; offset < payload_len; offset += vnet_hdr.gso_size, nof_pdus++) {
+    uint32_t seg_len = std::min((uint32_t)vnet_hdr.gso_size, payload_len - offset);
+
+    srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+    if (pdu == nullptr || hdr_len + seg_len > pdu->get_tailroom()) {
+      return -1;
+    }
+    memcpy(pdu->msg, pkt, hdr_len);
+    memcpy(&pdu->msg[hdr_len], &pkt[hdr_len + offset], seg_len);
+    pdu->N_bytes = hdr_len + seg_len;
+
+    // IP header and TCP pseudo-header
+    uint16_t l4_len = tcp_hdr_len + seg_len;
+    uint64_t pseudo = htons(IPPROTO_TCP) + htons(l4_len);
+    if (gso_type == TUN_VNET_HDR_GSO_TCPV4) {
+      struct iphdr* ip = (struct iphdr*)pdu->msg;
+      ip->tot_len      = htons(pdu->N_bytes);
+      ip->id           = htons(ntohs(ip->id) + nof_pdus);
+      ip->check        = 0;
+      ip->check        = tun_csum(pdu->msg, ip_hdr_len);
+      pseudo           = csum_partial((const uint8_t*)&ip->saddr, 2 * sizeof(ip->saddr), pseudo);
+    } else {
+      struct ipv6hdr* ip6 = (struct ipv6hdr*)pdu->msg;
+      ip6->payload_len    = htons(l4_len);
+      pseudo              = csum_partial((const uint8_t*)&ip6->saddr, 2 * sizeof(ip6->saddr), pseudo);
+    }
+
+    // TCP header: FIN/PSH only apply to the last segment and CWR only to the first one
+    struct tcphdr* tcp = (struct tcphdr*)&pdu->msg[ip_hdr_len];
+    tcp->seq           = htonl(ntohl(tcp->seq) + offset);
+    if (offset + seg_len < payload_len) {
+      tcp->fin = 0;
+      tcp->psh = 0;
+    }
+    if (offset > 0) {
+      tcp->cwr = 0;
+    }
+    tcp->check = 0;
+    tcp->check = tun_csum((const uint8_t*)tcp, l4_len, pseudo);
+
+    pdus.push_back(std::move(pdu));
+  }
+  return nof_pdus;
+}
+
+} // namespace srsue